@@ -0,0 +1,243 @@
+#include "a_applicationfilter.h"
+#include <QElapsedTimer>
+#include <algorithm>
+
+A_applicationfilter::A_applicationfilter(A_applicationmodel* _source, A_process* _processManager, QObject *parent)
+    : QAbstractProxyModel(parent), Source(_source), ProcessManager(_processManager)
+{
+    StateMask = A_applicationmodel::AnyState;
+    LastFilterDurationNs = 0;
+
+    RefilterTimer = new QTimer(this);
+    RefilterTimer->setSingleShot(true);
+    RefilterTimer->setInterval(A_applicationmodel::FlushIntervalMs);
+    connect(RefilterTimer, &QTimer::timeout, this, &A_applicationfilter::Refilter);
+
+    QAbstractProxyModel::setSourceModel(Source);
+    connect(Source, &QAbstractItemModel::modelAboutToBeReset, this, [this]() { beginResetModel(); });
+    connect(Source, &QAbstractItemModel::modelReset, this, &A_applicationfilter::OnSourceReset);
+    connect(Source, &QAbstractItemModel::dataChanged, this, &A_applicationfilter::OnSourceDataChanged);
+    connect(ProcessManager, &A_process::ApplicationStatusChanged,
+            this, &A_applicationfilter::OnApplicationStatusChanged);
+
+    // Schedule and parking changes alter the run state without a running-state change
+    connect(ProcessManager, &A_process::ApplicationScheduled, this,
+            [this](const QString& _appName, bool) { UpdateState(_appName); });
+    connect(ProcessManager, &A_process::ApplicationParked, this,
+            [this](const QString& _appName, qint64) { UpdateState(_appName); });
+
+    beginResetModel();
+    OnSourceReset();
+}
+
+void A_applicationfilter::SetFilterText(const QString& _text)
+{
+    if (_text == FilterText) {
+        return;
+    }
+    FilterText = _text;
+    Refilter();
+}
+
+void A_applicationfilter::SetStateMask(quint8 _stateMask)
+{
+    if (_stateMask == StateMask) {
+        return;
+    }
+    StateMask = _stateMask;
+    Refilter();
+}
+
+void A_applicationfilter::OnApplicationStatusChanged(const QString& _appName, bool _isRunning)
+{
+    Q_UNUSED(_isRunning);
+    UpdateState(_appName);
+}
+
+void A_applicationfilter::UpdateState(const QString& _appName)
+{
+    const int _row = Source->RowOf(_appName);
+    if (_row < 0) {
+        return;
+    }
+
+    const quint8 _oldState = Index.State(_row);
+    const quint8 _newState = A_applicationmodel::RunStateOf(ProcessManager->GetProcessInfo(_appName));
+    if (_oldState == _newState) {
+        return;
+    }
+    Index.SetState(_row, _newState);
+
+    // Bursts of status changes are applied together, at most once per frame
+    if (((_oldState & StateMask) != 0) != ((_newState & StateMask) != 0) && !RefilterTimer->isActive()) {
+        RefilterTimer->start();
+    }
+}
+
+void A_applicationfilter::OnSourceReset()
+{
+    RefilterTimer->stop();
+    Index.Clear();
+
+    const int _rowCount = Source->rowCount();
+    for (int _row = 0; _row < _rowCount; ++_row) {
+        const QModelIndex _sourceIndex = Source->index(_row, 0);
+        Index.SetDocument(_row, _sourceIndex.data(A_applicationmodel::SearchTextRole).toString(),
+                          quint8(_sourceIndex.data(A_applicationmodel::RunStateRole).toInt()));
+    }
+
+    ProxyToSource = Index.Search(FilterText, StateMask);
+    endResetModel();
+    emit FilterChanged(ProxyToSource.size(), _rowCount);
+}
+
+void A_applicationfilter::OnSourceDataChanged(const QModelIndex& _topLeft, const QModelIndex& _bottomRight,
+                                              const QList<int>& _roles)
+{
+    auto _first = std::lower_bound(ProxyToSource.constBegin(), ProxyToSource.constEnd(), _topLeft.row());
+    auto _last = std::upper_bound(_first, ProxyToSource.constEnd(), _bottomRight.row());
+    if (_first == _last) {
+        return;
+    }
+
+    const int _firstRow = int(_first - ProxyToSource.constBegin());
+    const int _lastRow = int(_last - ProxyToSource.constBegin()) - 1;
+    emit dataChanged(index(_firstRow, _topLeft.column()), index(_lastRow, _bottomRight.column()), _roles);
+}
+
+void A_applicationfilter::Refilter()
+{
+    QElapsedTimer _timer;
+    _timer.start();
+
+    RefilterTimer->stop();
+    const QVector<int> _rows = Index.Search(FilterText, StateMask);
+    if (_rows != ProxyToSource) {
+        ApplyRows(_rows);
+        emit FilterChanged(ProxyToSource.size(), Source->rowCount());
+    }
+
+    LastFilterDurationNs = _timer.nsecsElapsed();
+}
+
+void A_applicationfilter::ApplyRows(const QVector<int>& _rows)
+{
+    // Count the removal and insertion ranges; scattered changes are cheaper as a reset
+    int _ranges = 0;
+    {
+        int _i = 0;
+        int _j = 0;
+        int _previous = 0;  // 0 equal, 1 removal, 2 insertion
+        while (_i < ProxyToSource.size() || _j < _rows.size()) {
+            int _step = 0;
+            if (_j >= _rows.size() || (_i < ProxyToSource.size() && ProxyToSource.at(_i) < _rows.at(_j))) {
+                _step = 1;
+                ++_i;
+            } else if (_i >= ProxyToSource.size() || _rows.at(_j) < ProxyToSource.at(_i)) {
+                _step = 2;
+                ++_j;
+            } else {
+                ++_i;
+                ++_j;
+            }
+            if (_step != 0 && _step != _previous && ++_ranges > MaxIncrementalRanges) {
+                break;
+            }
+            _previous = _step;
+        }
+    }
+
+    if (_ranges > MaxIncrementalRanges) {
+        beginResetModel();
+        ProxyToSource = _rows;
+        endResetModel();
+        return;
+    }
+
+    // Remove rows that no longer match, last range first so earlier positions stay valid
+    int _i = ProxyToSource.size() - 1;
+    while (_i >= 0) {
+        if (std::binary_search(_rows.constBegin(), _rows.constEnd(), ProxyToSource.at(_i))) {
+            --_i;
+            continue;
+        }
+        const int _end = _i;
+        while (_i >= 0 && !std::binary_search(_rows.constBegin(), _rows.constEnd(), ProxyToSource.at(_i))) {
+            --_i;
+        }
+        beginRemoveRows(QModelIndex(), _i + 1, _end);
+        ProxyToSource.remove(_i + 1, _end - _i);
+        endRemoveRows();
+    }
+
+    // Insert newly matching rows; the remaining rows are a subsequence of _rows
+    int _position = 0;
+    int _j = 0;
+    while (_j < _rows.size()) {
+        if (_position < ProxyToSource.size() && ProxyToSource.at(_position) == _rows.at(_j)) {
+            ++_position;
+            ++_j;
+            continue;
+        }
+        const int _start = _j;
+        while (_j < _rows.size() && (_position >= ProxyToSource.size() || _rows.at(_j) < ProxyToSource.at(_position))) {
+            ++_j;
+        }
+        const int _count = _j - _start;
+        beginInsertRows(QModelIndex(), _position, _position + _count - 1);
+        ProxyToSource = ProxyToSource.mid(0, _position) + _rows.mid(_start, _count) + ProxyToSource.mid(_position);
+        endInsertRows();
+        _position += _count;
+    }
+}
+
+QModelIndex A_applicationfilter::mapToSource(const QModelIndex& _proxyIndex) const
+{
+    if (!_proxyIndex.isValid() || _proxyIndex.row() >= ProxyToSource.size()) {
+        return QModelIndex();
+    }
+    return Source->index(ProxyToSource.at(_proxyIndex.row()), _proxyIndex.column());
+}
+
+QModelIndex A_applicationfilter::mapFromSource(const QModelIndex& _sourceIndex) const
+{
+    if (!_sourceIndex.isValid()) {
+        return QModelIndex();
+    }
+
+    auto _it = std::lower_bound(ProxyToSource.constBegin(), ProxyToSource.constEnd(), _sourceIndex.row());
+    if (_it == ProxyToSource.constEnd() || *_it != _sourceIndex.row()) {
+        return QModelIndex();
+    }
+    return index(int(_it - ProxyToSource.constBegin()), _sourceIndex.column());
+}
+
+QModelIndex A_applicationfilter::index(int _row, int _column, const QModelIndex& _parent) const
+{
+    if (_parent.isValid() || _row < 0 || _row >= ProxyToSource.size() ||
+        _column < 0 || _column >= A_applicationmodel::ColumnCount) {
+        return QModelIndex();
+    }
+    return createIndex(_row, _column);
+}
+
+QModelIndex A_applicationfilter::parent(const QModelIndex& _child) const
+{
+    Q_UNUSED(_child);
+    return QModelIndex();
+}
+
+int A_applicationfilter::rowCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : ProxyToSource.size();
+}
+
+int A_applicationfilter::columnCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : A_applicationmodel::ColumnCount;
+}
+
+QVariant A_applicationfilter::headerData(int _section, Qt::Orientation _orientation, int _role) const
+{
+    return Source->headerData(_section, _orientation, _role);
+}
@@ -0,0 +1,115 @@
+#ifndef A_APPLICATIONFILTER_H
+#define A_APPLICATIONFILTER_H
+
+#include <QAbstractProxyModel>
+#include <QTimer>
+#include <QVector>
+#include <QString>
+#include "a_applicationmodel.h"
+#include "a_searchindex.h"
+
+/**
+ * @brief Filtering proxy over the application model
+ *
+ * Matches a substring against application names and executable paths and
+ * filters by supervision state. Matching is answered by an A_searchindex
+ * that is built when the source model resets and kept current from the
+ * process manager's status, schedule and parking signals, so a keystroke never scans the
+ * whole inventory. Visible rows keep the source order.
+ */
+class A_applicationfilter : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param _source Application model - must outlive this instance
+     * @param _processManager Process manager - source of status-change signals
+     */
+    A_applicationfilter(A_applicationmodel* _source, A_process* _processManager, QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the substring filter
+     * @param _text Substring of name or executable path - case-insensitive, empty shows all
+     */
+    void SetFilterText(const QString& _text);
+
+    /**
+     * @brief Sets the state filter
+     * @param _stateMask A_applicationmodel::RunState bits to show
+     */
+    void SetStateMask(quint8 _stateMask);
+
+    /**
+     * @brief Gets the time the last filter update took
+     * @return qint64 Index query and row update - nanoseconds
+     */
+    qint64 LastFilterNs() const { return LastFilterDurationNs; }
+
+    // QAbstractProxyModel
+    QModelIndex mapToSource(const QModelIndex& _proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& _sourceIndex) const override;
+    QModelIndex index(int _row, int _column, const QModelIndex& _parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& _child) const override;
+    int rowCount(const QModelIndex& _parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& _parent = QModelIndex()) const override;
+    QVariant headerData(int _section, Qt::Orientation _orientation, int _role = Qt::DisplayRole) const override;
+
+signals:
+    /**
+     * @brief Emitted when the set of visible rows changed
+     * @param visibleCount Rows passing the filter
+     * @param totalCount Rows in the source model
+     */
+    void FilterChanged(int visibleCount, int totalCount);
+
+private slots:
+    /**
+     * @brief Keeps the state index current
+     * @param _appName Application whose status changed
+     * @param _isRunning New running state - the full state is read from the process manager
+     */
+    void OnApplicationStatusChanged(const QString& _appName, bool _isRunning);
+
+    /**
+     * @brief Rebuilds the index after the source model reset
+     */
+    void OnSourceReset();
+
+    /**
+     * @brief Forwards changed source rows that are visible
+     */
+    void OnSourceDataChanged(const QModelIndex& _topLeft, const QModelIndex& _bottomRight, const QList<int>& _roles);
+
+    /**
+     * @brief Queries the index and applies the result to the visible rows
+     */
+    void Refilter();
+
+private:
+    static constexpr int MaxIncrementalRanges = 64;    // Above this many row ranges a reset is cheaper
+
+    A_applicationmodel* Source;         // Source model - rows in configuration order
+    A_process* ProcessManager;          // Process manager - run state lookup
+    A_searchindex Index;                // Substring and state index - document id: source row
+    QString FilterText;                 // Current substring filter
+    quint8 StateMask;                   // Current state filter - RunState bits
+    QVector<int> ProxyToSource;         // Visible rows - ascending source rows
+    QTimer* RefilterTimer;              // Single-shot coalescing timer for status-driven refilters
+    qint64 LastFilterDurationNs;        // Duration of the last refilter - nanoseconds
+
+    /**
+     * @brief Re-reads the run state of one application into the index
+     * Membership changes under a state filter are applied by a coalesced refilter.
+     * @param _appName Application whose state may have changed
+     */
+    void UpdateState(const QString& _appName);
+
+    /**
+     * @brief Moves the visible rows to a new set with row removals and insertions
+     * @param _rows New visible source rows - ascending
+     */
+    void ApplyRows(const QVector<int>& _rows);
+};
+
+#endif // A_APPLICATIONFILTER_H
@@ -0,0 +1,238 @@
+#include "a_applicationmodel.h"
+#include "a_tracer.h"
+#include <QDateTime>
+#include <algorithm>
+
+A_applicationmodel::A_applicationmodel(A_process* _processManager, QObject *parent)
+    : QAbstractTableModel(parent), ProcessManager(_processManager)
+{
+    FlushTimer = new QTimer(this);
+    FlushTimer->setSingleShot(true);
+    FlushTimer->setInterval(FlushIntervalMs);
+    connect(FlushTimer, &QTimer::timeout, this, &A_applicationmodel::FlushDirtyRows);
+}
+
+void A_applicationmodel::Reload()
+{
+    beginResetModel();
+
+    // A reset repaints everything; pending row updates are moot
+    DirtyRows.clear();
+    FlushTimer->stop();
+
+    const QStringList _names = ProcessManager->GetApplicationNames();
+    AppNames = QVector<QString>(_names.begin(), _names.end());
+    RowByName.clear();
+    RowByName.reserve(AppNames.size());
+    for (int _row = 0; _row < AppNames.size(); ++_row) {
+        RowByName.insert(AppNames.at(_row), _row);
+    }
+
+    endResetModel();
+}
+
+void A_applicationmodel::MarkDirty(const QString& _appName)
+{
+    const int _row = RowOf(_appName);
+    if (_row < 0) {
+        return;
+    }
+
+    DirtyRows.insert(_row);
+    if (!FlushTimer->isActive()) {
+        FlushTimer->start();
+    }
+}
+
+void A_applicationmodel::FlushDirtyRows()
+{
+    QTPM_TRACE_SCOPE("gui", "FlushDirtyRows");
+    if (DirtyRows.isEmpty()) {
+        return;
+    }
+
+    QVector<int> _rows(DirtyRows.begin(), DirtyRows.end());
+    DirtyRows.clear();
+    std::sort(_rows.begin(), _rows.end());
+
+    // The name column never changes; everything from status to control may
+    int _first = _rows.first();
+    int _last = _first;
+    for (int _i = 1; _i <= _rows.size(); ++_i) {
+        if (_i < _rows.size() && _rows.at(_i) == _last + 1) {
+            _last = _rows.at(_i);
+            continue;
+        }
+        emit dataChanged(index(_first, StatusColumn), index(_last, ControlColumn));
+        if (_i < _rows.size()) {
+            _first = _last = _rows.at(_i);
+        }
+    }
+}
+
+void A_applicationmodel::UptimeColumnChanged()
+{
+    if (AppNames.isEmpty()) {
+        return;
+    }
+    emit dataChanged(index(0, UptimeColumn), index(AppNames.size() - 1, ScheduleColumn), { Qt::DisplayRole });
+}
+
+A_applicationmodel::RunState A_applicationmodel::RunStateOf(const ProcessInfo& _info)
+{
+    if (_info.IsRunning) {
+        return RunningState;
+    }
+    if (_info.Parked) {
+        return ParkedState;
+    }
+    return _info.Desired == DesiredState::Start ? BackoffState : StoppedState;
+}
+
+QString A_applicationmodel::FormatUptime(qint64 _milliseconds)
+{
+    const qint64 _minutes = qMax<qint64>(0, _milliseconds / 60000);
+    if (_minutes < 1) {
+        return QString("<1m");
+    }
+    if (_minutes < 60) {
+        return QString("%1m").arg(_minutes);
+    }
+    if (_minutes < 1440) {
+        return QString("%1h %2m").arg(_minutes / 60).arg(_minutes % 60, 2, 10, QChar('0'));
+    }
+    return QString("%1d %2h").arg(_minutes / 1440).arg((_minutes / 60) % 24, 2, 10, QChar('0'));
+}
+
+QString A_applicationmodel::FormatTransition(const ScheduledTransition& _transition, qint64 _nowMs)
+{
+    if (_transition.TimeMs <= 0) {
+        return QString("-");
+    }
+
+    const QString _action = _transition.Start ? QString("start") : QString("stop");
+    const QDateTime _when = QDateTime::fromMSecsSinceEpoch(_transition.TimeMs);
+    const qint64 _days = QDateTime::fromMSecsSinceEpoch(_nowMs).date().daysTo(_when.date());
+
+    if (_days <= 0) {
+        return _action + _when.toString(" HH:mm");
+    }
+    if (_days < 7) {
+        return _action + _when.toString(" ddd HH:mm");
+    }
+    return _action + _when.toString(" d MMM HH:mm");
+}
+
+int A_applicationmodel::rowCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : AppNames.size();
+}
+
+int A_applicationmodel::columnCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant A_applicationmodel::data(const QModelIndex& _index, int _role) const
+{
+    if (!_index.isValid() || _index.row() >= AppNames.size()) {
+        return QVariant();
+    }
+
+    const QString& _appName = AppNames.at(_index.row());
+    if (_role == AppNameRole) {
+        return _appName;
+    }
+
+    const ProcessInfo _info = ProcessManager->GetProcessInfo(_appName);
+    if (_role == RunningRole) {
+        return _info.IsRunning;
+    }
+    if (_role == RunStateRole) {
+        return int(RunStateOf(_info));
+    }
+    if (_role == SearchTextRole) {
+        return _appName + QChar('\n') + _info.ExecutablePath;
+    }
+    if (_role == PolicyOkRole) {
+        return _info.PolicyOk;
+    }
+
+    if (_role == Qt::TextAlignmentRole) {
+        if (_index.column() == PidColumn || _index.column() == UptimeColumn || _index.column() == RestartsColumn ||
+            _index.column() == ScheduleColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return int(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+
+    if (_role == Qt::ToolTipRole && _index.column() == NameColumn) {
+        return _info.ExecutablePath;
+    }
+    if (_role == Qt::ToolTipRole && _index.column() == StatusColumn && _info.Parked) {
+        return QString("Stopped after %1 s idle - %2 kB of memory reclaimed")
+            .arg(_info.Idle.TimeoutSeconds).arg(_info.ReclaimedKb);
+    }
+    if (_role == Qt::ToolTipRole && _index.column() == StatusColumn && !_info.PolicyReport.isEmpty()) {
+        return "Launch policy:\n" + _info.PolicyReport;
+    }
+    if (_role == Qt::ToolTipRole && _index.column() == ScheduleColumn) {
+        const ScheduledTransition _transition = ProcessManager->GetNextScheduledTransition(_appName);
+        if (_transition.TimeMs <= 0) {
+            return QVariant();
+        }
+        return QString("%1 at %2").arg(_transition.Start ? "Starts" : "Stops",
+                                       QDateTime::fromMSecsSinceEpoch(_transition.TimeMs).toString("yyyy-MM-dd HH:mm"));
+    }
+
+    if (_role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (_index.column()) {
+    case NameColumn:
+        return _appName;
+    case StatusColumn:
+        switch (RunStateOf(_info)) {
+        case RunningState: return QString("running");
+        case BackoffState: return QString("backoff");
+        case ParkedState:  return QString("parked (%1 MB)").arg(_info.ReclaimedKb / 1024);
+        default:           return QString("stopped");
+        }
+    case PidColumn:
+        return _info.ProcessId > 0 ? QString::number(_info.ProcessId) : QString("-");
+    case UptimeColumn:
+        if (!_info.IsRunning || _info.StartTimeMs <= 0) {
+            return QString("-");
+        }
+        return FormatUptime(QDateTime::currentMSecsSinceEpoch() - _info.StartTimeMs);
+    case RestartsColumn:
+        return _info.RestartCount;
+    case ScheduleColumn:
+        return FormatTransition(ProcessManager->GetNextScheduledTransition(_appName),
+                                QDateTime::currentMSecsSinceEpoch());
+    case ControlColumn:
+        return _info.IsRunning ? QString("STOP") : QString("START");
+    default:
+        return QVariant();
+    }
+}
+
+QVariant A_applicationmodel::headerData(int _section, Qt::Orientation _orientation, int _role) const
+{
+    if (_orientation != Qt::Horizontal || _role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (_section) {
+    case NameColumn:     return QString("Application");
+    case StatusColumn:   return QString("Status");
+    case PidColumn:      return QString("PID");
+    case UptimeColumn:   return QString("Uptime");
+    case RestartsColumn: return QString("Restarts");
+    case ScheduleColumn: return QString("Schedule");
+    case TrendColumn:    return QString("Trend");
+    case ControlColumn:  return QString("Control");
+    default:             return QVariant();
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef A_APPLICATIONMODEL_H
+#define A_APPLICATIONMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+#include <QString>
+#include "a_process.h"
+
+/**
+ * @brief Table model exposing the monitoring state of all applications
+ *
+ * Rows are read straight from A_process on demand, so the model stores only
+ * the row order and a name-to-row index. Views paint only the visible rows,
+ * which keeps building and updating the list cheap for thousands of apps.
+ *
+ * State changes are not forwarded one by one: MarkDirty() records the row and
+ * a single-shot timer flushes all dirty rows at most once per frame, merged
+ * into contiguous dataChanged ranges. A burst of status signals during a
+ * restart storm therefore costs one repaint of the affected visible rows.
+ */
+class A_applicationmodel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Table columns
+     */
+    enum Column {
+        NameColumn,         // Application name
+        StatusColumn,       // Running or stopped
+        PidColumn,          // System process ID
+        UptimeColumn,       // Time since the process was seen starting
+        RestartsColumn,     // Automatic restarts
+        ScheduleColumn,     // Next run window transition
+        TrendColumn,        // Recent CPU or memory use - painted by a delegate
+        ControlColumn,      // Start/stop control - painted by a delegate
+        ColumnCount
+    };
+
+    /**
+     * @brief Custom data roles
+     */
+    enum Role {
+        AppNameRole = Qt::UserRole + 1,     // QString - application name of the row
+        RunningRole,                        // bool - current running state of the row
+        RunStateRole,                       // int - RunState bit of the row
+        SearchTextRole,                     // QString - name and executable path, newline separated
+        PolicyOkRole                        // bool - false if the launch policy was not fully applied
+    };
+
+    /**
+     * @brief Supervision states - bit values so filters can combine them
+     */
+    enum RunState : quint8 {
+        StoppedState = 0x1,     // Not running and not wanted
+        RunningState = 0x2,     // Running
+        BackoffState = 0x4,     // Wanted but not running - waiting for the next restart attempt
+        ParkedState = 0x8,      // Stopped for being idle - woken by a start request or a connection
+        AnyState = 0xF
+    };
+
+    explicit A_applicationmodel(A_process* _processManager, QObject *parent = nullptr);
+
+    /**
+     * @brief Rebuilds the row list from the process manager
+     * Call after the configuration has been (re)loaded.
+     */
+    void Reload();
+
+    /**
+     * @brief Marks one application's row as changed
+     * Views are notified by the next flush, at most FlushIntervalMs later.
+     * @param _appName Application name - ignored if unknown
+     */
+    void MarkDirty(const QString& _appName);
+
+    /**
+     * @brief Notifies views that the time-dependent columns of all rows changed
+     * Covers uptime and the day shown for schedule transitions. Views only
+     * repaint the rows they show.
+     */
+    void UptimeColumnChanged();
+
+    /**
+     * @brief Gets the row of an application
+     * @param _appName Application name
+     * @return int Row index - -1 if unknown
+     */
+    int RowOf(const QString& _appName) const { return RowByName.value(_appName, -1); }
+
+    /**
+     * @brief Derives the supervision state of an application
+     * @param _info Monitoring state from the process manager
+     * @return RunState Running, parked, backoff or stopped
+     */
+    static RunState RunStateOf(const ProcessInfo& _info);
+
+    /**
+     * @brief Formats an uptime for display
+     * @param _milliseconds Uptime - milliseconds
+     * @return QString Minute resolution - "<1m", "Nm", "Nh MMm" or "Nd HHh"
+     */
+    static QString FormatUptime(qint64 _milliseconds);
+
+    /**
+     * @brief Formats a scheduled transition for display
+     * @param _transition Pending transition from the process manager
+     * @param _nowMs Current time - milliseconds since epoch
+     * @return QString "start HH:MM" today, "stop Ddd HH:MM" within a week, else with the date - "-" if none
+     */
+    static QString FormatTransition(const ScheduledTransition& _transition, qint64 _nowMs);
+
+    // QAbstractTableModel
+    int rowCount(const QModelIndex& _parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& _parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& _index, int _role = Qt::DisplayRole) const override;
+    QVariant headerData(int _section, Qt::Orientation _orientation, int _role = Qt::DisplayRole) const override;
+
+    static constexpr int FlushIntervalMs = 16;  // Dirty row flush delay - one frame at 60 Hz
+
+private slots:
+    /**
+     * @brief Emits one batched update for all dirty rows
+     * Contiguous dirty rows are merged into a single dataChanged range.
+     */
+    void FlushDirtyRows();
+
+private:
+    A_process* ProcessManager;          // Process manager - source of all row data
+    QSet<int> DirtyRows;                // Rows changed since the last flush
+    QTimer* FlushTimer;                 // Single-shot flush timer - running while rows are dirty
+    QVector<QString> AppNames;          // Row order - application names
+    QHash<QString, int> RowByName;      // Row index - key: app name, value: row
+};
+
+#endif // A_APPLICATIONMODEL_H
@@ -0,0 +1,120 @@
+#include "a_apptable.h"
+#include <algorithm>
+
+void A_apptable::Sync(const QList<AppInfo>& _apps)
+{
+    ++Generation;
+    int _seen = 0;
+
+    for (const AppInfo& _app : _apps) {
+        int _id = IdOf(_app.Name);
+        if (_id < 0) {
+            _id = Add(_app.Name);
+        } else if (ExecutablePaths.at(_id) != _app.Executable) {
+            ResetRuntime(_id);
+        }
+
+        ExecutablePaths[_id] = _app.Executable;
+        Desired[_id] = DesiredStateOf(_app.Status);
+        Policies[_id] = _app.Policy;
+        Idle[_id] = _app.Idle;
+        if (SeenGeneration.at(_id) != Generation) {
+            SeenGeneration[_id] = Generation;
+            ++_seen;
+        }
+    }
+
+    if (_seen == Count()) {
+        return; // Every live id was seen - nothing removed
+    }
+    for (int _id = 0; _id < Size(); ++_id) {
+        if (Live.at(_id) && SeenGeneration.at(_id) != Generation) {
+            Remove(_id);
+        }
+    }
+}
+
+QStringList A_apptable::SortedNames() const
+{
+    QStringList _names = Ids.keys();
+    std::sort(_names.begin(), _names.end());
+    return _names;
+}
+
+ProcessInfo A_apptable::Info(int _id) const
+{
+    ProcessInfo _info;
+    _info.ExecutablePath = ExecutablePaths.at(_id);
+    _info.Desired = Desired.at(_id);
+    _info.IsRunning = Running.at(_id);
+    _info.ProcessId = ProcessIds.at(_id);
+    _info.StartTimeMs = StartTimesMs.at(_id);
+    _info.RestartCount = RestartCounts.at(_id);
+    _info.Policy = Policies.at(_id);
+    _info.PolicyReport = PolicyReports.at(_id);
+    _info.PolicyOk = PolicyOk.at(_id);
+    _info.Idle = Idle.at(_id);
+    _info.Parked = Parked.at(_id);
+    _info.ReclaimedKb = ReclaimedKb.at(_id);
+    _info.ParkedProcessId = ParkedProcessIds.at(_id);
+    return _info;
+}
+
+int A_apptable::Add(const QString& _name)
+{
+    int _id;
+    if (!FreeIds.isEmpty()) {
+        _id = FreeIds.takeLast();
+    } else {
+        _id = Size();
+        Live.append(false);
+        Desired.append(DesiredState::Stop);
+        Running.append(false);
+        Parked.append(false);
+        ProcessIds.append(0);
+        StartTimesMs.append(0);
+        LastRestartMs.append(-1);
+        ExecutablePaths.append(QString());
+        AppNames.append(QString());
+        RestartCounts.append(0);
+        ParkedProcessIds.append(0);
+        ReclaimedKb.append(0);
+        Policies.append(LaunchPolicy());
+        Idle.append(IdleInfo());
+        PolicyReports.append(QString());
+        PolicyOk.append(true);
+        HeartbeatSlots.append(-1);
+        SeenGeneration.append(0);
+    }
+
+    Live[_id] = true;
+    AppNames[_id] = _name;
+    LastRestartMs[_id] = -1;
+    ResetRuntime(_id);
+    Ids.insert(_name, _id);
+    return _id;
+}
+
+void A_apptable::Remove(int _id)
+{
+    Ids.remove(AppNames.at(_id));
+    Live[_id] = false;
+    AppNames[_id].clear();
+    ExecutablePaths[_id].clear();
+    Desired[_id] = DesiredState::Stop;
+    Policies[_id] = LaunchPolicy();
+    Idle[_id] = IdleInfo();
+    ResetRuntime(_id);
+    FreeIds.append(_id);
+}
+
+void A_apptable::ResetRuntime(int _id)
+{
+    SetStopped(_id);
+    Parked[_id] = false;
+    RestartCounts[_id] = 0;
+    ParkedProcessIds[_id] = 0;
+    ReclaimedKb[_id] = 0;
+    PolicyReports[_id].clear();
+    PolicyOk[_id] = true;
+}
@@ -0,0 +1,178 @@
+#ifndef A_APPTABLE_H
+#define A_APPTABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Desired state of an application - <status> of config.xml
+ */
+enum class DesiredState : quint8 {
+    Stop,       // Must not run - "stop"
+    Start,      // Must run - "start"
+    Unmanaged   // Any other <status> - neither started nor stopped
+};
+
+/**
+ * @brief Structure to hold process monitoring information
+ *
+ * Snapshot of one application's row in A_apptable, for callers outside the
+ * engine. The engine itself works on the table columns.
+ */
+struct ProcessInfo {
+    QString ExecutablePath;     // Full path to executable - system path to binary
+    DesiredState Desired = DesiredState::Stop; // Desired status - from <status>
+    bool IsRunning = false;   // Current running state - true if process is active
+    qint64 ProcessId = 0;     // System process ID - 0 if not running
+    qint64 StartTimeMs = 0;   // Clock time the process was seen starting - 0 if not running
+    int RestartCount = 0;     // Automatic restarts since the application was loaded
+    LaunchPolicy Policy;      // Scheduling policy applied at launch
+    QString PolicyReport;     // Policy check of the running process - empty if no policy or not checked
+    bool PolicyOk = true;     // False if the running process does not carry its policy
+    IdleInfo Idle;            // Idle shutdown settings
+    bool Parked = false;      // Stopped for being idle - still wanted, woken by a start request
+    qint64 ReclaimedKb = 0;   // Resident memory the process held when it was parked - kB
+    qint64 ParkedProcessId = 0; // Process stopped by parking - not mistaken for a restart while it exits
+};
+
+/**
+ * @brief Runtime state of all managed applications as a structure of arrays
+ *
+ * Every application has a stable integer id for as long as it stays in the
+ * configuration; each column below is indexed by it, so a monitoring tick
+ * walks a few contiguous arrays instead of chasing the nodes of a string-keyed
+ * map. Ids of removed applications go to a free list and are reused by the
+ * next added one; until then their Live entry is false. The name index is
+ * only for lookups by name from outside the tick.
+ */
+class A_apptable
+{
+public:
+    /**
+     * @brief Converts a configured status to the desired state
+     * @param _status "start" or "stop"
+     * @return DesiredState Start, Stop, or Unmanaged for anything else
+     */
+    static DesiredState DesiredStateOf(const QString& _status)
+    {
+        if (_status == QLatin1String("start")) {
+            return DesiredState::Start;
+        }
+        return _status == QLatin1String("stop") ? DesiredState::Stop : DesiredState::Unmanaged;
+    }
+
+    /**
+     * @brief Converts a desired state to its configured status
+     * @param _desired Desired state - Start or Stop
+     * @return QString "start" or "stop"
+     */
+    static QString StatusText(DesiredState _desired)
+    {
+        return _desired == DesiredState::Start ? QString("start") : QString("stop");
+    }
+
+    /**
+     * @brief Brings the table in line with the configuration
+     * New applications get an id, removed ones give theirs up. An application
+     * whose executable changed starts over with fresh runtime state; all
+     * others keep theirs, so unchanged apps report no spurious transitions.
+     * @param _apps Configured applications
+     */
+    void Sync(const QList<AppInfo>& _apps);
+
+    /**
+     * @brief Gets the id of an application
+     * @param _name Application name
+     * @return int Id - -1 if unknown
+     */
+    int IdOf(const QString& _name) const { return Ids.value(_name, -1); }
+
+    /**
+     * @brief Gets the id range - ids are in [0, Size())
+     * @return int One past the highest id ever handed out
+     */
+    int Size() const { return int(Live.size()); }
+
+    /**
+     * @brief Gets the number of applications
+     * @return int Live ids
+     */
+    int Count() const { return int(Ids.size()); }
+
+    /**
+     * @brief Gets the names of all applications
+     * @return QStringList Names in alphabetical order
+     */
+    QStringList SortedNames() const;
+
+    /**
+     * @brief Copies one application's row
+     * @param _id Application id - live
+     * @return ProcessInfo Snapshot of the row
+     */
+    ProcessInfo Info(int _id) const;
+
+    /**
+     * @brief Records that an application's process is gone
+     * @param _id Application id
+     */
+    void SetStopped(int _id)
+    {
+        Running[_id] = false;
+        ProcessIds[_id] = 0;
+        StartTimesMs[_id] = 0;
+        HeartbeatSlots[_id] = -1;
+    }
+
+    // Columns - index: app id. Hot ones first: every tick reads or writes them.
+    QVector<bool> Live;                 // False for ids on the free list
+    QVector<DesiredState> Desired;      // Desired state - from <status>
+    QVector<bool> Running;              // Current running state
+    QVector<bool> Parked;               // Stopped for being idle - still wanted
+    QVector<qint64> ProcessIds;         // System process ID - 0 if not running
+    QVector<qint64> StartTimesMs;       // Clock time the process was seen starting - 0 if not running
+    QVector<qint64> LastRestartMs;      // Last restart attempt - clock time, -1 if none
+    QVector<QString> ExecutablePaths;   // Full path to executable
+
+    // Cold columns - touched on transitions only
+    QVector<QString> AppNames;          // Application name
+    QVector<int> RestartCounts;         // Automatic restarts since the application was added
+    QVector<qint64> ParkedProcessIds;   // Process stopped by parking - ignored while it exits
+    QVector<qint64> ReclaimedKb;        // Resident memory the process held when it was parked - kB
+    QVector<LaunchPolicy> Policies;     // Scheduling policy applied at launch
+    QVector<IdleInfo> Idle;             // Idle shutdown settings
+    QVector<QString> PolicyReports;     // Policy check of the running process
+    QVector<bool> PolicyOk;             // False if the running process does not carry its policy
+    QVector<int> HeartbeatSlots;        // Heartbeat slot named to the running process - -1 if none
+
+private:
+    QHash<QString, int> Ids;            // Name index - key: app name, value: id
+    QVector<int> FreeIds;               // Ids of removed applications - reused first
+    QVector<quint32> SeenGeneration;    // Sync() pass that last saw the id - finds removed apps without a set
+    quint32 Generation = 0;             // Current Sync() pass
+
+    /**
+     * @brief Hands out an id for a new application
+     * @param _name Application name
+     * @return int Id with default runtime state
+     */
+    int Add(const QString& _name);
+
+    /**
+     * @brief Returns an application's id to the free list
+     * @param _id Application id - live
+     */
+    void Remove(int _id);
+
+    /**
+     * @brief Resets the runtime columns of one id
+     * @param _id Application id
+     */
+    void ResetRuntime(int _id);
+};
+
+#endif // A_APPTABLE_H
@@ -0,0 +1,187 @@
+#include "a_checkpoint.h"
+#include "a_apptable.h"
+#include "a_systeminterfaces.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+A_checkpoint::A_checkpoint()
+{
+    BootId = ReadBootId();
+}
+
+bool A_checkpoint::Open(const QString& _filePath)
+{
+    const QString _directory = QFileInfo(_filePath).absolutePath();
+    if (!QDir().mkpath(_directory) || !QFileInfo(_directory).isWritable()) {
+        qDebug() << "Error: Cannot write checkpoint directory:" << _directory;
+        return false;
+    }
+
+    FilePath = _filePath;
+    LastRecords.clear();
+    StartTicks.clear();
+    Load();
+    return true;
+}
+
+QHash<QString, CheckpointRecord> A_checkpoint::TakeRecords()
+{
+    QHash<QString, CheckpointRecord> _records;
+    _records.swap(Loaded);
+    return _records;
+}
+
+void A_checkpoint::Write(const A_apptable& _apps, qint64 _nowMs)
+{
+    if (FilePath.isEmpty()) {
+        return;
+    }
+    if (StartTicks.size() < _apps.Size()) {
+        StartTicks.resize(_apps.Size());
+    }
+
+    QByteArray _records;
+    _records.reserve(_apps.Count() * int(sizeof(CheckpointRecord)));
+    for (int _id = 0; _id < _apps.Size(); ++_id) {
+        if (!_apps.Live.at(_id)) {
+            continue;
+        }
+        const QByteArray _name = _apps.AppNames.at(_id).toUtf8();
+        if (_name.size() >= int(sizeof(CheckpointRecord::AppName))) {
+            continue; // Rediscovered by name after a restart, as without a checkpoint
+        }
+
+        CheckpointRecord _record;
+        std::memset(&_record, 0, sizeof(_record));
+        const bool _running = _apps.Running.at(_id) && _apps.ProcessIds.at(_id) > 0;
+        if (_running) {
+            // The start time only changes with the process - read it once per PID
+            QPair<qint64, quint64>& _ticks = StartTicks[_id];
+            if (_ticks.first != _apps.ProcessIds.at(_id)) {
+                _ticks = qMakePair(_apps.ProcessIds.at(_id), ProcessStartTicks(_apps.ProcessIds.at(_id)));
+            }
+            _record.ProcessId = _apps.ProcessIds.at(_id);
+            _record.ProcessStartTicks = _ticks.second;
+            _record.StartTimeMs = _apps.StartTimesMs.at(_id);
+            _record.HeartbeatSlot = quint32(_apps.HeartbeatSlots.at(_id) + 1);
+            _record.Running = 1;
+        }
+        _record.LastRestartMs = _apps.LastRestartMs.at(_id);
+        _record.ParkedProcessId = _apps.ParkedProcessIds.at(_id);
+        _record.ReclaimedKb = _apps.ReclaimedKb.at(_id);
+        _record.RestartCount = quint32(qMax(0, _apps.RestartCounts.at(_id)));
+        _record.ExecutableHash = Hash(_apps.ExecutablePaths.at(_id));
+        _record.Parked = _apps.Parked.at(_id) ? 1 : 0;
+        std::memcpy(_record.AppName, _name.constData(), size_t(_name.size()));
+        _records.append(reinterpret_cast<const char*>(&_record), int(sizeof(_record)));
+    }
+
+    if (_records == LastRecords) {
+        return;
+    }
+
+    CheckpointHeader _header;
+    std::memset(&_header, 0, sizeof(_header));
+    std::memcpy(_header.Magic, "QPMCKPT", 8);
+    _header.Version = FormatVersion;
+    _header.RecordSize = sizeof(CheckpointRecord);
+    _header.RecordCount = quint64(_records.size()) / sizeof(CheckpointRecord);
+    _header.WrittenMs = _nowMs;
+    std::memcpy(_header.BootId, BootId.constData(), sizeof(_header.BootId));
+    _header.Checksum = HashBytes(_records);
+
+    // Readers see either the old file or the new one, never a partial write
+    QSaveFile _file(FilePath);
+    if (!_file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Error: Cannot write checkpoint:" << FilePath << _file.errorString();
+        return;
+    }
+    _file.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    _file.write(_records);
+    if (!_file.commit()) {
+        qDebug() << "Error: Failed to write checkpoint:" << FilePath << _file.errorString();
+        return;
+    }
+    LastRecords = _records;
+}
+
+quint64 A_checkpoint::ProcessStartTicks(qint64 _processId)
+{
+    if (_processId <= 0) {
+        return 0;
+    }
+
+    ProcessStat _stat;
+    return A_procfsprocesstable::ReadStat(_processId, &_stat) ? _stat.StartTicks : 0;
+}
+
+quint32 A_checkpoint::Hash(const QString& _text)
+{
+    return HashBytes(_text.toUtf8());
+}
+
+quint32 A_checkpoint::HashBytes(const QByteArray& _bytes)
+{
+    quint32 _hash = 2166136261u;
+    for (char _byte : _bytes) {
+        _hash ^= static_cast<quint8>(_byte);
+        _hash *= 16777619u;
+    }
+    return _hash;
+}
+
+QByteArray A_checkpoint::ReadBootId()
+{
+    QFile _bootIdFile("/proc/sys/kernel/random/boot_id");
+    QByteArray _bootId;
+    if (_bootIdFile.open(QIODevice::ReadOnly)) {
+        _bootId = QByteArray::fromHex(_bootIdFile.readAll().trimmed().replace('-', ""));
+    }
+    return _bootId.leftJustified(16, '\0', true);
+}
+
+void A_checkpoint::Load()
+{
+    Loaded.clear();
+
+    QFile _file(FilePath);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return; // First start - nothing to adopt
+    }
+    const QByteArray _data = _file.readAll();
+
+    CheckpointHeader _header;
+    if (_data.size() < int(sizeof(_header))) {
+        qDebug() << "Warning: Checkpoint too short - ignored:" << FilePath;
+        return;
+    }
+    std::memcpy(&_header, _data.constData(), sizeof(_header));
+    if (std::memcmp(_header.Magic, "QPMCKPT", 8) != 0 || _header.Version != FormatVersion
+        || _header.RecordSize != sizeof(CheckpointRecord)
+        || quint64(_data.size() - int(sizeof(_header))) != _header.RecordCount * sizeof(CheckpointRecord)) {
+        qDebug() << "Warning: Checkpoint layout not recognized - ignored:" << FilePath;
+        return;
+    }
+    if (std::memcmp(_header.BootId, BootId.constData(), sizeof(_header.BootId)) != 0) {
+        qDebug() << "Checkpoint is from an earlier boot - its processes are gone";
+        return;
+    }
+
+    const QByteArray _records = _data.mid(int(sizeof(_header)));
+    if (HashBytes(_records) != _header.Checksum) {
+        qDebug() << "Warning: Checkpoint checksum mismatch - ignored:" << FilePath;
+        return;
+    }
+
+    Loaded.reserve(int(_header.RecordCount));
+    for (quint64 _i = 0; _i < _header.RecordCount; ++_i) {
+        CheckpointRecord _record;
+        std::memcpy(&_record, _records.constData() + _i * sizeof(CheckpointRecord), sizeof(_record));
+        _record.AppName[sizeof(_record.AppName) - 1] = '\0';
+        Loaded.insert(QString::fromUtf8(_record.AppName), _record);
+    }
+    qDebug() << "Checkpoint read with" << Loaded.size() << "applications, written at" << _header.WrittenMs;
+}
@@ -0,0 +1,131 @@
+#ifndef A_CHECKPOINT_H
+#define A_CHECKPOINT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QDebug>
+
+class A_apptable;
+
+/**
+ * @brief Fixed-layout runtime state of one application - 128 bytes
+ */
+struct CheckpointRecord {
+    qint64 ProcessId;           // Running process - 0 if not running
+    quint64 ProcessStartTicks;  // starttime of /proc/<pid>/stat - tells a reused PID apart
+    qint64 StartTimeMs;         // Clock time the process was seen starting - 0 if not running
+    qint64 LastRestartMs;       // Last restart attempt - -1 if none
+    qint64 ParkedProcessId;     // Process stopped by parking - 0 if none
+    qint64 ReclaimedKb;         // Resident memory reclaimed by parking - kB
+    quint32 RestartCount;       // Automatic restarts since the application was loaded
+    quint32 ExecutableHash;     // FNV-1a hash of the executable path - a changed path is not adopted
+    quint8 Running;             // 1 if the process was running
+    quint8 Parked;              // 1 if stopped for being idle
+    quint16 Reserved;           // Padding - always zero
+    quint32 HeartbeatSlot;      // Heartbeat slot named to the process, plus one - 0 if not watched
+    char AppName[64];           // UTF-8 app name - NUL terminated, longer names are not checkpointed
+};
+static_assert(sizeof(CheckpointRecord) == 128, "CheckpointRecord layout must stay fixed");
+
+/**
+ * @brief Header at the start of the checkpoint file - 64 bytes
+ */
+struct CheckpointHeader {
+    char Magic[8];              // "QPMCKPT" - file type marker
+    quint32 Version;            // Layout version - A_checkpoint::FormatVersion
+    quint32 RecordSize;         // sizeof(CheckpointRecord) - layout check
+    quint64 RecordCount;        // Records following the header
+    qint64 WrittenMs;           // Time of the write - milliseconds since epoch
+    char BootId[16];            // /proc/sys/kernel/random/boot_id - PIDs of another boot are meaningless
+    quint32 Checksum;           // FNV-1a hash of the records
+    char Reserved[12];          // Padding - always zero
+};
+static_assert(sizeof(CheckpointHeader) == 64, "CheckpointHeader layout must stay fixed");
+
+/**
+ * @brief Small file holding the engine's runtime state across monitor restarts
+ *
+ * Write() serializes the application table and replaces the file (write to a
+ * temporary, then rename) only when the state differs from the last write, so
+ * it is cheap to call after every tick. After a restart the engine reads the
+ * file back and adopts the processes that are still the same process - same
+ * boot, same PID and same kernel start time - instead of rediscovering them.
+ */
+class A_checkpoint
+{
+public:
+    static constexpr quint32 FormatVersion = 1;   // File layout version
+
+    A_checkpoint();
+
+    /**
+     * @brief Sets the checkpoint file and reads the state it holds
+     * A file of another boot, layout or with a bad checksum is ignored.
+     * @param _filePath Checkpoint file - its directory is created if missing
+     * @return bool True if the directory is writable
+     */
+    bool Open(const QString& _filePath);
+
+    /**
+     * @brief Checks whether Write() has a file to write
+     * @return bool True after a successful Open()
+     */
+    bool IsOpen() const { return !FilePath.isEmpty(); }
+
+    /**
+     * @brief Hands over the records read by Open()
+     * @return QHash<QString, CheckpointRecord> Records - key: app name; empty on later calls
+     */
+    QHash<QString, CheckpointRecord> TakeRecords();
+
+    /**
+     * @brief Writes the state of every application if it changed since the last write
+     * @param _apps Application table
+     * @param _nowMs Current time - milliseconds since epoch
+     */
+    void Write(const A_apptable& _apps, qint64 _nowMs);
+
+    /**
+     * @brief Reads the kernel start time of a process
+     * @param _processId Process ID
+     * @return quint64 starttime of /proc/<pid>/stat in clock ticks since boot - 0 if the process is gone
+     */
+    static quint64 ProcessStartTicks(qint64 _processId);
+
+    /**
+     * @brief Computes the 32-bit FNV-1a hash of a string
+     * @param _text Text - hashed as UTF-8
+     * @return quint32 Hash value
+     */
+    static quint32 Hash(const QString& _text);
+
+private:
+    QString FilePath;                               // Checkpoint file - empty until Open()
+    QByteArray BootId;                              // Current boot - 16 bytes
+    QHash<QString, CheckpointRecord> Loaded;        // Records read by Open() - until TakeRecords()
+    QByteArray LastRecords;                         // Records of the last write - change detection
+    QVector<QPair<qint64, quint64>> StartTicks;     // Start time per app id - (PID, ticks), read once per process
+
+    /**
+     * @brief Computes the 32-bit FNV-1a hash of a byte string
+     * @param _bytes Data
+     * @return quint32 Hash value
+     */
+    static quint32 HashBytes(const QByteArray& _bytes);
+
+    /**
+     * @brief Reads the current boot ID
+     * @return QByteArray 16 bytes - zero-filled if unavailable
+     */
+    static QByteArray ReadBootId();
+
+    /**
+     * @brief Reads and validates the checkpoint file
+     */
+    void Load();
+};
+
+#endif // A_CHECKPOINT_H
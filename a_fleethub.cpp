@@ -0,0 +1,263 @@
+#include "a_fleethub.h"
+#include <QDebug>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+#include <QTimer>
+
+A_fleethub::A_fleethub(const QStringList& _endpoints, QObject* parent)
+    : QObject(parent)
+{
+    Resyncs = 0;
+    Clock.start();
+
+    Hosts.resize(int(_endpoints.size()));
+    Connections.resize(int(_endpoints.size()));
+
+    for (int _host = 0; _host < int(_endpoints.size()); ++_host) {
+        FleetHost& _view = Hosts[_host];
+        Connection& _connection = Connections[_host];
+        _view.Endpoint = _endpoints.at(_host).trimmed();
+
+        // "host:port" - the last colon separates the port, so bracketed IPv6 works too
+        const int _colon = int(_view.Endpoint.lastIndexOf(':'));
+        bool _portOk = false;
+        if (_colon > 0) {
+            _connection.Address = _view.Endpoint.left(_colon).remove('[').remove(']');
+            _connection.Port = _view.Endpoint.mid(_colon + 1).toUShort(&_portOk);
+        }
+        if (!_portOk || _connection.Port == 0) {
+            qDebug() << "Warning: Invalid fleet monitor endpoint" << _view.Endpoint << "- expected host:port";
+            _connection.Port = 0;
+        }
+
+        _connection.Socket = new QTcpSocket(this);
+        _connection.Socket->setReadBufferSize(64 * 1024);
+        connect(_connection.Socket, &QTcpSocket::readyRead, this, [this, _host]() { OnReadyRead(_host); });
+        connect(_connection.Socket, &QTcpSocket::disconnected, this, [this, _host]() { OnDisconnected(_host); });
+        connect(_connection.Socket, &QTcpSocket::errorOccurred, this, [this, _host]() {
+            // Refused or unreachable connections never emit disconnected
+            if (Connections[_host].Socket->state() == QAbstractSocket::UnconnectedState) {
+                OnDisconnected(_host);
+            }
+        });
+
+        _connection.ReconnectTimer = new QTimer(this);
+        _connection.ReconnectTimer->setSingleShot(true);
+        connect(_connection.ReconnectTimer, &QTimer::timeout, this, [this, _host]() { Connect(_host); });
+    }
+
+    WatchdogTimer = new QTimer(this);
+    connect(WatchdogTimer, &QTimer::timeout, this, &A_fleethub::OnWatchdog);
+}
+
+A_fleethub::~A_fleethub()
+{
+    for (Connection& _connection : Connections) {
+        _connection.Socket->disconnect(this);
+    }
+}
+
+void A_fleethub::Start()
+{
+    for (int _host = 0; _host < int(Hosts.size()); ++_host) {
+        Connect(_host);
+    }
+    WatchdogTimer->start(SilenceTimeoutMs / 6);
+}
+
+int A_fleethub::ConnectedCount() const
+{
+    int _count = 0;
+    for (const FleetHost& _view : Hosts) {
+        _count += _view.Connected ? 1 : 0;
+    }
+    return _count;
+}
+
+void A_fleethub::OnWatchdog()
+{
+    const qint64 _nowMs = Clock.elapsed();
+    for (int _host = 0; _host < int(Connections.size()); ++_host) {
+        Connection& _connection = Connections[_host];
+        const QAbstractSocket::SocketState _state = _connection.Socket->state();
+
+        if (_state == QAbstractSocket::ConnectedState) {
+            if (_nowMs - _connection.LastActivityMs > SilenceTimeoutMs) {
+                Resync(_host, "no message within the silence timeout");
+            }
+        } else if (_state == QAbstractSocket::HostLookupState || _state == QAbstractSocket::ConnectingState) {
+            if (_nowMs - _connection.LastActivityMs > ConnectTimeoutMs) {
+                _connection.Socket->abort();
+                OnDisconnected(_host);
+            }
+        }
+    }
+}
+
+void A_fleethub::Connect(int _host)
+{
+    Connection& _connection = Connections[_host];
+    if (_connection.Port == 0) {
+        return;
+    }
+    _connection.Socket->abort();
+    _connection.Buffer.clear();
+    _connection.Synced = false;
+    _connection.LastActivityMs = Clock.elapsed();
+    _connection.Socket->connectToHost(_connection.Address, _connection.Port);
+}
+
+void A_fleethub::OnReadyRead(int _host)
+{
+    Connection& _connection = Connections[_host];
+    _connection.Buffer.append(_connection.Socket->readAll());
+
+    int _offset = 0;
+    A_fleetprotocol::Message _message;
+    for (;;) {
+        const int _result = A_fleetprotocol::Decode(_connection.Buffer, &_offset, &_message);
+        if (_result == 0) {
+            break;
+        }
+        if (_result < 0) {
+            Resync(_host, "malformed frame");
+            return;
+        }
+        _connection.LastActivityMs = Clock.elapsed();
+        if (!Apply(_host, _message)) {
+            Resync(_host, "sequence gap or unsupported protocol version");
+            return;
+        }
+    }
+
+    // Only a partial frame remains - bounded by A_fleetprotocol::MaxFrameBytes
+    _connection.Buffer.remove(0, _offset);
+}
+
+void A_fleethub::OnDisconnected(int _host)
+{
+    Connection& _connection = Connections[_host];
+    _connection.Buffer.clear();
+    _connection.Synced = false;
+
+    FleetHost& _view = Hosts[_host];
+    if (_view.Connected) {
+        _view.Connected = false;
+        qDebug() << "Fleet monitor" << _view.Endpoint << _view.ServerId << "disconnected";
+        emit HostStatusChanged(_host);
+    }
+
+    // errorOccurred and disconnected can both report one loss
+    if (_connection.ReconnectTimer->isActive()) {
+        return;
+    }
+    // Jitter keeps a hub restart from reconnecting to every monitor in the same instant
+    const int _delayMs = _connection.BackoffMs + int(QRandomGenerator::global()->bounded(_connection.BackoffMs / 2 + 1));
+    _connection.BackoffMs = qMin(_connection.BackoffMs * 2, ReconnectMaxMs);
+    _connection.ReconnectTimer->start(_delayMs);
+}
+
+void A_fleethub::Resync(int _host, const char* _reason)
+{
+    ++Resyncs;
+    qDebug() << "Fleet monitor" << Hosts[_host].Endpoint << "resynchronizing:" << _reason;
+    Connection& _connection = Connections[_host];
+    _connection.Socket->abort();
+    OnDisconnected(_host);
+}
+
+bool A_fleethub::Apply(int _host, const A_fleetprotocol::Message& _message)
+{
+    FleetHost& _view = Hosts[_host];
+    Connection& _connection = Connections[_host];
+
+    switch (_message.Type) {
+    case A_fleetprotocol::HelloMessage:
+        if (_message.ProtocolVersion != A_fleetprotocol::Version) {
+            qDebug() << "Warning: Fleet monitor" << _view.Endpoint << "speaks protocol" << _message.ProtocolVersion
+                     << "- expected" << A_fleetprotocol::Version;
+            return false;
+        }
+        if (_view.ServerId != _message.ServerId) {
+            _view.ServerId = _message.ServerId;
+            emit HostStatusChanged(_host);
+        }
+        return true;
+
+    case A_fleetprotocol::SnapshotMessage: {
+        _view.Apps.clear();
+        _view.Index.clear();
+        _view.Apps.reserve(int(_message.Apps.size()));
+        _view.Index.reserve(int(_message.Apps.size()));
+        for (const FleetAppState& _app : _message.Apps) {
+            const int _row = _view.Index.value(_app.Name, -1);
+            if (_row >= 0) {
+                _view.Apps[_row] = _app;
+            } else {
+                _view.Index.insert(_app.Name, int(_view.Apps.size()));
+                _view.Apps.append(_app);
+            }
+        }
+        _view.Sequence = _message.Sequence;
+        ++_view.Snapshots;
+        _connection.Synced = true;
+        _connection.BackoffMs = ReconnectMinMs;
+        emit HostReset(_host);
+        if (!_view.Connected) {
+            _view.Connected = true;
+            emit HostStatusChanged(_host);
+        }
+        return true;
+    }
+
+    case A_fleetprotocol::DeltaMessage: {
+        if (!_connection.Synced || _message.Sequence != _view.Sequence + 1) {
+            return false;
+        }
+
+        QVector<int> _rows;
+        _rows.reserve(int(_message.Apps.size()));
+        for (const FleetAppState& _app : _message.Apps) {
+            const int _row = _view.Index.value(_app.Name, -1);
+            if (_row >= 0) {
+                _view.Apps[_row] = _app;
+                _rows.append(_row);
+            } else if (_view.Apps.size() < A_fleetprotocol::MaxAppsPerHost) {
+                _view.Index.insert(_app.Name, int(_view.Apps.size()));
+                _rows.append(int(_view.Apps.size()));
+                _view.Apps.append(_app);
+            }
+        }
+
+        // Removal moves the last row into the gap - the row list no longer applies
+        bool _removed = false;
+        for (const QString& _name : _message.Removed) {
+            const int _row = _view.Index.value(_name, -1);
+            if (_row < 0) {
+                continue;
+            }
+            _view.Index.remove(_name);
+            const int _last = int(_view.Apps.size()) - 1;
+            if (_row != _last) {
+                _view.Apps[_row] = _view.Apps[_last];
+                _view.Index[_view.Apps[_row].Name] = _row;
+            }
+            _view.Apps.removeLast();
+            _removed = true;
+        }
+
+        _view.Sequence = _message.Sequence;
+        ++_view.Deltas;
+        if (_removed) {
+            emit HostReset(_host);
+        } else if (!_rows.isEmpty()) {
+            emit ApplicationsChanged(_host, _rows);
+        }
+        return true;
+    }
+
+    case A_fleetprotocol::PingMessage:
+        return true;
+    }
+    return true;
+}
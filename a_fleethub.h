@@ -0,0 +1,169 @@
+#ifndef A_FLEETHUB_H
+#define A_FLEETHUB_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "a_fleetprotocol.h"
+
+class QTcpSocket;
+class QTimer;
+
+/**
+ * @brief Hub-side view of one monitor
+ */
+struct FleetHost {
+    QString Endpoint;               // "host:port" from <fleet><monitor>
+    QString ServerId;               // From Hello - empty until the first connection
+    bool Connected = false;         // True between a Snapshot and the next disconnect
+    quint64 Sequence = 0;           // Last applied Snapshot or Delta
+    QVector<FleetAppState> Apps;    // Last known state - kept while disconnected
+    QHash<QString, int> Index;      // Row in Apps - key: app name
+    quint64 Snapshots = 0;          // Snapshots applied - one per (re)synchronization
+    quint64 Deltas = 0;             // Deltas applied
+};
+
+/**
+ * @brief Aggregates the application state of many monitors
+ *
+ * Holds one connection per configured monitor. Each connection starts with
+ * a Snapshot and then applies Deltas in sequence order; a sequence gap, a
+ * malformed frame or SilenceTimeoutMs without any message drops the
+ * connection, and every disconnect is followed by a reconnect with
+ * exponential backoff and a fresh Snapshot. Memory is bounded by
+ * A_fleetprotocol::MaxAppsPerHost states per monitor plus one frame of
+ * receive buffer per connection.
+ */
+class A_fleethub : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ReconnectMinMs = 500;      // First reconnect delay
+    static constexpr int ReconnectMaxMs = 30000;    // Backoff ceiling
+    static constexpr int SilenceTimeoutMs = 30000;  // Without any message the connection is considered dead
+    static constexpr int ConnectTimeoutMs = 10000;  // Abandon connection attempts after this long
+
+    /**
+     * @param _endpoints Monitors - "host:port" each
+     * @param parent Parent object
+     */
+    explicit A_fleethub(const QStringList& _endpoints, QObject* parent = nullptr);
+    ~A_fleethub();
+
+    /**
+     * @brief Connects to every monitor
+     */
+    void Start();
+
+    /**
+     * @brief Gets the number of monitors
+     * @return int Monitors - one per endpoint
+     */
+    int HostCount() const { return int(Hosts.size()); }
+
+    /**
+     * @brief Gets the view of one monitor
+     * @param _host Monitor index - endpoint order
+     * @return const FleetHost& View
+     */
+    const FleetHost& Host(int _host) const { return Hosts.at(_host); }
+
+    /**
+     * @brief Gets the number of monitors currently synchronized
+     * @return int Connected monitors
+     */
+    int ConnectedCount() const;
+
+    /**
+     * @brief Gets the number of resynchronizations forced by gaps or protocol errors
+     * @return quint64 Resyncs
+     */
+    quint64 ResyncCount() const { return Resyncs; }
+
+signals:
+    /**
+     * @brief Emitted when a monitor connects, disconnects or announces its ID
+     * @param host Monitor index
+     */
+    void HostStatusChanged(int host);
+
+    /**
+     * @brief Emitted when the application list of a monitor was replaced or rows were removed
+     * @param host Monitor index
+     */
+    void HostReset(int host);
+
+    /**
+     * @brief Emitted when applications of a monitor changed in place or were appended
+     * @param host Monitor index
+     * @param rows Changed rows - appended rows are at the end of Apps
+     */
+    void ApplicationsChanged(int host, const QVector<int>& rows);
+
+private slots:
+    /**
+     * @brief Drops connections that stayed silent or did not connect in time
+     */
+    void OnWatchdog();
+
+private:
+    /**
+     * @brief Connection state of one monitor
+     */
+    struct Connection {
+        QTcpSocket* Socket = nullptr;   // Connection - reused across reconnects
+        QTimer* ReconnectTimer = nullptr; // Single-shot reconnect
+        QByteArray Buffer;              // Received bytes not yet decoded - at most one frame
+        QString Address;                // Host part of the endpoint
+        quint16 Port = 0;               // Port part of the endpoint
+        int BackoffMs = ReconnectMinMs; // Next reconnect delay
+        bool Synced = false;            // True once a Snapshot was applied on this connection
+        qint64 LastActivityMs = 0;      // Last message or connection attempt - monotonic
+    };
+
+    QVector<FleetHost> Hosts;           // Views - endpoint order
+    QVector<Connection> Connections;    // Same index as Hosts
+    QTimer* WatchdogTimer;              // Checks silence and connect timeouts
+    QElapsedTimer Clock;                // Monotonic time base of LastActivityMs
+    quint64 Resyncs;                    // Forced resynchronizations
+
+    /**
+     * @brief Opens the connection to one monitor
+     * @param _host Monitor index
+     */
+    void Connect(int _host);
+
+    /**
+     * @brief Decodes and applies every complete frame received from a monitor
+     * @param _host Monitor index
+     */
+    void OnReadyRead(int _host);
+
+    /**
+     * @brief Marks a monitor disconnected and schedules the reconnect
+     * @param _host Monitor index
+     */
+    void OnDisconnected(int _host);
+
+    /**
+     * @brief Drops a connection whose stream can no longer be trusted
+     * @param _host Monitor index
+     * @param _reason Logged reason
+     */
+    void Resync(int _host, const char* _reason);
+
+    /**
+     * @brief Applies one decoded message
+     * @param _host Monitor index
+     * @param _message Message
+     * @return bool False if the connection must be resynchronized
+     */
+    bool Apply(int _host, const A_fleetprotocol::Message& _message);
+};
+
+#endif // A_FLEETHUB_H
@@ -0,0 +1,229 @@
+#include "a_fleetmodel.h"
+#include "a_applicationmodel.h"
+#include "qpm_status.h"
+#include <QBrush>
+#include <QDateTime>
+
+// Internal ID of an index - 0 for monitor rows, monitor index + 1 for application rows
+
+A_fleetmodel::A_fleetmodel(A_fleethub* _hub, QObject* parent)
+    : QAbstractItemModel(parent)
+{
+    Hub = _hub;
+    RowCounts.fill(0, Hub->HostCount());
+    for (int _host = 0; _host < Hub->HostCount(); ++_host) {
+        RowCounts[_host] = int(Hub->Host(_host).Apps.size());
+    }
+
+    connect(Hub, &A_fleethub::HostStatusChanged, this, &A_fleetmodel::OnHostStatusChanged);
+    connect(Hub, &A_fleethub::HostReset, this, &A_fleetmodel::OnHostReset);
+    connect(Hub, &A_fleethub::ApplicationsChanged, this, &A_fleetmodel::OnApplicationsChanged);
+}
+
+void A_fleetmodel::UptimeColumnChanged()
+{
+    for (int _host = 0; _host < int(RowCounts.size()); ++_host) {
+        if (RowCounts.at(_host) > 0) {
+            const QModelIndex _parent = index(_host, 0);
+            emit dataChanged(index(0, UptimeColumn, _parent), index(RowCounts.at(_host) - 1, UptimeColumn, _parent),
+                             { Qt::DisplayRole });
+        }
+    }
+}
+
+QModelIndex A_fleetmodel::index(int _row, int _column, const QModelIndex& _parent) const
+{
+    if (_column < 0 || _column >= ColumnCount || _row < 0) {
+        return QModelIndex();
+    }
+    if (!_parent.isValid()) {
+        return _row < int(RowCounts.size()) ? createIndex(_row, _column, quintptr(0)) : QModelIndex();
+    }
+    if (_parent.internalId() != 0 || _row >= RowCounts.value(_parent.row())) {
+        return QModelIndex();
+    }
+    return createIndex(_row, _column, quintptr(_parent.row() + 1));
+}
+
+QModelIndex A_fleetmodel::parent(const QModelIndex& _index) const
+{
+    if (!_index.isValid() || _index.internalId() == 0) {
+        return QModelIndex();
+    }
+    return createIndex(int(_index.internalId() - 1), 0, quintptr(0));
+}
+
+int A_fleetmodel::rowCount(const QModelIndex& _parent) const
+{
+    if (!_parent.isValid()) {
+        return int(RowCounts.size());
+    }
+    if (_parent.internalId() != 0 || _parent.column() != 0) {
+        return 0;
+    }
+    return RowCounts.value(_parent.row());
+}
+
+int A_fleetmodel::columnCount(const QModelIndex& _parent) const
+{
+    Q_UNUSED(_parent);
+    return ColumnCount;
+}
+
+QVariant A_fleetmodel::data(const QModelIndex& _index, int _role) const
+{
+    if (!_index.isValid()) {
+        return QVariant();
+    }
+
+    if (_role == Qt::TextAlignmentRole) {
+        if (_index.column() == PidColumn || _index.column() == UptimeColumn || _index.column() == RestartsColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return int(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+
+    // Monitor row
+    if (_index.internalId() == 0) {
+        const FleetHost& _view = Hub->Host(_index.row());
+        if (_role == Qt::ToolTipRole) {
+            return QString("%1\n%2 snapshots, %3 deltas").arg(_view.Endpoint).arg(_view.Snapshots).arg(_view.Deltas);
+        }
+        if (_role == Qt::ForegroundRole && !_view.Connected) {
+            return QBrush(Qt::red);
+        }
+        if (_role != Qt::DisplayRole) {
+            return QVariant();
+        }
+        switch (_index.column()) {
+        case NameColumn:
+            return _view.ServerId.isEmpty() ? _view.Endpoint : _view.ServerId;
+        case StatusColumn:
+            return HostStatus(_index.row());
+        default:
+            return QVariant();
+        }
+    }
+
+    // Application row - last known state while its monitor is disconnected
+    const int _host = int(_index.internalId() - 1);
+    const FleetHost& _view = Hub->Host(_host);
+    if (_index.row() >= int(_view.Apps.size())) {
+        return QVariant();
+    }
+    const FleetAppState& _app = _view.Apps.at(_index.row());
+
+    if (_role == Qt::ForegroundRole && !_view.Connected) {
+        return QBrush(Qt::gray);
+    }
+    if (_role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (_index.column()) {
+    case NameColumn:
+        return _app.Name;
+    case StatusColumn:
+        switch (_app.State) {
+        case QPM_STATE_RUNNING: return QString("running");
+        case QPM_STATE_BACKOFF: return QString("backoff");
+        case QPM_STATE_PARKED:  return QString("parked");
+        default:                return QString("stopped");
+        }
+    case PidColumn:
+        return _app.ProcessId > 0 ? QString::number(_app.ProcessId) : QString("-");
+    case UptimeColumn:
+        if (_app.StartedMs <= 0) {
+            return QString("-");
+        }
+        return A_applicationmodel::FormatUptime(QDateTime::currentMSecsSinceEpoch() - _app.StartedMs);
+    case RestartsColumn:
+        return _app.Restarts;
+    default:
+        return QVariant();
+    }
+}
+
+QVariant A_fleetmodel::headerData(int _section, Qt::Orientation _orientation, int _role) const
+{
+    if (_orientation != Qt::Horizontal || _role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (_section) {
+    case NameColumn:     return QString("Server / Application");
+    case StatusColumn:   return QString("Status");
+    case PidColumn:      return QString("PID");
+    case UptimeColumn:   return QString("Uptime");
+    case RestartsColumn: return QString("Restarts");
+    default:             return QVariant();
+    }
+}
+
+void A_fleetmodel::OnHostStatusChanged(int _host)
+{
+    emit dataChanged(index(_host, 0), index(_host, ColumnCount - 1));
+
+    // Application rows change colour with the connection
+    if (RowCounts.at(_host) > 0) {
+        const QModelIndex _parent = index(_host, 0);
+        emit dataChanged(index(0, 0, _parent), index(RowCounts.at(_host) - 1, ColumnCount - 1, _parent),
+                         { Qt::ForegroundRole });
+    }
+}
+
+void A_fleetmodel::OnHostReset(int _host)
+{
+    const QModelIndex _parent = index(_host, 0);
+    if (RowCounts.at(_host) > 0) {
+        beginRemoveRows(_parent, 0, RowCounts.at(_host) - 1);
+        RowCounts[_host] = 0;
+        endRemoveRows();
+    }
+    const int _count = int(Hub->Host(_host).Apps.size());
+    if (_count > 0) {
+        beginInsertRows(_parent, 0, _count - 1);
+        RowCounts[_host] = _count;
+        endInsertRows();
+    }
+    emit dataChanged(_parent, index(_host, ColumnCount - 1));
+}
+
+void A_fleetmodel::OnApplicationsChanged(int _host, const QVector<int>& _rows)
+{
+    const QModelIndex _parent = index(_host, 0);
+    const int _known = RowCounts.at(_host);
+    const int _count = int(Hub->Host(_host).Apps.size());
+    if (_count > _known) {
+        beginInsertRows(_parent, _known, _count - 1);
+        RowCounts[_host] = _count;
+        endInsertRows();
+    }
+
+    // One range over the changed rows views already knew
+    int _first = _known;
+    int _last = -1;
+    for (int _row : _rows) {
+        if (_row < _known) {
+            _first = qMin(_first, _row);
+            _last = qMax(_last, _row);
+        }
+    }
+    if (_last >= 0) {
+        emit dataChanged(index(_first, 0, _parent), index(_last, ColumnCount - 1, _parent));
+    }
+    emit dataChanged(_parent, index(_host, ColumnCount - 1));
+}
+
+QString A_fleetmodel::HostStatus(int _host) const
+{
+    const FleetHost& _view = Hub->Host(_host);
+    int _running = 0;
+    for (const FleetAppState& _app : _view.Apps) {
+        _running += _app.State == QPM_STATE_RUNNING ? 1 : 0;
+    }
+    const QString _counts = QString("%1/%2 running").arg(_running).arg(_view.Apps.size());
+    if (_view.Connected) {
+        return _counts;
+    }
+    return _view.Snapshots > 0 ? QString("disconnected - %1").arg(_counts) : QString("connecting");
+}
@@ -0,0 +1,80 @@
+#ifndef A_FLEETMODEL_H
+#define A_FLEETMODEL_H
+
+#include <QAbstractItemModel>
+#include <QVector>
+#include "a_fleethub.h"
+
+/**
+ * @brief Tree model of the fleet - one top-level row per monitor, its applications below
+ *
+ * Rows are read straight from A_fleethub. The model only keeps the row count
+ * each monitor had at its last notification, so row insertions and removals
+ * can be announced to views before they show the new state. A Delta that
+ * changes applications in place costs one dataChanged range per monitor.
+ */
+class A_fleetmodel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Tree columns
+     */
+    enum Column {
+        NameColumn,         // Server ID or application name
+        StatusColumn,       // Connection state or application state
+        PidColumn,          // System process ID
+        UptimeColumn,       // Time since the process started
+        RestartsColumn,     // Automatic restarts
+        ColumnCount
+    };
+
+    explicit A_fleetmodel(A_fleethub* _hub, QObject* parent = nullptr);
+
+    /**
+     * @brief Notifies views that the uptime column of every application changed
+     */
+    void UptimeColumnChanged();
+
+    // QAbstractItemModel
+    QModelIndex index(int _row, int _column, const QModelIndex& _parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& _index) const override;
+    int rowCount(const QModelIndex& _parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& _parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& _index, int _role = Qt::DisplayRole) const override;
+    QVariant headerData(int _section, Qt::Orientation _orientation, int _role = Qt::DisplayRole) const override;
+
+private slots:
+    /**
+     * @brief Repaints the row of a monitor
+     * @param _host Monitor index
+     */
+    void OnHostStatusChanged(int _host);
+
+    /**
+     * @brief Replaces the application rows of a monitor
+     * @param _host Monitor index
+     */
+    void OnHostReset(int _host);
+
+    /**
+     * @brief Announces appended rows and repaints changed ones
+     * @param _host Monitor index
+     * @param _rows Changed rows
+     */
+    void OnApplicationsChanged(int _host, const QVector<int>& _rows);
+
+private:
+    A_fleethub* Hub;            // Source of all row data
+    QVector<int> RowCounts;     // Application rows views know of - per monitor
+
+    /**
+     * @brief Formats the status of a monitor row
+     * @param _host Monitor index
+     * @return QString Connection state and running count
+     */
+    QString HostStatus(int _host) const;
+};
+
+#endif // A_FLEETMODEL_H
@@ -0,0 +1,158 @@
+#include "a_fleetprotocol.h"
+#include <QDataStream>
+#include <QtEndian>
+
+namespace {
+
+constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_0;
+
+/**
+ * @brief Starts a frame with a placeholder length and the message type
+ */
+void BeginFrame(QDataStream& _stream, A_fleetprotocol::MessageType _type)
+{
+    _stream.setVersion(StreamVersion);
+    _stream << quint32(0) << quint8(_type);
+}
+
+/**
+ * @brief Patches the payload length into a finished frame
+ */
+QByteArray EndFrame(QByteArray& _frame)
+{
+    qToBigEndian<quint32>(quint32(_frame.size() - int(sizeof(quint32))), _frame.data());
+    return _frame;
+}
+
+void WriteApp(QDataStream& _stream, const FleetAppState& _app)
+{
+    _stream << _app.Name.left(A_fleetprotocol::MaxNameLength) << _app.State << _app.ProcessId
+            << _app.Restarts << _app.StartedMs;
+}
+
+bool ReadApps(QDataStream& _stream, QVector<FleetAppState>* _apps)
+{
+    quint32 _count = 0;
+    _stream >> _count;
+    if (_count > quint32(A_fleetprotocol::MaxAppsPerHost)) {
+        return false;
+    }
+    _apps->resize(int(_count));
+    for (FleetAppState& _app : *_apps) {
+        _stream >> _app.Name >> _app.State >> _app.ProcessId >> _app.Restarts >> _app.StartedMs;
+    }
+    return _stream.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+QByteArray A_fleetprotocol::EncodeHello(const QString& _serverId)
+{
+    QByteArray _frame;
+    QDataStream _stream(&_frame, QIODevice::WriteOnly);
+    BeginFrame(_stream, HelloMessage);
+    _stream << Version << _serverId.left(MaxNameLength);
+    return EndFrame(_frame);
+}
+
+QByteArray A_fleetprotocol::EncodeSnapshot(quint64 _sequence, const QVector<FleetAppState>& _apps)
+{
+    QByteArray _frame;
+    QDataStream _stream(&_frame, QIODevice::WriteOnly);
+    BeginFrame(_stream, SnapshotMessage);
+    _stream << _sequence << quint32(_apps.size());
+    for (const FleetAppState& _app : _apps) {
+        WriteApp(_stream, _app);
+    }
+    return EndFrame(_frame);
+}
+
+QByteArray A_fleetprotocol::EncodeDelta(quint64 _sequence, const QVector<FleetAppState>& _changed,
+                                        const QStringList& _removed)
+{
+    QByteArray _frame;
+    QDataStream _stream(&_frame, QIODevice::WriteOnly);
+    BeginFrame(_stream, DeltaMessage);
+    _stream << _sequence << quint32(_changed.size());
+    for (const FleetAppState& _app : _changed) {
+        WriteApp(_stream, _app);
+    }
+    _stream << quint32(_removed.size());
+    for (const QString& _name : _removed) {
+        _stream << _name.left(MaxNameLength);
+    }
+    return EndFrame(_frame);
+}
+
+QByteArray A_fleetprotocol::EncodePing()
+{
+    QByteArray _frame;
+    QDataStream _stream(&_frame, QIODevice::WriteOnly);
+    BeginFrame(_stream, PingMessage);
+    return EndFrame(_frame);
+}
+
+int A_fleetprotocol::Decode(const QByteArray& _buffer, int* _offset, Message* _message)
+{
+    const int _available = int(_buffer.size()) - *_offset;
+    if (_available < int(sizeof(quint32))) {
+        return 0;
+    }
+    const quint32 _length = qFromBigEndian<quint32>(_buffer.constData() + *_offset);
+    if (_length == 0 || _length > quint32(MaxFrameBytes)) {
+        return -1;
+    }
+    if (quint32(_available) - sizeof(quint32) < _length) {
+        return 0;
+    }
+
+    // Parse in place - the receive buffer is not copied
+    const QByteArray _payload = QByteArray::fromRawData(_buffer.constData() + *_offset + sizeof(quint32), int(_length));
+    QDataStream _stream(_payload);
+    _stream.setVersion(StreamVersion);
+
+    quint8 _type = 0;
+    _stream >> _type;
+    *_message = Message();
+    bool _valid = true;
+
+    switch (_type) {
+    case HelloMessage:
+        _message->Type = HelloMessage;
+        _stream >> _message->ProtocolVersion >> _message->ServerId;
+        break;
+    case SnapshotMessage:
+        _message->Type = SnapshotMessage;
+        _stream >> _message->Sequence;
+        _valid = ReadApps(_stream, &_message->Apps);
+        break;
+    case DeltaMessage: {
+        _message->Type = DeltaMessage;
+        _stream >> _message->Sequence;
+        _valid = ReadApps(_stream, &_message->Apps);
+        quint32 _removedCount = 0;
+        _stream >> _removedCount;
+        if (!_valid || _removedCount > quint32(MaxAppsPerHost)) {
+            return -1;
+        }
+        _message->Removed.reserve(int(_removedCount));
+        for (quint32 _i = 0; _i < _removedCount; ++_i) {
+            QString _name;
+            _stream >> _name;
+            _message->Removed.append(_name);
+        }
+        break;
+    }
+    case PingMessage:
+        _message->Type = PingMessage;
+        break;
+    default:
+        return -1;
+    }
+
+    if (!_valid || _stream.status() != QDataStream::Ok) {
+        return -1;
+    }
+    *_offset += int(sizeof(quint32) + _length);
+    return 1;
+}
@@ -0,0 +1,106 @@
+#ifndef A_FLEETPROTOCOL_H
+#define A_FLEETPROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief State of one application as exchanged between a monitor and the fleet hub
+ */
+struct FleetAppState {
+    QString Name;               // Application name - unique per monitor
+    quint8 State = 0;           // QPM_STATE_* value from qpm_status.h
+    qint64 ProcessId = 0;       // Running process - 0 if none
+    quint32 Restarts = 0;       // Automatic restarts since the monitor started
+    qint64 StartedMs = 0;       // Start of the running process - 0 if not running
+
+    bool operator==(const FleetAppState& _other) const
+    {
+        return State == _other.State && ProcessId == _other.ProcessId && Restarts == _other.Restarts
+               && StartedMs == _other.StartedMs && Name == _other.Name;
+    }
+    bool operator!=(const FleetAppState& _other) const { return !(*this == _other); }
+};
+
+/**
+ * @brief Wire format between a monitor (A_fleetserver) and the hub (A_fleethub)
+ *
+ * Every message is one frame: a big-endian quint32 payload length followed
+ * by a QDataStream payload that starts with the message type. A monitor
+ * sends Hello and a full Snapshot to each new connection, then only Deltas
+ * - the applications whose state changed and the names of removed ones -
+ * each carrying the next sequence number. A hub that sees a sequence gap
+ * drops the connection and resynchronizes from the Snapshot of the next
+ * one. Ping keeps idle connections verifiably alive.
+ */
+class A_fleetprotocol
+{
+public:
+    static constexpr quint32 Version = 1;                   // Bumped on any payload change
+    static constexpr int MaxFrameBytes = 4 * 1024 * 1024;   // Larger frames are a protocol error
+    static constexpr int MaxAppsPerHost = 4096;             // Applications accepted per monitor - bounds hub memory
+    static constexpr int MaxNameLength = 128;               // Longer application names are truncated
+
+    enum MessageType : quint8 {
+        HelloMessage = 1,       // Version and server ID
+        SnapshotMessage = 2,    // Sequence and every application
+        DeltaMessage = 3,       // Sequence, changed applications and removed names
+        PingMessage = 4         // Keep-alive
+    };
+
+    /**
+     * @brief One decoded message
+     */
+    struct Message {
+        MessageType Type = PingMessage;
+        quint32 ProtocolVersion = 0;    // Hello
+        QString ServerId;               // Hello
+        quint64 Sequence = 0;           // Snapshot and Delta
+        QVector<FleetAppState> Apps;    // Snapshot - all, Delta - changed
+        QStringList Removed;            // Delta
+    };
+
+    /**
+     * @brief Encodes a Hello frame
+     * @param _serverId Monitor identifier - <id> of its configuration
+     * @return QByteArray Frame
+     */
+    static QByteArray EncodeHello(const QString& _serverId);
+
+    /**
+     * @brief Encodes a Snapshot frame
+     * @param _sequence Sequence number of the state it describes
+     * @param _apps Every application
+     * @return QByteArray Frame
+     */
+    static QByteArray EncodeSnapshot(quint64 _sequence, const QVector<FleetAppState>& _apps);
+
+    /**
+     * @brief Encodes a Delta frame
+     * @param _sequence Sequence number - one more than the previous Snapshot or Delta
+     * @param _changed Added or changed applications
+     * @param _removed Names of removed applications
+     * @return QByteArray Frame
+     */
+    static QByteArray EncodeDelta(quint64 _sequence, const QVector<FleetAppState>& _changed,
+                                  const QStringList& _removed);
+
+    /**
+     * @brief Encodes a Ping frame
+     * @return QByteArray Frame
+     */
+    static QByteArray EncodePing();
+
+    /**
+     * @brief Decodes the next complete frame of a receive buffer
+     * @param _buffer Received bytes
+     * @param _offset Read position - advanced past the frame on success
+     * @param _message Receives the message
+     * @return int 1 if a message was decoded, 0 if the frame is incomplete, -1 on a protocol error
+     */
+    static int Decode(const QByteArray& _buffer, int* _offset, Message* _message);
+};
+
+#endif // A_FLEETPROTOCOL_H
@@ -0,0 +1,200 @@
+#include "a_fleetserver.h"
+#include "a_process.h"
+#include "a_statustable.h"
+#include <QDebug>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+A_fleetserver::A_fleetserver(const QString& _serverId, QObject* parent)
+    : QObject(parent)
+{
+    ServerId = _serverId;
+    CurrentSequence = 0;
+    Deltas = 0;
+    Process = nullptr;
+
+    Server = new QTcpServer(this);
+    connect(Server, &QTcpServer::newConnection, this, &A_fleetserver::OnNewConnection);
+
+    PublishTimer = new QTimer(this);
+    connect(PublishTimer, &QTimer::timeout, this, &A_fleetserver::OnPublishTimer);
+
+    CoalesceTimer = new QTimer(this);
+    CoalesceTimer->setSingleShot(true);
+    connect(CoalesceTimer, &QTimer::timeout, this, &A_fleetserver::OnPublishTimer);
+
+    PingTimer = new QTimer(this);
+    connect(PingTimer, &QTimer::timeout, this, &A_fleetserver::OnPingTimer);
+}
+
+A_fleetserver::~A_fleetserver()
+{
+    // Sockets are children of this object - disconnect first so no handler sees a half-destroyed server
+    for (QTcpSocket* _client : Clients) {
+        _client->disconnect(this);
+    }
+}
+
+bool A_fleetserver::Listen(const QHostAddress& _address, quint16 _port)
+{
+    if (!Server->listen(_address, _port)) {
+        qDebug() << "Warning: Fleet server cannot listen on" << _address.toString() << _port
+                 << Server->errorString();
+        return false;
+    }
+    PingTimer->start(PingIntervalMs);
+    qDebug() << "Fleet server" << ServerId << "listening on" << _address.toString() << Server->serverPort();
+    return true;
+}
+
+quint16 A_fleetserver::Port() const
+{
+    return Server->isListening() ? Server->serverPort() : 0;
+}
+
+void A_fleetserver::Publish(const QVector<FleetAppState>& _apps)
+{
+    QHash<QString, FleetAppState> _next;
+    _next.reserve(qMin(int(_apps.size()), A_fleetprotocol::MaxAppsPerHost));
+    for (const FleetAppState& _app : _apps) {
+        if (_next.size() >= A_fleetprotocol::MaxAppsPerHost && !_next.contains(_app.Name)) {
+            continue; // Hubs would refuse the Snapshot
+        }
+        _next.insert(_app.Name, _app);
+    }
+
+    QVector<FleetAppState> _changed;
+    for (auto _it = _next.constBegin(); _it != _next.constEnd(); ++_it) {
+        const auto _current = Current.constFind(_it.key());
+        if (_current == Current.constEnd() || _current.value() != _it.value()) {
+            _changed.append(_it.value());
+        }
+    }
+    QStringList _removed;
+    for (auto _it = Current.constBegin(); _it != Current.constEnd(); ++_it) {
+        if (!_next.contains(_it.key())) {
+            _removed.append(_it.key());
+        }
+    }
+    if (_changed.isEmpty() && _removed.isEmpty()) {
+        return;
+    }
+
+    Current.swap(_next);
+    ++CurrentSequence;
+    ++Deltas;
+
+    // Encoded once for all hubs
+    if (!Clients.isEmpty()) {
+        Broadcast(A_fleetprotocol::EncodeDelta(CurrentSequence, _changed, _removed));
+    }
+}
+
+void A_fleetserver::AttachProcess(A_process* _process, int _intervalMs)
+{
+    Process = _process;
+    connect(Process, &A_process::ApplicationStatusChanged, CoalesceTimer, qOverload<>(&QTimer::start));
+    PublishTimer->start(qMax(100, _intervalMs));
+    OnPublishTimer();
+}
+
+void A_fleetserver::DisconnectClients()
+{
+    const QList<QTcpSocket*> _clients = Clients;
+    for (QTcpSocket* _client : _clients) {
+        _client->abort();
+    }
+}
+
+QVector<FleetAppState> A_fleetserver::PublishedState() const
+{
+    QVector<FleetAppState> _apps;
+    _apps.reserve(int(Current.size()));
+    for (const FleetAppState& _app : Current) {
+        _apps.append(_app);
+    }
+    return _apps;
+}
+
+QVector<FleetAppState> A_fleetserver::StatesOf(const A_process* _process)
+{
+    QVector<FleetAppState> _apps;
+    const QStringList _names = _process->GetApplicationNames();
+    _apps.reserve(int(_names.size()));
+    for (const QString& _name : _names) {
+        const ProcessInfo _info = _process->GetProcessInfo(_name);
+        FleetAppState _app;
+        _app.Name = _name;
+        _app.State = quint8(A_statustable::StateOf(_info));
+        _app.ProcessId = _info.IsRunning ? _info.ProcessId : 0;
+        _app.Restarts = quint32(qMax(0, _info.RestartCount));
+        _app.StartedMs = _info.IsRunning ? _info.StartTimeMs : 0;
+        _apps.append(_app);
+    }
+    return _apps;
+}
+
+void A_fleetserver::OnNewConnection()
+{
+    while (QTcpSocket* _client = Server->nextPendingConnection()) {
+        if (Clients.size() >= MaxClients) {
+            qDebug() << "Warning: Fleet server refusing hub" << _client->peerAddress().toString()
+                     << "- already serving" << Clients.size();
+            _client->abort();
+            _client->deleteLater();
+            continue;
+        }
+
+        Clients.append(_client);
+        connect(_client, &QTcpSocket::disconnected, this, [this, _client]() {
+            Clients.removeOne(_client);
+            _client->deleteLater();
+        });
+        // Hubs send nothing - discard whatever arrives
+        connect(_client, &QTcpSocket::readyRead, _client, [_client]() { _client->readAll(); });
+
+        qDebug() << "Fleet hub connected from" << _client->peerAddress().toString();
+        if (Send(_client, A_fleetprotocol::EncodeHello(ServerId))) {
+            Send(_client, A_fleetprotocol::EncodeSnapshot(CurrentSequence, PublishedState()));
+        }
+    }
+}
+
+void A_fleetserver::OnPublishTimer()
+{
+    if (Process) {
+        Publish(StatesOf(Process));
+    }
+}
+
+void A_fleetserver::OnPingTimer()
+{
+    if (!Clients.isEmpty()) {
+        Broadcast(A_fleetprotocol::EncodePing());
+    }
+}
+
+void A_fleetserver::Broadcast(const QByteArray& _frame)
+{
+    // Send() may drop a hub, which removes it from Clients
+    const QList<QTcpSocket*> _clients = Clients;
+    for (QTcpSocket* _client : _clients) {
+        Send(_client, _frame);
+    }
+}
+
+bool A_fleetserver::Send(QTcpSocket* _client, const QByteArray& _frame)
+{
+    if (_client->state() != QAbstractSocket::ConnectedState) {
+        return false;
+    }
+    _client->write(_frame);
+    if (_client->bytesToWrite() > MaxPendingBytes) {
+        qDebug() << "Warning: Fleet hub" << _client->peerAddress().toString()
+                 << "is not reading - disconnecting it";
+        _client->abort();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,149 @@
+#ifndef A_FLEETSERVER_H
+#define A_FLEETSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include "a_fleetprotocol.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+class A_process;
+
+/**
+ * @brief Serves one monitor's application state to fleet hubs
+ *
+ * Keeps the last published state of every application. Publish() compares a
+ * new state list against it and broadcasts a single encoded Delta of the
+ * differences to every connected hub; a newly connected hub gets Hello and
+ * a Snapshot. A hub that stops reading is disconnected once its unsent data
+ * exceeds MaxPendingBytes, so a stalled peer never grows the monitor's
+ * memory - it resynchronizes from a fresh Snapshot when it reconnects.
+ */
+class A_fleetserver : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 MaxPendingBytes = 8 * 1024 * 1024;    // Unsent bytes per hub before it is dropped
+    static constexpr int PingIntervalMs = 10000;                    // Keep-alive interval - well below the hub's silence timeout
+    static constexpr int MaxClients = 16;                           // Concurrent hubs
+
+    /**
+     * @param _serverId Identifier announced in Hello - <id> of the configuration
+     * @param parent Parent object
+     */
+    explicit A_fleetserver(const QString& _serverId, QObject* parent = nullptr);
+    ~A_fleetserver();
+
+    /**
+     * @brief Starts accepting hub connections
+     * @param _address Listen address
+     * @param _port Listen port - 0 for any free port
+     * @return bool True if listening
+     */
+    bool Listen(const QHostAddress& _address, quint16 _port);
+
+    /**
+     * @brief Gets the listen port
+     * @return quint16 Port - 0 if not listening
+     */
+    quint16 Port() const;
+
+    /**
+     * @brief Replaces the published state and sends the differences to every hub
+     * @param _apps Current state of every application - later entries win on duplicate names
+     */
+    void Publish(const QVector<FleetAppState>& _apps);
+
+    /**
+     * @brief Publishes the state of a monitoring engine on every check and status change
+     * @param _process Engine - must outlive this server
+     * @param _intervalMs Publish interval - picks up restart counters and PIDs between status signals
+     */
+    void AttachProcess(A_process* _process, int _intervalMs = 1000);
+
+    /**
+     * @brief Disconnects every hub - they reconnect and resynchronize
+     */
+    void DisconnectClients();
+
+    /**
+     * @brief Gets the number of connected hubs
+     * @return int Hubs
+     */
+    int ClientCount() const { return int(Clients.size()); }
+
+    /**
+     * @brief Gets the sequence number of the last published change
+     * @return quint64 Sequence - 0 before the first change
+     */
+    quint64 Sequence() const { return CurrentSequence; }
+
+    /**
+     * @brief Gets the number of Delta messages published
+     * @return quint64 Deltas
+     */
+    quint64 DeltaCount() const { return Deltas; }
+
+    /**
+     * @brief Gets the published state of every application
+     * @return QVector<FleetAppState> Applications - unordered
+     */
+    QVector<FleetAppState> PublishedState() const;
+
+    /**
+     * @brief Builds the fleet state of every application of an engine
+     * @param _process Engine
+     * @return QVector<FleetAppState> Applications in name order
+     */
+    static QVector<FleetAppState> StatesOf(const A_process* _process);
+
+private slots:
+    /**
+     * @brief Sends Hello and a Snapshot to newly connected hubs
+     */
+    void OnNewConnection();
+
+    /**
+     * @brief Republishes the attached engine's state
+     */
+    void OnPublishTimer();
+
+    /**
+     * @brief Sends Ping to every hub
+     */
+    void OnPingTimer();
+
+private:
+    QString ServerId;                           // Identifier announced in Hello
+    QTcpServer* Server;                         // Listening socket
+    QList<QTcpSocket*> Clients;                 // Connected hubs
+    QHash<QString, FleetAppState> Current;      // Last published state - key: app name
+    quint64 CurrentSequence;                    // Sequence of the last published change
+    quint64 Deltas;                             // Delta messages published
+    A_process* Process;                         // Attached engine - null if Publish() is called directly
+    QTimer* PublishTimer;                       // Republishes the attached engine
+    QTimer* CoalesceTimer;                      // Single-shot - merges a burst of status signals into one publish
+    QTimer* PingTimer;                          // Keep-alive
+
+    /**
+     * @brief Queues a frame on every hub and drops the ones that fell too far behind
+     * @param _frame Encoded frame
+     */
+    void Broadcast(const QByteArray& _frame);
+
+    /**
+     * @brief Queues a frame on one hub, dropping it if it fell too far behind
+     * @param _client Hub connection
+     * @param _frame Encoded frame
+     * @return bool False if the hub was dropped
+     */
+    bool Send(QTcpSocket* _client, const QByteArray& _frame);
+};
+
+#endif // A_FLEETSERVER_H
@@ -0,0 +1,334 @@
+#include "a_healthprobe.h"
+#include <QSet>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+
+const int ProbeStatistics::BucketBoundsMs[ProbeStatistics::BucketCount - 1] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000
+};
+
+void ProbeStatistics::Record(qint64 _latencyMs, bool _success)
+{
+    int _bucket = 0;
+    while (_bucket < BucketCount - 1 && _latencyMs > BucketBoundsMs[_bucket]) {
+        ++_bucket;
+    }
+    ++Buckets[_bucket];
+
+    if (_success) {
+        ++Successes;
+    } else {
+        ++Failures;
+    }
+    MaxLatencyMs = qMax(MaxLatencyMs, _latencyMs);
+}
+
+QString ProbeStatistics::ToString() const
+{
+    QStringList _parts;
+    for (int _i = 0; _i < BucketCount; ++_i) {
+        QString _label = (_i < BucketCount - 1)
+                             ? QString("<=%1ms").arg(BucketBoundsMs[_i])
+                             : QString(">%1ms").arg(BucketBoundsMs[BucketCount - 2]);
+        _parts << QString("%1:%2").arg(_label).arg(Buckets[_i]);
+    }
+    return QString("ok=%1 fail=%2 max=%3ms [%4]")
+        .arg(Successes).arg(Failures).arg(MaxLatencyMs).arg(_parts.join(' '));
+}
+
+A_healthprobe::A_healthprobe(QObject *parent) : QObject(parent)
+{
+}
+
+A_healthprobe::~A_healthprobe()
+{
+    for (ProbeState* _state : Probes) {
+        ReleaseResources(_state);
+        delete _state;
+    }
+    Probes.clear();
+}
+
+void A_healthprobe::SetProbes(const QList<AppInfo>& _apps)
+{
+    QSet<QString> _configured;
+
+    for (const AppInfo& _app : _apps) {
+        if (!_app.Probe.IsEnabled()) {
+            continue;
+        }
+        _configured.insert(_app.Name);
+
+        ProbeState* _state = Probes.value(_app.Name, nullptr);
+        if (_state && _state->Config == _app.Probe) {
+            continue; // Unchanged - keep running state and statistics
+        }
+
+        if (!_state) {
+            _state = new ProbeState();
+            _state->AppName = _app.Name;
+
+            _state->PeriodTimer = new QTimer(this);
+            connect(_state->PeriodTimer, &QTimer::timeout, this, [this, _state]() {
+                RunProbe(_state);
+            });
+
+            _state->TimeoutTimer = new QTimer(this);
+            _state->TimeoutTimer->setSingleShot(true);
+            connect(_state->TimeoutTimer, &QTimer::timeout, this, [this, _state]() {
+                qDebug() << "Health probe timed out:" << _state->AppName;
+                CompleteProbe(_state, false);
+            });
+
+            Probes[_app.Name] = _state;
+        } else {
+            ReleaseResources(_state);
+            _state->InFlight = false;
+            _state->ConsecutiveFailures = 0;
+        }
+
+        _state->Config = _app.Probe;
+        _state->PeriodTimer->setInterval(_app.Probe.PeriodMs);
+        qDebug() << "Health probe configured:" << _app.Name << "type:" << _app.Probe.Type;
+    }
+
+    // Drop probes that are no longer configured
+    for (auto _it = Probes.begin(); _it != Probes.end();) {
+        if (_configured.contains(_it.key())) {
+            ++_it;
+            continue;
+        }
+        ProbeState* _state = _it.value();
+        ReleaseResources(_state);
+        delete _state->PeriodTimer;
+        delete _state->TimeoutTimer;
+        delete _state;
+        _it = Probes.erase(_it);
+    }
+}
+
+void A_healthprobe::SetApplicationRunning(const QString& _appName, bool _isRunning)
+{
+    ProbeState* _state = Probes.value(_appName, nullptr);
+    if (!_state || _state->Active == _isRunning) {
+        return;
+    }
+
+    _state->Active = _isRunning;
+    _state->ConsecutiveFailures = 0;
+
+    if (_isRunning) {
+        // First probe after one period so the application has time to come up
+        _state->PeriodTimer->start();
+    } else {
+        _state->PeriodTimer->stop();
+        _state->TimeoutTimer->stop();
+        ReleaseResources(_state);
+        _state->InFlight = false;
+    }
+}
+
+QMap<QString, ProbeStatistics> A_healthprobe::GetStatistics() const
+{
+    QMap<QString, ProbeStatistics> _stats;
+    for (auto _it = Probes.constBegin(); _it != Probes.constEnd(); ++_it) {
+        _stats[_it.key()] = _it.value()->Stats;
+    }
+    return _stats;
+}
+
+void A_healthprobe::RunProbe(ProbeState* _state)
+{
+    if (!_state->Active || _state->InFlight) {
+        return; // Previous probe still running - never overlap
+    }
+
+    _state->InFlight = true;
+    _state->Response.clear();
+    _state->Elapsed.start();
+    _state->TimeoutTimer->start(_state->Config.TimeoutMs);
+
+    if (_state->Config.Type == "exec") {
+        StartExecProbe(_state);
+    } else if (!StartSocketProbe(_state)) {
+        CompleteProbe(_state, false);
+    }
+}
+
+bool A_healthprobe::StartSocketProbe(ProbeState* _state)
+{
+    QString _host = _state->Config.Host;
+    if (_host == "localhost") {
+        _host = "127.0.0.1";
+    }
+
+    sockaddr_in _address = {};
+    _address.sin_family = AF_INET;
+    _address.sin_port = htons(static_cast<quint16>(_state->Config.Port));
+    if (inet_pton(AF_INET, _host.toLatin1().constData(), &_address.sin_addr) != 1) {
+        qDebug() << "Health probe has invalid host:" << _state->AppName << _host;
+        return false;
+    }
+
+    int _fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        qDebug() << "Health probe cannot create socket:" << _state->AppName << "errno:" << errno;
+        return false;
+    }
+    _state->SocketFd = _fd;
+
+    int _result = ::connect(_fd, reinterpret_cast<sockaddr*>(&_address), sizeof(_address));
+    if (_result < 0 && errno != EINPROGRESS) {
+        return false;
+    }
+
+    // Wait for connect completion; readiness for write reports the outcome
+    _state->Notifier = new QSocketNotifier(_fd, QSocketNotifier::Write, this);
+    connect(_state->Notifier, &QSocketNotifier::activated, this, [this, _state]() {
+        OnSocketActivated(_state);
+    });
+    return true;
+}
+
+void A_healthprobe::OnSocketActivated(ProbeState* _state)
+{
+    if (!_state->InFlight || _state->SocketFd < 0 || !_state->Notifier) {
+        return;
+    }
+
+    if (_state->Notifier->type() == QSocketNotifier::Write) {
+        int _error = 0;
+        socklen_t _length = sizeof(_error);
+        if (::getsockopt(_state->SocketFd, SOL_SOCKET, SO_ERROR, &_error, &_length) < 0 || _error != 0) {
+            CompleteProbe(_state, false);
+            return;
+        }
+
+        if (_state->Config.Type == "tcp") {
+            CompleteProbe(_state, true);
+            return;
+        }
+
+        // HTTP: send the request, then switch to waiting for the status line
+        QByteArray _request = QString("GET %1 HTTP/1.0\r\nHost: %2\r\nConnection: close\r\n\r\n")
+                                  .arg(_state->Config.Path, _state->Config.Host)
+                                  .toLatin1();
+        ssize_t _sent = ::send(_state->SocketFd, _request.constData(), _request.size(), MSG_NOSIGNAL);
+        if (_sent != _request.size()) {
+            CompleteProbe(_state, false);
+            return;
+        }
+
+        _state->Notifier->setEnabled(false);
+        _state->Notifier->deleteLater();
+        _state->Notifier = new QSocketNotifier(_state->SocketFd, QSocketNotifier::Read, this);
+        connect(_state->Notifier, &QSocketNotifier::activated, this, [this, _state]() {
+            OnSocketActivated(_state);
+        });
+        return;
+    }
+
+    // HTTP response: only the status line matters
+    char _buffer[512];
+    ssize_t _received = 0;
+    while ((_received = ::recv(_state->SocketFd, _buffer, sizeof(_buffer), 0)) > 0) {
+        _state->Response.append(_buffer, static_cast<int>(_received));
+        if (_state->Response.contains("\r\n") || _state->Response.size() > 4096) {
+            break;
+        }
+    }
+
+    bool _closed = (_received == 0);
+    if (_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        CompleteProbe(_state, false);
+        return;
+    }
+
+    int _lineEnd = _state->Response.indexOf("\r\n");
+    if (_lineEnd < 0 && !_closed && _state->Response.size() <= 4096) {
+        return; // Status line incomplete - wait for more data
+    }
+
+    // "HTTP/1.1 200 OK" - 2xx and 3xx count as healthy
+    QList<QByteArray> _statusLine = _state->Response.left(_lineEnd < 0 ? _state->Response.size() : _lineEnd).split(' ');
+    bool _ok = false;
+    int _code = _statusLine.size() >= 2 ? _statusLine.at(1).toInt(&_ok) : 0;
+    bool _healthy = _statusLine.value(0).startsWith("HTTP/") && _ok && _code >= 200 && _code < 400;
+    if (!_healthy) {
+        qDebug() << "Health probe HTTP status not healthy:" << _state->AppName << _code;
+    }
+    CompleteProbe(_state, _healthy);
+}
+
+void A_healthprobe::StartExecProbe(ProbeState* _state)
+{
+    _state->ExecProcess = new QProcess(this);
+    _state->ExecProcess->setStandardOutputFile(QProcess::nullDevice());
+    _state->ExecProcess->setStandardErrorFile(QProcess::nullDevice());
+
+    connect(_state->ExecProcess, &QProcess::finished, this,
+            [this, _state](int _exitCode, QProcess::ExitStatus _exitStatus) {
+        CompleteProbe(_state, _exitStatus == QProcess::NormalExit && _exitCode == 0);
+    });
+    connect(_state->ExecProcess, &QProcess::errorOccurred, this,
+            [this, _state](QProcess::ProcessError _error) {
+        if (_error == QProcess::FailedToStart) {
+            CompleteProbe(_state, false);
+        }
+    });
+
+    _state->ExecProcess->start("sh", QStringList() << "-c" << _state->Config.Command);
+}
+
+void A_healthprobe::CompleteProbe(ProbeState* _state, bool _success)
+{
+    if (!_state->InFlight) {
+        return;
+    }
+
+    _state->InFlight = false;
+    _state->TimeoutTimer->stop();
+    _state->Stats.Record(_state->Elapsed.elapsed(), _success);
+    ReleaseResources(_state);
+
+    if (_success) {
+        _state->ConsecutiveFailures = 0;
+        return;
+    }
+
+    ++_state->ConsecutiveFailures;
+    qDebug() << "Health probe failed:" << _state->AppName
+             << "streak:" << _state->ConsecutiveFailures << "/" << _state->Config.FailureThreshold;
+
+    if (_state->ConsecutiveFailures >= _state->Config.FailureThreshold) {
+        _state->ConsecutiveFailures = 0;
+        emit ProbeFailed(_state->AppName);
+    }
+}
+
+void A_healthprobe::ReleaseResources(ProbeState* _state)
+{
+    if (_state->Notifier) {
+        _state->Notifier->setEnabled(false);
+        _state->Notifier->deleteLater();
+        _state->Notifier = nullptr;
+    }
+
+    if (_state->SocketFd >= 0) {
+        ::close(_state->SocketFd);
+        _state->SocketFd = -1;
+    }
+
+    if (_state->ExecProcess) {
+        QProcess* _process = _state->ExecProcess;
+        _state->ExecProcess = nullptr;
+        _process->disconnect(this);
+        if (_process->state() != QProcess::NotRunning) {
+            _process->kill();
+        }
+        _process->deleteLater();
+    }
+}
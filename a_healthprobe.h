@@ -0,0 +1,150 @@
+#ifndef A_HEALTHPROBE_H
+#define A_HEALTHPROBE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QProcess>
+#include <QSocketNotifier>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QDebug>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Latency and outcome statistics collected for one application's probe
+ *
+ * Latencies are counted into fixed millisecond buckets; the last bucket
+ * collects everything slower than the largest bound (including timeouts).
+ */
+struct ProbeStatistics {
+    static constexpr int BucketCount = 13;
+    static const int BucketBoundsMs[BucketCount - 1];   // Upper bucket bounds - milliseconds, ascending
+
+    quint64 Buckets[BucketCount] = {};   // Latency histogram - count per bucket
+    quint64 Successes = 0;               // Successful probes - total count
+    quint64 Failures = 0;                // Failed probes - total count, timeouts included
+    qint64 MaxLatencyMs = 0;             // Slowest probe seen - milliseconds
+
+    /**
+     * @brief Records a single probe outcome
+     * @param _latencyMs Time from probe start to result - milliseconds
+     * @param _success True if the probe passed
+     */
+    void Record(qint64 _latencyMs, bool _success);
+
+    /**
+     * @brief Formats the histogram as a single human-readable line
+     * @return QString Bucket counts in "<=Nms:count" form
+     */
+    QString ToString() const;
+};
+
+/**
+ * @brief Class running asynchronous health probes for supervised applications
+ *
+ * Each application with a configured probe gets its own period timer while it
+ * is running. TCP and HTTP probes use non-blocking sockets watched by
+ * QSocketNotifier, exec probes use an asynchronous QProcess, so no probe ever
+ * blocks the event loop. After FailureThreshold consecutive failures the
+ * ProbeFailed signal is emitted so the owner can restart the application.
+ */
+class A_healthprobe : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit A_healthprobe(QObject *parent = nullptr);
+    ~A_healthprobe();
+
+    /**
+     * @brief Synchronizes probe definitions with the configuration
+     * Probes whose definition is unchanged keep their state and statistics.
+     * @param _apps Current application list - probes without a type are ignored
+     */
+    void SetProbes(const QList<AppInfo>& _apps);
+
+    /**
+     * @brief Activates or deactivates probing for an application
+     * Probing only runs while the application is running. Idempotent.
+     * @param _appName Application name - must match configuration
+     * @param _isRunning Current running state of the application
+     */
+    void SetApplicationRunning(const QString& _appName, bool _isRunning);
+
+    /**
+     * @brief Gets probe statistics for all probed applications
+     * @return QMap<QString, ProbeStatistics> Key: app name, value: statistics
+     */
+    QMap<QString, ProbeStatistics> GetStatistics() const;
+
+signals:
+    /**
+     * @brief Emitted when an application's probe reaches its failure threshold
+     * @param appName Name of the unhealthy application
+     */
+    void ProbeFailed(const QString& appName);
+
+private:
+    /**
+     * @brief Runtime state of one application's probe
+     */
+    struct ProbeState {
+        QString AppName;                       // Application name - owner of this probe
+        ProbeInfo Config;                      // Probe definition - from configuration
+        QTimer* PeriodTimer = nullptr;         // Period timer - fires a new probe
+        QTimer* TimeoutTimer = nullptr;        // Timeout timer - aborts the probe in flight
+        QSocketNotifier* Notifier = nullptr;   // Socket notifier - connect/read readiness
+        QProcess* ExecProcess = nullptr;       // Exec probe process - null unless in flight
+        int SocketFd = -1;                     // Probe socket - -1 when closed
+        QByteArray Response;                   // HTTP response bytes - status line only
+        QElapsedTimer Elapsed;                 // Probe stopwatch - started with each probe
+        bool Active = false;                   // Probing enabled - true while app runs
+        bool InFlight = false;                 // Probe running - prevents overlapping probes
+        int ConsecutiveFailures = 0;           // Failure streak - reset on success
+        ProbeStatistics Stats;                 // Latency histogram and counters
+    };
+
+    QMap<QString, ProbeState*> Probes;   // Probe states - key: app name
+
+    /**
+     * @brief Starts a single probe for the given state
+     * @param _state Probe state - must be active and not in flight
+     */
+    void RunProbe(ProbeState* _state);
+
+    /**
+     * @brief Starts a TCP connect (and optional HTTP GET) probe
+     * @param _state Probe state - configured for "tcp" or "http"
+     * @return bool False if the socket could not be created
+     */
+    bool StartSocketProbe(ProbeState* _state);
+
+    /**
+     * @brief Handles socket readiness for TCP/HTTP probes
+     * @param _state Probe state owning the socket
+     */
+    void OnSocketActivated(ProbeState* _state);
+
+    /**
+     * @brief Starts an exec probe
+     * @param _state Probe state - configured for "exec"
+     */
+    void StartExecProbe(ProbeState* _state);
+
+    /**
+     * @brief Finishes the probe in flight and accounts the result
+     * @param _state Probe state - ignored if no probe is in flight
+     * @param _success True if the probe passed
+     */
+    void CompleteProbe(ProbeState* _state, bool _success);
+
+    /**
+     * @brief Releases the socket, notifier and process of a probe
+     * @param _state Probe state to clean up
+     */
+    void ReleaseResources(ProbeState* _state);
+};
+
+#endif // A_HEALTHPROBE_H
@@ -0,0 +1,258 @@
+#include "a_heartbeatwatchdog.h"
+#include "qpm_heartbeat.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <sys/mman.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+static_assert(sizeof(qpm_heartbeat_t) == QPM_HEARTBEAT_SLOT_SIZE, "Heartbeat slot must fill one cache line");
+
+namespace {
+
+/**
+ * @brief Gets the directory of the slot files
+ * tmpfs keeps the counters in memory; fall back to the temp directory without it.
+ */
+QString SlotDirectory()
+{
+    return QFileInfo("/dev/shm").isDir() ? QString("/dev/shm") : QDir::tempPath();
+}
+
+} // namespace
+
+A_heartbeatwatchdog::A_heartbeatwatchdog()
+{
+    Persistent = false;
+
+    // The instance number keeps several engines in one process (simulator, benchmarks) apart
+    static std::atomic<int> _instances(0);
+    const QString _path = QString("%1/qtprocessmonitor-heartbeat-%2-%3").arg(SlotDirectory()).arg(getpid()).arg(_instances++);
+    Slots = Map(_path, true);
+    if (Slots) {
+        Path = _path;
+    }
+
+    FreeSlots.reserve(SlotCount);
+    for (int _slot = SlotCount - 1; _slot >= 0; --_slot) {
+        FreeSlots.append(_slot);
+    }
+}
+
+A_heartbeatwatchdog::~A_heartbeatwatchdog()
+{
+    Release();
+}
+
+bool A_heartbeatwatchdog::Open(const QString& _name)
+{
+    const QString _path = SlotDirectory() + "/" + _name;
+    if (Persistent && _path == Path) {
+        return true;
+    }
+
+    // Counters of the previous run stay - adopted processes go on beating into them
+    qpm_heartbeat* _slots = Map(_path, false);
+    if (!_slots) {
+        return false;
+    }
+    if (!Armed.isEmpty()) {
+        qDebug() << "Warning: Heartbeat file changed -" << Armed.size() << "applications unwatched until relaunched";
+        Armed.clear();
+        ArmedIndex.clear();
+    }
+    Release();
+    Slots = _slots;
+    Path = _path;
+    Persistent = true;
+    return true;
+}
+
+qpm_heartbeat* A_heartbeatwatchdog::Map(const QString& _path, bool _truncate)
+{
+    const QByteArray _encoded = QFile::encodeName(_path);
+    const size_t _size = size_t(SlotCount) * sizeof(qpm_heartbeat_t);
+
+    const int _fd = ::open(_encoded.constData(), O_RDWR | O_CREAT | O_CLOEXEC | (_truncate ? O_TRUNC : 0), 0600);
+    if (_fd < 0) {
+        qDebug() << "Warning: Cannot create heartbeat file" << _path << strerror(errno);
+        return nullptr;
+    }
+    void* _mapping = MAP_FAILED;
+    if (ftruncate(_fd, off_t(_size)) == 0) {
+        _mapping = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    }
+    ::close(_fd);
+    if (_mapping == MAP_FAILED) {
+        qDebug() << "Warning: Cannot map heartbeat file" << _path << strerror(errno);
+        if (_truncate) {
+            ::unlink(_encoded.constData());
+        }
+        return nullptr;
+    }
+    return static_cast<qpm_heartbeat*>(_mapping);
+}
+
+void A_heartbeatwatchdog::Release()
+{
+    if (!Slots) {
+        return;
+    }
+    munmap(Slots, size_t(SlotCount) * sizeof(qpm_heartbeat_t));
+    if (!Persistent) {
+        ::unlink(QFile::encodeName(Path).constData());
+    }
+    Slots = nullptr;
+}
+
+void A_heartbeatwatchdog::SetApplications(const QList<AppInfo>& _apps)
+{
+    if (!Slots) {
+        return;
+    }
+
+    QSet<QString> _configured;
+    for (const AppInfo& _app : _apps) {
+        if (_app.HeartbeatTimeout <= 0) {
+            continue;
+        }
+        _configured.insert(_app.Name);
+
+        Assignment& _assignment = Assigned[_app.Name];
+        if (_assignment.Slot < 0) {
+            if (FreeSlots.isEmpty()) {
+                qDebug() << "Warning: No heartbeat slot left for" << _app.Name;
+                Assigned.remove(_app.Name);
+                continue;
+            }
+            _assignment.Slot = FreeSlots.takeLast();
+        }
+        _assignment.TimeoutMs = qint64(_app.HeartbeatTimeout) * 1000;
+
+        const int _armedIndex = ArmedIndex.value(_app.Name, -1);
+        if (_armedIndex >= 0) {
+            Armed[_armedIndex].TimeoutMs = _assignment.TimeoutMs;
+        }
+    }
+
+    for (auto _it = Assigned.begin(); _it != Assigned.end();) {
+        if (_configured.contains(_it.key())) {
+            ++_it;
+            continue;
+        }
+        Disarm(_it.key());
+        FreeSlots.append(_it->Slot);
+        _it = Assigned.erase(_it);
+    }
+}
+
+QStringList A_heartbeatwatchdog::Environment(const QString& _appName) const
+{
+    const auto _it = Assigned.constFind(_appName);
+    if (_it == Assigned.constEnd()) {
+        return QStringList();
+    }
+    return QStringList() << "QPM_HEARTBEAT_FILE=" + Path
+                         << "QPM_HEARTBEAT_SLOT=" + QString::number(_it->Slot);
+}
+
+void A_heartbeatwatchdog::Arm(const QString& _appName, qint64 _nowMs)
+{
+    const auto _it = Assigned.constFind(_appName);
+    if (_it == Assigned.constEnd()) {
+        return;
+    }
+
+    __atomic_store_n(&Slots[_it->Slot].counter, quint64(0), __ATOMIC_RELAXED);
+    StartWatch(_appName, _it.value(), 0, _nowMs);
+}
+
+bool A_heartbeatwatchdog::Adopt(const QString& _appName, int _slot, qint64 _nowMs)
+{
+    const auto _it = Assigned.find(_appName);
+    if (!Slots || _it == Assigned.end() || _slot < 0 || _slot >= SlotCount) {
+        return false;
+    }
+
+    if (_it->Slot != _slot) {
+        const int _freeIndex = FreeSlots.indexOf(_slot);
+        if (_freeIndex >= 0) {
+            FreeSlots[_freeIndex] = _it->Slot;
+        } else {
+            // Handed to another application by this run - swap unless its process already uses it
+            for (auto _other = Assigned.begin(); _other != Assigned.end(); ++_other) {
+                if (_other->Slot != _slot) {
+                    continue;
+                }
+                if (ArmedIndex.contains(_other.key())) {
+                    return false;
+                }
+                _other->Slot = _it->Slot;
+                break;
+            }
+        }
+        _it->Slot = _slot;
+    }
+
+    StartWatch(_appName, _it.value(), __atomic_load_n(&Slots[_slot].counter, __ATOMIC_RELAXED), _nowMs);
+    return true;
+}
+
+void A_heartbeatwatchdog::StartWatch(const QString& _appName, const Assignment& _assignment, quint64 _count, qint64 _nowMs)
+{
+    int _index = ArmedIndex.value(_appName, -1);
+    if (_index < 0) {
+        _index = int(Armed.size());
+        Armed.append(Watch());
+        ArmedIndex.insert(_appName, _index);
+    }
+    Watch& _watch = Armed[_index];
+    _watch.Slot = _assignment.Slot;
+    _watch.TimeoutMs = _assignment.TimeoutMs;
+    _watch.LastCount = _count;
+    _watch.LastChangeMs = _nowMs;
+    _watch.AppName = _appName;
+}
+
+void A_heartbeatwatchdog::Disarm(const QString& _appName)
+{
+    const int _index = ArmedIndex.value(_appName, -1);
+    if (_index < 0) {
+        return;
+    }
+
+    // Swap with the last entry so the array stays dense
+    ArmedIndex.remove(_appName);
+    const int _last = int(Armed.size()) - 1;
+    if (_index != _last) {
+        Armed[_index] = Armed[_last];
+        ArmedIndex[Armed[_index].AppName] = _index;
+    }
+    Armed.removeLast();
+}
+
+QStringList A_heartbeatwatchdog::Scan(qint64 _nowMs)
+{
+    QStringList _stalled;
+
+    for (Watch& _watch : Armed) {
+        const quint64 _count = __atomic_load_n(&Slots[_watch.Slot].counter, __ATOMIC_RELAXED);
+        if (_count != _watch.LastCount) {
+            _watch.LastCount = _count;
+            _watch.LastChangeMs = _nowMs;
+        } else if (_count != 0 && _nowMs - _watch.LastChangeMs >= _watch.TimeoutMs) {
+            _stalled.append(_watch.AppName);
+        }
+    }
+
+    for (const QString& _appName : _stalled) {
+        Disarm(_appName);
+    }
+    return _stalled;
+}
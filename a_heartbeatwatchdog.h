@@ -0,0 +1,158 @@
+#ifndef A_HEARTBEATWATCHDOG_H
+#define A_HEARTBEATWATCHDOG_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "a_settingsclass.h"
+
+struct qpm_heartbeat;
+
+/**
+ * @brief Detects hung applications from shared-memory heartbeat counters
+ *
+ * The watchdog owns one shared-memory file of 64-byte slots (layout in
+ * qpm_heartbeat.h). Every application with <heartbeatTimeout> gets a slot,
+ * named to it through QPM_HEARTBEAT_FILE/QPM_HEARTBEAT_SLOT at launch, and
+ * bumps the counter in it. Scan() compares each armed slot with the value
+ * seen last time using plain loads - no system calls - so thousands of
+ * slots are checked in microseconds. A slot is only watched once its
+ * counter has left zero, so applications that never beat are left alone.
+ * The file is private to the monitor process until Open() moves it to a
+ * named file that survives a monitor restart.
+ */
+class A_heartbeatwatchdog
+{
+public:
+    static constexpr int SlotCount = 16384;     // Slots in the file - 1 MB, pages allocated on first use
+
+    A_heartbeatwatchdog();
+    ~A_heartbeatwatchdog();
+
+    A_heartbeatwatchdog(const A_heartbeatwatchdog&) = delete;
+    A_heartbeatwatchdog& operator=(const A_heartbeatwatchdog&) = delete;
+
+    /**
+     * @brief Assigns slots to the applications that have a heartbeat timeout
+     * Applications keep their slot across reloads; removed ones free it.
+     * @param _apps Current application list
+     */
+    void SetApplications(const QList<AppInfo>& _apps);
+
+    /**
+     * @brief Moves the slots to a named file that outlives the monitor
+     * A restarted monitor opening the same name maps the counters its adopted
+     * applications still beat into. Watches armed before are dropped - their
+     * processes beat into the previous file.
+     * @param _name File name - in /dev/shm, or the temp directory without it
+     * @return bool True if the file is mapped
+     */
+    bool Open(const QString& _name);
+
+    /**
+     * @brief Gets the slot of an application
+     * @param _appName Application name
+     * @return int Slot index - -1 if the application is not watched
+     */
+    int SlotOf(const QString& _appName) const { return Assigned.value(_appName).Slot; }
+
+    /**
+     * @brief Gets the environment telling an application where its slot is
+     * @param _appName Application name
+     * @return QStringList "NAME=value" entries - empty if the application is not watched
+     */
+    QStringList Environment(const QString& _appName) const;
+
+    /**
+     * @brief Clears an application's counter and starts watching it
+     * Called right before launch, so a beat from the new process is never lost.
+     * @param _appName Application name - ignored if it has no slot
+     * @param _nowMs Current time - milliseconds
+     */
+    void Arm(const QString& _appName, qint64 _nowMs);
+
+    /**
+     * @brief Watches an adopted process that is already beating
+     * The application takes back the slot its process was started with; an
+     * application holding that slot and not watched gets the other one. The
+     * counter is kept, so the process goes on beating where it left off.
+     * @param _appName Application name
+     * @param _slot Slot named to the running process
+     * @param _nowMs Current time - milliseconds
+     * @return bool True if watched - false without a timeout or if a watched application holds the slot
+     */
+    bool Adopt(const QString& _appName, int _slot, qint64 _nowMs);
+
+    /**
+     * @brief Stops watching an application until it is armed again
+     * @param _appName Application name
+     */
+    void Disarm(const QString& _appName);
+
+    /**
+     * @brief Checks every armed slot for a counter that stopped moving
+     * Stalled applications are disarmed, so each hang is reported once.
+     * @param _nowMs Current time - milliseconds
+     * @return QStringList Applications whose heartbeat stood still for their timeout
+     */
+    QStringList Scan(qint64 _nowMs);
+
+    /**
+     * @brief Gets the shared-memory file path
+     * @return QString Path - empty if the file could not be created
+     */
+    QString FilePath() const { return Path; }
+
+private:
+    /**
+     * @brief Watch state of one armed slot - kept dense for the scan
+     */
+    struct Watch {
+        int Slot = -1;              // Slot index
+        qint64 TimeoutMs = 0;       // Allowed standstill - milliseconds
+        quint64 LastCount = 0;      // Counter at the last change
+        qint64 LastChangeMs = 0;    // Time the counter last moved
+        QString AppName;            // Owner - only read when reporting
+    };
+
+    /**
+     * @brief Slot assignment of one configured application
+     */
+    struct Assignment {
+        int Slot = -1;              // Slot index
+        qint64 TimeoutMs = 0;       // From <heartbeatTimeout>
+    };
+
+    QString Path;                                   // Shared-memory file
+    bool Persistent;                                // Path set by Open() - kept on destruction
+    qpm_heartbeat* Slots;                           // Mapped slot array - null if unavailable
+    QHash<QString, Assignment> Assigned;            // Configured applications - key: app name
+    QVector<int> FreeSlots;                         // Unassigned slots - lowest on top
+    QVector<Watch> Armed;                           // Watched slots - scanned in order
+    QHash<QString, int> ArmedIndex;                 // Position in Armed - key: app name
+
+    /**
+     * @brief Maps a slot file, creating it if missing
+     * @param _path File path
+     * @param _truncate Clear existing counters
+     * @return qpm_heartbeat* Mapped slots - null on error
+     */
+    static qpm_heartbeat* Map(const QString& _path, bool _truncate);
+
+    /**
+     * @brief Unmaps the slots - the file is removed unless Persistent
+     */
+    void Release();
+
+    /**
+     * @brief Starts or restarts the watch of an assigned application
+     * @param _appName Application name
+     * @param _assignment Slot and timeout
+     * @param _count Counter value the watch starts from
+     * @param _nowMs Current time - milliseconds
+     */
+    void StartWatch(const QString& _appName, const Assignment& _assignment, quint64 _count, qint64 _nowMs);
+};
+
+#endif // A_HEARTBEATWATCHDOG_H
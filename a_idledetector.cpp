@@ -0,0 +1,80 @@
+#include "a_idledetector.h"
+#include "a_systeminterfaces.h"
+#include <QFile>
+#include <QList>
+#include <unistd.h>
+
+A_idledetector::A_idledetector()
+{
+    TicksPerSecond = double(qMax(1L, sysconf(_SC_CLK_TCK)));
+}
+
+qint64 A_idledetector::Sample(const QString& _appName, qint64 _processId, const IdleInfo& _idle, qint64 _nowMs)
+{
+    quint64 _cpuTicks = 0;
+    quint64 _ioChars = 0;
+    if (_processId <= 0 || !ReadCounters(_processId, &_cpuTicks, &_ioChars)) {
+        Tracked.remove(_appName);
+        return 0;
+    }
+
+    auto _it = Tracked.find(_appName);
+    if (_it == Tracked.end() || _it->ProcessId != _processId) {
+        Tracked.insert(_appName, Counters { _processId, _cpuTicks, _ioChars, _nowMs, _nowMs });
+        return 0;
+    }
+
+    Counters& _last = _it.value();
+    const qint64 _intervalMs = _nowMs - _last.SampleMs;
+    if (_intervalMs <= 0) {
+        return _nowMs - _last.IdleSinceMs;
+    }
+
+    const double _cpuPercent = double(_cpuTicks - _last.CpuTicks) / TicksPerSecond * 100000.0 / double(_intervalMs);
+    const bool _idleInterval = _cpuPercent <= _idle.CpuPercent && _ioChars == _last.IoChars;
+
+    _last.CpuTicks = _cpuTicks;
+    _last.IoChars = _ioChars;
+    _last.SampleMs = _nowMs;
+    if (!_idleInterval) {
+        _last.IdleSinceMs = _nowMs;
+        return 0;
+    }
+    return _nowMs - _last.IdleSinceMs;
+}
+
+void A_idledetector::Forget(const QString& _appName)
+{
+    Tracked.remove(_appName);
+}
+
+qint64 A_idledetector::ResidentKb(qint64 _processId)
+{
+    ProcessStat _stat;
+    if (!A_procfsprocesstable::ReadStatm(_processId, &_stat)) {
+        return 0;
+    }
+    return qint64(_stat.ResidentPages) * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+bool A_idledetector::ReadCounters(qint64 _processId, quint64* _cpuTicks, quint64* _ioChars)
+{
+    ProcessStat _stat;
+    if (!A_procfsprocesstable::ReadStat(_processId, &_stat)) {
+        return false;
+    }
+    *_cpuTicks = _stat.CpuTicks;
+
+    // io: "rchar: N\nwchar: N\n..." - counts every read/write, sockets and pipes included
+    *_ioChars = 0;
+    QFile _ioFile(QString("/proc/%1/io").arg(_processId));
+    if (_ioFile.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> _lines = _ioFile.read(512).split('\n');
+        for (const QByteArray& _line : _lines) {
+            if (_line.startsWith("rchar:") || _line.startsWith("wchar:")) {
+                *_ioChars += _line.mid(6).trimmed().toULongLong();
+            }
+        }
+    }
+    return true;
+}
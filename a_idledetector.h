@@ -0,0 +1,71 @@
+#ifndef A_IDLEDETECTOR_H
+#define A_IDLEDETECTOR_H
+
+#include <QHash>
+#include <QString>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Tracks how long running applications have been idle
+ *
+ * Each Sample() reads the process's CPU ticks from /proc/<pid>/stat and its
+ * read/write character counts from /proc/<pid>/io; the latter include socket
+ * and pipe traffic, not just disk I/O. An interval counts as idle when CPU
+ * use stayed at or below IdleInfo::CpuPercent and neither count moved. If
+ * /proc/<pid>/io is unreadable (another user's process) only CPU is used.
+ */
+class A_idledetector
+{
+public:
+    A_idledetector();
+
+    /**
+     * @brief Takes a sample and returns the idle time so far
+     * The first sample of a process only sets the baseline.
+     * @param _appName Application name
+     * @param _processId Running process - a new PID restarts tracking
+     * @param _idle Idle thresholds
+     * @param _nowMs Current time - milliseconds
+     * @return qint64 Milliseconds the process has been idle - 0 if it was active in the last interval
+     */
+    qint64 Sample(const QString& _appName, qint64 _processId, const IdleInfo& _idle, qint64 _nowMs);
+
+    /**
+     * @brief Drops the tracking state of an application
+     * @param _appName Application name
+     */
+    void Forget(const QString& _appName);
+
+    /**
+     * @brief Reads the resident memory of a process
+     * @param _processId Process ID
+     * @return qint64 Resident set size in kB - 0 if unreadable
+     */
+    static qint64 ResidentKb(qint64 _processId);
+
+private:
+    /**
+     * @brief Activity counters of one tracked process
+     */
+    struct Counters {
+        qint64 ProcessId = 0;       // Tracked process - tracking restarts when it changes
+        quint64 CpuTicks = 0;       // utime + stime
+        quint64 IoChars = 0;        // rchar + wchar - 0 if /proc/<pid>/io is unreadable
+        qint64 SampleMs = 0;        // Time of the sample
+        qint64 IdleSinceMs = 0;     // Start of the current idle stretch
+    };
+
+    QHash<QString, Counters> Tracked;   // Last sample per application - key: app name
+    double TicksPerSecond;              // Clock ticks per second - from sysconf
+
+    /**
+     * @brief Reads the activity counters of a process
+     * @param _processId Process ID
+     * @param _cpuTicks Receives utime + stime
+     * @param _ioChars Receives rchar + wchar - 0 if unreadable
+     * @return bool False if the process is gone
+     */
+    static bool ReadCounters(qint64 _processId, quint64* _cpuTicks, quint64* _ioChars);
+};
+
+#endif // A_IDLEDETECTOR_H
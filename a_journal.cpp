@@ -0,0 +1,356 @@
+#include "a_journal.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+const char JournalMagic[8] = { 'Q', 'P', 'M', 'J', 'R', 'N', 'L', '\0' };
+
+QString SegmentFileName(quint64 _sequence)
+{
+    return QString("journal-%1.qpj").arg(_sequence, 8, 10, QChar('0'));
+}
+}
+
+A_journal::A_journal()
+{
+    SegmentCapacity = 0;
+    MaxSegments = 0;
+    ActiveSegment = nullptr;
+}
+
+A_journal::~A_journal()
+{
+    Close();
+}
+
+bool A_journal::Open(const QString& _directory, qint64 _segmentBytes, int _maxSegments)
+{
+    Close();
+
+    if (!QDir().mkpath(_directory)) {
+        qDebug() << "Error: Cannot create journal directory:" << _directory;
+        return false;
+    }
+
+    Directory = _directory;
+    MaxSegments = qMax(1, _maxSegments);
+    SegmentCapacity = qMax<qint64>(SparseInterval,
+                                   (_segmentBytes - qint64(sizeof(JournalSegmentHeader))) / qint64(sizeof(JournalRecord)));
+
+    // Map existing segments in sequence order
+    QRegularExpression _pattern("^journal-(\\d+)\\.qpj$");
+    QStringList _files = QDir(Directory).entryList(QStringList() << "journal-*.qpj", QDir::Files, QDir::Name);
+    for (const QString& _file : _files) {
+        QRegularExpressionMatch _match = _pattern.match(_file);
+        if (!_match.hasMatch()) {
+            continue;
+        }
+        Segment* _segment = MapSegment(Directory + "/" + _file, _match.captured(1).toULongLong());
+        if (_segment) {
+            Segments.append(_segment);
+        } else {
+            qDebug() << "Warning: Skipping invalid journal segment:" << _file;
+        }
+    }
+
+    // A directory left by a larger configuration shrinks to the limit right away
+    Trim(MaxSegments);
+
+    if (!Segments.isEmpty() && Segments.last()->Backed
+        && Segments.last()->Header()->RecordCount < Segments.last()->Header()->Capacity) {
+        ActiveSegment = Segments.last();
+    } else {
+        Rotate();
+    }
+
+    if (!ActiveSegment) {
+        qDebug() << "Error: Journal could not open a writable segment in:" << Directory;
+        return false;
+    }
+
+    qDebug() << "Journal opened:" << Directory << "segments:" << Segments.size()
+             << "active:" << ActiveSegment->FilePath;
+    return true;
+}
+
+void A_journal::Close()
+{
+    for (Segment* _segment : Segments) {
+        ReleaseSegment(_segment);
+    }
+    Segments.clear();
+    ActiveSegment = nullptr;
+}
+
+void A_journal::Append(qint64 _timestampMs, JournalEventType _type, const QString& _appName, qint64 _processId, qint64 _detail)
+{
+    if (!ActiveSegment) {
+        return;
+    }
+
+    JournalSegmentHeader* _header = ActiveSegment->Header();
+    if (_header->RecordCount >= _header->Capacity) {
+        Rotate();
+        if (!ActiveSegment) {
+            return;
+        }
+        _header = ActiveSegment->Header();
+    }
+
+    const quint64 _index = _header->RecordCount;
+    const QByteArray _name = _appName.toUtf8();
+
+    JournalRecord& _record = ActiveSegment->Records()[_index];
+    _record.TimestampMs = _timestampMs;
+    _record.AppHash = HashName(_name);
+    _record.EventType = static_cast<quint16>(_type);
+    _record.Reserved = 0;
+    _record.ProcessId = _processId;
+    _record.Detail = _detail;
+    const size_t _nameLength = qMin<size_t>(_name.size(), sizeof(_record.AppName) - 1);
+    std::memcpy(_record.AppName, _name.constData(), _nameLength);
+    std::memset(_record.AppName + _nameLength, 0, sizeof(_record.AppName) - _nameLength);
+
+    if (_index == 0) {
+        _header->FirstTimestampMs = _record.TimestampMs;
+    }
+    _header->LastTimestampMs = _record.TimestampMs;
+    TrackTimestamp(ActiveSegment, _index);
+
+    // Publish the record only after it is fully written
+    _header->RecordCount = _index + 1;
+
+    if (_index % SparseInterval == 0) {
+        ActiveSegment->SparseIndex.append(qMakePair(_record.TimestampMs, static_cast<quint32>(_index)));
+    }
+}
+
+QList<JournalRecord> A_journal::Query(const QString& _appName, qint64 _fromMs, qint64 _toMs) const
+{
+    QList<JournalRecord> _result;
+    const QByteArray _name = _appName.toUtf8();
+    const quint32 _hash = HashName(_name);
+    const QByteArray _storedName = _name.left(sizeof(JournalRecord::AppName) - 1);
+
+    for (const Segment* _segment : Segments) {
+        const JournalSegmentHeader* _header = _segment->Header();
+        if (_header->RecordCount == 0 ||
+            _segment->MaxTimestampMs < _fromMs || _segment->MinTimestampMs > _toMs) {
+            continue;
+        }
+
+        // Jump to the last sparse entry before the range, then scan forward
+        quint32 _start = 0;
+        const auto& _index = _segment->SparseIndex;
+        if (_segment->Ordered) {
+            auto _it = std::lower_bound(_index.constBegin(), _index.constEnd(), _fromMs,
+                                        [](const QPair<qint64, quint32>& _entry, qint64 _time) {
+                                            return _entry.first < _time;
+                                        });
+            if (_it != _index.constBegin()) {
+                _start = (_it - 1)->second;
+            }
+        }
+
+        const JournalRecord* _records = _segment->Records();
+        for (quint64 _i = _start; _i < _header->RecordCount; ++_i) {
+            const JournalRecord& _record = _records[_i];
+            if (_record.TimestampMs > _toMs) {
+                if (_segment->Ordered) {
+                    break;
+                }
+                continue;
+            }
+            if (_record.TimestampMs < _fromMs) {
+                continue;
+            }
+            if (!_name.isEmpty() &&
+                (_record.AppHash != _hash ||
+                 qstrncmp(_record.AppName, _storedName.constData(), sizeof(_record.AppName)) != 0)) {
+                continue;
+            }
+            _result.append(_record);
+        }
+    }
+
+    // Segments are in append order; only a clock step back leaves the result unsorted
+    auto _earlier = [](const JournalRecord& _a, const JournalRecord& _b) { return _a.TimestampMs < _b.TimestampMs; };
+    if (!std::is_sorted(_result.begin(), _result.end(), _earlier)) {
+        std::stable_sort(_result.begin(), _result.end(), _earlier);
+    }
+    return _result;
+}
+
+QString A_journal::EventTypeName(quint16 _type)
+{
+    switch (static_cast<JournalEventType>(_type)) {
+    case JournalEventType::Running:      return "running";
+    case JournalEventType::Stopped:      return "stopped";
+    case JournalEventType::Crashed:      return "crashed";
+    case JournalEventType::Restarted:    return "restarted";
+    case JournalEventType::LaunchFailed: return "launch-failed";
+    case JournalEventType::KillSignal:   return "kill-signal";
+    case JournalEventType::ProbeFailed:  return "probe-failed";
+    case JournalEventType::Scheduled:    return "scheduled";
+    case JournalEventType::Parked:       return "parked";
+    case JournalEventType::HeartbeatStalled: return "heartbeat-stalled";
+    }
+    return "unknown";
+}
+
+A_journal::Segment* A_journal::MapSegment(const QString& _filePath, quint64 _sequence)
+{
+    int _fd = ::open(QFile::encodeName(_filePath).constData(), O_RDWR | O_CLOEXEC);
+    if (_fd < 0) {
+        return nullptr;
+    }
+
+    off_t _size = ::lseek(_fd, 0, SEEK_END);
+    if (_size < off_t(sizeof(JournalSegmentHeader))) {
+        ::close(_fd);
+        return nullptr;
+    }
+
+    // Appending may resume here; a segment whose blocks cannot be reserved is only read
+    const bool _backed = ::posix_fallocate(_fd, 0, _size) == 0;
+    void* _base = ::mmap(nullptr, size_t(_size), PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    ::close(_fd); // The mapping keeps the file referenced
+    if (_base == MAP_FAILED) {
+        return nullptr;
+    }
+
+    Segment* _segment = new Segment();
+    _segment->FilePath = _filePath;
+    _segment->Sequence = _sequence;
+    _segment->Base = static_cast<uchar*>(_base);
+    _segment->MappedSize = size_t(_size);
+    _segment->Backed = _backed;
+
+    const JournalSegmentHeader* _header = _segment->Header();
+    const quint64 _fits = (quint64(_size) - sizeof(JournalSegmentHeader)) / sizeof(JournalRecord);
+    if (std::memcmp(_header->Magic, JournalMagic, sizeof(JournalMagic)) != 0 ||
+        _header->Version != FormatVersion ||
+        _header->RecordSize != sizeof(JournalRecord) ||
+        _header->Capacity > _fits ||
+        _header->RecordCount > _header->Capacity) {
+        ReleaseSegment(_segment);
+        return nullptr;
+    }
+
+    const JournalRecord* _records = _segment->Records();
+    for (quint64 _i = 0; _i < _header->RecordCount; ++_i) {
+        if (_i % SparseInterval == 0) {
+            _segment->SparseIndex.append(qMakePair(_records[_i].TimestampMs, static_cast<quint32>(_i)));
+        }
+        TrackTimestamp(_segment, _i);
+    }
+
+    return _segment;
+}
+
+A_journal::Segment* A_journal::CreateSegment(quint64 _sequence)
+{
+    const QString _filePath = Directory + "/" + SegmentFileName(_sequence);
+    const size_t _size = sizeof(JournalSegmentHeader) + SegmentCapacity * sizeof(JournalRecord);
+
+    int _fd = ::open(QFile::encodeName(_filePath).constData(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        qDebug() << "Error: Cannot create journal segment:" << _filePath;
+        return nullptr;
+    }
+
+    // Reserve every block now - a store into a sparse page on a full disk raises SIGBUS
+    const int _error = ::posix_fallocate(_fd, 0, off_t(_size));
+    if (_error != 0) {
+        qDebug() << "Error: Cannot reserve journal segment:" << _filePath << strerror(_error);
+        ::close(_fd);
+        ::unlink(QFile::encodeName(_filePath).constData());
+        return nullptr;
+    }
+
+    void* _base = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    ::close(_fd);
+    if (_base == MAP_FAILED) {
+        qDebug() << "Error: Cannot map journal segment:" << _filePath;
+        return nullptr;
+    }
+
+    Segment* _segment = new Segment();
+    _segment->FilePath = _filePath;
+    _segment->Sequence = _sequence;
+    _segment->Base = static_cast<uchar*>(_base);
+    _segment->MappedSize = _size;
+
+    // posix_fallocate zero-fills, so only the identifying fields need writing
+    JournalSegmentHeader* _header = _segment->Header();
+    std::memcpy(_header->Magic, JournalMagic, sizeof(JournalMagic));
+    _header->Version = FormatVersion;
+    _header->RecordSize = sizeof(JournalRecord);
+    _header->Capacity = SegmentCapacity;
+
+    return _segment;
+}
+
+void A_journal::Rotate()
+{
+    const quint64 _sequence = Segments.isEmpty() ? 1 : Segments.last()->Sequence + 1;
+
+    ActiveSegment = CreateSegment(_sequence);
+    if (!ActiveSegment) {
+        qDebug() << "Error: Journal rotation failed - events are no longer recorded";
+        return;
+    }
+    Segments.append(ActiveSegment);
+    Trim(MaxSegments);
+
+    qDebug() << "Journal rotated to segment:" << ActiveSegment->FilePath;
+}
+
+void A_journal::Trim(int _keep)
+{
+    while (Segments.size() > _keep) {
+        Segment* _oldest = Segments.takeFirst();
+        QFile::remove(_oldest->FilePath);
+        ReleaseSegment(_oldest);
+    }
+}
+
+void A_journal::TrackTimestamp(Segment* _segment, quint64 _index)
+{
+    const qint64 _timestampMs = _segment->Records()[_index].TimestampMs;
+    if (_index == 0) {
+        _segment->MinTimestampMs = _timestampMs;
+        _segment->MaxTimestampMs = _timestampMs;
+        return;
+    }
+    if (_timestampMs < _segment->Records()[_index - 1].TimestampMs) {
+        _segment->Ordered = false;
+    }
+    _segment->MinTimestampMs = qMin(_segment->MinTimestampMs, _timestampMs);
+    _segment->MaxTimestampMs = qMax(_segment->MaxTimestampMs, _timestampMs);
+}
+
+void A_journal::ReleaseSegment(Segment* _segment)
+{
+    if (_segment->Base) {
+        ::munmap(_segment->Base, _segment->MappedSize);
+    }
+    delete _segment;
+}
+
+quint32 A_journal::HashName(const QByteArray& _bytes)
+{
+    quint32 _hash = 2166136261u;
+    for (char _byte : _bytes) {
+        _hash ^= static_cast<quint8>(_byte);
+        _hash *= 16777619u;
+    }
+    return _hash;
+}
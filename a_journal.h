@@ -0,0 +1,194 @@
+#ifndef A_JOURNAL_H
+#define A_JOURNAL_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QDebug>
+
+/**
+ * @brief Supervision events stored in the journal
+ */
+enum class JournalEventType : quint16 {
+    Running = 1,        // Process confirmed running - Detail unused
+    Stopped = 2,        // Process stopped on request - Detail unused
+    Crashed = 3,        // Process disappeared while it should run - Detail unused
+    Restarted = 4,      // Process automatically restarted - Detail unused
+    LaunchFailed = 5,   // Launch attempt failed - Detail unused
+    KillSignal = 6,     // Kill escalation step - Detail holds the signal number
+    ProbeFailed = 7,    // Health probe reached its failure threshold - Detail unused
+    Scheduled = 8,      // Run window opened or closed - Detail 1 for start, 0 for stop
+    Parked = 9,         // Stopped after an idle period - Detail holds the reclaimed resident kB
+    HeartbeatStalled = 10 // Heartbeat counter stood still for the configured timeout - Detail unused
+};
+
+/**
+ * @brief Fixed-layout journal record - 64 bytes, one per event
+ */
+struct JournalRecord {
+    qint64 TimestampMs;     // Event time - milliseconds since epoch
+    quint32 AppHash;        // FNV-1a hash of the full UTF-8 app name - query prefilter
+    quint16 EventType;      // JournalEventType value
+    quint16 Reserved;       // Padding - always zero
+    qint64 ProcessId;       // Process ID involved - 0 if none
+    qint64 Detail;          // Event-specific detail - see JournalEventType
+    char AppName[32];       // UTF-8 app name - truncated, NUL terminated
+};
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord layout must stay fixed");
+
+/**
+ * @brief Header at the start of every segment file - 64 bytes
+ */
+struct JournalSegmentHeader {
+    char Magic[8];              // "QPMJRNL" - file type marker
+    quint32 Version;            // Layout version - A_journal::FormatVersion
+    quint32 RecordSize;         // sizeof(JournalRecord) - layout check
+    quint64 Capacity;           // Records that fit in the segment
+    quint64 RecordCount;        // Committed records - written after the record itself
+    qint64 FirstTimestampMs;    // Time of the first record - 0 if empty
+    qint64 LastTimestampMs;     // Time of the last record - 0 if empty
+    char Reserved[16];          // Padding - always zero
+};
+static_assert(sizeof(JournalSegmentHeader) == 64, "JournalSegmentHeader layout must stay fixed");
+
+/**
+ * @brief Append-only binary journal of supervision history
+ *
+ * Records are written straight into a memory-mapped segment file, so an
+ * append is a memcpy plus a header update with no system call. System calls
+ * only happen when a segment fills up and the journal rotates to a new file.
+ * A sparse in-memory time index (one entry every SparseInterval records)
+ * lets queries skip directly to the requested time range. Timestamps come
+ * from the wall clock and may step back; a segment holding such a step is
+ * scanned in full instead.
+ */
+class A_journal
+{
+public:
+    static constexpr quint32 FormatVersion = 1;       // Segment layout version
+    static constexpr quint32 SparseInterval = 64;     // Records per sparse index entry
+
+    A_journal();
+    ~A_journal();
+
+    /**
+     * @brief Opens (or creates) the journal in a directory
+     * Existing segments are mapped and indexed; appending resumes in the newest one.
+     * @param _directory Journal directory - created if missing
+     * @param _segmentBytes Segment file size - rounded to whole records
+     * @param _maxSegments Segments kept on disk - oldest are deleted here and on rotation
+     * @return bool True if the journal is ready for appends
+     */
+    bool Open(const QString& _directory, qint64 _segmentBytes = 4 * 1024 * 1024, int _maxSegments = 8);
+
+    /**
+     * @brief Unmaps and closes all segments
+     */
+    void Close();
+
+    /**
+     * @brief Checks whether the journal accepts appends
+     * @return bool True if open
+     */
+    bool IsOpen() const { return ActiveSegment != nullptr; }
+
+    /**
+     * @brief Appends one event record
+     * @param _timestampMs Time of the event - milliseconds since epoch, from the engine's clock
+     * @param _type Event type
+     * @param _appName Application name - truncated to 31 bytes in the record
+     * @param _processId Process ID involved - 0 if none
+     * @param _detail Event-specific detail - see JournalEventType
+     */
+    void Append(qint64 _timestampMs, JournalEventType _type, const QString& _appName, qint64 _processId = 0, qint64 _detail = 0);
+
+    /**
+     * @brief Returns events of one application within a time range
+     * @param _appName Application name - empty matches all applications
+     * @param _fromMs Range start - milliseconds since epoch, inclusive
+     * @param _toMs Range end - milliseconds since epoch, inclusive
+     * @return QList<JournalRecord> Matching records in time order - equal times in append order
+     */
+    QList<JournalRecord> Query(const QString& _appName, qint64 _fromMs, qint64 _toMs) const;
+
+    /**
+     * @brief Gets a readable name for an event type
+     * @param _type Raw event type value from a record
+     * @return QString Event name - "unknown" for unrecognized values
+     */
+    static QString EventTypeName(quint16 _type);
+
+private:
+    /**
+     * @brief One mapped segment file
+     */
+    struct Segment {
+        QString FilePath;                            // Segment file path
+        quint64 Sequence = 0;                        // Segment number - from the file name
+        uchar* Base = nullptr;                       // Mapping base - header followed by records
+        size_t MappedSize = 0;                       // Mapping length - bytes
+        bool Backed = true;                          // Blocks reserved on disk - appends never hit an unbacked page
+        bool Ordered = true;                         // Timestamps never decrease - false disables the time index
+        qint64 MinTimestampMs = 0;                   // Earliest record time - 0 if empty
+        qint64 MaxTimestampMs = 0;                   // Latest record time - 0 if empty
+        QVector<QPair<qint64, quint32>> SparseIndex; // Time index - (timestamp, record index)
+
+        JournalSegmentHeader* Header() const { return reinterpret_cast<JournalSegmentHeader*>(Base); }
+        JournalRecord* Records() const { return reinterpret_cast<JournalRecord*>(Base + sizeof(JournalSegmentHeader)); }
+    };
+
+    QString Directory;              // Journal directory - holds journal-<seq>.qpj files
+    quint64 SegmentCapacity;        // Records per new segment
+    int MaxSegments;                // Segments kept on disk
+    QList<Segment*> Segments;       // Mapped segments - oldest first
+    Segment* ActiveSegment;         // Segment receiving appends - null when closed
+
+    /**
+     * @brief Maps an existing segment file and rebuilds its sparse index
+     * @param _filePath Segment file path
+     * @param _sequence Segment number
+     * @return Segment* Mapped segment, or nullptr if the file is invalid
+     */
+    Segment* MapSegment(const QString& _filePath, quint64 _sequence);
+
+    /**
+     * @brief Creates and maps a new empty segment file
+     * @param _sequence Segment number
+     * @return Segment* Mapped segment, or nullptr on error
+     */
+    Segment* CreateSegment(quint64 _sequence);
+
+    /**
+     * @brief Starts a new segment and deletes segments beyond MaxSegments
+     */
+    void Rotate();
+
+    /**
+     * @brief Deletes the oldest segments
+     * @param _keep Segments to keep
+     */
+    void Trim(int _keep);
+
+    /**
+     * @brief Folds one appended or mapped record into a segment's time range
+     * @param _segment Segment holding the record
+     * @param _index Record index
+     */
+    static void TrackTimestamp(Segment* _segment, quint64 _index);
+
+    /**
+     * @brief Unmaps a segment and frees it
+     * @param _segment Segment to release
+     */
+    static void ReleaseSegment(Segment* _segment);
+
+    /**
+     * @brief Computes the 32-bit FNV-1a hash of a byte string
+     * @param _bytes UTF-8 app name
+     * @return quint32 Hash value
+     */
+    static quint32 HashName(const QByteArray& _bytes);
+};
+
+#endif // A_JOURNAL_H
@@ -0,0 +1,264 @@
+#include "a_launchpolicy.h"
+#include "a_systeminterfaces.h"
+#include <QFile>
+#include <QStringList>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// ioprio ABI - not every libc ships <linux/ioprio.h>
+constexpr int IoprioClassShift = 13;
+constexpr int IoprioWhoProcess = 1;
+constexpr int IoprioClassRealtime = 1;
+constexpr int IoprioClassBestEffort = 2;
+constexpr int IoprioClassIdle = 3;
+
+/**
+ * @brief Reads a small /proc or /sys file
+ * @param _path File path
+ * @return QByteArray Contents - empty if unreadable
+ */
+QByteArray ReadSmallFile(const QString& _path)
+{
+    QFile _file(_path);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return _file.read(64 * 1024);
+}
+
+} // namespace
+
+A_launchpolicy::A_launchpolicy()
+{
+    HasAffinity = false;
+    CPU_ZERO(&Affinity);
+    memset(NodeMask, 0, sizeof(NodeMask));
+    IoPriorityValue = 0;
+    OomScoreText[0] = '\0';
+    OomScoreLength = 0;
+}
+
+bool A_launchpolicy::Prepare(const LaunchPolicy& _policy)
+{
+    Policy = _policy;
+
+    // Explicit CPUs win; otherwise a NUMA node also pins the application to that node's CPUs
+    QString _cpuList = _policy.Cpus;
+    if (_cpuList.isEmpty() && _policy.NumaNode >= 0) {
+        _cpuList = QString::fromLatin1(ReadSmallFile(
+            QString("/sys/devices/system/node/node%1/cpulist").arg(_policy.NumaNode))).trimmed();
+        if (_cpuList.isEmpty()) {
+            qDebug() << "NUMA node has no CPUs or does not exist:" << _policy.NumaNode;
+            return false;
+        }
+    }
+
+    HasAffinity = !_cpuList.isEmpty();
+    CPU_ZERO(&Affinity);
+    if (HasAffinity) {
+        QVector<int> _cpus;
+        if (!ParseCpuList(_cpuList, &_cpus)) {
+            qDebug() << "Invalid CPU list:" << _cpuList;
+            return false;
+        }
+        for (int _cpu : _cpus) {
+            if (_cpu >= CPU_SETSIZE) {
+                qDebug() << "CPU number out of range:" << _cpu;
+                return false;
+            }
+            CPU_SET(_cpu, &Affinity);
+        }
+    }
+
+    memset(NodeMask, 0, sizeof(NodeMask));
+    if (_policy.NumaNode >= 0) {
+        if (_policy.NumaNode >= MaxNumaNodes) {
+            return false;
+        }
+        const size_t _bits = 8 * sizeof(unsigned long);
+        NodeMask[size_t(_policy.NumaNode) / _bits] |= 1UL << (size_t(_policy.NumaNode) % _bits);
+    }
+
+    IoPriorityValue = 0;
+    if (_policy.IoClass == "realtime") {
+        IoPriorityValue = (IoprioClassRealtime << IoprioClassShift) | _policy.IoPriority;
+    } else if (_policy.IoClass == "best-effort") {
+        IoPriorityValue = (IoprioClassBestEffort << IoprioClassShift) | _policy.IoPriority;
+    } else if (_policy.IoClass == "idle") {
+        IoPriorityValue = IoprioClassIdle << IoprioClassShift;
+    }
+
+    OomScoreLength = 0;
+    OomScoreText[0] = '\0';
+    if (_policy.OomScoreAdj != LaunchPolicy::Inherit) {
+        OomScoreLength = snprintf(OomScoreText, sizeof(OomScoreText), "%d\n", _policy.OomScoreAdj);
+    }
+
+    return true;
+}
+
+int A_launchpolicy::Apply() const
+{
+    if (HasAffinity && sched_setaffinity(0, sizeof(Affinity), &Affinity) != 0) {
+        return AffinityStep;
+    }
+
+    // Preferred rather than bound, so a full node spills over instead of invoking the OOM killer
+    if (Policy.NumaNode >= 0 &&
+        syscall(SYS_set_mempolicy, MPOL_PREFERRED, NodeMask, (unsigned long)(8 * sizeof(NodeMask))) != 0) {
+        return MemoryStep;
+    }
+
+    if (Policy.Nice != LaunchPolicy::Inherit && setpriority(PRIO_PROCESS, 0, Policy.Nice) != 0) {
+        return NiceStep;
+    }
+
+    if (IoPriorityValue != 0 && syscall(SYS_ioprio_set, IoprioWhoProcess, 0, IoPriorityValue) != 0) {
+        return IoPriorityStep;
+    }
+
+    if (OomScoreLength > 0) {
+        const int _fd = ::open("/proc/self/oom_score_adj", O_WRONLY | O_CLOEXEC);
+        if (_fd < 0) {
+            return OomScoreStep;
+        }
+        const bool _written = ::write(_fd, OomScoreText, size_t(OomScoreLength)) == OomScoreLength;
+        const int _error = errno;
+        ::close(_fd);
+        if (!_written) {
+            errno = _error;
+            return OomScoreStep;
+        }
+    }
+
+    return NoStep;
+}
+
+QString A_launchpolicy::Verify(qint64 _processId, bool* _ok) const
+{
+    const QString _procDir = QString("/proc/%1").arg(_processId);
+    QStringList _lines;
+    bool _allOk = true;
+
+    auto _report = [&_lines, &_allOk](const QString& _setting, const QString& _expected, const QString& _actual) {
+        if (_actual == _expected) {
+            _lines.append(_setting + " " + _expected + ": ok");
+        } else {
+            _lines.append(_setting + " " + _expected + ": got " + (_actual.isEmpty() ? QString("?") : _actual));
+            _allOk = false;
+        }
+    };
+
+    if (HasAffinity) {
+        // Compare masks, not text - the kernel may write the same set differently
+        QString _actual;
+        const QList<QByteArray> _status = ReadSmallFile(_procDir + "/status").split('\n');
+        for (const QByteArray& _line : _status) {
+            if (_line.startsWith("Cpus_allowed_list:")) {
+                _actual = QString::fromLatin1(_line.mid(18)).trimmed();
+                break;
+            }
+        }
+        QVector<int> _cpus;
+        cpu_set_t _actualMask;
+        CPU_ZERO(&_actualMask);
+        if (ParseCpuList(_actual, &_cpus)) {
+            for (int _cpu : _cpus) {
+                if (_cpu < CPU_SETSIZE) {
+                    CPU_SET(_cpu, &_actualMask);
+                }
+            }
+        }
+        const QString _expected = FormatCpuList(Affinity);
+        _report("cpus", _expected, CPU_EQUAL(&_actualMask, &Affinity) ? _expected : _actual);
+    }
+
+    if (Policy.NumaNode >= 0) {
+        // Every mapping line names its policy; the first is enough
+        const QByteArray _numaMaps = ReadSmallFile(_procDir + "/numa_maps");
+        const QByteArray _firstLine = _numaMaps.left(_numaMaps.indexOf('\n'));
+        const QList<QByteArray> _fields = _firstLine.split(' ');
+        const QString _expected = QString("prefer:%1").arg(Policy.NumaNode);
+        _report("numa", _expected, _fields.size() > 1 ? QString::fromLatin1(_fields.at(1)) : QString());
+    }
+
+    if (Policy.Nice != LaunchPolicy::Inherit) {
+        ProcessStat _stat;
+        _report("nice", QString::number(Policy.Nice),
+                A_procfsprocesstable::ReadStat(_processId, &_stat) ? QString::number(_stat.Nice) : QString());
+    }
+
+    if (IoPriorityValue != 0) {
+        const long _actual = syscall(SYS_ioprio_get, IoprioWhoProcess, int(_processId));
+        _report("ioprio", QString::number(IoPriorityValue), _actual >= 0 ? QString::number(_actual) : QString());
+    }
+
+    if (OomScoreLength > 0) {
+        _report("oom_score_adj", QString::number(Policy.OomScoreAdj),
+                QString::fromLatin1(ReadSmallFile(_procDir + "/oom_score_adj")).trimmed());
+    }
+
+    if (_ok) {
+        *_ok = _allOk;
+    }
+    return _lines.join('\n');
+}
+
+const char* A_launchpolicy::StepName(int _step)
+{
+    switch (_step) {
+    case AffinityStep:   return "cpu affinity";
+    case MemoryStep:     return "numa memory policy";
+    case NiceStep:       return "nice";
+    case IoPriorityStep: return "io priority";
+    case OomScoreStep:   return "oom_score_adj";
+    default:             return "none";
+    }
+}
+
+bool A_launchpolicy::ParseCpuList(const QString& _list, QVector<int>* _cpus)
+{
+    _cpus->clear();
+    const QStringList _parts = _list.split(',', Qt::SkipEmptyParts);
+    for (const QString& _part : _parts) {
+        const int _dash = _part.indexOf('-');
+        bool _okFirst = false;
+        bool _okLast = true;
+        const int _first = (_dash >= 0 ? _part.left(_dash) : _part).trimmed().toInt(&_okFirst);
+        const int _last = _dash >= 0 ? _part.mid(_dash + 1).trimmed().toInt(&_okLast) : _first;
+        if (!_okFirst || !_okLast || _first < 0 || _last < _first || _last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (int _cpu = _first; _cpu <= _last; ++_cpu) {
+            _cpus->append(_cpu);
+        }
+    }
+    std::sort(_cpus->begin(), _cpus->end());
+    return !_cpus->isEmpty();
+}
+
+QString A_launchpolicy::FormatCpuList(const cpu_set_t& _mask)
+{
+    QStringList _ranges;
+    for (int _cpu = 0; _cpu < CPU_SETSIZE; ++_cpu) {
+        if (!CPU_ISSET(_cpu, &_mask)) {
+            continue;
+        }
+        int _last = _cpu;
+        while (_last + 1 < CPU_SETSIZE && CPU_ISSET(_last + 1, &_mask)) {
+            ++_last;
+        }
+        _ranges.append(_last == _cpu ? QString::number(_cpu) : QString("%1-%2").arg(_cpu).arg(_last));
+        _cpu = _last;
+    }
+    return _ranges.join(',');
+}
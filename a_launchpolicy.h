@@ -0,0 +1,93 @@
+#ifndef A_LAUNCHPOLICY_H
+#define A_LAUNCHPOLICY_H
+
+#include <QString>
+#include <QVector>
+#include <QDebug>
+#include <sched.h>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Applies a LaunchPolicy inside a freshly forked child and checks it afterwards
+ *
+ * Prepare() does all parsing and file reading in the parent, before fork.
+ * Apply() then only issues system calls on precomputed values, so it is
+ * async-signal-safe and can run between fork and exec; every setting it
+ * makes survives exec. If any step fails the child exits instead of running
+ * with a partial policy. Verify() reads the settings of the running process
+ * back from /proc.
+ */
+class A_launchpolicy
+{
+public:
+    static constexpr int MaxNumaNodes = 1024;   // Highest NUMA node number accepted + 1
+
+    /**
+     * @brief Policy steps - reported by Apply() when one fails
+     */
+    enum Step {
+        NoStep = 0,         // Everything applied
+        AffinityStep,       // sched_setaffinity
+        MemoryStep,         // set_mempolicy
+        NiceStep,           // setpriority
+        IoPriorityStep,     // ioprio_set
+        OomScoreStep        // /proc/self/oom_score_adj
+    };
+
+    A_launchpolicy();
+
+    /**
+     * @brief Precomputes everything Apply() needs
+     * @param _policy Policy to apply - unset fields are left alone
+     * @return bool False if the CPU list or NUMA node cannot be resolved
+     */
+    bool Prepare(const LaunchPolicy& _policy);
+
+    /**
+     * @brief Applies the prepared policy to the calling process
+     * Async-signal-safe - call between fork and exec.
+     * @return int NoStep on success, otherwise the failed Step with errno set
+     */
+    int Apply() const;
+
+    /**
+     * @brief Checks that a running process carries the prepared policy
+     * @param _processId Process to inspect
+     * @param _ok Receives false if any setting differs
+     * @return QString One "<setting>: ok" or "<setting>: got <value>" line per set field
+     */
+    QString Verify(qint64 _processId, bool* _ok) const;
+
+    /**
+     * @brief Gets a readable name for a Step
+     * @param _step Step value
+     * @return const char* Short name
+     */
+    static const char* StepName(int _step);
+
+    /**
+     * @brief Parses a kernel-style CPU list
+     * @param _list List text - "0-3,8,10-11" form
+     * @param _cpus Receives the CPU numbers in ascending order
+     * @return bool True if the list is valid and not empty
+     */
+    static bool ParseCpuList(const QString& _list, QVector<int>* _cpus);
+
+private:
+    LaunchPolicy Policy;                // Prepared policy - for Verify()
+    bool HasAffinity;                   // Affinity is set
+    cpu_set_t Affinity;                 // CPU mask - from Cpus or the NUMA node's CPUs
+    unsigned long NodeMask[MaxNumaNodes / (8 * sizeof(unsigned long))]; // Preferred memory node mask
+    int IoPriorityValue;                // Encoded ioprio - 0 when inherited
+    char OomScoreText[16];              // oom_score_adj value as written - empty when inherited
+    int OomScoreLength;                 // Length of OomScoreText
+
+    /**
+     * @brief Formats a CPU mask as a kernel-style list
+     * @param _mask CPU mask
+     * @return QString "0-3,8" form
+     */
+    static QString FormatCpuList(const cpu_set_t& _mask);
+};
+
+#endif // A_LAUNCHPOLICY_H
@@ -0,0 +1,417 @@
+#include "a_logcapture.h"
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+
+namespace {
+
+QString SafeFileName(const QString& _appName)
+{
+    QString _name = _appName;
+    for (QChar& _char : _name) {
+        if (!_char.isLetterOrNumber() && _char != '-' && _char != '_' && _char != '.') {
+            _char = '_';
+        }
+    }
+    return _name.isEmpty() ? QString("_") : _name;
+}
+
+int QueuedBytes(int _pipeFd)
+{
+    int _queued = 0;
+    return ioctl(_pipeFd, FIONREAD, &_queued) == 0 ? _queued : -1;
+}
+
+} // namespace
+
+A_logcapture::A_logcapture()
+{
+    MaxFileBytes = 0;
+    MaxFiles = 0;
+    RingBytes = 0;
+    EpollFd = -1;
+    WakeFd = -1;
+    NullFd = -1;
+    Running = false;
+    SpliceToFile = true;
+    CaptureThread = nullptr;
+}
+
+A_logcapture::~A_logcapture()
+{
+    Close();
+}
+
+bool A_logcapture::Open(const QString& _directory, qint64 _maxFileBytes, int _maxFiles, int _ringBytes)
+{
+    Close();
+
+    if (!QDir().mkpath(_directory)) {
+        qDebug() << "Error: Cannot create log directory:" << _directory;
+        return false;
+    }
+
+    Directory = _directory;
+    MaxFileBytes = qMax<qint64>(ChunkBytes, _maxFileBytes);
+    MaxFiles = qMax(1, _maxFiles);
+    RingBytes = qMax(4096, _ringBytes);
+    SpliceToFile = true;
+
+    EpollFd = epoll_create1(EPOLL_CLOEXEC);
+    WakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    NullFd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if (EpollFd < 0 || WakeFd < 0 || NullFd < 0) {
+        qDebug() << "Error: Cannot set up output capture:" << strerror(errno);
+        Close();
+        return false;
+    }
+
+    epoll_event _event = {};
+    _event.events = EPOLLIN;
+    _event.data.ptr = nullptr; // Wake-up marker
+    epoll_ctl(EpollFd, EPOLL_CTL_ADD, WakeFd, &_event);
+
+    Running = true;
+    CaptureThread = QThread::create([this]() { CaptureLoop(); });
+    CaptureThread->setObjectName("qpm-logcapture");
+    CaptureThread->start();
+
+    qDebug() << "Output capture opened:" << Directory;
+    return true;
+}
+
+void A_logcapture::Close()
+{
+    if (CaptureThread) {
+        Running = false;
+        const quint64 _one = 1;
+        ssize_t _ignored = ::write(WakeFd, &_one, sizeof(_one));
+        (void)_ignored;
+        CaptureThread->wait();
+        delete CaptureThread;
+        CaptureThread = nullptr;
+    }
+
+    QMutexLocker _lock(&StateLock);
+    for (Stream* _stream : std::as_const(Streams)) {
+        ::close(_stream->ReadFd);
+        delete _stream;
+    }
+    Streams.clear();
+    for (Sink* _sink : std::as_const(Sinks)) {
+        ReleaseSink(_sink);
+    }
+    Sinks.clear();
+
+    for (int* _fd : { &EpollFd, &WakeFd, &NullFd }) {
+        if (*_fd >= 0) {
+            ::close(*_fd);
+            *_fd = -1;
+        }
+    }
+}
+
+int A_logcapture::CreatePipe(const QString& _appName)
+{
+    if (!IsOpen()) {
+        return -1;
+    }
+
+    Sink* _sink = SinkFor(_appName);
+    if (!_sink) {
+        return -1;
+    }
+
+    int _fds[2];
+    if (pipe2(_fds, O_CLOEXEC) != 0) {
+        qDebug() << "Error: Cannot create output pipe for:" << _appName << strerror(errno);
+        return -1;
+    }
+    // Only the capture side is non-blocking; the application keeps ordinary blocking writes
+    fcntl(_fds[0], F_SETFL, fcntl(_fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(_fds[0], F_SETPIPE_SZ, RingBytes);
+
+    Stream* _stream = new Stream;
+    _stream->ReadFd = _fds[0];
+    _stream->Target = _sink;
+    {
+        QMutexLocker _lock(&StateLock);
+        Streams.insert(_fds[0], _stream);
+    }
+
+    epoll_event _event = {};
+    _event.events = EPOLLIN;
+    _event.data.ptr = _stream;
+    if (epoll_ctl(EpollFd, EPOLL_CTL_ADD, _fds[0], &_event) != 0) {
+        qDebug() << "Error: Cannot watch output pipe for:" << _appName << strerror(errno);
+        QMutexLocker _lock(&StateLock);
+        Streams.remove(_fds[0]);
+        delete _stream;
+        ::close(_fds[0]);
+        ::close(_fds[1]);
+        return -1;
+    }
+
+    return _fds[1];
+}
+
+QByteArray A_logcapture::Tail(const QString& _appName, int _maxBytes) const
+{
+    Sink* _sink = nullptr;
+    {
+        QMutexLocker _lock(&StateLock);
+        _sink = Sinks.value(_appName, nullptr);
+    }
+    if (!_sink || _maxBytes <= 0) {
+        return QByteArray();
+    }
+
+    // Duplicate the ring into a scratch pipe so reading leaves the ring intact
+    QMutexLocker _ringLock(&_sink->RingLock);
+    int _scratch[2];
+    if (pipe2(_scratch, O_CLOEXEC | O_NONBLOCK) != 0) {
+        return QByteArray();
+    }
+    fcntl(_scratch[1], F_SETPIPE_SZ, _sink->RingCapacity);
+
+    QByteArray _tail;
+    const ssize_t _copied = tee(_sink->RingRead, _scratch[1], size_t(_sink->RingCapacity), SPLICE_F_NONBLOCK);
+    if (_copied > 0) {
+        _tail.resize(int(_copied));
+        qint64 _filled = 0;
+        while (_filled < _copied) {
+            const ssize_t _read = ::read(_scratch[0], _tail.data() + _filled, size_t(_copied - _filled));
+            if (_read <= 0) {
+                break;
+            }
+            _filled += _read;
+        }
+        _tail.truncate(int(_filled));
+    }
+    ::close(_scratch[0]);
+    ::close(_scratch[1]);
+
+    return _tail.size() > _maxBytes ? _tail.right(_maxBytes) : _tail;
+}
+
+QString A_logcapture::LogFilePath(const QString& _appName) const
+{
+    return IsOpen() ? Directory + "/" + SafeFileName(_appName) + ".log" : QString();
+}
+
+void A_logcapture::CaptureLoop()
+{
+    epoll_event _events[64];
+    while (Running) {
+        const int _count = epoll_wait(EpollFd, _events, 64, -1);
+        if (_count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qDebug() << "Error: Output capture stopped:" << strerror(errno);
+            break;
+        }
+
+        for (int _i = 0; _i < _count; ++_i) {
+            Stream* _stream = static_cast<Stream*>(_events[_i].data.ptr);
+            if (!_stream) {
+                quint64 _value = 0;
+                ssize_t _ignored = ::read(WakeFd, &_value, sizeof(_value));
+                (void)_ignored;
+                continue;
+            }
+
+            // Level-triggered: a pipe with data left over is reported again next round
+            if (!Drain(_stream)) {
+                epoll_ctl(EpollFd, EPOLL_CTL_DEL, _stream->ReadFd, nullptr);
+                QMutexLocker _lock(&StateLock);
+                Streams.remove(_stream->ReadFd);
+                ::close(_stream->ReadFd);
+                delete _stream;
+            }
+        }
+    }
+}
+
+bool A_logcapture::Drain(Stream* _stream)
+{
+    Sink* _sink = _stream->Target;
+    int _moved = 0;
+    bool _first = true;
+
+    while (_moved < ChunkBytes) {
+        const int _available = QueuedBytes(_stream->ReadFd);
+        if (_available <= 0) {
+            // Readable but empty on the first look means every writer has exited
+            return !_first && _available == 0;
+        }
+        _first = false;
+
+        // Chunks never exceed the ring, so the ring always ends with the newest bytes
+        const int _length = qMin(qMin(_available, ChunkBytes - _moved), _sink->RingCapacity);
+
+        if (SpliceToFile) {
+            FeedRing(_sink, _stream->ReadFd, nullptr, _length);
+            WriteFile(_sink, _stream->ReadFd, nullptr, _length);
+        } else {
+            if (CopyBuffer.size() < ChunkBytes) {
+                CopyBuffer.resize(ChunkBytes);
+            }
+            const ssize_t _read = ::read(_stream->ReadFd, CopyBuffer.data(), size_t(_length));
+            if (_read <= 0) {
+                return _read < 0 && errno == EAGAIN;
+            }
+            FeedRing(_sink, -1, CopyBuffer.constData(), int(_read));
+            WriteFile(_sink, -1, CopyBuffer.constData(), int(_read));
+        }
+        _moved += _length;
+    }
+    return true;
+}
+
+void A_logcapture::FeedRing(Sink* _sink, int _sourceFd, const char* _data, int _length)
+{
+    QMutexLocker _lock(&_sink->RingLock);
+
+    // Drop the oldest bytes so the new chunk fits
+    const int _excess = qMax(0, QueuedBytes(_sink->RingRead)) + _length - _sink->RingCapacity;
+    if (_excess > 0) {
+        splice(_sink->RingRead, nullptr, NullFd, nullptr, size_t(_excess), SPLICE_F_NONBLOCK);
+    }
+
+    for (int _attempt = 0; _attempt < 2; ++_attempt) {
+        const ssize_t _copied = _sourceFd >= 0
+            ? tee(_sourceFd, _sink->RingWrite, size_t(_length), SPLICE_F_NONBLOCK)
+            : ::write(_sink->RingWrite, _data, size_t(_length));
+        if (_copied >= 0 || errno != EAGAIN) {
+            return;
+        }
+        // Ring slots are full of small buffers - free half of it and try once more
+        splice(_sink->RingRead, nullptr, NullFd, nullptr, size_t(_sink->RingCapacity / 2), SPLICE_F_NONBLOCK);
+    }
+}
+
+bool A_logcapture::WriteFile(Sink* _sink, int _sourceFd, const char* _data, int _length)
+{
+    if (_sink->FileBytes > 0 && _sink->FileBytes + _length > MaxFileBytes) {
+        Rotate(_sink);
+    }
+
+    int _remaining = _length;
+    while (_remaining > 0 && _sink->FileFd >= 0) {
+        ssize_t _written = -1;
+        if (_sourceFd < 0) {
+            _written = ::write(_sink->FileFd, _data + (_length - _remaining), size_t(_remaining));
+        } else if (SpliceToFile) {
+            _written = splice(_sourceFd, nullptr, _sink->FileFd, nullptr, size_t(_remaining), SPLICE_F_MOVE);
+            if (_written < 0 && errno == EINVAL) {
+                // Filesystem without splice support - copy through user space from now on
+                qDebug() << "Output capture: splice unsupported in" << Directory << "- using read/write";
+                SpliceToFile = false;
+                continue;
+            }
+        } else {
+            char _buffer[16384];
+            const ssize_t _read = ::read(_sourceFd, _buffer, size_t(qMin<int>(_remaining, sizeof(_buffer))));
+            if (_read <= 0) {
+                break;
+            }
+            _written = ::write(_sink->FileFd, _buffer, size_t(_read));
+            _written = _written < 0 ? -1 : _read; // The chunk left the pipe either way
+        }
+
+        if (_written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        _sink->FileBytes += _written;
+        _remaining -= int(_written);
+    }
+
+    if (_remaining == 0) {
+        return true;
+    }
+
+    if (!_sink->WriteFailed) {
+        qDebug() << "Warning: Dropping captured output for" << _sink->FilePath << "-" << strerror(errno);
+        _sink->WriteFailed = true;
+    }
+    // Always consume the chunk so a failing disk cannot spin the capture loop
+    if (_sourceFd >= 0) {
+        splice(_sourceFd, nullptr, NullFd, nullptr, size_t(_remaining), 0);
+    }
+    return false;
+}
+
+void A_logcapture::Rotate(Sink* _sink)
+{
+    if (_sink->FileFd >= 0) {
+        ::close(_sink->FileFd);
+        _sink->FileFd = -1;
+    }
+
+    // <app>.log.(N-1) is dropped, every other file moves up by one
+    const QByteArray _base = QFile::encodeName(_sink->FilePath);
+    for (int _i = MaxFiles - 1; _i >= 1; --_i) {
+        const QByteArray _from = _i == 1 ? _base : _base + "." + QByteArray::number(_i - 1);
+        const QByteArray _to = _base + "." + QByteArray::number(_i);
+        ::rename(_from.constData(), _to.constData());
+    }
+    if (MaxFiles == 1) {
+        ::unlink(_base.constData());
+    }
+
+    _sink->FileFd = ::open(_base.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    _sink->FileBytes = 0;
+    _sink->WriteFailed = false;
+}
+
+A_logcapture::Sink* A_logcapture::SinkFor(const QString& _appName)
+{
+    QMutexLocker _lock(&StateLock);
+    auto _it = Sinks.constFind(_appName);
+    if (_it != Sinks.constEnd()) {
+        return _it.value();
+    }
+
+    Sink* _sink = new Sink;
+    _sink->FilePath = Directory + "/" + SafeFileName(_appName) + ".log";
+
+    // No O_APPEND: splice(2) refuses append-mode targets, so write at the tracked end instead
+    _sink->FileFd = ::open(QFile::encodeName(_sink->FilePath).constData(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    int _ring[2] = { -1, -1 };
+    if (_sink->FileFd < 0 || pipe2(_ring, O_CLOEXEC | O_NONBLOCK) != 0) {
+        qDebug() << "Error: Cannot open output log:" << _sink->FilePath << strerror(errno);
+        ReleaseSink(_sink);
+        return nullptr;
+    }
+    _sink->FileBytes = qMax<qint64>(0, lseek(_sink->FileFd, 0, SEEK_END));
+    _sink->RingRead = _ring[0];
+    _sink->RingWrite = _ring[1];
+    fcntl(_sink->RingWrite, F_SETPIPE_SZ, RingBytes);
+    _sink->RingCapacity = qMax(4096, fcntl(_sink->RingWrite, F_GETPIPE_SZ));
+
+    Sinks.insert(_appName, _sink);
+    return _sink;
+}
+
+void A_logcapture::ReleaseSink(Sink* _sink)
+{
+    for (int _fd : { _sink->FileFd, _sink->RingRead, _sink->RingWrite }) {
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+    }
+    delete _sink;
+}
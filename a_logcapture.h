@@ -0,0 +1,169 @@
+#ifndef A_LOGCAPTURE_H
+#define A_LOGCAPTURE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QDebug>
+#include <atomic>
+
+/**
+ * @brief Captures application stdout/stderr into rotated log files and ring buffers
+ *
+ * Every launch gets a pipe whose write end becomes the child's stdout and
+ * stderr. The read ends are watched by epoll on a dedicated capture thread,
+ * so output volume never delays the supervision loop. Data is moved with
+ * tee(2) into a per-application ring pipe (the in-memory tail, kept in the
+ * kernel) and splice(2) into the log file, so captured bytes never pass
+ * through user space. Filesystems without splice support fall back to
+ * read/write. Each wakeup moves at most ChunkBytes per pipe, so one chatty
+ * application cannot starve the others; a full disk or slow file only
+ * back-pressures the application writing to it.
+ */
+class A_logcapture
+{
+public:
+    static constexpr int ChunkBytes = 256 * 1024;   // Bytes moved per pipe per wakeup - fairness bound
+
+    A_logcapture();
+    ~A_logcapture();
+
+    /**
+     * @brief Starts capturing into a directory
+     * @param _directory Log directory - created if missing, holds <app>.log files
+     * @param _maxFileBytes Size at which a log file is rotated
+     * @param _maxFiles Files kept per application - <app>.log plus rotated <app>.log.N
+     * @param _ringBytes In-memory tail per application - rounded up by the kernel to whole pages
+     * @return bool True if the capture thread is running
+     */
+    bool Open(const QString& _directory, qint64 _maxFileBytes = 8 * 1024 * 1024, int _maxFiles = 4,
+              int _ringBytes = 256 * 1024);
+
+    /**
+     * @brief Stops the capture thread and closes all pipes and files
+     * Output still buffered in open pipes is discarded.
+     */
+    void Close();
+
+    /**
+     * @brief Checks whether output is being captured
+     * @return bool True if open
+     */
+    bool IsOpen() const { return EpollFd >= 0; }
+
+    /**
+     * @brief Creates the output pipe for one launch of an application
+     * The caller passes the descriptor to the child as stdout/stderr and then
+     * closes it; capture of that launch ends when every writer has exited.
+     * @param _appName Application name - selects the log file and ring buffer
+     * @return int Write end of the pipe - close-on-exec, -1 on error or when closed
+     */
+    int CreatePipe(const QString& _appName);
+
+    /**
+     * @brief Reads the newest captured output of an application
+     * @param _appName Application name
+     * @param _maxBytes Maximum bytes returned - the newest ones are kept
+     * @return QByteArray Captured output - empty if nothing was captured
+     */
+    QByteArray Tail(const QString& _appName, int _maxBytes = 64 * 1024) const;
+
+    /**
+     * @brief Gets the current log file of an application
+     * @param _appName Application name
+     * @return QString Path of <app>.log - empty when closed
+     */
+    QString LogFilePath(const QString& _appName) const;
+
+private:
+    /**
+     * @brief Per-application destination of captured output
+     */
+    struct Sink {
+        QString FilePath;           // Current log file - <dir>/<app>.log
+        int FileFd = -1;            // Log file - written at FileBytes
+        qint64 FileBytes = 0;       // Current log file size - rotation trigger
+        int RingRead = -1;          // Ring pipe read end - holds the newest output
+        int RingWrite = -1;         // Ring pipe write end - tee target
+        int RingCapacity = 0;       // Ring pipe size - bytes
+        bool WriteFailed = false;   // Set after a failed file write - logged once
+        mutable QMutex RingLock;    // Serializes ring trimming and Tail() reads
+    };
+
+    /**
+     * @brief One launch's output pipe
+     */
+    struct Stream {
+        int ReadFd = -1;            // Pipe read end - registered with epoll
+        Sink* Target = nullptr;     // Destination - owned by Sinks
+    };
+
+    QString Directory;                  // Log directory
+    qint64 MaxFileBytes;                // Rotation size - bytes
+    int MaxFiles;                       // Files kept per application
+    int RingBytes;                      // Requested ring pipe size - bytes
+    int EpollFd;                        // Readiness of all stream pipes - -1 when closed
+    int WakeFd;                         // eventfd - interrupts epoll_wait on Close()
+    int NullFd;                         // /dev/null - splice target when trimming rings
+    std::atomic<bool> Running;          // Capture thread keeps polling while true
+    std::atomic<bool> SpliceToFile;     // Cleared when the filesystem rejects splice
+    QThread* CaptureThread;             // Runs CaptureLoop()
+    QByteArray CopyBuffer;              // Read/write fallback buffer - capture thread only
+    mutable QMutex StateLock;           // Guards Sinks and Streams - Sink pointers stay valid until Close()
+    QHash<QString, Sink*> Sinks;        // Destinations - key: app name
+    QHash<int, Stream*> Streams;        // Open launch pipes - key: read fd
+
+    /**
+     * @brief Capture thread body - waits on epoll and drains ready pipes
+     */
+    void CaptureLoop();
+
+    /**
+     * @brief Moves up to ChunkBytes from a pipe into its sink
+     * @param _stream Ready stream
+     * @return bool False once the pipe reached end-of-file or failed
+     */
+    bool Drain(Stream* _stream);
+
+    /**
+     * @brief Copies a chunk into a ring pipe, discarding the oldest bytes if it is full
+     * @param _sink Destination sink
+     * @param _sourceFd Pipe holding the chunk - tee source, or -1 to write _data
+     * @param _data Chunk bytes - used only when _sourceFd is -1
+     * @param _length Chunk size - bytes
+     */
+    void FeedRing(Sink* _sink, int _sourceFd, const char* _data, int _length);
+
+    /**
+     * @brief Writes a chunk to the log file, rotating first if it would exceed MaxFileBytes
+     * @param _sink Destination sink
+     * @param _sourceFd Pipe holding the chunk - splice source, or -1 to write _data
+     * @param _data Chunk bytes - used only when _sourceFd is -1
+     * @param _length Chunk size - bytes
+     * @return bool False if the file could not be written
+     */
+    bool WriteFile(Sink* _sink, int _sourceFd, const char* _data, int _length);
+
+    /**
+     * @brief Shifts <app>.log to <app>.log.1 and so on, then opens a fresh file
+     * @param _sink Sink whose file is rotated
+     */
+    void Rotate(Sink* _sink);
+
+    /**
+     * @brief Finds or creates the sink of an application
+     * @param _appName Application name
+     * @return Sink* Sink, or nullptr if its file or ring could not be created
+     */
+    Sink* SinkFor(const QString& _appName);
+
+    /**
+     * @brief Closes a sink's descriptors
+     * @param _sink Sink to release - deleted
+     */
+    static void ReleaseSink(Sink* _sink);
+};
+
+#endif // A_LOGCAPTURE_H
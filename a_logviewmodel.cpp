@@ -0,0 +1,476 @@
+#include "a_logviewmodel.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+/**
+ * @brief Finds the last occurrence of a byte string
+ * @param _base Range start
+ * @param _length Range length - bytes
+ * @param _needle Bytes to find - not empty
+ * @return const char* Start of the last match, or nullptr
+ */
+const char* LastOccurrence(const char* _base, qint64 _length, const QByteArray& _needle)
+{
+    qint64 _lastStart = _length - _needle.size();
+    while (_lastStart >= 0) {
+        const char* _candidate = static_cast<const char*>(memrchr(_base, _needle.at(0), size_t(_lastStart + 1)));
+        if (!_candidate) {
+            return nullptr;
+        }
+        if (memcmp(_candidate, _needle.constData(), size_t(_needle.size())) == 0) {
+            return _candidate;
+        }
+        _lastStart = _candidate - _base - 1;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+A_logviewmodel::A_logviewmodel(QObject *parent) : QAbstractListModel(parent)
+{
+    FileFd = -1;
+    FileInode = 0;
+    Map = nullptr;
+    MappedSize = 0;
+    ShrinkSeen = false;
+    LineCount = 0;
+    Indexed = 0;
+    Indexer = nullptr;
+    StopIndexing = false;
+    PublishedRows = 0;
+    PartialRowShown = false;
+    SearchOffset = 0;
+    SearchForward = true;
+
+    PublishTimer = new QTimer(this);
+    PublishTimer->setInterval(100);
+    connect(PublishTimer, &QTimer::timeout, this, &A_logviewmodel::PublishRows);
+
+    FollowTimer = new QTimer(this);
+    FollowTimer->setInterval(FollowIntervalMs);
+    connect(FollowTimer, &QTimer::timeout, this, &A_logviewmodel::CheckGrowth);
+
+    SearchTimer = new QTimer(this);
+    SearchTimer->setInterval(0);
+    connect(SearchTimer, &QTimer::timeout, this, &A_logviewmodel::ContinueSearch);
+}
+
+A_logviewmodel::~A_logviewmodel()
+{
+    Close();
+}
+
+bool A_logviewmodel::Open(const QString& _filePath)
+{
+    Close();
+
+    FilePath = _filePath;
+    FileFd = ::open(QFile::encodeName(_filePath).constData(), O_RDONLY | O_CLOEXEC);
+    struct stat _stat;
+    if (FileFd < 0 || fstat(FileFd, &_stat) != 0) {
+        qDebug() << "Error: Cannot open log file:" << _filePath << strerror(errno);
+        Close();
+        return false;
+    }
+    FileInode = quint64(_stat.st_ino);
+
+    if (!MapFile()) {
+        Close();
+        return false;
+    }
+
+    {
+        QMutexLocker _lock(&IndexLock);
+        Checkpoints = { 0 };
+        LineCount = 0;
+        Indexed = 0;
+    }
+
+    // The first screen comes from a synchronous scan; the rest is indexed in the background
+    IndexRange(0, qMin(MappedSize, InitialIndexBytes));
+    PublishRows();
+    StartIndexer();
+    return true;
+}
+
+void A_logviewmodel::Close()
+{
+    CancelSearch();
+    StopIndexer();
+
+    beginResetModel();
+    UnmapFile();
+    if (FileFd >= 0) {
+        ::close(FileFd);
+        FileFd = -1;
+    }
+    {
+        QMutexLocker _lock(&IndexLock);
+        Checkpoints.clear();
+        LineCount = 0;
+        Indexed = 0;
+    }
+    PublishedRows = 0;
+    PartialRowShown = false;
+    endResetModel();
+}
+
+void A_logviewmodel::SetFollow(bool _follow)
+{
+    if (_follow) {
+        FollowTimer->start();
+    } else {
+        FollowTimer->stop();
+    }
+}
+
+qint64 A_logviewmodel::IndexedBytes() const
+{
+    QMutexLocker _lock(&IndexLock);
+    return Indexed;
+}
+
+bool A_logviewmodel::MapFile()
+{
+    struct stat _stat;
+    if (fstat(FileFd, &_stat) != 0) {
+        return false;
+    }
+
+    MappedSize = qint64(_stat.st_size);
+    if (MappedSize == 0) {
+        Map = nullptr;
+        return true;
+    }
+
+    void* _map = mmap(nullptr, size_t(MappedSize), PROT_READ, MAP_SHARED, FileFd, 0);
+    if (_map == MAP_FAILED) {
+        qDebug() << "Error: Cannot map log file:" << FilePath << strerror(errno);
+        Map = nullptr;
+        MappedSize = 0;
+        return false;
+    }
+    Map = static_cast<const char*>(_map);
+    return true;
+}
+
+void A_logviewmodel::UnmapFile()
+{
+    if (Map) {
+        munmap(const_cast<char*>(Map), size_t(MappedSize));
+    }
+    Map = nullptr;
+    MappedSize = 0;
+    ShrinkSeen = false;
+}
+
+qint64 A_logviewmodel::ReadableSize() const
+{
+    struct stat _stat;
+    if (!Map || fstat(FileFd, &_stat) != 0) {
+        return 0;
+    }
+    if (qint64(_stat.st_size) >= MappedSize) {
+        return MappedSize;
+    }
+
+    // Truncated behind our back - only the part still in the file may be touched
+    if (!ShrinkSeen.exchange(true)) {
+        QMetaObject::invokeMethod(const_cast<A_logviewmodel*>(this), "CheckGrowth", Qt::QueuedConnection);
+    }
+    return qint64(_stat.st_size);
+}
+
+bool A_logviewmodel::IndexRange(qint64 _from, qint64 _to)
+{
+    qint64 _lines = 0;
+    {
+        QMutexLocker _lock(&IndexLock);
+        _lines = LineCount;
+    }
+
+    QVector<qint64> _checkpoints;
+    qint64 _position = _from;
+    while (_position < _to) {
+        const qint64 _sliceEnd = qMin(_to, _position + IndexSliceBytes);
+        if (ReadableSize() < _sliceEnd) {
+            return false; // Truncated - the reopen indexes the file again
+        }
+        const char* _cursor = Map + _position;
+        const char* const _end = Map + _sliceEnd;
+        while (_cursor < _end) {
+            const char* _newline = static_cast<const char*>(memchr(_cursor, '\n', size_t(_end - _cursor)));
+            if (!_newline) {
+                break;
+            }
+            _cursor = _newline + 1;
+            if (++_lines % CheckpointInterval == 0) {
+                _checkpoints.append(_cursor - Map);
+            }
+        }
+
+        {
+            QMutexLocker _lock(&IndexLock);
+            Checkpoints += _checkpoints;
+            LineCount = _lines;
+            Indexed = _sliceEnd;
+        }
+        _checkpoints.clear();
+        _position = _sliceEnd;
+
+        if (StopIndexing) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void A_logviewmodel::StartIndexer()
+{
+    if (Indexer || !Map) {
+        return;
+    }
+
+    const qint64 _from = IndexedBytes();
+    const qint64 _to = MappedSize;
+    if (_from >= _to) {
+        PublishRows();
+        return;
+    }
+
+    StopIndexing = false;
+    QThread* _thread = QThread::create([this, _from, _to]() { IndexRange(_from, _to); });
+    Indexer = _thread;
+    connect(_thread, &QThread::finished, this, [this, _thread]() {
+        if (Indexer == _thread) {
+            Indexer = nullptr;
+            _thread->deleteLater();
+            PublishRows();
+        }
+    });
+    _thread->start(QThread::LowPriority);
+    PublishTimer->start();
+}
+
+void A_logviewmodel::StopIndexer()
+{
+    PublishTimer->stop();
+    if (!Indexer) {
+        return;
+    }
+    StopIndexing = true;
+    Indexer->wait();
+    Indexer->deleteLater();
+    Indexer = nullptr;
+}
+
+qint64 A_logviewmodel::LineStart(qint64 _row) const
+{
+    qint64 _offset = 0;
+    {
+        QMutexLocker _lock(&IndexLock);
+        const qint64 _checkpoint = qMin<qint64>(_row / CheckpointInterval, Checkpoints.size() - 1);
+        if (_checkpoint < 0) {
+            return 0;
+        }
+        _offset = Checkpoints.at(int(_checkpoint));
+        _row -= _checkpoint * CheckpointInterval;
+    }
+
+    const qint64 _size = ReadableSize();
+    for (; _row > 0 && _offset < _size; --_row) {
+        const char* _newline = static_cast<const char*>(memchr(Map + _offset, '\n', size_t(_size - _offset)));
+        if (!_newline) {
+            return _size;
+        }
+        _offset = _newline + 1 - Map;
+    }
+    return _offset;
+}
+
+qint64 A_logviewmodel::RowOfOffset(qint64 _offset) const
+{
+    qint64 _checkpoint = 0;
+    qint64 _position = 0;
+    {
+        QMutexLocker _lock(&IndexLock);
+        auto _it = std::upper_bound(Checkpoints.constBegin(), Checkpoints.constEnd(), _offset);
+        _checkpoint = qMax<qint64>(0, (_it - Checkpoints.constBegin()) - 1);
+        _position = Checkpoints.isEmpty() ? 0 : Checkpoints.at(int(_checkpoint));
+    }
+
+    qint64 _row = _checkpoint * CheckpointInterval;
+    _offset = qMin(_offset, ReadableSize());
+    while (_position < _offset) {
+        const char* _newline = static_cast<const char*>(memchr(Map + _position, '\n', size_t(_offset - _position)));
+        if (!_newline) {
+            break;
+        }
+        ++_row;
+        _position = _newline + 1 - Map;
+    }
+    return _row;
+}
+
+int A_logviewmodel::CurrentRowCount(bool* _partial) const
+{
+    qint64 _lines = 0;
+    qint64 _indexed = 0;
+    {
+        QMutexLocker _lock(&IndexLock);
+        _lines = LineCount;
+        _indexed = Indexed;
+    }
+
+    // A line still being written is shown once everything before it is indexed
+    *_partial = _indexed == MappedSize && LineStart(_lines) < MappedSize;
+    return int(qMin<qint64>(INT_MAX, _lines + (*_partial ? 1 : 0)));
+}
+
+void A_logviewmodel::PublishRows()
+{
+    if (!Indexer) {
+        PublishTimer->stop();
+    }
+
+    bool _partial = false;
+    const int _rows = CurrentRowCount(&_partial);
+
+    // A trailing partial line may have been extended or completed since it was shown
+    if (PartialRowShown && PublishedRows > 0) {
+        emit dataChanged(index(PublishedRows - 1), index(PublishedRows - 1), { Qt::DisplayRole });
+    }
+    if (_rows > PublishedRows) {
+        beginInsertRows(QModelIndex(), PublishedRows, _rows - 1);
+        PublishedRows = _rows;
+        endInsertRows();
+    }
+    PartialRowShown = _partial && _rows == PublishedRows;
+
+    emit IndexProgress(IndexedBytes(), MappedSize);
+}
+
+void A_logviewmodel::CheckGrowth()
+{
+    if (FileFd < 0) {
+        return;
+    }
+
+    struct stat _pathStat;
+    struct stat _mappedStat;
+    const bool _pathExists = ::stat(QFile::encodeName(FilePath).constData(), &_pathStat) == 0;
+    if (fstat(FileFd, &_mappedStat) != 0) {
+        return;
+    }
+
+    // Rotated away or truncated - follow the file now at the path, from its start
+    if ((_pathExists && quint64(_pathStat.st_ino) != FileInode) || qint64(_mappedStat.st_size) < MappedSize ||
+        ShrinkSeen) {
+        qDebug() << "Log file rotated, reopening:" << FilePath;
+        Open(FilePath);
+        return;
+    }
+
+    if (qint64(_mappedStat.st_size) > MappedSize && !Indexer) {
+        UnmapFile();
+        if (MapFile()) {
+            StartIndexer();
+        }
+    }
+}
+
+void A_logviewmodel::StartSearch(const QByteArray& _needle, int _fromRow, bool _forward)
+{
+    CancelSearch();
+    if (_needle.isEmpty() || !Map || PublishedRows == 0) {
+        emit SearchFinished(-1);
+        return;
+    }
+
+    SearchNeedle = _needle;
+    SearchForward = _forward;
+    SearchOffset = LineStart(qBound(0, _fromRow, PublishedRows - 1));
+    SearchTimer->start();
+}
+
+void A_logviewmodel::CancelSearch()
+{
+    SearchTimer->stop();
+    SearchNeedle.clear();
+}
+
+void A_logviewmodel::ContinueSearch()
+{
+    const qint64 _limit = qMin(IndexedBytes(), ReadableSize());
+    const qint64 _needleSize = SearchNeedle.size();
+    const char* _hit = nullptr;
+    bool _exhausted = false;
+
+    if (SearchForward) {
+        const qint64 _end = qMin(_limit, SearchOffset + SearchSliceBytes + _needleSize - 1);
+        if (_end - SearchOffset >= _needleSize) {
+            _hit = static_cast<const char*>(memmem(Map + SearchOffset, size_t(_end - SearchOffset),
+                                                   SearchNeedle.constData(), size_t(_needleSize)));
+        }
+        _exhausted = _end >= _limit;
+        SearchOffset = qMax(SearchOffset + 1, _end - _needleSize + 1);
+    } else {
+        // Matches must start before SearchOffset; the window overlaps it by the needle length
+        const qint64 _begin = qMax<qint64>(0, SearchOffset - SearchSliceBytes);
+        const qint64 _end = qMin(_limit, SearchOffset + _needleSize - 1);
+        if (_end - _begin >= _needleSize) {
+            _hit = LastOccurrence(Map + _begin, _end - _begin, SearchNeedle);
+        }
+        _exhausted = _begin == 0;
+        SearchOffset = _begin;
+    }
+
+    if (!_hit && !_exhausted) {
+        return; // Next slice on the next event loop pass
+    }
+
+    SearchTimer->stop();
+    int _row = -1;
+    if (_hit) {
+        // The indexer may be ahead of the rows views know about
+        PublishRows();
+        _row = int(qMin<qint64>(RowOfOffset(_hit - Map), PublishedRows - 1));
+    }
+    emit SearchFinished(_row);
+}
+
+int A_logviewmodel::rowCount(const QModelIndex& _parent) const
+{
+    return _parent.isValid() ? 0 : PublishedRows;
+}
+
+QVariant A_logviewmodel::data(const QModelIndex& _index, int _role) const
+{
+    if (_role != Qt::DisplayRole || !_index.isValid() || _index.row() >= PublishedRows || !Map) {
+        return QVariant();
+    }
+
+    const qint64 _start = LineStart(_index.row());
+    const qint64 _available = qMin<qint64>(ReadableSize() - _start, MaxLineBytes);
+    if (_available <= 0) {
+        return QString();
+    }
+    const char* _line = Map + _start;
+    const char* _newline = static_cast<const char*>(memchr(_line, '\n', size_t(_available)));
+    qint64 _length = _newline ? _newline - _line : _available;
+    if (_length > 0 && _line[_length - 1] == '\r') {
+        --_length;
+    }
+    return QString::fromUtf8(_line, int(_length));
+}
@@ -0,0 +1,208 @@
+#ifndef A_LOGVIEWMODEL_H
+#define A_LOGVIEWMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief List model showing one line of a memory-mapped log file per row
+ *
+ * The file is mapped read-only and never copied. Its line index is sparse -
+ * the start offset of every CheckpointInterval-th line - and is built by a
+ * background thread, so opening only has to scan the first InitialIndexBytes
+ * before the first screen can be shown. Rows are appended as indexing
+ * advances; data() finds a line by scanning forward from its checkpoint.
+ *
+ * With follow enabled the file is polled for growth and the new bytes are
+ * indexed the same way; a rotated or truncated file is reopened. Touching a
+ * mapped page past the end of a truncated file raises SIGBUS, so every read
+ * is first clamped to the size fstat() reports; a shrink found that way also
+ * schedules the reopen, with or without follow. Searches run
+ * over the mapping in SearchSliceBytes steps from the event loop, so they
+ * neither block the UI nor read the file into memory.
+ */
+class A_logviewmodel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CheckpointInterval = 64;                   // Lines per sparse index entry
+    static constexpr qint64 InitialIndexBytes = 1024 * 1024;        // Indexed synchronously by Open()
+    static constexpr qint64 IndexSliceBytes = 8 * 1024 * 1024;      // Indexed per published batch
+    static constexpr qint64 SearchSliceBytes = 16 * 1024 * 1024;    // Searched per event loop pass
+    static constexpr int MaxLineBytes = 4096;                       // Longer lines are cut for display
+    static constexpr int FollowIntervalMs = 500;                    // Growth poll interval in follow mode
+
+    explicit A_logviewmodel(QObject *parent = nullptr);
+    ~A_logviewmodel();
+
+    /**
+     * @brief Maps a log file and indexes its beginning
+     * @param _filePath Log file - may be empty but must exist
+     * @return bool True if the file is mapped and rows are available
+     */
+    bool Open(const QString& _filePath);
+
+    /**
+     * @brief Stops indexing and searching and unmaps the file
+     */
+    void Close();
+
+    /**
+     * @brief Enables or disables following the file as it grows
+     * @param _follow True to poll for appended data every FollowIntervalMs
+     */
+    void SetFollow(bool _follow);
+
+    /**
+     * @brief Gets the mapped file size
+     * @return qint64 Bytes mapped - 0 when closed
+     */
+    qint64 MappedBytes() const { return MappedSize; }
+
+    /**
+     * @brief Gets how much of the file has been indexed
+     * @return qint64 Bytes indexed - equal to MappedBytes() once indexing is done
+     */
+    qint64 IndexedBytes() const;
+
+    /**
+     * @brief Starts an incremental search
+     * Only indexed bytes are searched. Cancels a search in progress.
+     * @param _needle Bytes to find - case sensitive
+     * @param _fromRow Row the search starts at - included when searching forward
+     * @param _forward True to search towards the end of the file
+     */
+    void StartSearch(const QByteArray& _needle, int _fromRow, bool _forward);
+
+    /**
+     * @brief Cancels the search in progress
+     */
+    void CancelSearch();
+
+    // QAbstractListModel
+    int rowCount(const QModelIndex& _parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& _index, int _role = Qt::DisplayRole) const override;
+
+signals:
+    /**
+     * @brief Emitted when more of the file has been indexed
+     * @param indexedBytes Bytes indexed so far
+     * @param totalBytes Bytes mapped
+     */
+    void IndexProgress(qint64 indexedBytes, qint64 totalBytes);
+
+    /**
+     * @brief Emitted when a search ends
+     * @param row Row of the match - -1 if not found
+     */
+    void SearchFinished(int row);
+
+private slots:
+    /**
+     * @brief Publishes rows found by the indexer since the last call
+     */
+    void PublishRows();
+
+    /**
+     * @brief Remaps and indexes the file if it grew, reopens it if it was rotated
+     */
+    void CheckGrowth();
+
+    /**
+     * @brief Searches the next slice of the file
+     */
+    void ContinueSearch();
+
+private:
+    QString FilePath;                   // Mapped file
+    int FileFd;                         // Open file - -1 when closed
+    quint64 FileInode;                  // Inode of the mapped file - detects rotation
+    const char* Map;                    // Mapping base - null when closed or empty
+    qint64 MappedSize;                  // Mapping length - bytes
+    mutable std::atomic<bool> ShrinkSeen; // File found shorter than the mapping - reopen scheduled
+
+    // Index - written by the indexer thread, read under IndexLock
+    mutable QMutex IndexLock;           // Guards Checkpoints, LineCount and Indexed
+    QVector<qint64> Checkpoints;        // Start offset of lines 0, 64, 128, ...
+    qint64 LineCount;                   // Newline-terminated lines found
+    qint64 Indexed;                     // Bytes scanned
+
+    QThread* Indexer;                   // Background indexing pass - null when idle
+    std::atomic<bool> StopIndexing;     // Asks the indexer to return early
+    QTimer* PublishTimer;               // Publishes rows while the indexer runs
+    QTimer* FollowTimer;                // Growth poll in follow mode
+    int PublishedRows;                  // Rows announced to views
+    bool PartialRowShown;               // Last published row has no newline yet
+
+    QByteArray SearchNeedle;            // Bytes searched for
+    qint64 SearchOffset;                // Next byte to search - forward: slice start, backward: slice end
+    bool SearchForward;                 // Search direction
+    QTimer* SearchTimer;                // Zero-interval slice timer - active while searching
+
+    /**
+     * @brief Scans bytes for newlines and appends to the index
+     * Safe to call from the indexer thread; publishes results under IndexLock.
+     * @param _from First byte - must equal the indexed size
+     * @param _to End of the range - exclusive
+     * @return bool False if stopped early
+     */
+    bool IndexRange(qint64 _from, qint64 _to);
+
+    /**
+     * @brief Indexes the rest of the mapping on a background thread
+     */
+    void StartIndexer();
+
+    /**
+     * @brief Stops the background indexer and waits for it
+     */
+    void StopIndexer();
+
+    /**
+     * @brief Finds where a line starts
+     * @param _row Line number - must be below the indexed line count + 1
+     * @return qint64 Byte offset
+     */
+    qint64 LineStart(qint64 _row) const;
+
+    /**
+     * @brief Finds the line containing a byte
+     * @param _offset Byte offset - must be inside the indexed range
+     * @return qint64 Line number
+     */
+    qint64 RowOfOffset(qint64 _offset) const;
+
+    /**
+     * @brief Counts the rows views should show for the current index
+     * @param _partial Receives whether the last row lacks its newline
+     * @return int Row count - complete lines plus a trailing partial line once fully indexed
+     */
+    int CurrentRowCount(bool* _partial) const;
+
+    /**
+     * @brief Gets how much of the mapping is still backed by the file
+     * Safe to call from the indexer thread. A shrink schedules CheckGrowth().
+     * @return qint64 Bytes that may be read - at most MappedSize
+     */
+    qint64 ReadableSize() const;
+
+    /**
+     * @brief Maps the file at its current size
+     * @return bool True on success - an empty file maps to nothing
+     */
+    bool MapFile();
+
+    /**
+     * @brief Releases the mapping
+     */
+    void UnmapFile();
+};
+
+#endif // A_LOGVIEWMODEL_H
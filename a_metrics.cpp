@@ -0,0 +1,134 @@
+#include "a_metrics.h"
+#include "a_systeminterfaces.h"
+#include <QStringList>
+#include <unistd.h>
+
+A_latencyhistogram::A_latencyhistogram()
+{
+    Reset();
+}
+
+void A_latencyhistogram::Reset()
+{
+    for (auto& _bucket : Buckets) {
+        _bucket.store(0, std::memory_order_relaxed);
+    }
+    Count.store(0, std::memory_order_relaxed);
+    Sum.store(0, std::memory_order_relaxed);
+    Max.store(0, std::memory_order_relaxed);
+}
+
+LatencySnapshot A_latencyhistogram::Snapshot() const
+{
+    LatencySnapshot _snapshot;
+
+    // Copy the buckets first so percentiles are computed over one consistent total
+    quint64 _counts[BucketCount];
+    quint64 _total = 0;
+    for (int _i = 0; _i < BucketCount; ++_i) {
+        _counts[_i] = Buckets[_i].load(std::memory_order_relaxed);
+        _total += _counts[_i];
+    }
+
+    _snapshot.Count = _total;
+    _snapshot.MaxNs = Max.load(std::memory_order_relaxed);
+    if (_total == 0) {
+        return _snapshot;
+    }
+    _snapshot.MeanNs = Sum.load(std::memory_order_relaxed) / qMax<quint64>(1, Count.load(std::memory_order_relaxed));
+
+    const quint64 _p50Rank = (_total * 50 + 99) / 100;
+    const quint64 _p99Rank = (_total * 99 + 99) / 100;
+    quint64 _seen = 0;
+    for (int _i = 0; _i < BucketCount; ++_i) {
+        if (_counts[_i] == 0) {
+            continue;
+        }
+        _seen += _counts[_i];
+        if (_snapshot.P50Ns == 0 && _seen >= _p50Rank) {
+            _snapshot.P50Ns = BucketUpperBound(_i);
+        }
+        if (_seen >= _p99Rank) {
+            _snapshot.P99Ns = BucketUpperBound(_i);
+            break;
+        }
+    }
+
+    // Bucket bounds may overshoot the exact maximum
+    _snapshot.P50Ns = qMin(_snapshot.P50Ns, _snapshot.MaxNs);
+    _snapshot.P99Ns = qMin(_snapshot.P99Ns, _snapshot.MaxNs);
+    return _snapshot;
+}
+
+quint64 A_latencyhistogram::BucketUpperBound(int _index)
+{
+    if (_index < SubBucketCount) {
+        return quint64(_index);
+    }
+    const int _shift = (_index - SubBucketCount) / SubBucketCount;
+    const quint64 _sub = quint64((_index - SubBucketCount) % SubBucketCount);
+    const quint64 _lower = (quint64(SubBucketCount) + _sub) << _shift;
+    return _lower + ((quint64(1) << _shift) - 1);
+}
+
+A_latencyhistogram& A_metrics::Histogram(Metric _metric)
+{
+    static A_latencyhistogram _histograms[MetricCount];
+    return _histograms[_metric];
+}
+
+QString A_metrics::MetricName(Metric _metric)
+{
+    switch (_metric) {
+    case TickDuration:    return "tick";
+    case AppLookup:       return "lookup";
+    case Launch:          return "launch";
+    case Kill:            return "kill";
+    case ConfigSave:      return "save";
+    case SparklineRender: return "sparkline";
+    case MetricCount:     break;
+    }
+    return "unknown";
+}
+
+QString A_metrics::Dump()
+{
+    if (!IsEnabled()) {
+        return "Metrics disabled at compile time (QTPM_ENABLE_METRICS not defined)";
+    }
+
+    // Nanoseconds shown as microseconds with one decimal
+    auto _us = [](quint64 _ns) { return QString::number(double(_ns) / 1000.0, 'f', 1); };
+
+    QStringList _lines;
+    _lines << QString("%1 %2 %3 %4 %5 %6")
+                  .arg(QString("phase"), -10).arg(QString("count"), 10).arg(QString("p50(us)"), 12)
+                  .arg(QString("p99(us)"), 12).arg(QString("max(us)"), 12).arg(QString("mean(us)"), 12);
+    for (int _i = 0; _i < MetricCount; ++_i) {
+        const LatencySnapshot _snapshot = Histogram(Metric(_i)).Snapshot();
+        _lines << QString("%1 %2 %3 %4 %5 %6")
+                      .arg(MetricName(Metric(_i)), -10)
+                      .arg(_snapshot.Count, 10)
+                      .arg(_us(_snapshot.P50Ns), 12)
+                      .arg(_us(_snapshot.P99Ns), 12)
+                      .arg(_us(_snapshot.MaxNs), 12)
+                      .arg(_us(_snapshot.MeanNs), 12);
+    }
+    return _lines.join('\n');
+}
+
+void A_metrics::ResetAll()
+{
+    for (int _i = 0; _i < MetricCount; ++_i) {
+        Histogram(Metric(_i)).Reset();
+    }
+}
+
+qint64 A_metrics::ResidentKb()
+{
+    ProcessStat _stat;
+    if (!A_procfsprocesstable::ReadStatm(getpid(), &_stat)) {
+        return 0;
+    }
+    return qint64(_stat.ResidentPages) * (sysconf(_SC_PAGESIZE) / 1024);
+}
@@ -0,0 +1,194 @@
+#ifndef A_METRICS_H
+#define A_METRICS_H
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Summary of a latency histogram at one point in time
+ */
+struct LatencySnapshot {
+    quint64 Count = 0;      // Samples recorded
+    quint64 P50Ns = 0;      // Median - nanoseconds, bucket upper bound
+    quint64 P99Ns = 0;      // 99th percentile - nanoseconds, bucket upper bound
+    quint64 MaxNs = 0;      // Largest sample - nanoseconds, exact
+    quint64 MeanNs = 0;     // Average - nanoseconds
+};
+
+/**
+ * @brief Lock-free HDR-style latency histogram
+ *
+ * Values are bucketed log-linearly: 16 sub-buckets per power of two, which
+ * keeps every bucket within 6.25% of its value over the full 64-bit range.
+ * Recording is a handful of relaxed atomic increments, safe from any thread.
+ */
+class A_latencyhistogram
+{
+public:
+    static constexpr int SubBucketBits = 4;                        // 16 sub-buckets per power of two
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int BucketCount = SubBucketCount + (64 - SubBucketBits) * SubBucketCount;
+
+    A_latencyhistogram();
+
+    /**
+     * @brief Records one sample
+     * @param _valueNs Sample value - nanoseconds
+     */
+    void Record(quint64 _valueNs)
+    {
+        Buckets[BucketIndex(_valueNs)].fetch_add(1, std::memory_order_relaxed);
+        Count.fetch_add(1, std::memory_order_relaxed);
+        Sum.fetch_add(_valueNs, std::memory_order_relaxed);
+
+        quint64 _max = Max.load(std::memory_order_relaxed);
+        while (_valueNs > _max && !Max.compare_exchange_weak(_max, _valueNs, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Computes count, percentiles and max from the current buckets
+     * @return LatencySnapshot Summary - percentiles report the bucket upper bound
+     */
+    LatencySnapshot Snapshot() const;
+
+    /**
+     * @brief Clears all samples
+     */
+    void Reset();
+
+private:
+    std::atomic<quint64> Buckets[BucketCount];  // Sample counts - see BucketIndex()
+    std::atomic<quint64> Count;                 // Total samples
+    std::atomic<quint64> Sum;                   // Sum of samples - nanoseconds
+    std::atomic<quint64> Max;                   // Largest sample - nanoseconds
+
+    /**
+     * @brief Maps a value to its bucket
+     * Values below 16 map 1:1; larger values use the top 5 significant bits.
+     * @param _value Sample value
+     * @return int Bucket index in [0, BucketCount)
+     */
+    static int BucketIndex(quint64 _value)
+    {
+        if (_value < quint64(SubBucketCount)) {
+            return int(_value);
+        }
+        const int _msb = 63 - __builtin_clzll(_value);
+        const int _shift = _msb - SubBucketBits;
+        const int _sub = int(_value >> _shift) - SubBucketCount;
+        return SubBucketCount + _shift * SubBucketCount + _sub;
+    }
+
+    /**
+     * @brief Gets the largest value that maps to a bucket
+     * @param _index Bucket index
+     * @return quint64 Upper bound of the bucket - nanoseconds
+     */
+    static quint64 BucketUpperBound(int _index);
+};
+
+/**
+ * @brief Process-wide registry of hot-path latency histograms
+ */
+class A_metrics
+{
+public:
+    /**
+     * @brief Instrumented hot-path phases
+     */
+    enum Metric {
+        TickDuration = 0,   // Full CheckProcesses tick
+        AppLookup,          // FindProcessByExecutable per app
+        Launch,             // LaunchProcess
+        Kill,               // KillProcess including escalation
+        ConfigSave,         // A_settingsclass::SaveConfiguration
+        SparklineRender,    // Rendering one sparkline pixmap in the application list
+        MetricCount
+    };
+
+    /**
+     * @brief Gets the histogram of a phase
+     * @param _metric Phase to look up
+     * @return A_latencyhistogram& Process-wide histogram
+     */
+    static A_latencyhistogram& Histogram(Metric _metric);
+
+    /**
+     * @brief Gets a display name for a phase
+     * @param _metric Phase
+     * @return QString Short name - e.g. "tick"
+     */
+    static QString MetricName(Metric _metric);
+
+    /**
+     * @brief Formats all histograms as a table
+     * @return QString One line per phase with count, p50, p99, max and mean
+     */
+    static QString Dump();
+
+    /**
+     * @brief Clears all histograms
+     */
+    static void ResetAll();
+
+    /**
+     * @brief Reads the resident set size of this process
+     * Available whether or not instrumentation was compiled in.
+     * @return qint64 Resident memory - kilobytes, 0 if unavailable
+     */
+    static qint64 ResidentKb();
+
+    /**
+     * @brief Reports whether instrumentation was compiled in
+     * @return bool True if QTPM_ENABLE_METRICS was defined
+     */
+    static constexpr bool IsEnabled()
+    {
+#ifdef QTPM_ENABLE_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+};
+
+/**
+ * @brief Scope timer recording its lifetime into a histogram
+ *
+ * Uses the monotonic steady_clock, which reads through the vDSO on Linux.
+ */
+class A_metricscope
+{
+public:
+    explicit A_metricscope(A_metrics::Metric _metric)
+        : Target(A_metrics::Histogram(_metric)), Start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~A_metricscope()
+    {
+        const auto _elapsed = std::chrono::steady_clock::now() - Start;
+        Target.Record(quint64(std::chrono::duration_cast<std::chrono::nanoseconds>(_elapsed).count()));
+    }
+
+    A_metricscope(const A_metricscope&) = delete;
+    A_metricscope& operator=(const A_metricscope&) = delete;
+
+private:
+    A_latencyhistogram& Target;                        // Histogram receiving the sample
+    std::chrono::steady_clock::time_point Start;       // Scope entry time - monotonic
+};
+
+// Instrumentation compiles to nothing unless QTPM_ENABLE_METRICS is defined
+#define QTPM_METRIC_CONCAT_INNER(_a, _b) _a##_b
+#define QTPM_METRIC_CONCAT(_a, _b) QTPM_METRIC_CONCAT_INNER(_a, _b)
+#ifdef QTPM_ENABLE_METRICS
+#define QTPM_METRIC_SCOPE(_metric) A_metricscope QTPM_METRIC_CONCAT(_metricScope, __LINE__)(A_metrics::_metric)
+#else
+#define QTPM_METRIC_SCOPE(_metric) ((void)0)
+#endif
+
+#endif // A_METRICS_H
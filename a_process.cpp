@@ -1,8 +1,11 @@
 #include "a_process.h"
+#include "a_metrics.h"
+#include "a_tracer.h"
+#include "a_launchpolicy.h"
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
-#include <QThread>
-#include <QDateTime>
+#include <csignal>
 #include <unistd.h>
 
 A_process::A_process(QObject *parent) : QObject(parent)
@@ -13,6 +16,27 @@ A_process::A_process(QObject *parent) : QObject(parent)
     connect(MonitorTimer, &QTimer::timeout, this, &A_process::CheckProcesses);
 
     SettingsRef = nullptr;
+    StatusTable = nullptr;
+
+    // Real system access by default; simulators inject their own
+    ProcessTable = A_processtable::System();
+    SignalSender = A_signalsender::System();
+    Spawner = A_processspawner::System();
+    Clock = A_clock::System();
+
+    // Health probes restart hung applications through the normal restart path
+    HealthProbe = new A_healthprobe(this);
+    connect(HealthProbe, &A_healthprobe::ProbeFailed, this, &A_process::OnProbeFailed);
+
+    // Socket-activated applications are launched on their first connection
+    SocketActivator = new A_socketactivator(this);
+    connect(SocketActivator, &A_socketactivator::ActivationRequested, this, &A_process::OnActivationRequested);
+
+    // Run windows - the timer sleeps until the next transition instead of polling
+    ScheduleTimer = new QTimer(this);
+    ScheduleTimer->setSingleShot(true);
+    ScheduleTimer->setTimerType(Qt::PreciseTimer);
+    connect(ScheduleTimer, &QTimer::timeout, this, &A_process::OnScheduleTimer);
 
     qDebug() << "A_process initialized with 2-second monitoring interval";
 }
@@ -21,24 +45,35 @@ A_process::~A_process()
 {
     StopMonitoring();
 
-    // Clean up active processes
-    for (auto _it = ActiveProcesses.begin(); _it != ActiveProcesses.end(); ++_it) {
-        if (_it.value()) {
-            _it.value()->kill();
-            _it.value()->waitForFinished(3000);
-            delete _it.value();
-        }
-    }
-    ActiveProcesses.clear();
+    // Applications are detached and keep running - ShutdownApplications() stops them
+    delete StatusTable;
 }
 
 void A_process::SetSettingsReference(A_settingsclass* _settings)
 {
     SettingsRef = _settings;
+    SyncedConfig.reset();
     UpdateProcessMap();
     qDebug() << "Settings reference set and process map updated";
 }
 
+void A_process::SetSystemInterfaces(A_processtable* _processTable, A_signalsender* _signalSender,
+                                    A_processspawner* _spawner, A_clock* _clock)
+{
+    if (_processTable) {
+        ProcessTable = _processTable;
+    }
+    if (_signalSender) {
+        SignalSender = _signalSender;
+    }
+    if (_spawner) {
+        Spawner = _spawner;
+    }
+    if (_clock) {
+        Clock = _clock;
+    }
+}
+
 void A_process::StartMonitoring()
 {
     if (SettingsRef == nullptr) {
@@ -48,41 +83,175 @@ void A_process::StartMonitoring()
 
     UpdateProcessMap();
     MonitorTimer->start();
+    ArmScheduleTimer();
     qDebug() << "Process monitoring started";
 }
 
 void A_process::StopMonitoring()
 {
     MonitorTimer->stop();
+    ScheduleTimer->stop();
     qDebug() << "Process monitoring stopped";
 }
 
+bool A_process::OpenJournal(const QString& _directory)
+{
+    return Journal.Open(_directory);
+}
+
+QList<JournalRecord> A_process::QueryJournal(const QString& _appName, qint64 _fromMs, qint64 _toMs) const
+{
+    return Journal.Query(_appName, _fromMs, _toMs);
+}
+
+bool A_process::OpenLogCapture(const QString& _directory)
+{
+    return LogCapture.Open(_directory);
+}
+
+bool A_process::OpenStatusTable(const QString& _segmentName)
+{
+    if (StatusTable && (_segmentName.isEmpty() || StatusTable->SegmentName() == _segmentName)) {
+        return !StatusTable->SegmentName().isEmpty();
+    }
+
+    delete StatusTable;
+    StatusTable = new A_statustable(_segmentName);
+    if (StatusTable->SegmentName().isEmpty()) {
+        return false;
+    }
+    qDebug() << "Publishing status table:" << StatusTable->SegmentName();
+    PublishStatus();
+    return true;
+}
+
+bool A_process::OpenCheckpoint(const QString& _filePath)
+{
+    QElapsedTimer _adoptTimer;
+    _adoptTimer.start();
+
+    if (!Checkpoint.Open(_filePath)) {
+        return false;
+    }
+
+    // Adopted processes beat into the slot file of the previous run - one file per user and checkpoint
+    const QString _heartbeatName = QString("qtprocessmonitor-heartbeat-%1-%2")
+                                       .arg(getuid())
+                                       .arg(A_checkpoint::Hash(QFileInfo(_filePath).absoluteFilePath()), 8, 16, QChar('0'));
+    if (!Heartbeats.Open(_heartbeatName)) {
+        qDebug() << "Warning: Heartbeats of adopted applications cannot be watched";
+    }
+
+    // Records of applications no longer configured, or whose executable changed, are dropped
+    UpdateProcessMap();
+    const QHash<QString, CheckpointRecord> _records = Checkpoint.TakeRecords();
+    QStringList _adopted;
+    for (auto _it = _records.constBegin(); _it != _records.constEnd(); ++_it) {
+        const int _id = Apps.IdOf(_it.key());
+        const CheckpointRecord& _record = _it.value();
+        if (_id < 0 || Apps.Running.at(_id)
+            || _record.ExecutableHash != A_checkpoint::Hash(Apps.ExecutablePaths.at(_id))) {
+            continue;
+        }
+
+        Apps.RestartCounts[_id] = int(_record.RestartCount);
+        Apps.LastRestartMs[_id] = _record.LastRestartMs;
+        Apps.Parked[_id] = _record.Parked != 0;
+        Apps.ParkedProcessIds[_id] = _record.ParkedProcessId;
+        Apps.ReclaimedKb[_id] = _record.ReclaimedKb;
+
+        // A PID alone may have been reused; the kernel start time may not
+        if (_record.Running && _record.ProcessStartTicks != 0
+            && A_checkpoint::ProcessStartTicks(_record.ProcessId) == _record.ProcessStartTicks) {
+            Apps.Running[_id] = true;
+            Apps.ProcessIds[_id] = _record.ProcessId;
+            Apps.StartTimesMs[_id] = _record.StartTimeMs;
+            CheckLaunchPolicy(_id);
+            _adopted.append(_it.key());
+
+            const int _slot = int(_record.HeartbeatSlot) - 1;
+            if (_slot >= 0 && Heartbeats.Adopt(_it.key(), _slot, Clock->NowMs())) {
+                Apps.HeartbeatSlots[_id] = _slot;
+            } else if (Heartbeats.SlotOf(_it.key()) >= 0) {
+                qDebug() << "Warning: Heartbeat of adopted" << _it.key() << "not watched until its next launch";
+            }
+        }
+    }
+
+    qDebug() << "Adopted" << _adopted.size() << "running applications of" << _records.size()
+             << "checkpointed in" << _adoptTimer.elapsed() << "ms";
+    PublishStatus();
+    for (const QString& _appName : _adopted) {
+        emit ApplicationStatusChanged(_appName, true);
+    }
+    return true;
+}
+
+void A_process::PublishStatus()
+{
+    if (StatusTable) {
+        StatusTable->Publish(Apps, Clock->NowMs());
+    }
+    Checkpoint.Write(Apps, Clock->NowMs());
+}
+
+QByteArray A_process::GetApplicationOutput(const QString& _appName, int _maxBytes) const
+{
+    return LogCapture.Tail(_appName, _maxBytes);
+}
+
+QString A_process::GetLogFilePath(const QString& _appName) const
+{
+    return LogCapture.LogFilePath(_appName);
+}
+
+ScheduledTransition A_process::GetNextScheduledTransition(const QString& _appName) const
+{
+    return Scheduler.NextTransition(_appName);
+}
+
+QMap<QString, ActivationStatistics> A_process::GetActivationStatistics() const
+{
+    return SocketActivator->GetStatistics();
+}
+
 bool A_process::StartApplication(const QString& _appName)
 {
-    if (!ProcessMap.contains(_appName)) {
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0) {
         qDebug() << "Error: Application not found in configuration:" << _appName;
         return false;
     }
 
-    ProcessInfo& _processInfo = ProcessMap[_appName];
+    // A start request always wakes a parked application
+    Apps.Parked[_id] = false;
 
     // Check if already running
-    if (_processInfo.IsRunning) {
+    if (Apps.Running.at(_id)) {
         qDebug() << "Application already running:" << _appName;
         return true;
     }
 
     // Launch the process
-    bool _success = LaunchProcess(_appName, _processInfo.ExecutablePath);
-    if (_success) {
-        _processInfo.IsRunning = true;
-        _processInfo.Status = "start";
+    qint64 _processId = 0;
+    bool _success = LaunchProcess(_appName, Apps.ExecutablePaths.at(_id), &_processId);
+    if (!_success) {
+        Journal.Append(Clock->NowMs(), JournalEventType::LaunchFailed, _appName);
+    } else {
+        // Without a PID from the spawner the next tick finds the process by name
+        Apps.Running[_id] = true;
+        Apps.ProcessIds[_id] = _processId;
+        Apps.StartTimesMs[_id] = Clock->NowMs();
+        Apps.Desired[_id] = DesiredState::Start;
+        CheckLaunchPolicy(_id);
+        Journal.Append(Clock->NowMs(), JournalEventType::Running, _appName, Apps.ProcessIds.at(_id));
 
         // Update settings
         if (SettingsRef) {
             SettingsRef->UpdateAppStatus(_appName, "start");
         }
 
+        PublishStatus();
         emit ApplicationStatusChanged(_appName, true);
     }
 
@@ -91,69 +260,147 @@ bool A_process::StartApplication(const QString& _appName)
 
 bool A_process::StopApplication(const QString& _appName)
 {
-    if (!ProcessMap.contains(_appName)) {
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0) {
         qDebug() << "Error: Application not found in configuration:" << _appName;
         return false;
     }
 
-    ProcessInfo& _processInfo = ProcessMap[_appName];
-
     // Kill the process if running
-    if (_processInfo.IsRunning && _processInfo.ProcessId > 0) {
-        bool _killSuccess = KillProcess(_processInfo.ProcessId);
-        if (_killSuccess) {
-            _processInfo.IsRunning = false;
-            _processInfo.ProcessId = 0;
-            _processInfo.Status = "stop";
-
-            // Clean up QProcess object if exists
-            if (ActiveProcesses.contains(_appName)) {
-                QProcess* _proc = ActiveProcesses[_appName];
-                ActiveProcesses.remove(_appName);
-                _proc->kill();
-                _proc->waitForFinished(3000);
-                delete _proc;
-            }
+    const qint64 _processId = Apps.ProcessIds.at(_id);
+    const bool _running = Apps.Running.at(_id) && _processId > 0;
+    if (_running && !KillProcess(_processId, _appName)) {
+        return false;
+    }
+
+    // A parked or crashed application must stay down as well - no wake-up and no restart
+    Journal.Append(Clock->NowMs(), JournalEventType::Stopped, _appName, _running ? _processId : 0);
+    Apps.SetStopped(_id);
+    Apps.Parked[_id] = false;
+    Apps.Desired[_id] = DesiredState::Stop;
+    HealthProbe->SetApplicationRunning(_appName, false);
+    SocketActivator->SetWaiting(_appName, false);
+
+    // Update settings
+    if (SettingsRef) {
+        SettingsRef->UpdateAppStatus(_appName, "stop");
+    }
+
+    PublishStatus();
+    emit ApplicationStatusChanged(_appName, false);
+    return true;
+}
+
+ShutdownReport A_process::ShutdownApplications(int _deadlineMs)
+{
+    QTPM_TRACE_SCOPE("engine", "ShutdownApplications");
+
+    // No tick may relaunch what is being stopped
+    StopMonitoring();
+
+    QHash<QString, int> _timeouts;
+    QHash<QString, QStringList> _dependsOn;
+    if (SyncedConfig) {
+        for (const AppInfo& _app : SyncedConfig->Applications) {
+            _timeouts.insert(_app.Name, _app.StopTimeout);
+            _dependsOn.insert(_app.Name, _app.DependsOn);
+        }
+    }
+
+    QList<ShutdownTarget> _targets;
+    QHash<QString, int> _targetIndex;
+    for (int _id = 0; _id < Apps.Size(); ++_id) {
+        if (!Apps.Live.at(_id) || !Apps.Running.at(_id) || Apps.ProcessIds.at(_id) <= 0) {
+            continue;
+        }
+        ShutdownTarget _target;
+        _target.Name = Apps.AppNames.at(_id);
+        _target.ProcessId = Apps.ProcessIds.at(_id);
+        if (_timeouts.value(_target.Name) > 0) {
+            _target.TimeoutMs = _timeouts.value(_target.Name) * 1000;
+        }
+        _targetIndex.insert(_target.Name, int(_targets.size()));
+        _targets.append(_target);
+    }
 
-            // Update settings
-            if (SettingsRef) {
-                SettingsRef->UpdateAppStatus(_appName, "stop");
+    // Reverse dependency order - an application goes one wave after everything that
+    // depends on it. A cycle stops growing after one pass per application.
+    for (int _pass = 0; _pass < int(_targets.size()); ++_pass) {
+        bool _changed = false;
+        for (const ShutdownTarget& _target : _targets) {
+            for (const QString& _dependency : _dependsOn.value(_target.Name)) {
+                const int _index = _targetIndex.value(_dependency, -1);
+                if (_index >= 0 && _targets.at(_index).Wave <= _target.Wave) {
+                    _targets[_index].Wave = _target.Wave + 1;
+                    _changed = true;
+                }
             }
+        }
+        if (!_changed) {
+            break;
+        }
+    }
 
-            emit ApplicationStatusChanged(_appName, false);
-            return true;
+    qDebug() << "Shutting down" << _targets.size() << "applications within" << _deadlineMs << "ms";
+    A_shutdowncoordinator _coordinator(SignalSender, Clock);
+    const ShutdownReport _report = _coordinator.Run(_targets, _deadlineMs);
+
+    for (const ShutdownResult& _result : _report.Results) {
+        const int _id = Apps.IdOf(_result.Name);
+        if (_result.Killed) {
+            Journal.Append(Clock->NowMs(), JournalEventType::KillSignal, _result.Name, _result.ProcessId, SIGKILL);
         }
+        if (_id < 0 || !_result.Exited) {
+            continue;
+        }
+        Journal.Append(Clock->NowMs(), JournalEventType::Stopped, _result.Name, _result.ProcessId);
+        Apps.SetStopped(_id);
+        HealthProbe->SetApplicationRunning(_result.Name, false);
+        Heartbeats.Disarm(_result.Name);
+        emit ApplicationStatusChanged(_result.Name, false);
     }
+    PublishStatus();
 
-    return false;
+    qDebug() << "Shutdown finished:" << _report.ToString();
+    return _report;
 }
 
-bool A_process::IsApplicationRunning(const QString& _appName)
+bool A_process::WakeApplication(const QString& _appName)
 {
-    if (ProcessMap.contains(_appName)) {
-        return ProcessMap[_appName].IsRunning;
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0 || !Apps.Parked.at(_id)) {
+        return false;
     }
-    return false;
+
+    qDebug() << "Waking parked application:" << _appName;
+    return StartApplication(_appName);
+}
+
+bool A_process::IsApplicationRunning(const QString& _appName)
+{
+    const int _id = Apps.IdOf(_appName);
+    return _id >= 0 && Apps.Running.at(_id);
 }
 
 bool A_process::RefreshApplicationStatus(const QString& _appName)
 {
-    if (!ProcessMap.contains(_appName)) {
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0) {
         qDebug() << "Application not found for refresh:" << _appName;
         return false;
     }
 
-    ProcessInfo& _processInfo = ProcessMap[_appName];
-    qint64 _foundPid = FindProcessByExecutable(_processInfo.ExecutablePath);
+    qint64 _foundPid = FindProcessByExecutable(Apps.ExecutablePaths.at(_id));
     bool _actuallyRunning = (_foundPid > 0);
 
     qDebug() << "Refreshing status for" << _appName
-             << "- Internal:" << _processInfo.IsRunning
+             << "- Internal:" << Apps.Running.at(_id)
              << "Actual:" << _actuallyRunning;
 
-    if (_processInfo.IsRunning != _actuallyRunning) {
-        _processInfo.IsRunning = _actuallyRunning;
-        _processInfo.ProcessId = _actuallyRunning ? _foundPid : 0;
+    if (Apps.Running.at(_id) != _actuallyRunning) {
+        Apps.Running[_id] = _actuallyRunning;
+        Apps.ProcessIds[_id] = _actuallyRunning ? _foundPid : 0;
+        Apps.StartTimesMs[_id] = _actuallyRunning ? Clock->NowMs() : 0;
         emit ApplicationStatusChanged(_appName, _actuallyRunning);
         qDebug() << "Status updated for" << _appName << "to" << _actuallyRunning;
     }
@@ -161,85 +408,261 @@ bool A_process::RefreshApplicationStatus(const QString& _appName)
     return true;
 }
 
+QStringList A_process::GetApplicationNames() const
+{
+    return Apps.SortedNames();
+}
+
+ProcessInfo A_process::GetProcessInfo(const QString& _appName) const
+{
+    const int _id = Apps.IdOf(_appName);
+    return _id >= 0 ? Apps.Info(_id) : ProcessInfo();
+}
+
+QMap<QString, ProbeStatistics> A_process::GetProbeStatistics() const
+{
+    return HealthProbe->GetStatistics();
+}
+
+void A_process::OnProbeFailed(const QString& _appName)
+{
+    qDebug() << "Health probe failed:" << _appName;
+    KillHungProcess(_appName, JournalEventType::ProbeFailed);
+}
+
+void A_process::KillHungProcess(const QString& _appName, JournalEventType _event)
+{
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0) {
+        return;
+    }
+
+    const qint64 _processId = Apps.ProcessIds.at(_id);
+    if (Apps.Desired.at(_id) != DesiredState::Start || !Apps.Running.at(_id) || _processId <= 0) {
+        return;
+    }
+
+    qDebug() << "Killing hung process:" << _appName << "PID:" << _processId;
+    Journal.Append(Clock->NowMs(), _event, _appName, _processId);
+
+    if (KillProcess(_processId, _appName)) {
+        Apps.SetStopped(_id);
+        HealthProbe->SetApplicationRunning(_appName, false);
+        Heartbeats.Disarm(_appName);
+        emit ApplicationStatusChanged(_appName, false);
+    } else {
+        qDebug() << "Failed to kill unhealthy process:" << _appName;
+    }
+}
+
+void A_process::OnActivationRequested(const QString& _appName)
+{
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0 || Apps.Desired.at(_id) != DesiredState::Start || Apps.Running.at(_id)) {
+        return;
+    }
+
+    // Shares the restart backoff, so an application that dies on start is not relaunched per connection
+    Apps.LastRestartMs[_id] = Clock->NowMs();
+    qDebug() << "Activating on first connection:" << _appName;
+    StartApplication(_appName);
+}
+
+void A_process::OnScheduleTimer()
+{
+    const qint64 _now = Clock->NowMs();
+    const QList<ScheduledTransition> _due = Scheduler.TakeDue(_now);
+    for (const ScheduledTransition& _transition : _due) {
+        ApplyScheduledTransition(_transition);
+    }
+
+    ArmScheduleTimer();
+}
+
+void A_process::ArmScheduleTimer()
+{
+    const qint64 _deadline = Scheduler.NextDeadlineMs();
+    if (_deadline == 0 || !MonitorTimer->isActive()) {
+        ScheduleTimer->stop();
+        return;
+    }
+
+    // Long sleeps are cut short so a changed wall clock is noticed; an early wake just re-arms
+    const qint64 _delay = qBound<qint64>(0, _deadline - Clock->NowMs(), MaxScheduleSleepMs);
+    ScheduleTimer->start(int(_delay));
+}
+
+void A_process::ApplyScheduledTransition(const ScheduledTransition& _transition)
+{
+    const QString& _appName = _transition.AppName;
+    const int _id = Apps.IdOf(_appName);
+    if (_id < 0) {
+        return;
+    }
+
+    const DesiredState _desired = _transition.Start ? DesiredState::Start : DesiredState::Stop;
+    qDebug() << "Schedule" << (_transition.Start ? "opens" : "closes") << "run window of" << _appName;
+    Journal.Append(Clock->NowMs(), JournalEventType::Scheduled, _appName, Apps.ProcessIds.at(_id), _transition.Start ? 1 : 0);
+
+    // Record the desired state first so the monitor enforces it even if this attempt fails
+    Apps.Desired[_id] = _desired;
+    if (SettingsRef) {
+        SettingsRef->UpdateAppStatus(_appName, A_apptable::StatusText(_desired));
+    }
+
+    if (_transition.Start) {
+        StartApplication(_appName);
+    } else if (Apps.Running.at(_id)) {
+        StopApplication(_appName);
+    }
+
+    emit ApplicationScheduled(_appName, _transition.Start);
+}
+
+void A_process::ParkApplication(int _id)
+{
+    const QString _appName = Apps.AppNames.at(_id);
+    const qint64 _processId = Apps.ProcessIds.at(_id);
+
+    // Measured before the kill - this is what parking gives back
+    const qint64 _residentKb = A_idledetector::ResidentKb(_processId);
+    qDebug() << "Parking idle application:" << _appName << "PID:" << _processId
+             << "after" << Apps.Idle.at(_id).TimeoutSeconds << "s idle," << _residentKb << "kB";
+
+    if (!KillProcess(_processId, _appName)) {
+        qDebug() << "Failed to park application:" << _appName;
+        return;
+    }
+
+    Journal.Append(Clock->NowMs(), JournalEventType::Parked, _appName, _processId, _residentKb);
+    Apps.ParkedProcessIds[_id] = _processId;
+    Apps.SetStopped(_id);
+    Apps.Parked[_id] = true;
+    Apps.ReclaimedKb[_id] = _residentKb;
+    IdleDetector.Forget(_appName);
+
+    emit ApplicationStatusChanged(_appName, false);
+    emit ApplicationParked(_appName, _residentKb);
+}
+
 void A_process::CheckProcesses()
 {
+    QTPM_METRIC_SCOPE(TickDuration);
+    QTPM_TRACE_SCOPE("engine", "CheckProcesses");
+
     if (!SettingsRef) {
         return;
     }
 
-    // Update process map from current settings
+    // Update the application table from current settings
     UpdateProcessMap();
 
-    for (auto _it = ProcessMap.begin(); _it != ProcessMap.end(); ++_it) {
-        QString _appName = _it.key();
-        ProcessInfo& _processInfo = _it.value();
+    // Ids are stable, so signal handlers may call back in without invalidating the walk
+    for (int _id = 0; _id < Apps.Size(); ++_id) {
+        if (!Apps.Live.at(_id)) {
+            continue;
+        }
+        const QString _appName = Apps.AppNames.at(_id);
 
         // Check current process status
-        qint64 _foundPid = FindProcessByExecutable(_processInfo.ExecutablePath);
+        qint64 _foundPid = FindProcessByExecutable(Apps.ExecutablePaths.at(_id));
         bool _actuallyRunning = (_foundPid > 0);
 
-        if (_processInfo.Status == "start") {
+        if (Apps.Desired.at(_id) == DesiredState::Start) {
             // Application SHOULD be running
             
-            if (_actuallyRunning) {
+            // A parked process may take a moment to exit; it does not count as running
+            if (_actuallyRunning && !(Apps.Parked.at(_id) && _foundPid == Apps.ParkedProcessIds.at(_id))) {
                 // Process is running as expected
-                if (!_processInfo.IsRunning || _processInfo.ProcessId != _foundPid) {
-                    _processInfo.IsRunning = true;
-                    _processInfo.ProcessId = _foundPid;
+                if (!Apps.Running.at(_id) || Apps.ProcessIds.at(_id) != _foundPid) {
+                    Apps.Running[_id] = true;
+                    Apps.ProcessIds[_id] = _foundPid;
+                    Apps.StartTimesMs[_id] = Clock->NowMs();
+                    CheckLaunchPolicy(_id);
+                    Journal.Append(Clock->NowMs(), JournalEventType::Running, _appName, _foundPid);
                     emit ApplicationStatusChanged(_appName, true);
                     qDebug() << "Process confirmed running:" << _appName << "PID:" << _foundPid;
                 }
+                Apps.Parked[_id] = false;
+
+                if (Apps.Idle.at(_id).IsEnabled() &&
+                    IdleDetector.Sample(_appName, _foundPid, Apps.Idle.at(_id), Clock->NowMs())
+                        >= qint64(Apps.Idle.at(_id).TimeoutSeconds) * 1000) {
+                    ParkApplication(_id);
+                }
+            } else if (Apps.Parked.at(_id)) {
+                // Parked - stays down until a start request, an API call or a connection wakes it
+                if (SocketActivator->IsSocketActivated(_appName)) {
+                    SocketActivator->SetWaiting(_appName, true);
+                }
+            } else if (SocketActivator->IsSocketActivated(_appName)) {
+                // Socket-activated - an exit means idle, not a crash; wait for the next connection
+                if (Apps.Running.at(_id)) {
+                    Journal.Append(Clock->NowMs(), JournalEventType::Stopped, _appName, Apps.ProcessIds.at(_id));
+                    Apps.SetStopped(_id);
+                    emit ApplicationStatusChanged(_appName, false);
+                    qDebug() << "Socket-activated process exited:" << _appName;
+                }
+                if (Apps.LastRestartMs.at(_id) < 0 || (Clock->NowMs() - Apps.LastRestartMs.at(_id)) > 5000) {
+                    SocketActivator->SetWaiting(_appName, true);
+                }
             } else {
                 // Process should be running but isn't - need to start it
-                if (_processInfo.IsRunning) {
+                if (Apps.Running.at(_id)) {
                     // Update our state first
-                    _processInfo.IsRunning = false;
-                    _processInfo.ProcessId = 0;
+                    Journal.Append(Clock->NowMs(), JournalEventType::Crashed, _appName, Apps.ProcessIds.at(_id));
+                    Apps.SetStopped(_id);
                     emit ApplicationStatusChanged(_appName, false);
                     qDebug() << "Process stopped unexpectedly:" << _appName;
                 }
 
                 // Wait before attempting restart to avoid rapid spawning
-                static QMap<QString, qint64> _lastRestartTime;
-                qint64 _currentTime = QDateTime::currentMSecsSinceEpoch();
+                qint64 _currentTime = Clock->NowMs();
                 
-                if (!_lastRestartTime.contains(_appName) || 
-                    (_currentTime - _lastRestartTime[_appName]) > 5000) { // 5 second minimum between restarts
+                if (Apps.LastRestartMs.at(_id) < 0 ||
+                    (_currentTime - Apps.LastRestartMs.at(_id)) > 5000) { // 5 second minimum between restarts
                     
-                    _lastRestartTime[_appName] = _currentTime;
+                    Apps.LastRestartMs[_id] = _currentTime;
                     qDebug() << "Attempting to start missing process:" << _appName;
                     
-                    if (LaunchProcess(_appName, _processInfo.ExecutablePath)) {
-                        // Give process time to fully start
-                        QThread::msleep(2000);
-                        
-                        // Verify it actually started
-                        _foundPid = FindProcessByExecutable(_processInfo.ExecutablePath);
+                    if (LaunchProcess(_appName, Apps.ExecutablePaths.at(_id), &_foundPid)) {
+                        if (_foundPid <= 0) {
+                            // Spawner could not report the PID - give the process time to show up
+                            Clock->SleepMs(2000);
+                            _foundPid = FindProcessByExecutable(Apps.ExecutablePaths.at(_id));
+                        }
                         if (_foundPid > 0) {
-                            _processInfo.IsRunning = true;
-                            _processInfo.ProcessId = _foundPid;
+                            Apps.Running[_id] = true;
+                            Apps.ProcessIds[_id] = _foundPid;
+                            Apps.StartTimesMs[_id] = Clock->NowMs();
+                            ++Apps.RestartCounts[_id];
+                            CheckLaunchPolicy(_id);
+                            Journal.Append(Clock->NowMs(), JournalEventType::Restarted, _appName, _foundPid);
                             emit ApplicationRestarted(_appName);
                             emit ApplicationStatusChanged(_appName, true);
                             qDebug() << "Process started successfully:" << _appName << "PID:" << _foundPid;
                         } else {
+                            Journal.Append(Clock->NowMs(), JournalEventType::LaunchFailed, _appName);
                             qDebug() << "Process failed to start properly:" << _appName;
                         }
                     } else {
+                        Journal.Append(Clock->NowMs(), JournalEventType::LaunchFailed, _appName);
                         qDebug() << "Failed to launch process:" << _appName;
                     }
                 }
             }
             
-        } else if (_processInfo.Status == "stop") {
+        } else if (Apps.Desired.at(_id) == DesiredState::Stop) {
             // Application should NOT be running
+            Apps.Parked[_id] = false;
             
             if (_actuallyRunning) {
                 // Process is running but shouldn't be - stop it
                 qDebug() << "Stopping unwanted process:" << _appName << "PID:" << _foundPid;
                 
-                if (KillProcess(_foundPid)) {
-                    _processInfo.IsRunning = false;
-                    _processInfo.ProcessId = 0;
+                if (KillProcess(_foundPid, _appName)) {
+                    Journal.Append(Clock->NowMs(), JournalEventType::Stopped, _appName, _foundPid);
+                    Apps.SetStopped(_id);
                     emit ApplicationStatusChanged(_appName, false);
                     qDebug() << "Successfully stopped process:" << _appName;
                 } else {
@@ -247,14 +670,34 @@ void A_process::CheckProcesses()
                 }
             } else {
                 // Process is correctly stopped
-                if (_processInfo.IsRunning) {
-                    _processInfo.IsRunning = false;
-                    _processInfo.ProcessId = 0;
+                if (Apps.Running.at(_id)) {
+                    Journal.Append(Clock->NowMs(), JournalEventType::Stopped, _appName, Apps.ProcessIds.at(_id));
+                    Apps.SetStopped(_id);
                     emit ApplicationStatusChanged(_appName, false);
                 }
             }
         }
+
+        const bool _running = Apps.Running.at(_id);
+        HealthProbe->SetApplicationRunning(_appName, _running);
+        if (!_running) {
+            Heartbeats.Disarm(_appName);
+        }
+
+        if (_running || Apps.Desired.at(_id) != DesiredState::Start) {
+            SocketActivator->SetWaiting(_appName, false);
+            SocketActivator->SampleResident(_appName, Apps.ProcessIds.at(_id));
+        }
     }
+
+    // A deadlocked application keeps its PID; only its heartbeat gives it away
+    const QStringList _stalled = Heartbeats.Scan(Clock->NowMs());
+    for (const QString& _appName : _stalled) {
+        qDebug() << "Heartbeat stalled:" << _appName;
+        KillHungProcess(_appName, JournalEventType::HeartbeatStalled);
+    }
+
+    PublishStatus();
 }
 
 void A_process::UpdateProcessMap()
@@ -263,185 +706,114 @@ void A_process::UpdateProcessMap()
         return;
     }
 
-    ProcessMap.clear();
-    QList<AppInfo> _apps = SettingsRef->GetApplications();
+    // Called every tick - nothing to do until a new configuration version is published
+    const ConfigSnapshotPtr _config = SettingsRef->Snapshot();
+    if (_config == SyncedConfig) {
+        return;
+    }
+    SyncedConfig = _config;
+    QTPM_TRACE_SCOPE("engine", "UpdateProcessMap");
 
-    for (const AppInfo& _app : _apps) {
-        ProcessInfo _processInfo;
-        _processInfo.ExecutablePath = _app.Executable;
-        _processInfo.Status = _app.Status;
-        _processInfo.IsRunning = false;
-        _processInfo.ProcessId = 0;
+    // Runtime state of unchanged apps is kept, so they report no spurious transitions
+    const QList<AppInfo>& _apps = _config->Applications;
+    Apps.Sync(_apps);
 
-        ProcessMap[_app.Name] = _processInfo;
+    HealthProbe->SetProbes(_apps);
+    SocketActivator->SetSockets(_apps);
+    Heartbeats.SetApplications(_apps);
+
+    // Unchanged windows keep their queue entry, so this is cheap on every tick
+    if (Scheduler.SetSchedules(_apps, Clock->NowMs())) {
+        ArmScheduleTimer();
     }
 
-    qDebug() << "Process map updated with" << ProcessMap.size() << "applications";
+    qDebug() << "Process map updated with" << Apps.Count() << "applications from configuration version"
+             << _config->Version;
 }
 
 qint64 A_process::FindProcessByExecutable(const QString& _executablePath)
 {
-    QProcess _findProcess;
-    
-    // Use pidof command which is more reliable for finding exact executable matches
-    QFileInfo _fileInfo(_executablePath);
-    QString _execName = _fileInfo.baseName();
-    
-    // Try pidof first (most reliable)
-    QString _command = QString("pidof %1").arg(_execName);
-    _findProcess.start("sh", QStringList() << "-c" << _command);
-    _findProcess.waitForFinished(3000);
-
-    if (_findProcess.exitCode() == 0) {
-        QString _output = _findProcess.readAllStandardOutput().trimmed();
-        QStringList _pids = _output.split(' ', Qt::SkipEmptyParts);
-
-        if (!_pids.isEmpty()) {
-            bool _ok;
-            qint64 _pid = _pids.first().toLongLong(&_ok);
-            if (_ok && _pid > 0) {
-                qDebug() << "Found process by pidof:" << _execName << "PID:" << _pid;
-                return _pid;
-            }
-        }
-    }
-
-    // Fallback to pgrep with exact executable name
-    _command = QString("pgrep -x %1").arg(_execName);
-    _findProcess.start("sh", QStringList() << "-c" << _command);
-    _findProcess.waitForFinished(3000);
+    QTPM_METRIC_SCOPE(AppLookup);
 
-    if (_findProcess.exitCode() == 0) {
-        QString _output = _findProcess.readAllStandardOutput().trimmed();
-        QStringList _pids = _output.split('\n', Qt::SkipEmptyParts);
-
-        if (!_pids.isEmpty()) {
-            bool _ok;
-            qint64 _pid = _pids.first().toLongLong(&_ok);
-            if (_ok && _pid > 0) {
-                qDebug() << "Found process by pgrep -x:" << _execName << "PID:" << _pid;
-                return _pid;
-            }
-        }
-    }
-
-    return 0; // Not found
+    return ProcessTable->FindProcess(_executablePath);
 }
 
-bool A_process::KillProcess(qint64 _processId)
+bool A_process::KillProcess(qint64 _processId, const QString& _appName)
 {
+    QTPM_METRIC_SCOPE(Kill);
+    QTPM_TRACE_SCOPE("engine", "KillProcess");
+
     if (_processId <= 0) {
         qDebug() << "Invalid process ID for kill operation:" << _processId;
         return false;
     }
 
-    QProcess _killProcess;
-    
-    // Try SIGTERM first (gentler approach)
-    QString _command = QString("kill -TERM %1").arg(_processId);
-    _killProcess.start("sh", QStringList() << "-c" << _command);
-    _killProcess.waitForFinished(3000);
-    
-    if (_killProcess.exitCode() == 0) {
-        qDebug() << "Process killed successfully with SIGTERM:" << _processId;
-        return true;
-    }
-    
-    // Try SIGHUP (close terminal) approach
-    _command = QString("kill -HUP %1").arg(_processId);
-    _killProcess.start("sh", QStringList() << "-c" << _command);
-    _killProcess.waitForFinished(3000);
-    
-    if (_killProcess.exitCode() == 0) {
-        qDebug() << "Process killed successfully with SIGHUP:" << _processId;
-        return true;
-    }
-    
-    // Try SIGINT (Ctrl+C equivalent)
-    _command = QString("kill -INT %1").arg(_processId);
-    _killProcess.start("sh", QStringList() << "-c" << _command);
-    _killProcess.waitForFinished(3000);
-    
-    if (_killProcess.exitCode() == 0) {
-        qDebug() << "Process killed successfully with SIGINT:" << _processId;
-        return true;
-    }
-    
-    // As a last resort, try SIGKILL (force kill)
-    _command = QString("kill -KILL %1").arg(_processId);
-    qDebug() << "Force kill attempt for process:" << _processId;
-    _killProcess.start("sh", QStringList() << "-c" << _command);
-    _killProcess.waitForFinished(3000);
-    
-    if (_killProcess.exitCode() == 0) {
-        qDebug() << "Process force-killed successfully:" << _processId;
-        return true;
+    // Escalate from SIGTERM (gentlest) through SIGHUP and SIGINT to SIGKILL
+    static const int _signals[] = { SIGTERM, SIGHUP, SIGINT, SIGKILL };
+    static const char* const _signalNames[] = { "SIGTERM", "SIGHUP", "SIGINT", "SIGKILL" };
+
+    for (int _i = 0; _i < 4; ++_i) {
+        if (_signals[_i] == SIGKILL) {
+            qDebug() << "Force kill attempt for process:" << _processId;
+        }
+        Journal.Append(Clock->NowMs(), JournalEventType::KillSignal, _appName, _processId, _signals[_i]);
+
+        if (SignalSender->SendSignal(_processId, _signals[_i])) {
+            qDebug() << "Process killed successfully with" << _signalNames[_i] << ":" << _processId;
+            return true;
+        }
     }
-    
+
     qDebug() << "All kill attempts failed for process:" << _processId;
     return false;
 }
 
-bool A_process::LaunchProcess(const QString& _applicationName, const QString& _path)
+bool A_process::LaunchProcess(const QString& _applicationName, const QString& _path, qint64* _processId)
 {
+    QTPM_METRIC_SCOPE(Launch);
+    QTPM_TRACE_SCOPE("engine", "LaunchProcess");
+
     qDebug() << "Attempting to launch:" << _applicationName << "at path:" << _path;
 
-    // Check if executable exists and is accessible
-    QFileInfo _fileInfo(_path);
-    if (!_fileInfo.exists() || !_fileInfo.isExecutable()) {
-        qDebug() << "Executable does not exist or is not executable:" << _path;
-        return false;
+    // The child holds its own copy of the pipe; ours is closed right away so EOF follows its exit
+    const int _outputFd = LogCapture.CreatePipe(_applicationName);
+    *_processId = 0;
+    Heartbeats.Arm(_applicationName, Clock->NowMs());
+    const int _id = Apps.IdOf(_applicationName);
+    const bool _started = Spawner->Spawn(_applicationName, _path, _id >= 0 ? Apps.Policies.at(_id) : LaunchPolicy(),
+                                         _processId, _outputFd, SocketActivator->SocketFds(_applicationName),
+                                         Heartbeats.Environment(_applicationName));
+    if (_outputFd >= 0) {
+        ::close(_outputFd);
     }
-
-    // For GUI applications, use startDetached as the primary method
-    QProcessEnvironment _env = QProcessEnvironment::systemEnvironment();
-    
-    // Ensure GUI environment variables are set properly
-    if (!_env.contains("DISPLAY")) {
-        _env.insert("DISPLAY", ":0");
+    if (!_started) {
+        Heartbeats.Disarm(_applicationName);
+    } else if (_id >= 0) {
+        Apps.HeartbeatSlots[_id] = Heartbeats.SlotOf(_applicationName);
     }
-    
-    if (!_env.contains("XAUTHORITY")) {
-        QString _xauth = QDir::homePath() + "/.Xauthority";
-        if (QFileInfo(_xauth).exists()) {
-            _env.insert("XAUTHORITY", _xauth);
-        }
+    return _started;
+}
+
+void A_process::CheckLaunchPolicy(int _id)
+{
+    Apps.PolicyReports[_id].clear();
+    Apps.PolicyOk[_id] = true;
+    const qint64 _processId = Apps.ProcessIds.at(_id);
+    if (!Apps.Policies.at(_id).IsEnabled() || _processId <= 0) {
+        return;
     }
-    
-    // Add XDG variables to ensure proper desktop integration
-    _env.insert("XDG_RUNTIME_DIR", "/run/user/" + QString::number(getuid()));
-    _env.insert("XDG_SESSION_TYPE", "x11");
-    
-    // Set working directory
-    QString _workingDir = QDir::homePath();
-    
-    qint64 _pid = 0;
-    
-    // First try: startDetached with environment (best for GUI apps)
-    QProcess _process;
-    _process.setProcessEnvironment(_env);
-    _process.setWorkingDirectory(_workingDir);
-    
-    if (_process.startDetached(_path, QStringList(), _workingDir, &_pid)) {
-        qDebug() << "Process started detached successfully:" << _applicationName << "PID:" << _pid;
-        return true;
+
+    A_launchpolicy _launchPolicy;
+    if (!_launchPolicy.Prepare(Apps.Policies.at(_id))) {
+        Apps.PolicyOk[_id] = false;
+        return;
     }
-    
-    // Second try: Use system command with proper environment
-    QString _command = QString("DISPLAY=:0 XDG_RUNTIME_DIR=/run/user/%1 nohup \"%2\" > /dev/null 2>&1 &")
-                      .arg(getuid())
-                      .arg(_path);
-                      
-    qDebug() << "Trying system command:" << _command;
-    int _result = system(_command.toLocal8Bit().constData());
-    
-    if (_result == 0) {
-        qDebug() << "Process started with system command:" << _applicationName;
-        // Give it a moment to start
-        QThread::msleep(1000);
-        return true;
+
+    bool _policyOk = true;
+    Apps.PolicyReports[_id] = _launchPolicy.Verify(_processId, &_policyOk);
+    Apps.PolicyOk[_id] = _policyOk;
+    if (!_policyOk) {
+        qDebug() << "Warning: Launch policy not in effect for" << Apps.AppNames.at(_id) << "PID:" << _processId
+                 << "-" << Apps.PolicyReports.at(_id);
     }
-    
-    qDebug() << "All launch methods failed for:" << _applicationName;
-    return false;
 }
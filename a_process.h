@@ -3,21 +3,22 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QProcess>
 #include <QMap>
 #include <QString>
 #include <QDebug>
 #include "a_settingsclass.h"
-
-/**
- * @brief Structure to hold process monitoring information
- */
-struct ProcessInfo {
-    QString ExecutablePath;     // Full path to executable - system path to binary
-    QString Status;            // Desired status - "start" or "stop"
-    bool IsRunning;           // Current running state - true if process is active
-    qint64 ProcessId;         // System process ID - 0 if not running
-};
+#include "a_apptable.h"
+#include "a_healthprobe.h"
+#include "a_journal.h"
+#include "a_logcapture.h"
+#include "a_scheduler.h"
+#include "a_socketactivator.h"
+#include "a_idledetector.h"
+#include "a_heartbeatwatchdog.h"
+#include "a_statustable.h"
+#include "a_checkpoint.h"
+#include "a_shutdowncoordinator.h"
+#include "a_systeminterfaces.h"
 
 /**
  * @brief Class responsible for monitoring and managing application processes
@@ -31,6 +32,8 @@ class A_process : public QObject
     Q_OBJECT
 
 public:
+    static constexpr int MaxScheduleSleepMs = 10 * 60 * 1000;  // Longest schedule timer wait - bounds wall clock jumps
+
     explicit A_process(QObject *parent = nullptr);
     ~A_process();
 
@@ -40,6 +43,18 @@ public:
      */
     void SetSettingsReference(A_settingsclass* _settings);
 
+    /**
+     * @brief Replaces the process table, signal, spawn and clock dependencies
+     * Intended for simulators; the defaults access the real system.
+     * @param _processTable Process lookup - nullptr keeps the current one
+     * @param _signalSender Signal delivery - nullptr keeps the current one
+     * @param _spawner Process creation - nullptr keeps the current one
+     * @param _clock Time source - nullptr keeps the current one
+     * All objects must outlive this instance.
+     */
+    void SetSystemInterfaces(A_processtable* _processTable, A_signalsender* _signalSender,
+                             A_processspawner* _spawner, A_clock* _clock);
+
     /**
      * @brief Starts the monitoring timer
      * Begins checking process status every 2 seconds
@@ -61,11 +76,31 @@ public:
 
     /**
      * @brief Manually stops a specific application
+     * An application that is not running - parked or between restarts - is
+     * kept down from now on.
      * @param _appName Application name - must match configuration
-     * @return bool True if stopped successfully, false on error
+     * @return bool True if stopped or already down, false on error
      */
     bool StopApplication(const QString& _appName);
 
+    /**
+     * @brief Stops monitoring and every running application, all at once
+     * Applications get SIGTERM together - those that others depend on in a later
+     * wave - and SIGKILL after their <stopTimeout>. Everything still alive at the
+     * deadline is killed. Desired states are kept, so a restarted monitor brings
+     * the applications back up.
+     * @param _deadlineMs Global deadline - milliseconds
+     * @return ShutdownReport Per-application outcome and total shutdown time
+     */
+    ShutdownReport ShutdownApplications(int _deadlineMs);
+
+    /**
+     * @brief Wakes a parked application
+     * @param _appName Application name - must match configuration
+     * @return bool True if the application was parked and has been started
+     */
+    bool WakeApplication(const QString& _appName);
+
     /**
      * @brief Checks if specific application is currently running
      * @param _appName Application name - must match configuration
@@ -80,6 +115,95 @@ public:
      */
     bool RefreshApplicationStatus(const QString& _appName);
 
+    /**
+     * @brief Gets the names of all managed applications
+     * @return QStringList Application names in sorted order
+     */
+    QStringList GetApplicationNames() const;
+
+    /**
+     * @brief Gets the monitoring state of one application
+     * @param _appName Application name - must match configuration
+     * @return ProcessInfo Current state - default-constructed if not found
+     */
+    ProcessInfo GetProcessInfo(const QString& _appName) const;
+
+    /**
+     * @brief Gets health probe latency histograms and counters
+     * @return QMap<QString, ProbeStatistics> Key: app name, value: probe statistics
+     */
+    QMap<QString, ProbeStatistics> GetProbeStatistics() const;
+
+    /**
+     * @brief Opens the supervision event journal
+     * @param _directory Journal directory - created if missing
+     * @return bool True if the journal is ready
+     */
+    bool OpenJournal(const QString& _directory);
+
+    /**
+     * @brief Queries recorded supervision events
+     * @param _appName Application name - empty for all applications
+     * @param _fromMs Range start - milliseconds since epoch, inclusive
+     * @param _toMs Range end - milliseconds since epoch, inclusive
+     * @return QList<JournalRecord> Matching events in time order
+     */
+    QList<JournalRecord> QueryJournal(const QString& _appName, qint64 _fromMs, qint64 _toMs) const;
+
+    /**
+     * @brief Starts capturing stdout/stderr of launched applications
+     * Applications launched before this call keep their previous output target.
+     * @param _directory Log directory - created if missing, holds <app>.log files
+     * @return bool True if capture is active
+     */
+    bool OpenLogCapture(const QString& _directory);
+
+    /**
+     * @brief Starts publishing application state to a shared-memory status table
+     * Read with qpmstat or qpm_status.h. Calling it again with the same name does nothing.
+     * @param _segmentName POSIX shared-memory name - empty for the per-user default
+     * @return bool True if the table is published
+     */
+    bool OpenStatusTable(const QString& _segmentName = QString());
+
+    /**
+     * @brief Restores runtime state saved before a monitor restart and keeps saving it
+     * Processes that are still the same process (boot, PID and kernel start time)
+     * are adopted as running, with their uptime, restart counters, backoff and
+     * parking intact. Call after SetSettingsReference() and before StartMonitoring().
+     * @param _filePath Checkpoint file - created on the first change
+     * @return bool True if the checkpoint is written from now on
+     */
+    bool OpenCheckpoint(const QString& _filePath);
+
+    /**
+     * @brief Gets the newest captured output of an application
+     * @param _appName Application name - must match configuration
+     * @param _maxBytes Maximum bytes returned
+     * @return QByteArray Output tail - empty if capture is off or nothing was written
+     */
+    QByteArray GetApplicationOutput(const QString& _appName, int _maxBytes = 64 * 1024) const;
+
+    /**
+     * @brief Gets the file captured output of an application is written to
+     * @param _appName Application name - must match configuration
+     * @return QString Path of the current log file - empty if capture is off
+     */
+    QString GetLogFilePath(const QString& _appName) const;
+
+    /**
+     * @brief Gets the next run window edge of an application
+     * @param _appName Application name - must match configuration
+     * @return ScheduledTransition Pending transition - TimeMs is 0 if the application has no schedule
+     */
+    ScheduledTransition GetNextScheduledTransition(const QString& _appName) const;
+
+    /**
+     * @brief Gets first-request latency and memory figures of socket-activated applications
+     * @return QMap<QString, ActivationStatistics> Key: app name, value: activation statistics
+     */
+    QMap<QString, ActivationStatistics> GetActivationStatistics() const;
+
 signals:
     /**
      * @brief Emitted when an application status changes
@@ -94,22 +218,107 @@ signals:
      */
     void ApplicationRestarted(const QString& appName);
 
-private slots:
+    /**
+     * @brief Emitted when a run window of an application opens or closes
+     * @param appName Name of the scheduled application
+     * @param start True if the window opened, false if it closed
+     */
+    void ApplicationScheduled(const QString& appName, bool start);
+
+    /**
+     * @brief Emitted when an idle application is parked
+     * @param appName Name of the parked application
+     * @param reclaimedKb Resident memory the process held - kB
+     */
+    void ApplicationParked(const QString& appName, qint64 reclaimedKb);
+
+protected slots:
     /**
      * @brief Timer callback for periodic process monitoring
      * Checks all processes every 2 seconds and restarts if needed
      */
     void CheckProcesses();
 
+private slots:
+    /**
+     * @brief Handles a health probe reaching its failure threshold
+     * Kills the hung process so the next check restarts it
+     * @param _appName Name of the unhealthy application
+     */
+    void OnProbeFailed(const QString& _appName);
+
+    /**
+     * @brief Applies the run window transitions that are due and sleeps until the next one
+     */
+    void OnScheduleTimer();
+
+    /**
+     * @brief Launches a dormant socket-activated application on its first connection
+     * @param _appName Name of the application whose socket became readable
+     */
+    void OnActivationRequested(const QString& _appName);
+
 private:
     QTimer* MonitorTimer;               // Timer for periodic checks - 2 second interval
     A_settingsclass* SettingsRef;       // Reference to settings - configuration source
-    QMap<QString, ProcessInfo> ProcessMap; // Map of managed processes - key: app name, value: process info
-    QMap<QString, QProcess*> ActiveProcesses; // Map of active QProcess objects - for process management
+    ConfigSnapshotPtr SyncedConfig;     // Configuration the application table was last synchronized with - held, so never reused
+    A_apptable Apps;                    // Runtime state of managed applications - one column entry per app id
+    A_healthprobe* HealthProbe;         // Health probe runner - asynchronous liveness checks
+    A_socketactivator* SocketActivator; // Listening sockets of socket-activated applications
+    A_journal Journal;                  // Event journal - persistent supervision history
+    A_logcapture LogCapture;            // Output capture - stdout/stderr of launched applications
+    A_idledetector IdleDetector;        // Idle tracking of running applications with idle shutdown
+    A_heartbeatwatchdog Heartbeats;     // Shared-memory heartbeat slots - hang detection
+    A_statustable* StatusTable;         // Shared-memory status table - null until OpenStatusTable()
+    A_checkpoint Checkpoint;            // Runtime state file - adopted after a monitor restart
+    A_scheduler Scheduler;              // Run window scheduler - next transition per scheduled app
+    QTimer* ScheduleTimer;              // Single-shot timer armed for the earliest transition
+
+    // System access - injectable for simulation
+    A_processtable* ProcessTable;        // Process lookup - pidof/pgrep by default
+    A_signalsender* SignalSender;        // Signal delivery - kill(2) by default
+    A_processspawner* Spawner;           // Process creation - detached start by default
+    A_clock* Clock;                      // Time source - wall clock by default
+
+    /**
+     * @brief Arms the schedule timer for the earliest pending transition
+     * Does nothing while monitoring is stopped.
+     */
+    void ArmScheduleTimer();
+
+    /**
+     * @brief Moves an application to the state its schedule asks for
+     * Uses the same start/stop paths as manual control.
+     * @param _transition Due transition
+     */
+    void ApplyScheduledTransition(const ScheduledTransition& _transition);
 
     /**
-     * @brief Updates internal process map from settings
-     * Synchronizes process list with current configuration
+     * @brief Stops an idle application without changing its desired status
+     * @param _id Application id - must be running
+     */
+    void ParkApplication(int _id);
+
+    /**
+     * @brief Kills a running application that stopped making progress
+     * The next check restarts it.
+     * @param _appName Application name
+     * @param _event Journal event recording the reason
+     */
+    void KillHungProcess(const QString& _appName, JournalEventType _event);
+
+    /**
+     * @brief Copies the current state of every application into the status table and checkpoint, if open
+     */
+    void PublishStatus();
+
+protected:
+    // Engine steps - protected so benchmark harnesses can drive them directly
+
+    /**
+     * @brief Updates the application table from settings
+     * Synchronizes the table with the current configuration snapshot; returns
+     * at once if that snapshot was already applied
      */
     void UpdateProcessMap();
 
@@ -123,17 +332,26 @@ private:
     /**
      * @brief Kills a process by process ID
      * @param _processId System process ID - must be valid PID
+     * @param _appName Application name - for journal records, may be empty
      * @return bool True if killed successfully, false on error
      */
-    bool KillProcess(qint64 _processId);
+    bool KillProcess(qint64 _processId, const QString& _appName = QString());
 
     /**
      * @brief Starts a new process
      * @param _appName Application name - for tracking purposes
      * @param _executablePath Full path to executable
+     * @param _processId Receives the new process ID - 0 if the spawner could not tell
      * @return bool True if started successfully, false on error
      */
-    bool LaunchProcess(const QString& _appName, const QString& _executablePath);
+    bool LaunchProcess(const QString& _appName, const QString& _executablePath, qint64* _processId);
+
+    /**
+     * @brief Checks that a newly seen process carries its launch policy
+     * Reads the settings back from /proc; mismatches are logged.
+     * @param _id Application id - its process ID must be set
+     */
+    void CheckLaunchPolicy(int _id);
 };
 
 #endif // A_PROCESS_H
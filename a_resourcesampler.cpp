@@ -0,0 +1,134 @@
+#include "a_resourcesampler.h"
+#include "a_systeminterfaces.h"
+#include <cmath>
+#include <unistd.h>
+
+A_resourcesampler::A_resourcesampler(A_process* _processManager, const QString& _procRoot, QObject *parent)
+    : QObject(parent), ProcessManager(_processManager), ProcRoot(_procRoot)
+{
+    SampleTimer = new QTimer(this);
+    connect(SampleTimer, &QTimer::timeout, this, &A_resourcesampler::SampleAll);
+
+    TicksPerSecond = double(qMax(1L, sysconf(_SC_CLK_TCK)));
+    PageMb = double(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+    Monotonic.start();
+}
+
+void A_resourcesampler::Start(int _intervalMs)
+{
+    SampleTimer->start(_intervalMs);
+}
+
+void A_resourcesampler::Stop()
+{
+    SampleTimer->stop();
+}
+
+QVector<float> A_resourcesampler::Samples(const QString& _appName, Metric _metric) const
+{
+    QVector<float> _samples;
+    auto _it = History.constFind(_appName);
+    if (_it == History.constEnd()) {
+        return _samples;
+    }
+
+    const Series& _series = _it.value();
+    _samples.reserve(_series.Count);
+    for (int _i = 0; _i < _series.Count; ++_i) {
+        const int _slot = (_series.Head - _series.Count + _i + HistorySize) % HistorySize;
+        _samples.append(_series.Values[_metric][_slot]);
+    }
+    return _samples;
+}
+
+quint64 A_resourcesampler::Version(const QString& _appName) const
+{
+    auto _it = History.constFind(_appName);
+    return _it == History.constEnd() ? 0 : _it->Version;
+}
+
+bool A_resourcesampler::ReadProcess(qint64 _processId, quint64* _cpuTicks, quint64* _residentPages) const
+{
+    ProcessStat _stat;
+    if (!A_procfsprocesstable::ReadStat(_processId, &_stat, ProcRoot) ||
+        !A_procfsprocesstable::ReadStatm(_processId, &_stat, ProcRoot)) {
+        return false;
+    }
+    *_cpuTicks = _stat.CpuTicks;
+    *_residentPages = _stat.ResidentPages;
+    return true;
+}
+
+bool A_resourcesampler::Append(Series& _series, float _cpuPercent, float _residentMb)
+{
+    bool _same = false;
+    if (_series.Count > 0) {
+        const int _newest = (_series.Head - 1 + HistorySize) % HistorySize;
+        _same = _series.Values[CpuPercent][_newest] == _cpuPercent &&
+                _series.Values[ResidentMb][_newest] == _residentMb;
+    }
+
+    _series.Values[CpuPercent][_series.Head] = _cpuPercent;
+    _series.Values[ResidentMb][_series.Head] = _residentMb;
+    _series.Head = (_series.Head + 1) % HistorySize;
+    _series.FlatCount = _same ? _series.FlatCount + 1 : 1;
+
+    // A full history of identical samples plots the same after shifting
+    if (_series.Count == HistorySize && _series.FlatCount > HistorySize) {
+        return false;
+    }
+    _series.Count = qMin(_series.Count + 1, int(HistorySize));
+    ++_series.Version;
+    return true;
+}
+
+void A_resourcesampler::SampleAll()
+{
+    const qint64 _nowNs = Monotonic.nsecsElapsed();
+
+    QStringList _changed;
+    const QStringList _names = ProcessManager->GetApplicationNames();
+    for (const QString& _appName : _names) {
+        const ProcessInfo _info = ProcessManager->GetProcessInfo(_appName);
+
+        quint64 _cpuTicks = 0;
+        quint64 _residentPages = 0;
+        const bool _alive = _info.IsRunning && _info.ProcessId > 0 &&
+                            ReadProcess(_info.ProcessId, &_cpuTicks, &_residentPages);
+
+        auto _it = History.find(_appName);
+        if (!_alive && _it == History.end()) {
+            continue; // Never ran while sampled - nothing to plot
+        }
+        if (_it == History.end()) {
+            _it = History.insert(_appName, Series());
+        }
+        Series& _series = _it.value();
+
+        float _cpuPercent = 0.0f;
+        float _residentMb = 0.0f;
+        if (_alive) {
+            // The first sample of a new process has no CPU delta yet
+            if (_series.LastProcessId == _info.ProcessId && _nowNs > _series.LastSampleNs &&
+                _cpuTicks >= _series.LastCpuTicks) {
+                const double _seconds = double(_nowNs - _series.LastSampleNs) / 1e9;
+                _cpuPercent = float(100.0 * double(_cpuTicks - _series.LastCpuTicks) / TicksPerSecond / _seconds);
+            }
+            // Tenth-of-a-megabyte resolution keeps idle processes flat
+            _residentMb = float(std::round(double(_residentPages) * PageMb * 10.0) / 10.0);
+            _series.LastProcessId = _info.ProcessId;
+            _series.LastCpuTicks = _cpuTicks;
+        } else {
+            _series.LastProcessId = 0;
+        }
+        _series.LastSampleNs = _nowNs;
+
+        if (Append(_series, _cpuPercent, _residentMb)) {
+            _changed.append(_appName);
+        }
+    }
+
+    if (!_changed.isEmpty()) {
+        emit SamplesUpdated(_changed);
+    }
+}
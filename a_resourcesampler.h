@@ -0,0 +1,124 @@
+#ifndef A_RESOURCESAMPLER_H
+#define A_RESOURCESAMPLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include "a_process.h"
+
+/**
+ * @brief Periodically samples CPU and memory use of the running applications
+ *
+ * Each sweep reads /proc/<pid>/stat and /proc/<pid>/statm for every running
+ * application and appends to a fixed-size history per application. A series
+ * carries a version that only advances when its plotted shape can change, so
+ * an idle application with a flat history causes no repaint at all.
+ */
+class A_resourcesampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Sampled metrics
+     */
+    enum Metric {
+        CpuPercent,     // CPU use since the previous sample - percent of one core
+        ResidentMb      // Resident memory - megabytes
+    };
+
+    static constexpr int HistorySize = 60;  // Samples kept per application
+
+    /**
+     * @param _processManager Process manager - source of application names and PIDs
+     * @param _procRoot procfs mount point
+     */
+    explicit A_resourcesampler(A_process* _processManager, const QString& _procRoot = "/proc",
+                               QObject *parent = nullptr);
+
+    /**
+     * @brief Starts periodic sampling
+     * @param _intervalMs Sampling interval - milliseconds
+     */
+    void Start(int _intervalMs = 5000);
+
+    /**
+     * @brief Stops periodic sampling
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the history of one metric
+     * @param _appName Application name
+     * @param _metric Metric to read
+     * @return QVector<float> Samples, oldest first - empty if never sampled
+     */
+    QVector<float> Samples(const QString& _appName, Metric _metric) const;
+
+    /**
+     * @brief Gets the version of an application's history
+     * @param _appName Application name
+     * @return quint64 Version - changes whenever the plotted history changes, 0 if never sampled
+     */
+    quint64 Version(const QString& _appName) const;
+
+public slots:
+    /**
+     * @brief Takes one sample of every running application
+     */
+    void SampleAll();
+
+signals:
+    /**
+     * @brief Emitted after a sweep that changed at least one history
+     * @param appNames Applications whose version changed
+     */
+    void SamplesUpdated(const QStringList& appNames);
+
+private:
+    /**
+     * @brief History and bookkeeping for one application
+     */
+    struct Series {
+        float Values[2][HistorySize] = {};  // Ring buffers - index: Metric
+        int Head = 0;                       // Next write position
+        int Count = 0;                      // Valid samples - up to HistorySize
+        int FlatCount = 0;                  // Trailing samples equal to the newest one
+        quint64 Version = 0;                // Plot version - advances when the shape changes
+        qint64 LastProcessId = 0;           // Process sampled last time
+        quint64 LastCpuTicks = 0;           // utime + stime at the last sample - clock ticks
+        qint64 LastSampleNs = 0;            // Monotonic time of the last sample - nanoseconds
+    };
+
+    A_process* ProcessManager;          // Process manager - application list and PIDs
+    QString ProcRoot;                   // procfs mount point
+    QTimer* SampleTimer;                // Sweep timer
+    QElapsedTimer Monotonic;            // Sample time base - CPU deltas
+    QHash<QString, Series> History;     // Histories - key: app name
+    double TicksPerSecond;              // Clock ticks per second - sysconf(_SC_CLK_TCK)
+    double PageMb;                      // Page size - megabytes
+
+    /**
+     * @brief Reads CPU ticks and resident pages of one process
+     * @param _processId Process to read
+     * @param _cpuTicks Receives utime + stime - clock ticks
+     * @param _residentPages Receives resident set size - pages
+     * @return bool False if the process is gone or unreadable
+     */
+    bool ReadProcess(qint64 _processId, quint64* _cpuTicks, quint64* _residentPages) const;
+
+    /**
+     * @brief Appends one sample to a series
+     * @param _series Series to extend
+     * @param _cpuPercent CPU sample
+     * @param _residentMb Memory sample
+     * @return bool True if the version advanced
+     */
+    static bool Append(Series& _series, float _cpuPercent, float _residentMb);
+};
+
+#endif // A_RESOURCESAMPLER_H
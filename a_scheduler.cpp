@@ -0,0 +1,362 @@
+#include "a_scheduler.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QStringList>
+#include <QTime>
+
+A_cronexpression::A_cronexpression()
+{
+    Minutes = 0;
+    Hours = 0;
+    DaysOfMonth = 0;
+    Months = 0;
+    DaysOfWeek = 0;
+    DayOfMonthRestricted = false;
+    DayOfWeekRestricted = false;
+    Valid = false;
+}
+
+bool A_cronexpression::Parse(const QString& _expression)
+{
+    Valid = false;
+
+    QString _text = _expression.simplified();
+    if (_text == "@hourly") {
+        _text = "0 * * * *";
+    } else if (_text == "@daily" || _text == "@midnight") {
+        _text = "0 0 * * *";
+    } else if (_text == "@weekly") {
+        _text = "0 0 * * 0";
+    } else if (_text == "@monthly") {
+        _text = "0 0 1 * *";
+    } else if (_text == "@yearly" || _text == "@annually") {
+        _text = "0 0 1 1 *";
+    }
+
+    const QStringList _fields = _text.split(' ');
+    if (_fields.size() != 5) {
+        return false;
+    }
+
+    quint64 _minutes = 0;
+    quint64 _hours = 0;
+    quint64 _daysOfMonth = 0;
+    quint64 _months = 0;
+    quint64 _daysOfWeek = 0;
+    if (!ParseField(_fields.at(0), 0, 59, &_minutes) ||
+        !ParseField(_fields.at(1), 0, 23, &_hours) ||
+        !ParseField(_fields.at(2), 1, 31, &_daysOfMonth) ||
+        !ParseField(_fields.at(3), 1, 12, &_months) ||
+        !ParseField(_fields.at(4), 0, 7, &_daysOfWeek)) {
+        return false;
+    }
+
+    // Day 7 is another name for Sunday
+    if (_daysOfWeek & (quint64(1) << 7)) {
+        _daysOfWeek |= 1;
+    }
+
+    Minutes = _minutes;
+    Hours = quint32(_hours);
+    DaysOfMonth = quint32(_daysOfMonth);
+    Months = quint32(_months);
+    DaysOfWeek = quint32(_daysOfWeek & 0x7f);
+    DayOfMonthRestricted = !_fields.at(2).startsWith('*');
+    DayOfWeekRestricted = !_fields.at(4).startsWith('*');
+    Valid = true;
+    return true;
+}
+
+bool A_cronexpression::ParseField(const QString& _field, int _min, int _max, quint64* _bits)
+{
+    *_bits = 0;
+
+    const QStringList _parts = _field.split(',');
+    for (const QString& _part : _parts) {
+        QString _range = _part;
+        int _step = 1;
+
+        const int _slash = _part.indexOf('/');
+        if (_slash >= 0) {
+            bool _ok = false;
+            _step = _part.mid(_slash + 1).toInt(&_ok);
+            if (!_ok || _step <= 0) {
+                return false;
+            }
+            _range = _part.left(_slash);
+        }
+
+        int _first = _min;
+        int _last = _max;
+        if (_range != "*") {
+            const int _dash = _range.indexOf('-');
+            bool _okFirst = false;
+            bool _okLast = true;
+            if (_dash >= 0) {
+                _first = _range.left(_dash).toInt(&_okFirst);
+                _last = _range.mid(_dash + 1).toInt(&_okLast);
+            } else {
+                _first = _range.toInt(&_okFirst);
+                // "N/step" runs from N to the end of the range
+                _last = _slash >= 0 ? _max : _first;
+            }
+            if (!_okFirst || !_okLast || _first < _min || _last > _max || _first > _last) {
+                return false;
+            }
+        }
+
+        for (int _value = _first; _value <= _last; _value += _step) {
+            *_bits |= quint64(1) << _value;
+        }
+    }
+    return *_bits != 0;
+}
+
+bool A_cronexpression::MatchesDate(const QDate& _date) const
+{
+    if (!(Months & (1u << _date.month()))) {
+        return false;
+    }
+
+    const bool _dayOfMonth = DaysOfMonth & (1u << _date.day());
+    const bool _dayOfWeek = DaysOfWeek & (1u << (_date.dayOfWeek() % 7));
+
+    if (DayOfMonthRestricted && DayOfWeekRestricted) {
+        return _dayOfMonth || _dayOfWeek;
+    }
+    if (DayOfMonthRestricted) {
+        return _dayOfMonth;
+    }
+    if (DayOfWeekRestricted) {
+        return _dayOfWeek;
+    }
+    return true;
+}
+
+qint64 A_cronexpression::NextMs(qint64 _afterMs) const
+{
+    if (!Valid) {
+        return 0;
+    }
+
+    // Start at the first whole minute after _afterMs
+    const QDateTime _after = QDateTime::fromMSecsSinceEpoch(_afterMs);
+    QDate _date = _after.date();
+    int _firstMinute = _after.time().hour() * 60 + _after.time().minute() + 1;
+
+    for (int _day = 0; _day <= SearchDays; ++_day, _date = _date.addDays(1), _firstMinute = 0) {
+        if (!MatchesDate(_date)) {
+            continue;
+        }
+        for (int _hour = _firstMinute / 60; _hour < 24; ++_hour) {
+            if (!(Hours & (1u << _hour))) {
+                continue;
+            }
+            const int _fromMinute = _hour == _firstMinute / 60 ? _firstMinute % 60 : 0;
+            for (int _minute = _fromMinute; _minute < 60; ++_minute) {
+                if (!(Minutes & (quint64(1) << _minute))) {
+                    continue;
+                }
+                // Times skipped by a DST change resolve forward and may repeat
+                const qint64 _fireMs = QDateTime(_date, QTime(_hour, _minute)).toMSecsSinceEpoch();
+                if (_fireMs > _afterMs) {
+                    return _fireMs;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+qint64 A_cronexpression::PreviousMs(qint64 _atOrBeforeMs) const
+{
+    if (!Valid) {
+        return 0;
+    }
+
+    const QDateTime _before = QDateTime::fromMSecsSinceEpoch(_atOrBeforeMs);
+    QDate _date = _before.date();
+    int _lastMinute = _before.time().hour() * 60 + _before.time().minute();
+
+    for (int _day = 0; _day <= SearchDays; ++_day, _date = _date.addDays(-1), _lastMinute = 24 * 60 - 1) {
+        if (!MatchesDate(_date)) {
+            continue;
+        }
+        for (int _hour = _lastMinute / 60; _hour >= 0; --_hour) {
+            if (!(Hours & (1u << _hour))) {
+                continue;
+            }
+            const int _fromMinute = _hour == _lastMinute / 60 ? _lastMinute % 60 : 59;
+            for (int _minute = _fromMinute; _minute >= 0; --_minute) {
+                if (!(Minutes & (quint64(1) << _minute))) {
+                    continue;
+                }
+                const qint64 _fireMs = QDateTime(_date, QTime(_hour, _minute)).toMSecsSinceEpoch();
+                if (_fireMs <= _atOrBeforeMs) {
+                    return _fireMs;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+bool A_scheduler::SetSchedules(const QList<AppInfo>& _apps, qint64 _nowMs)
+{
+    bool _changed = false;
+    QSet<QString> _seen;
+
+    for (const AppInfo& _app : _apps) {
+        if (_app.Schedules.isEmpty()) {
+            continue;
+        }
+        _seen.insert(_app.Name);
+
+        auto _it = Apps.find(_app.Name);
+        if (_it != Apps.end() && _it->Windows == _app.Schedules) {
+            continue;
+        }
+        if (_it != Apps.end()) {
+            Dequeue(_app.Name);
+        } else {
+            _it = Apps.insert(_app.Name, AppSchedule());
+        }
+
+        AppSchedule& _schedule = _it.value();
+        _schedule.Windows = _app.Schedules;
+        _schedule.Starts.clear();
+        _schedule.Stops.clear();
+        for (const ScheduleInfo& _window : _app.Schedules) {
+            A_cronexpression _start;
+            A_cronexpression _stop;
+            _start.Parse(_window.Start);
+            _stop.Parse(_window.Stop);
+            _schedule.Starts.append(_start);
+            _schedule.Stops.append(_stop);
+        }
+
+        // Report the state the new windows imply right away, whatever it was before
+        _schedule.Initial = true;
+        _schedule.DueMs = _nowMs;
+        _schedule.DueStart = DesiredState(_schedule, _nowMs);
+        Queue.insert(_schedule.DueMs, _app.Name);
+        _changed = true;
+    }
+
+    for (auto _it = Apps.begin(); _it != Apps.end();) {
+        if (_seen.contains(_it.key())) {
+            ++_it;
+            continue;
+        }
+        Dequeue(_it.key());
+        _it = Apps.erase(_it);
+        _changed = true;
+    }
+
+    return _changed;
+}
+
+QList<ScheduledTransition> A_scheduler::TakeDue(qint64 _nowMs)
+{
+    QList<ScheduledTransition> _due;
+
+    while (!Queue.isEmpty() && Queue.firstKey() <= _nowMs) {
+        const QString _appName = Queue.first();
+        Queue.erase(Queue.begin());
+
+        AppSchedule& _schedule = Apps[_appName];
+        const qint64 _dueMs = _schedule.DueMs;
+        _schedule.DueMs = 0;
+
+        // Re-evaluate instead of trusting DueStart - the clock may have jumped past several edges
+        const bool _state = DesiredState(_schedule, _nowMs);
+        if (_schedule.Initial || _state != _schedule.State) {
+            _due.append(ScheduledTransition { _appName, _dueMs, _state });
+            _schedule.State = _state;
+            _schedule.Initial = false;
+        }
+
+        Enqueue(_appName, _nowMs);
+    }
+
+    return _due;
+}
+
+qint64 A_scheduler::NextDeadlineMs() const
+{
+    return Queue.isEmpty() ? 0 : Queue.firstKey();
+}
+
+ScheduledTransition A_scheduler::NextTransition(const QString& _appName) const
+{
+    auto _it = Apps.constFind(_appName);
+    if (_it == Apps.constEnd() || _it->DueMs == 0) {
+        return ScheduledTransition { _appName, 0, false };
+    }
+    return ScheduledTransition { _appName, _it->DueMs, _it->DueStart };
+}
+
+bool A_scheduler::DesiredState(const AppSchedule& _schedule, qint64 _timeMs)
+{
+    for (int _i = 0; _i < _schedule.Starts.size(); ++_i) {
+        const qint64 _lastStart = _schedule.Starts.at(_i).PreviousMs(_timeMs);
+        const qint64 _lastStop = _schedule.Stops.at(_i).PreviousMs(_timeMs);
+        // A start and stop in the same minute leave the window closed
+        if (_lastStart > 0 && _lastStart > _lastStop) {
+            return true;
+        }
+    }
+    return false;
+}
+
+qint64 A_scheduler::NextFireMs(const AppSchedule& _schedule, qint64 _afterMs)
+{
+    qint64 _next = 0;
+    for (int _i = 0; _i < _schedule.Starts.size(); ++_i) {
+        for (qint64 _fireMs : { _schedule.Starts.at(_i).NextMs(_afterMs), _schedule.Stops.at(_i).NextMs(_afterMs) }) {
+            if (_fireMs > 0 && (_next == 0 || _fireMs < _next)) {
+                _next = _fireMs;
+            }
+        }
+    }
+    return _next;
+}
+
+void A_scheduler::Enqueue(const QString& _appName, qint64 _afterMs)
+{
+    AppSchedule& _schedule = Apps[_appName];
+
+    // Skip fire times that leave the state as it is, so the queue holds real transitions only
+    qint64 _fireMs = _afterMs;
+    for (int _i = 0; _i < MaxSkippedFires; ++_i) {
+        _fireMs = NextFireMs(_schedule, _fireMs);
+        if (_fireMs == 0) {
+            return;
+        }
+        const bool _state = DesiredState(_schedule, _fireMs);
+        if (_state != _schedule.State) {
+            _schedule.DueMs = _fireMs;
+            _schedule.DueStart = _state;
+            Queue.insert(_fireMs, _appName);
+            return;
+        }
+    }
+
+    qDebug() << "Warning: No schedule transition within" << MaxSkippedFires << "fire times for" << _appName;
+}
+
+void A_scheduler::Dequeue(const QString& _appName)
+{
+    AppSchedule& _schedule = Apps[_appName];
+    if (_schedule.DueMs == 0) {
+        return;
+    }
+
+    for (auto _it = Queue.find(_schedule.DueMs); _it != Queue.end() && _it.key() == _schedule.DueMs; ++_it) {
+        if (_it.value() == _appName) {
+            Queue.erase(_it);
+            break;
+        }
+    }
+    _schedule.DueMs = 0;
+}
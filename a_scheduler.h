@@ -0,0 +1,189 @@
+#ifndef A_SCHEDULER_H
+#define A_SCHEDULER_H
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QMultiMap>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Five-field cron expression - minute hour day-of-month month day-of-week
+ *
+ * Fields accept "*", "N", "N-M", comma lists and "/step" suffixes; day-of-week
+ * runs 0-7 with both 0 and 7 meaning Sunday. As in cron, when both day fields
+ * are restricted a day matches if either does. The @hourly, @daily, @midnight,
+ * @weekly, @monthly, @yearly and @annually shorthands are accepted. Matching
+ * uses local time and one bitmask per field.
+ */
+class A_cronexpression
+{
+public:
+    static constexpr int SearchDays = 8 * 366;  // Search horizon - covers leap-day-only expressions
+
+    A_cronexpression();
+
+    /**
+     * @brief Parses an expression
+     * @param _expression Cron text - five whitespace separated fields or a shorthand
+     * @return bool True if valid; an invalid expression never fires
+     */
+    bool Parse(const QString& _expression);
+
+    /**
+     * @brief Checks whether the last Parse() succeeded
+     * @return bool True if the expression can fire
+     */
+    bool IsValid() const { return Valid; }
+
+    /**
+     * @brief Finds the first fire time after a point in time
+     * @param _afterMs Milliseconds since epoch - exclusive
+     * @return qint64 Fire time in milliseconds since epoch - 0 if none within SearchDays
+     */
+    qint64 NextMs(qint64 _afterMs) const;
+
+    /**
+     * @brief Finds the last fire time up to a point in time
+     * @param _atOrBeforeMs Milliseconds since epoch - inclusive
+     * @return qint64 Fire time in milliseconds since epoch - 0 if none within SearchDays
+     */
+    qint64 PreviousMs(qint64 _atOrBeforeMs) const;
+
+private:
+    quint64 Minutes;            // Bit N set - minute N matches
+    quint32 Hours;              // Bit N set - hour N matches
+    quint32 DaysOfMonth;        // Bit N set - day N (1-31) matches
+    quint32 Months;             // Bit N set - month N (1-12) matches
+    quint32 DaysOfWeek;         // Bit N set - weekday N (0 = Sunday) matches
+    bool DayOfMonthRestricted;  // Day-of-month field was not "*"
+    bool DayOfWeekRestricted;   // Day-of-week field was not "*"
+    bool Valid;                 // Parse succeeded
+
+    /**
+     * @brief Parses one field into a bitmask
+     * @param _field Field text
+     * @param _min Lowest allowed value
+     * @param _max Highest allowed value
+     * @param _bits Receives one bit per matching value
+     * @return bool True if every part of the field is valid
+     */
+    static bool ParseField(const QString& _field, int _min, int _max, quint64* _bits);
+
+    /**
+     * @brief Checks the month and day fields against a date
+     * @param _date Local date
+     * @return bool True if the expression can fire on that day
+     */
+    bool MatchesDate(const QDate& _date) const;
+};
+
+/**
+ * @brief A run window edge reached by a scheduled application
+ */
+struct ScheduledTransition {
+    QString AppName;            // Application name
+    qint64 TimeMs = 0;          // Transition time - milliseconds since epoch, 0 if none pending
+    bool Start = false;         // True if the application should start, false if it should stop
+};
+
+/**
+ * @brief Next-fire-time scheduler for application run windows
+ *
+ * Each scheduled application has exactly one pending entry in a queue ordered
+ * by time: the next moment its desired state actually changes. Fire times that
+ * do not change the state (a start inside an already open window) are skipped
+ * when the entry is computed, so the owner only has to sleep until
+ * NextDeadlineMs() and collect TakeDue(); nothing is evaluated between
+ * transitions. The desired state at any time is whether any window's latest
+ * start fire is newer than its latest stop fire.
+ *
+ * Time is passed in by the caller so simulators can drive it with their clock.
+ */
+class A_scheduler
+{
+public:
+    static constexpr int MaxSkippedFires = 64;  // Fire times inspected per entry before giving up
+
+    /**
+     * @brief Synchronizes run windows with the configuration
+     * Applications whose windows are unchanged keep their pending entry. New or
+     * changed applications get an immediate entry carrying their current state.
+     * @param _apps Current application list - applications without windows are unscheduled
+     * @param _nowMs Current time - milliseconds since epoch
+     * @return bool True if the queue changed
+     */
+    bool SetSchedules(const QList<AppInfo>& _apps, qint64 _nowMs);
+
+    /**
+     * @brief Removes and returns all transitions due by a point in time
+     * Each application is queued again at its following transition.
+     * @param _nowMs Current time - milliseconds since epoch
+     * @return QList<ScheduledTransition> Due transitions in time order
+     */
+    QList<ScheduledTransition> TakeDue(qint64 _nowMs);
+
+    /**
+     * @brief Gets the time of the earliest pending transition
+     * @return qint64 Milliseconds since epoch - 0 if nothing is scheduled
+     */
+    qint64 NextDeadlineMs() const;
+
+    /**
+     * @brief Gets the pending transition of an application
+     * @param _appName Application name
+     * @return ScheduledTransition Pending transition - TimeMs is 0 if the application is unscheduled
+     */
+    ScheduledTransition NextTransition(const QString& _appName) const;
+
+private:
+    /**
+     * @brief Parsed run windows and queue entry of one application
+     */
+    struct AppSchedule {
+        QList<ScheduleInfo> Windows;            // Configured windows - change detection
+        QVector<A_cronexpression> Starts;       // Parsed start expressions - one per window
+        QVector<A_cronexpression> Stops;        // Parsed stop expressions - one per window
+        bool State = false;                     // Desired state last reported
+        bool Initial = true;                    // Current state not reported yet
+        qint64 DueMs = 0;                       // Queued transition time - 0 if none
+        bool DueStart = false;                  // Queued transition direction
+    };
+
+    QHash<QString, AppSchedule> Apps;           // Scheduled applications - key: app name
+    QMultiMap<qint64, QString> Queue;           // Pending transitions - key: time, value: app name
+
+    /**
+     * @brief Computes whether an application should run at a point in time
+     * @param _schedule Application windows
+     * @param _timeMs Milliseconds since epoch
+     * @return bool True if any window is open
+     */
+    static bool DesiredState(const AppSchedule& _schedule, qint64 _timeMs);
+
+    /**
+     * @brief Finds the first fire time of any window edge after a point in time
+     * @param _schedule Application windows
+     * @param _afterMs Milliseconds since epoch - exclusive
+     * @return qint64 Milliseconds since epoch - 0 if none
+     */
+    static qint64 NextFireMs(const AppSchedule& _schedule, qint64 _afterMs);
+
+    /**
+     * @brief Queues an application at its next state change after a point in time
+     * @param _appName Application name - must be in Apps
+     * @param _afterMs Milliseconds since epoch - exclusive
+     */
+    void Enqueue(const QString& _appName, qint64 _afterMs);
+
+    /**
+     * @brief Removes an application's queue entry
+     * @param _appName Application name - must be in Apps
+     */
+    void Dequeue(const QString& _appName);
+};
+
+#endif // A_SCHEDULER_H
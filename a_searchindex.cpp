@@ -0,0 +1,152 @@
+#include "a_searchindex.h"
+#include <algorithm>
+
+A_searchindex::A_searchindex()
+{
+}
+
+void A_searchindex::Clear()
+{
+    Texts.clear();
+    States.clear();
+    Postings.clear();
+}
+
+quint64 A_searchindex::GramKey(const QString& _text, int _position, int _length)
+{
+    quint64 _key = quint64(_length) << 48;
+    for (int _i = 0; _i < _length; ++_i) {
+        _key |= quint64(_text.at(_position + _i).unicode()) << (16 * _i);
+    }
+    return _key;
+}
+
+QVector<quint64> A_searchindex::Grams(const QString& _text)
+{
+    QVector<quint64> _grams;
+    _grams.reserve(_text.size() * 3);
+    for (int _length = 1; _length <= 3; ++_length) {
+        for (int _position = 0; _position + _length <= _text.size(); ++_position) {
+            _grams.append(GramKey(_text, _position, _length));
+        }
+    }
+    std::sort(_grams.begin(), _grams.end());
+    _grams.erase(std::unique(_grams.begin(), _grams.end()), _grams.end());
+    return _grams;
+}
+
+void A_searchindex::UpdatePostings(int _id, const QString& _text, bool _insert)
+{
+    const QVector<quint64> _grams = Grams(_text);
+    for (quint64 _gram : _grams) {
+        QVector<int>& _list = Postings[_gram];
+        if (_insert) {
+            // Ascending rebuilds append; out-of-order updates insert in place
+            if (_list.isEmpty() || _list.last() < _id) {
+                _list.append(_id);
+            } else {
+                auto _at = std::lower_bound(_list.begin(), _list.end(), _id);
+                if (_at == _list.end() || *_at != _id) {
+                    _list.insert(_at, _id);
+                }
+            }
+        } else {
+            auto _at = std::lower_bound(_list.begin(), _list.end(), _id);
+            if (_at != _list.end() && *_at == _id) {
+                _list.erase(_at);
+            }
+            if (_list.isEmpty()) {
+                Postings.remove(_gram);
+            }
+        }
+    }
+}
+
+void A_searchindex::SetDocument(int _id, const QString& _text, quint8 _state)
+{
+    if (_id < 0) {
+        return;
+    }
+
+    if (_id >= Texts.size()) {
+        Texts.resize(_id + 1);
+        States.resize(_id + 1);
+    } else if (!Texts.at(_id).isNull()) {
+        UpdatePostings(_id, Texts.at(_id), false);
+    }
+
+    // Non-null even when empty, so the slot counts as present
+    QString _lower = _text.toLower();
+    if (_lower.isNull()) {
+        _lower = QString("");
+    }
+    UpdatePostings(_id, _lower, true);
+    Texts[_id] = _lower;
+    States[_id] = _state;
+}
+
+void A_searchindex::SetState(int _id, quint8 _state)
+{
+    if (_id >= 0 && _id < States.size()) {
+        States[_id] = _state;
+    }
+}
+
+QVector<int> A_searchindex::Search(const QString& _query, quint8 _stateMask) const
+{
+    QVector<int> _result;
+    const QString _lower = _query.toLower();
+
+    if (_lower.isEmpty()) {
+        _result.reserve(Texts.size());
+        for (int _id = 0; _id < Texts.size(); ++_id) {
+            if (!Texts.at(_id).isNull() && (States.at(_id) & _stateMask)) {
+                _result.append(_id);
+            }
+        }
+        return _result;
+    }
+
+    // Posting lists of the query's grams; any missing gram means no match
+    const int _gramLength = qMin(3, int(_lower.size()));
+    QVector<const QVector<int>*> _lists;
+    for (int _position = 0; _position + _gramLength <= _lower.size(); ++_position) {
+        auto _it = Postings.constFind(GramKey(_lower, _position, _gramLength));
+        if (_it == Postings.constEnd()) {
+            return _result;
+        }
+        if (!_lists.contains(&_it.value())) {
+            _lists.append(&_it.value());
+        }
+    }
+    std::sort(_lists.begin(), _lists.end(),
+              [](const QVector<int>* _a, const QVector<int>* _b) { return _a->size() < _b->size(); });
+
+    // Intersect smallest first so the candidate set only shrinks
+    QVector<int> _candidates;
+    for (int _id : *_lists.first()) {
+        if (States.at(_id) & _stateMask) {
+            _candidates.append(_id);
+        }
+    }
+    for (int _i = 1; _i < _lists.size() && !_candidates.isEmpty(); ++_i) {
+        QVector<int> _next;
+        _next.reserve(_candidates.size());
+        std::set_intersection(_candidates.constBegin(), _candidates.constEnd(),
+                              _lists.at(_i)->constBegin(), _lists.at(_i)->constEnd(),
+                              std::back_inserter(_next));
+        _candidates.swap(_next);
+    }
+
+    // Up to three characters the gram match is exact; longer queries need a check
+    if (_lower.size() <= 3) {
+        return _candidates;
+    }
+    _result.reserve(_candidates.size());
+    for (int _id : _candidates) {
+        if (Texts.at(_id).contains(_lower)) {
+            _result.append(_id);
+        }
+    }
+    return _result;
+}
@@ -0,0 +1,99 @@
+#ifndef A_SEARCHINDEX_H
+#define A_SEARCHINDEX_H
+
+#include <QHash>
+#include <QVector>
+#include <QString>
+
+/**
+ * @brief Incrementally maintained substring index over application documents
+ *
+ * Every document (application name and executable path, lower-cased) is split
+ * into its distinct 1-, 2- and 3-character grams. Each gram keeps a sorted
+ * posting list of document ids. A query intersects the posting lists of its
+ * trigrams, smallest first, and verifies the remaining candidates, so the cost
+ * follows the number of matches rather than the number of documents. Queries
+ * of one or two characters are answered exactly from the shorter grams.
+ *
+ * Documents carry a small state bit set that queries can filter on; changing
+ * it does not touch the gram postings.
+ */
+class A_searchindex
+{
+public:
+    A_searchindex();
+
+    /**
+     * @brief Removes all documents
+     */
+    void Clear();
+
+    /**
+     * @brief Adds or replaces a document
+     * Adding ids in ascending order appends to the posting lists, which makes
+     * a full rebuild linear.
+     * @param _id Document id - non-negative, ids should be dense
+     * @param _text Searchable text - matched case-insensitively
+     * @param _state State bits of the document
+     */
+    void SetDocument(int _id, const QString& _text, quint8 _state);
+
+    /**
+     * @brief Changes the state bits of a document
+     * @param _id Document id - ignored if unknown
+     * @param _state New state bits
+     */
+    void SetState(int _id, quint8 _state);
+
+    /**
+     * @brief Gets the state bits of a document
+     * @param _id Document id
+     * @return quint8 State bits - 0 if unknown
+     */
+    quint8 State(int _id) const { return (_id >= 0 && _id < States.size()) ? States.at(_id) : 0; }
+
+    /**
+     * @brief Finds documents containing a substring
+     * @param _query Substring - empty matches every document
+     * @param _stateMask Accepted state bits - a document matches if any bit is shared
+     * @return QVector<int> Matching document ids in ascending order
+     */
+    QVector<int> Search(const QString& _query, quint8 _stateMask) const;
+
+    /**
+     * @brief Gets the number of documents
+     * @return int Document count
+     */
+    int Size() const { return Texts.size(); }
+
+private:
+    QVector<QString> Texts;                     // Lower-cased document text - index: id, null if absent
+    QVector<quint8> States;                     // Document state bits - index: id
+    QHash<quint64, QVector<int>> Postings;      // Sorted document ids - key: packed gram
+
+    /**
+     * @brief Packs up to three UTF-16 code units into a gram key
+     * @param _text Source text
+     * @param _position First code unit
+     * @param _length Gram length - 1 to 3
+     * @return quint64 Gram key - length in the top bits keeps lengths apart
+     */
+    static quint64 GramKey(const QString& _text, int _position, int _length);
+
+    /**
+     * @brief Collects the distinct grams of a text
+     * @param _text Lower-cased text
+     * @return QVector<quint64> Sorted, unique gram keys
+     */
+    static QVector<quint64> Grams(const QString& _text);
+
+    /**
+     * @brief Adds or removes one document from the posting lists of its grams
+     * @param _id Document id
+     * @param _text Lower-cased document text
+     * @param _insert True to add, false to remove
+     */
+    void UpdatePostings(int _id, const QString& _text, bool _insert);
+};
+
+#endif // A_SEARCHINDEX_H
@@ -1,12 +1,14 @@
 #include "a_settingsclass.h"
+#include "a_metrics.h"
+#include "a_tracer.h"
+#include "a_scheduler.h"
+#include "a_launchpolicy.h"
 
 A_settingsclass::A_settingsclass()
 {
     // Initialize default values
-    ServerId = "";
-    ServerPort = "";
-    ServerIp = "";
     XmlFilePath = "";
+    Current = std::make_shared<const ConfigSnapshot>();
 }
 
 A_settingsclass::~A_settingsclass()
@@ -16,6 +18,7 @@ A_settingsclass::~A_settingsclass()
 
 bool A_settingsclass::LoadConfiguration(const QString& _filePath)
 {
+    QMutexLocker _lock(&WriteLock);
     XmlFilePath = _filePath;
 
     QFile _xmlFile(_filePath);
@@ -43,30 +46,49 @@ bool A_settingsclass::LoadConfiguration(const QString& _filePath)
         return false;
     }
 
+    // Sections missing from the file keep their current values
+    auto _next = std::make_shared<ConfigSnapshot>(*Snapshot());
+
     // Parse settings
     QDomNodeList _settingsNodes = _rootElement.elementsByTagName("settings");
     if (_settingsNodes.size() > 0) {
-        ParseSettings(_settingsNodes.at(0).toElement());
+        ParseSettings(_settingsNodes.at(0).toElement(), _next.get());
     }
 
     // Parse applications
     QDomNodeList _appsNodes = _rootElement.elementsByTagName("applications");
     if (_appsNodes.size() > 0) {
-        ParseApplications(_appsNodes.at(0).toElement());
+        ParseApplications(_appsNodes.at(0).toElement(), _next.get());
+    }
+
+    // Parse fleet monitors - present only in a hub's configuration
+    _next->FleetMonitors.clear();
+    const QDomElement _fleetElement = _rootElement.firstChildElement("fleet");
+    for (QDomElement _monitor = _fleetElement.firstChildElement("monitor"); !_monitor.isNull();
+         _monitor = _monitor.nextSiblingElement("monitor")) {
+        const QString _endpoint = _monitor.text().trimmed();
+        if (!_endpoint.isEmpty()) {
+            _next->FleetMonitors.append(_endpoint);
+        }
     }
 
+    Publish(std::move(_next));
     return true;
 }
 
 bool A_settingsclass::SaveConfiguration()
 {
+    QTPM_METRIC_SCOPE(ConfigSave);
+    QTPM_TRACE_SCOPE("config", "SaveConfiguration");
+    QMutexLocker _lock(&WriteLock);
+
     if (XmlFilePath.isEmpty()) {
         qDebug() << "Error: No file path set for saving configuration.";
         return false;
     }
 
     // Build the XML document with current data
-    BuildXmlDocument();
+    BuildXmlDocument(*Snapshot());
     
     // Save to the current working file first
     bool _savedToCurrent = SaveToFile(XmlFilePath);
@@ -152,17 +174,27 @@ bool A_settingsclass::SaveToFile(const QString& _filePath)
 
 void A_settingsclass::UpdateSettings(const QString& _id, const QString& _port, const QString& _ip)
 {
-    ServerId = _id;
-    ServerPort = _port;
-    ServerIp = _ip;
+    QMutexLocker _lock(&WriteLock);
+    auto _next = std::make_shared<ConfigSnapshot>(*Snapshot());
+    _next->ServerId = _id;
+    _next->ServerPort = _port;
+    _next->ServerIp = _ip;
+    Publish(std::move(_next));
     qDebug() << "Settings updated - ID:" << _id << "Port:" << _port << "IP:" << _ip;
 }
 
 bool A_settingsclass::UpdateAppStatus(const QString& _appName, const QString& _status)
 {
-    for (int _i = 0; _i < Applications.size(); ++_i) {
-        if (Applications[_i].Name == _appName) {
-            Applications[_i].Status = _status;
+    QMutexLocker _lock(&WriteLock);
+    const ConfigSnapshotPtr _current = Snapshot();
+    for (int _i = 0; _i < _current->Applications.size(); ++_i) {
+        if (_current->Applications.at(_i).Name == _appName) {
+            if (_current->Applications.at(_i).Status == _status) {
+                return true; // Unchanged - no new version
+            }
+            auto _next = std::make_shared<ConfigSnapshot>(*_current);
+            _next->Applications[_i].Status = _status;
+            Publish(std::move(_next));
             qDebug() << "App status updated -" << _appName << ":" << _status;
             return true;
         }
@@ -172,7 +204,13 @@ bool A_settingsclass::UpdateAppStatus(const QString& _appName, const QString& _s
     return false;
 }
 
-void A_settingsclass::ParseSettings(const QDomElement& _settingsElement)
+void A_settingsclass::Publish(std::shared_ptr<ConfigSnapshot> _next)
+{
+    _next->Version = Snapshot()->Version + 1;
+    std::atomic_store(&Current, ConfigSnapshotPtr(std::move(_next)));
+}
+
+void A_settingsclass::ParseSettings(const QDomElement& _settingsElement, ConfigSnapshot* _config)
 {
     QDomNodeList _children = _settingsElement.childNodes();
 
@@ -180,20 +218,20 @@ void A_settingsclass::ParseSettings(const QDomElement& _settingsElement)
         QDomElement _child = _children.at(_i).toElement();
 
         if (_child.tagName() == "id") {
-            ServerId = _child.text().trimmed();
+            _config->ServerId = _child.text().trimmed();
         } else if (_child.tagName() == "port") {
-            ServerPort = _child.text().trimmed();
+            _config->ServerPort = _child.text().trimmed();
         } else if (_child.tagName() == "ip") {
-            ServerIp = _child.text().trimmed();
+            _config->ServerIp = _child.text().trimmed();
         }
     }
 
-    qDebug() << "Settings parsed - ID:" << ServerId << "Port:" << ServerPort << "IP:" << ServerIp;
+    qDebug() << "Settings parsed - ID:" << _config->ServerId << "Port:" << _config->ServerPort << "IP:" << _config->ServerIp;
 }
 
-void A_settingsclass::ParseApplications(const QDomElement& _appsElement)
+void A_settingsclass::ParseApplications(const QDomElement& _appsElement, ConfigSnapshot* _config)
 {
-    Applications.clear();
+    _config->Applications.clear();
     QDomNodeList _appNodes = _appsElement.elementsByTagName("app");
 
     for (int _i = 0; _i < _appNodes.size(); ++_i) {
@@ -211,19 +249,117 @@ void A_settingsclass::ParseApplications(const QDomElement& _appsElement)
                 _appInfo.Executable = _child.text().trimmed();
             } else if (_child.tagName() == "status") {
                 _appInfo.Status = _child.text().trimmed();
+            } else if (_child.tagName() == "probe") {
+                _appInfo.Probe = ParseProbe(_child);
+            } else if (_child.tagName() == "schedule") {
+                ScheduleInfo _schedule;
+                if (ParseSchedule(_child, &_schedule)) {
+                    _appInfo.Schedules.append(_schedule);
+                } else {
+                    // Not applied, but kept so a save does not delete what the user typed
+                    QString _raw;
+                    QTextStream _stream(&_raw);
+                    _child.save(_stream, 0);
+                    _appInfo.RejectedSchedules.append(_raw);
+                }
+            } else if (_child.tagName() == "idle") {
+                _appInfo.Idle = ParseIdle(_child);
+            } else if (_child.tagName() == "heartbeatTimeout") {
+                bool _ok = false;
+                const int _timeout = _child.text().trimmed().toInt(&_ok);
+                if (_ok && _timeout > 0) {
+                    _appInfo.HeartbeatTimeout = _timeout;
+                } else {
+                    qDebug() << "Warning: Invalid heartbeat timeout ignored:" << _child.text();
+                }
+            } else if (_child.tagName() == "listen") {
+                const QString _listen = _child.text().trimmed();
+                if (!_listen.isEmpty()) {
+                    _appInfo.Listen.append(_listen);
+                }
+            } else if (_child.tagName() == "stopTimeout") {
+                bool _ok = false;
+                const int _timeout = _child.text().trimmed().toInt(&_ok);
+                if (_ok && _timeout > 0) {
+                    _appInfo.StopTimeout = _timeout;
+                } else {
+                    qDebug() << "Warning: Invalid stop timeout ignored:" << _child.text();
+                }
+            } else if (_child.tagName() == "dependsOn") {
+                const QString _dependency = _child.text().trimmed();
+                if (!_dependency.isEmpty()) {
+                    _appInfo.DependsOn.append(_dependency);
+                }
+            } else {
+                ParsePolicyElement(_child, &_appInfo.Policy);
             }
         }
 
         if (!_appInfo.Name.isEmpty() && !_appInfo.Executable.isEmpty()) {
-            Applications.append(_appInfo);
+            _config->Applications.append(_appInfo);
             qDebug() << "App parsed:" << _appInfo.Name << "Status:" << _appInfo.Status;
         }
     }
 
-    qDebug() << "Total applications loaded:" << Applications.size();
+    qDebug() << "Total applications loaded:" << _config->Applications.size();
 }
 
-void A_settingsclass::BuildXmlDocument()
+ProbeInfo A_settingsclass::ParseProbe(const QDomElement& _probeElement)
+{
+    ProbeInfo _probe;
+    _probe.Type = _probeElement.attribute("type").trimmed().toLower();
+
+    if (_probe.Type != "tcp" && _probe.Type != "http" && _probe.Type != "exec") {
+        qDebug() << "Warning: Unknown probe type ignored:" << _probe.Type;
+        return ProbeInfo();
+    }
+
+    QDomNodeList _children = _probeElement.childNodes();
+    for (int _i = 0; _i < _children.size(); ++_i) {
+        QDomElement _child = _children.at(_i).toElement();
+        QString _value = _child.text().trimmed();
+        bool _ok = false;
+
+        if (_child.tagName() == "host") {
+            _probe.Host = _value;
+        } else if (_child.tagName() == "port") {
+            int _port = _value.toInt(&_ok);
+            if (_ok && _port > 0 && _port <= 65535) {
+                _probe.Port = _port;
+            }
+        } else if (_child.tagName() == "path") {
+            _probe.Path = _value.startsWith('/') ? _value : "/" + _value;
+        } else if (_child.tagName() == "command") {
+            _probe.Command = _value;
+        } else if (_child.tagName() == "timeout") {
+            int _timeout = _value.toInt(&_ok);
+            if (_ok && _timeout > 0) {
+                _probe.TimeoutMs = _timeout;
+            }
+        } else if (_child.tagName() == "period") {
+            int _period = _value.toInt(&_ok);
+            if (_ok && _period > 0) {
+                _probe.PeriodMs = _period;
+            }
+        } else if (_child.tagName() == "failureThreshold") {
+            int _threshold = _value.toInt(&_ok);
+            if (_ok && _threshold > 0) {
+                _probe.FailureThreshold = _threshold;
+            }
+        }
+    }
+
+    // A probe without a target cannot run
+    if ((_probe.Type == "exec" && _probe.Command.isEmpty()) ||
+        (_probe.Type != "exec" && _probe.Port == 0)) {
+        qDebug() << "Warning: Incomplete" << _probe.Type << "probe ignored";
+        return ProbeInfo();
+    }
+
+    return _probe;
+}
+
+void A_settingsclass::BuildXmlDocument(const ConfigSnapshot& _config)
 {
     XmlDocument.clear();
 
@@ -237,15 +373,15 @@ void A_settingsclass::BuildXmlDocument()
 
     // Add settings children
     QDomElement _idElement = XmlDocument.createElement("id");
-    _idElement.appendChild(XmlDocument.createTextNode(ServerId));
+    _idElement.appendChild(XmlDocument.createTextNode(_config.ServerId));
     _settingsElement.appendChild(_idElement);
 
     QDomElement _portElement = XmlDocument.createElement("port");
-    _portElement.appendChild(XmlDocument.createTextNode(ServerPort));
+    _portElement.appendChild(XmlDocument.createTextNode(_config.ServerPort));
     _settingsElement.appendChild(_portElement);
 
     QDomElement _ipElement = XmlDocument.createElement("ip");
-    _ipElement.appendChild(XmlDocument.createTextNode(ServerIp));
+    _ipElement.appendChild(XmlDocument.createTextNode(_config.ServerIp));
     _settingsElement.appendChild(_ipElement);
 
     // Create applications section
@@ -253,7 +389,7 @@ void A_settingsclass::BuildXmlDocument()
     _rootElement.appendChild(_appsElement);
 
     // Add each application
-    for (const AppInfo& _app : Applications) {
+    for (const AppInfo& _app : _config.Applications) {
         QDomElement _appElement = XmlDocument.createElement("app");
         _appsElement.appendChild(_appElement);
 
@@ -268,5 +404,236 @@ void A_settingsclass::BuildXmlDocument()
         QDomElement _statusElement = XmlDocument.createElement("status");
         _statusElement.appendChild(XmlDocument.createTextNode(_app.Status));
         _appElement.appendChild(_statusElement);
+
+        AppendProbeElement(_appElement, _app.Probe);
+        AppendScheduleElements(_appElement, _app.Schedules, _app.RejectedSchedules);
+        AppendPolicyElements(_appElement, _app.Policy);
+        AppendIdleElement(_appElement, _app.Idle);
+
+        if (_app.HeartbeatTimeout > 0) {
+            QDomElement _heartbeatElement = XmlDocument.createElement("heartbeatTimeout");
+            _heartbeatElement.appendChild(XmlDocument.createTextNode(QString::number(_app.HeartbeatTimeout)));
+            _appElement.appendChild(_heartbeatElement);
+        }
+
+        for (const QString& _listen : _app.Listen) {
+            QDomElement _listenElement = XmlDocument.createElement("listen");
+            _listenElement.appendChild(XmlDocument.createTextNode(_listen));
+            _appElement.appendChild(_listenElement);
+        }
+
+        if (_app.StopTimeout > 0) {
+            QDomElement _stopTimeoutElement = XmlDocument.createElement("stopTimeout");
+            _stopTimeoutElement.appendChild(XmlDocument.createTextNode(QString::number(_app.StopTimeout)));
+            _appElement.appendChild(_stopTimeoutElement);
+        }
+
+        for (const QString& _dependency : _app.DependsOn) {
+            QDomElement _dependsElement = XmlDocument.createElement("dependsOn");
+            _dependsElement.appendChild(XmlDocument.createTextNode(_dependency));
+            _appElement.appendChild(_dependsElement);
+        }
     }
+
+    // Hub mode - monitors whose state is aggregated
+    if (!_config.FleetMonitors.isEmpty()) {
+        QDomElement _fleetElement = XmlDocument.createElement("fleet");
+        _rootElement.appendChild(_fleetElement);
+        for (const QString& _endpoint : _config.FleetMonitors) {
+            QDomElement _monitorElement = XmlDocument.createElement("monitor");
+            _monitorElement.appendChild(XmlDocument.createTextNode(_endpoint));
+            _fleetElement.appendChild(_monitorElement);
+        }
+    }
+}
+
+void A_settingsclass::AppendProbeElement(QDomElement& _appElement, const ProbeInfo& _probe)
+{
+    if (!_probe.IsEnabled()) {
+        return;
+    }
+
+    QDomElement _probeElement = XmlDocument.createElement("probe");
+    _probeElement.setAttribute("type", _probe.Type);
+    _appElement.appendChild(_probeElement);
+
+    auto _appendChild = [this, &_probeElement](const QString& _tag, const QString& _value) {
+        QDomElement _element = XmlDocument.createElement(_tag);
+        _element.appendChild(XmlDocument.createTextNode(_value));
+        _probeElement.appendChild(_element);
+    };
+
+    if (_probe.Type == "exec") {
+        _appendChild("command", _probe.Command);
+    } else {
+        _appendChild("host", _probe.Host);
+        _appendChild("port", QString::number(_probe.Port));
+        if (_probe.Type == "http") {
+            _appendChild("path", _probe.Path);
+        }
+    }
+    _appendChild("timeout", QString::number(_probe.TimeoutMs));
+    _appendChild("period", QString::number(_probe.PeriodMs));
+    _appendChild("failureThreshold", QString::number(_probe.FailureThreshold));
+}
+
+bool A_settingsclass::ParseSchedule(const QDomElement& _scheduleElement, ScheduleInfo* _schedule)
+{
+    _schedule->Start = _scheduleElement.firstChildElement("start").text().simplified();
+    _schedule->Stop = _scheduleElement.firstChildElement("stop").text().simplified();
+
+    // A window needs both edges; a bad expression would silently never fire
+    A_cronexpression _start;
+    A_cronexpression _stop;
+    if (!_start.Parse(_schedule->Start) || !_stop.Parse(_schedule->Stop)) {
+        qDebug() << "Warning: Invalid schedule not applied - start:" << _schedule->Start << "stop:" << _schedule->Stop;
+        return false;
+    }
+    return true;
+}
+
+void A_settingsclass::AppendScheduleElements(QDomElement& _appElement, const QList<ScheduleInfo>& _schedules,
+                                             const QStringList& _rejected)
+{
+    for (const ScheduleInfo& _schedule : _schedules) {
+        QDomElement _scheduleElement = XmlDocument.createElement("schedule");
+        _appElement.appendChild(_scheduleElement);
+
+        QDomElement _startElement = XmlDocument.createElement("start");
+        _startElement.appendChild(XmlDocument.createTextNode(_schedule.Start));
+        _scheduleElement.appendChild(_startElement);
+
+        QDomElement _stopElement = XmlDocument.createElement("stop");
+        _stopElement.appendChild(XmlDocument.createTextNode(_schedule.Stop));
+        _scheduleElement.appendChild(_stopElement);
+    }
+
+    for (const QString& _raw : _rejected) {
+        QDomDocument _fragment;
+        if (_fragment.setContent(_raw)) {
+            _appElement.appendChild(XmlDocument.importNode(_fragment.documentElement(), true));
+        }
+    }
+}
+
+bool A_settingsclass::ParsePolicyElement(const QDomElement& _element, LaunchPolicy* _policy)
+{
+    const QString _tag = _element.tagName();
+    const QString _value = _element.text().trimmed();
+    bool _ok = false;
+
+    if (_tag == "cpus") {
+        QVector<int> _cpus;
+        if (A_launchpolicy::ParseCpuList(_value, &_cpus)) {
+            _policy->Cpus = _value;
+        } else {
+            qDebug() << "Warning: Invalid CPU list ignored:" << _value;
+        }
+    } else if (_tag == "numaNode") {
+        const int _node = _value.toInt(&_ok);
+        if (_ok && _node >= 0 && _node < A_launchpolicy::MaxNumaNodes) {
+            _policy->NumaNode = _node;
+        } else {
+            qDebug() << "Warning: Invalid NUMA node ignored:" << _value;
+        }
+    } else if (_tag == "nice") {
+        const int _nice = _value.toInt(&_ok);
+        if (_ok && _nice >= -20 && _nice <= 19) {
+            _policy->Nice = _nice;
+        } else {
+            qDebug() << "Warning: Invalid nice value ignored:" << _value;
+        }
+    } else if (_tag == "ioClass") {
+        const QString _class = _value.toLower();
+        if (_class == "realtime" || _class == "best-effort" || _class == "idle") {
+            _policy->IoClass = _class;
+        } else {
+            qDebug() << "Warning: Unknown I/O class ignored:" << _value;
+        }
+    } else if (_tag == "ioPriority") {
+        const int _priority = _value.toInt(&_ok);
+        if (_ok && _priority >= 0 && _priority <= 7) {
+            _policy->IoPriority = _priority;
+        } else {
+            qDebug() << "Warning: Invalid I/O priority ignored:" << _value;
+        }
+    } else if (_tag == "oomScoreAdj") {
+        const int _adjust = _value.toInt(&_ok);
+        if (_ok && _adjust >= -1000 && _adjust <= 1000) {
+            _policy->OomScoreAdj = _adjust;
+        } else {
+            qDebug() << "Warning: Invalid OOM score adjustment ignored:" << _value;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void A_settingsclass::AppendPolicyElements(QDomElement& _appElement, const LaunchPolicy& _policy)
+{
+    auto _appendChild = [this, &_appElement](const QString& _tag, const QString& _value) {
+        QDomElement _element = XmlDocument.createElement(_tag);
+        _element.appendChild(XmlDocument.createTextNode(_value));
+        _appElement.appendChild(_element);
+    };
+
+    if (!_policy.Cpus.isEmpty()) {
+        _appendChild("cpus", _policy.Cpus);
+    }
+    if (_policy.NumaNode >= 0) {
+        _appendChild("numaNode", QString::number(_policy.NumaNode));
+    }
+    if (_policy.Nice != LaunchPolicy::Inherit) {
+        _appendChild("nice", QString::number(_policy.Nice));
+    }
+    if (!_policy.IoClass.isEmpty()) {
+        _appendChild("ioClass", _policy.IoClass);
+        _appendChild("ioPriority", QString::number(_policy.IoPriority));
+    }
+    if (_policy.OomScoreAdj != LaunchPolicy::Inherit) {
+        _appendChild("oomScoreAdj", QString::number(_policy.OomScoreAdj));
+    }
+}
+
+IdleInfo A_settingsclass::ParseIdle(const QDomElement& _idleElement)
+{
+    IdleInfo _idle;
+    bool _ok = false;
+
+    const int _timeout = _idleElement.firstChildElement("timeout").text().trimmed().toInt(&_ok);
+    if (!_ok || _timeout <= 0) {
+        qDebug() << "Warning: Idle shutdown without a valid <timeout> ignored";
+        return IdleInfo();
+    }
+    _idle.TimeoutSeconds = _timeout;
+
+    const QDomElement _cpuElement = _idleElement.firstChildElement("cpuPercent");
+    if (!_cpuElement.isNull()) {
+        const double _cpu = _cpuElement.text().trimmed().toDouble(&_ok);
+        if (_ok && _cpu >= 0.0) {
+            _idle.CpuPercent = _cpu;
+        } else {
+            qDebug() << "Warning: Invalid idle CPU threshold ignored:" << _cpuElement.text();
+        }
+    }
+    return _idle;
+}
+
+void A_settingsclass::AppendIdleElement(QDomElement& _appElement, const IdleInfo& _idle)
+{
+    if (!_idle.IsEnabled()) {
+        return;
+    }
+
+    QDomElement _idleElement = XmlDocument.createElement("idle");
+    _appElement.appendChild(_idleElement);
+
+    QDomElement _timeoutElement = XmlDocument.createElement("timeout");
+    _timeoutElement.appendChild(XmlDocument.createTextNode(QString::number(_idle.TimeoutSeconds)));
+    _idleElement.appendChild(_timeoutElement);
+
+    QDomElement _cpuElement = XmlDocument.createElement("cpuPercent");
+    _cpuElement.appendChild(XmlDocument.createTextNode(QString::number(_idle.CpuPercent)));
+    _idleElement.appendChild(_cpuElement);
 }
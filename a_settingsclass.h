@@ -2,6 +2,7 @@
 #define A_SETTINGSCLASS_H
 
 #include <QString>
+#include <QStringList>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomNode>
@@ -11,6 +12,100 @@
 #include <QStringConverter>
 #include <QFileInfo>
 #include <QDir>
+#include <QMutex>
+#include <climits>
+#include <memory>
+
+/**
+ * @brief Structure to hold an application's health probe definition
+ *
+ * Parsed from an optional <probe type="tcp|http|exec"> element of <app>.
+ */
+struct ProbeInfo {
+    QString Type;               // Probe type - "tcp", "http", "exec" or empty for no probe
+    QString Host = "127.0.0.1"; // Target host - IPv4 address for tcp/http probes
+    int Port = 0;               // Target port - required for tcp/http probes
+    QString Path = "/";         // Request path - used by http probes
+    QString Command;            // Command line - run through "sh -c" by exec probes
+    int TimeoutMs = 1000;       // Probe timeout - milliseconds before a probe counts as failed
+    int PeriodMs = 5000;        // Probe period - milliseconds between probe starts
+    int FailureThreshold = 3;   // Failure threshold - consecutive failures before restart
+
+    bool IsEnabled() const { return !Type.isEmpty(); }
+
+    bool operator==(const ProbeInfo& _other) const {
+        return Type == _other.Type && Host == _other.Host && Port == _other.Port
+               && Path == _other.Path && Command == _other.Command
+               && TimeoutMs == _other.TimeoutMs && PeriodMs == _other.PeriodMs
+               && FailureThreshold == _other.FailureThreshold;
+    }
+    bool operator!=(const ProbeInfo& _other) const { return !(*this == _other); }
+};
+
+/**
+ * @brief Structure to hold an application's launch-time scheduling policy
+ *
+ * Parsed from the optional <cpus>, <numaNode>, <nice>, <ioClass>,
+ * <ioPriority> and <oomScoreAdj> elements of <app>. Unset fields inherit the
+ * monitor's own settings.
+ */
+struct LaunchPolicy {
+    static constexpr int Inherit = INT_MIN;     // Numeric field not set - the monitor's value is inherited
+
+    QString Cpus;               // CPU list - "0-3,8" form, empty to inherit the monitor's affinity
+    int NumaNode = -1;          // Preferred memory node - also the CPU set when Cpus is empty, -1 to inherit
+    int Nice = Inherit;         // Nice value - -20 (highest priority) to 19
+    QString IoClass;            // I/O scheduling class - "realtime", "best-effort", "idle" or empty to inherit
+    int IoPriority = 4;         // Priority within the I/O class - 0 (highest) to 7
+    int OomScoreAdj = Inherit;  // OOM killer adjustment - -1000 to 1000
+
+    bool IsEnabled() const {
+        return !Cpus.isEmpty() || NumaNode >= 0 || Nice != Inherit || !IoClass.isEmpty()
+               || OomScoreAdj != Inherit;
+    }
+
+    bool operator==(const LaunchPolicy& _other) const {
+        return Cpus == _other.Cpus && NumaNode == _other.NumaNode && Nice == _other.Nice
+               && IoClass == _other.IoClass && IoPriority == _other.IoPriority
+               && OomScoreAdj == _other.OomScoreAdj;
+    }
+    bool operator!=(const LaunchPolicy& _other) const { return !(*this == _other); }
+};
+
+/**
+ * @brief Structure to hold an application's idle shutdown settings
+ *
+ * Parsed from an optional <idle> element of <app>. An application idle for
+ * TimeoutSeconds is parked: stopped until a start request wakes it.
+ */
+struct IdleInfo {
+    int TimeoutSeconds = 0;     // Idle time before parking - 0 disables idle shutdown
+    double CpuPercent = 0.5;    // CPU use at or below this counts as idle - percent of one core
+
+    bool IsEnabled() const { return TimeoutSeconds > 0; }
+
+    bool operator==(const IdleInfo& _other) const {
+        return TimeoutSeconds == _other.TimeoutSeconds && CpuPercent == _other.CpuPercent;
+    }
+    bool operator!=(const IdleInfo& _other) const { return !(*this == _other); }
+};
+
+/**
+ * @brief Structure to hold one scheduled run window of an application
+ *
+ * Parsed from a <schedule> element of <app>. Both fields are five-field cron
+ * expressions (minute hour day-of-month month day-of-week, local time); the
+ * application should run from each start fire time until the next stop fire.
+ */
+struct ScheduleInfo {
+    QString Start;              // Cron expression opening the window
+    QString Stop;               // Cron expression closing the window
+
+    bool operator==(const ScheduleInfo& _other) const {
+        return Start == _other.Start && Stop == _other.Stop;
+    }
+    bool operator!=(const ScheduleInfo& _other) const { return !(*this == _other); }
+};
 
 /**
  * @brief Structure to hold application information
@@ -19,13 +114,45 @@ struct AppInfo {
     QString Name;           // Application name - identifier for the application
     QString Executable;     // Full path to executable - must be valid system path
     QString Status;         // Current status - "start" or "stop"
+    ProbeInfo Probe;        // Health probe - disabled when Probe.Type is empty
+    QList<ScheduleInfo> Schedules; // Run windows - empty when Status alone decides
+    QStringList RejectedSchedules; // <schedule> elements that failed to parse - raw XML, written back unchanged
+    LaunchPolicy Policy;    // Launch-time scheduling policy - applied between fork and exec
+    IdleInfo Idle;          // Idle shutdown - disabled when Idle.TimeoutSeconds is 0
+    int HeartbeatTimeout = 0; // Seconds a started heartbeat may stand still before a restart - 0 disables the watchdog
+    QStringList Listen;     // Activation sockets - "port", "host:port" or a Unix socket path; empty for always-on
+    int StopTimeout = 0;    // Seconds between SIGTERM and SIGKILL at shutdown - 0 for the default
+    QStringList DependsOn;  // Applications this one needs - it is stopped before them at shutdown
+};
+
+/**
+ * @brief One version of the configuration - never modified once published
+ *
+ * A_settingsclass hands out snapshots as shared pointers to const. A reader
+ * keeps a consistent view of every field for as long as it holds the pointer,
+ * without locks or copies; the snapshot is freed when its last holder lets go.
+ */
+struct ConfigSnapshot {
+    quint64 Version = 0;        // Increases with every published change - 0 before the first load
+    QString ServerId;           // Server identifier
+    QString ServerPort;         // Server port
+    QString ServerIp;           // Server IP address
+    QList<AppInfo> Applications; // All managed applications
+    QStringList FleetMonitors;  // Hub mode - <fleet><monitor> endpoints, empty for a single monitor
 };
 
+using ConfigSnapshotPtr = std::shared_ptr<const ConfigSnapshot>;
+
 /**
  * @brief Class responsible for reading and writing XML configuration data
  *
  * This class handles all XML operations including reading settings,
  * managing application configurations, and persisting changes to file.
+ *
+ * The configuration itself is published as immutable ConfigSnapshot
+ * versions. Readers on any thread take the current one with Snapshot();
+ * writers build a modified copy and swap it in atomically (read-copy-update),
+ * serialized among themselves by a mutex that readers never touch.
  */
 class A_settingsclass
 {
@@ -62,42 +189,125 @@ public:
      */
     bool UpdateAppStatus(const QString& _appName, const QString& _status);
 
-    // Getters for main settings
-    QString GetId() const { return ServerId; }           // Server ID - current identifier
-    QString GetPort() const { return ServerPort; }       // Server port - current network port
-    QString GetIp() const { return ServerIp; }           // Server IP - current IP address
+    /**
+     * @brief Gets the current configuration
+     * Safe on any thread. Fields read through one snapshot are always consistent
+     * with each other; call again to see later changes.
+     * @return ConfigSnapshotPtr Current snapshot - never null
+     */
+    ConfigSnapshotPtr Snapshot() const { return std::atomic_load(&Current); }
+
+    /**
+     * @brief Gets the version of the current configuration
+     * @return quint64 Version - 0 before the first load
+     */
+    quint64 Version() const { return Snapshot()->Version; }
+
+    // Getters for main settings - each reads the current snapshot
+    QString GetId() const { return Snapshot()->ServerId; }           // Server ID - current identifier
+    QString GetPort() const { return Snapshot()->ServerPort; }       // Server port - current network port
+    QString GetIp() const { return Snapshot()->ServerIp; }           // Server IP - current IP address
+    QStringList GetFleetMonitors() const { return Snapshot()->FleetMonitors; } // Monitors aggregated in hub mode - "host:port"
 
     /**
      * @brief Gets list of all applications
-     * @return QList<AppInfo> List of application configurations
+     * @return QList<AppInfo> List of application configurations - shares the snapshot's data
      */
-    QList<AppInfo> GetApplications() const { return Applications; }
+    QList<AppInfo> GetApplications() const { return Snapshot()->Applications; }
 
 private:
     QString XmlFilePath;        // Path to XML file - stores current file location
-    QString ServerId;           // Server identifier - main configuration ID
-    QString ServerPort;         // Server port - main configuration port
-    QString ServerIp;           // Server IP - main configuration IP address
-    QList<AppInfo> Applications; // List of applications - all managed applications
+    ConfigSnapshotPtr Current;  // Published configuration - accessed only through std::atomic_load/store
+    QMutex WriteLock;           // Serializes writers - loads, updates and saves; readers never take it
 
     QDomDocument XmlDocument;   // XML document object - handles XML parsing and writing
 
+    /**
+     * @brief Publishes a new configuration version
+     * Must be called with WriteLock held.
+     * @param _next Modified configuration - its Version is assigned here
+     */
+    void Publish(std::shared_ptr<ConfigSnapshot> _next);
+
     /**
      * @brief Parses settings section from XML
      * @param _settingsElement DOM element containing settings
+     * @param _config Configuration being built
      */
-    void ParseSettings(const QDomElement& _settingsElement);
+    void ParseSettings(const QDomElement& _settingsElement, ConfigSnapshot* _config);
 
     /**
      * @brief Parses applications section from XML
      * @param _appsElement DOM element containing applications
+     * @param _config Configuration being built
+     */
+    void ParseApplications(const QDomElement& _appsElement, ConfigSnapshot* _config);
+
+    /**
+     * @brief Parses a <probe> element of an application
+     * @param _probeElement DOM element containing the probe definition
+     * @return ProbeInfo Parsed probe - invalid fields keep their defaults
+     */
+    ProbeInfo ParseProbe(const QDomElement& _probeElement);
+
+    /**
+     * @brief Parses a <schedule> element of an application
+     * @param _scheduleElement DOM element containing <start> and <stop> cron expressions
+     * @param _schedule Receives the parsed window
+     * @return bool True if both expressions are valid
+     */
+    bool ParseSchedule(const QDomElement& _scheduleElement, ScheduleInfo* _schedule);
+
+    /**
+     * @brief Parses one launch policy element of an application
+     * @param _element DOM element - ignored unless it is a launch policy tag
+     * @param _policy Policy to update - invalid values keep the previous setting
+     * @return bool True if the element is a launch policy tag
+     */
+    bool ParsePolicyElement(const QDomElement& _element, LaunchPolicy* _policy);
+
+    /**
+     * @brief Parses an <idle> element of an application
+     * @param _idleElement DOM element containing <timeout> and optional <cpuPercent>
+     * @return IdleInfo Parsed settings - disabled if the timeout is missing or invalid
+     */
+    IdleInfo ParseIdle(const QDomElement& _idleElement);
+
+    /**
+     * @brief Appends a <probe> element describing _probe to an application element
+     * @param _appElement DOM element of the application
+     * @param _probe Probe definition - nothing is written if disabled
+     */
+    void AppendProbeElement(QDomElement& _appElement, const ProbeInfo& _probe);
+
+    /**
+     * @brief Appends one <schedule> element per run window to an application element
+     * @param _appElement DOM element of the application
+     * @param _schedules Run windows - nothing is written if empty
+     * @param _rejected Raw <schedule> elements that failed to parse - appended unchanged
+     */
+    void AppendScheduleElements(QDomElement& _appElement, const QList<ScheduleInfo>& _schedules,
+                                const QStringList& _rejected);
+
+    /**
+     * @brief Appends the set launch policy fields to an application element
+     * @param _appElement DOM element of the application
+     * @param _policy Launch policy - inherited fields are not written
+     */
+    void AppendPolicyElements(QDomElement& _appElement, const LaunchPolicy& _policy);
+
+    /**
+     * @brief Appends an <idle> element describing _idle to an application element
+     * @param _appElement DOM element of the application
+     * @param _idle Idle settings - nothing is written if disabled
      */
-    void ParseApplications(const QDomElement& _appsElement);
+    void AppendIdleElement(QDomElement& _appElement, const IdleInfo& _idle);
 
     /**
      * @brief Creates XML structure for saving
+     * @param _config Configuration to write
      */
-    void BuildXmlDocument();
+    void BuildXmlDocument(const ConfigSnapshot& _config);
     
     /**
      * @brief Helper method to save XML to a specific file
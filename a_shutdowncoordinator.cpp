@@ -0,0 +1,117 @@
+#include "a_shutdowncoordinator.h"
+#include "a_systeminterfaces.h"
+#include <algorithm>
+#include <csignal>
+
+A_shutdowncoordinator::A_shutdowncoordinator(A_signalsender* _signalSender, A_clock* _clock)
+{
+    SignalSender = _signalSender;
+    Clock = _clock;
+}
+
+ShutdownReport A_shutdowncoordinator::Run(const QList<ShutdownTarget>& _targets, int _deadlineMs)
+{
+    const qint64 _originMs = Clock->NowMs();
+    auto _elapsedMs = [&]() { return Clock->NowMs() - _originMs; };
+    const qint64 _deadline = qMax(0, _deadlineMs);
+
+    ShutdownReport _report;
+    QVector<int> _waves;
+    for (const ShutdownTarget& _target : _targets) {
+        ShutdownResult _result;
+        _result.Name = _target.Name;
+        _result.ProcessId = _target.ProcessId;
+        _report.Results.append(_result);
+        if (!_waves.contains(_target.Wave)) {
+            _waves.append(_target.Wave);
+        }
+    }
+    std::sort(_waves.begin(), _waves.end());
+
+    for (int _wave : _waves) {
+        // Signal the whole wave at once
+        QVector<Pending> _pending;
+        const qint64 _startMs = _elapsedMs();
+        for (int _i = 0; _i < int(_targets.size()); ++_i) {
+            const ShutdownTarget& _target = _targets.at(_i);
+            if (_target.Wave != _wave) {
+                continue;
+            }
+            ShutdownResult& _result = _report.Results[_i];
+            if (_target.ProcessId <= 0) {
+                _result.Exited = true;
+                _result.ExitMs = _startMs;
+                continue;
+            }
+
+            Pending _entry;
+            _entry.Index = _i;
+            if (_startMs < _deadline) {
+                SignalSender->SendSignal(_target.ProcessId, SIGTERM);
+                _entry.KillAtMs = qMin(_startMs + qMax(0, _target.TimeoutMs), _deadline);
+            } else {
+                _entry.KillAtMs = _startMs; // Deadline already passed - straight to SIGKILL
+            }
+            _pending.append(_entry);
+        }
+
+        // Await all exits of the wave together
+        while (!_pending.isEmpty()) {
+            const qint64 _nowMs = _elapsedMs();
+            qint64 _nextMs = _nowMs + 60000;
+            QVector<qint64> _processIds;
+            _processIds.reserve(_pending.size());
+
+            for (int _p = 0; _p < int(_pending.size()); ++_p) {
+                Pending& _entry = _pending[_p];
+                ShutdownResult& _result = _report.Results[_entry.Index];
+                if (!_entry.Killed && _nowMs >= _entry.KillAtMs) {
+                    qDebug() << "Shutdown: killing" << _result.Name << "PID:" << _result.ProcessId;
+                    SignalSender->SendSignal(_result.ProcessId, SIGKILL);
+                    _entry.Killed = true;
+                    _result.Killed = true;
+                    _entry.GiveUpAtMs = qMin(_nowMs + KillGraceMs, _deadline + KillGraceMs);
+                }
+                if (_entry.Killed && _nowMs >= _entry.GiveUpAtMs) {
+                    qDebug() << "Shutdown: exit of" << _result.Name << "not confirmed";
+                    _pending.remove(_p--);
+                    continue;
+                }
+
+                _nextMs = qMin(_nextMs, _entry.Killed ? _entry.GiveUpAtMs : _entry.KillAtMs);
+                _processIds.append(_result.ProcessId);
+            }
+            if (_pending.isEmpty()) {
+                break;
+            }
+
+            const QVector<qint64> _exited = SignalSender->WaitForExit(_processIds, int(qMax<qint64>(0, _nextMs - _nowMs)));
+            if (_exited.isEmpty()) {
+                continue;
+            }
+            const qint64 _exitMs = _elapsedMs();
+            for (int _p = 0; _p < int(_pending.size()); ++_p) {
+                ShutdownResult& _result = _report.Results[_pending.at(_p).Index];
+                if (!_exited.contains(_result.ProcessId)) {
+                    continue;
+                }
+                _result.Exited = true;
+                _result.ExitMs = _exitMs;
+                _pending.remove(_p--);
+            }
+        }
+    }
+    SignalSender->WaitForExit(QVector<qint64>(), 0);
+
+    for (const ShutdownResult& _result : _report.Results) {
+        if (!_result.Exited) {
+            ++_report.Survivors;
+        } else if (_result.Killed) {
+            ++_report.Killed;
+        } else {
+            ++_report.Terminated;
+        }
+    }
+    _report.ElapsedMs = _elapsedMs();
+    return _report;
+}
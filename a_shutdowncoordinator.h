@@ -0,0 +1,100 @@
+#ifndef A_SHUTDOWNCOORDINATOR_H
+#define A_SHUTDOWNCOORDINATOR_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QDebug>
+
+class A_signalsender;
+class A_clock;
+
+/**
+ * @brief One process to stop
+ */
+struct ShutdownTarget {
+    QString Name;               // Application name - for reporting
+    qint64 ProcessId = 0;       // Process to stop - must be positive
+    int TimeoutMs = 10000;      // Time between SIGTERM and SIGKILL
+    int Wave = 0;               // Stop order - lower waves are stopped and awaited first
+};
+
+/**
+ * @brief Outcome of stopping one process
+ */
+struct ShutdownResult {
+    QString Name;               // Application name
+    qint64 ProcessId = 0;       // Process that was stopped
+    bool Exited = false;        // Exit observed - false if it outlived the deadline
+    bool Killed = false;        // SIGKILL was needed
+    qint64 ExitMs = -1;         // Time from the start of the shutdown to the exit - -1 if not observed
+};
+
+/**
+ * @brief Summary of a whole shutdown
+ */
+struct ShutdownReport {
+    QList<ShutdownResult> Results;  // One per target, in target order
+    qint64 ElapsedMs = 0;           // Total shutdown time
+    int Terminated = 0;             // Exited after SIGTERM
+    int Killed = 0;                 // Exited after SIGKILL
+    int Survivors = 0;              // Exit not observed before the deadline
+
+    /**
+     * @brief Formats the report for logs
+     * @return QString Single line summary
+     */
+    QString ToString() const
+    {
+        return QString("%1 applications in %2 ms - %3 terminated, %4 killed, %5 not confirmed")
+            .arg(Results.size()).arg(ElapsedMs).arg(Terminated).arg(Killed).arg(Survivors);
+    }
+};
+
+/**
+ * @brief Stops many processes at once within one deadline
+ *
+ * Every process of a wave gets SIGTERM at the same moment; the exits are then
+ * awaited together through A_signalsender::WaitForExit(), so the wave takes
+ * as long as its slowest process rather than the sum of all of them. A
+ * process still alive after its own timeout gets SIGKILL. When the global
+ * deadline passes, everything still alive - including waves not yet started -
+ * gets SIGKILL and the shutdown ends. Signals, exit waits and time all go
+ * through the injected interfaces, so a simulator can run it in virtual time.
+ */
+class A_shutdowncoordinator
+{
+public:
+    static constexpr int KillGraceMs = 1000;    // Wait for the exit after SIGKILL - bounded by the deadline
+
+    /**
+     * @param _signalSender Signal delivery and exit waits - must outlive the coordinator
+     * @param _clock Time source of timeouts and the deadline - must outlive the coordinator
+     */
+    A_shutdowncoordinator(A_signalsender* _signalSender, A_clock* _clock);
+
+    /**
+     * @brief Stops all targets and waits for them
+     * Blocks the caller for at most _deadlineMs plus KillGraceMs.
+     * @param _targets Processes to stop
+     * @param _deadlineMs Global deadline - milliseconds from now
+     * @return ShutdownReport Per-target outcome and totals
+     */
+    ShutdownReport Run(const QList<ShutdownTarget>& _targets, int _deadlineMs);
+
+private:
+    A_signalsender* SignalSender;   // Signal delivery and exit waits - system or simulated
+    A_clock* Clock;                 // Time source - system or simulated
+
+    /**
+     * @brief In-flight state of one target
+     */
+    struct Pending {
+        int Index = -1;             // Position in the target list
+        qint64 KillAtMs = 0;        // Time SIGKILL is due - relative to the shutdown start
+        bool Killed = false;        // SIGKILL sent
+        qint64 GiveUpAtMs = 0;      // After SIGKILL - time the exit stops being awaited
+    };
+};
+
+#endif // A_SHUTDOWNCOORDINATOR_H
@@ -0,0 +1,306 @@
+#include "a_socketactivator.h"
+#include "a_systeminterfaces.h"
+#include <QFile>
+#include <QSet>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+QString ActivationStatistics::ToString() const
+{
+    return QString("activations=%1 first-accept last=%2 max=%3ms unmeasured=%4 %5=%6kB")
+        .arg(Activations)
+        .arg(LastLatencyMs >= 0 ? QString("%1ms").arg(LastLatencyMs) : QString("-"))
+        .arg(MaxLatencyMs)
+        .arg(Unmeasured)
+        .arg(Dormant ? "saved" : "resident")
+        .arg(LastResidentKb);
+}
+
+A_socketactivator::A_socketactivator(QObject *parent) : QObject(parent)
+{
+    LatencyTimer = new QTimer(this);
+    LatencyTimer->setInterval(LatencyPollMs);
+    LatencyTimer->setTimerType(Qt::PreciseTimer);
+    connect(LatencyTimer, &QTimer::timeout, this, &A_socketactivator::CheckAcceptQueues);
+}
+
+A_socketactivator::~A_socketactivator()
+{
+    for (AppSockets* _sockets : Apps) {
+        Release(_sockets);
+    }
+    Apps.clear();
+}
+
+void A_socketactivator::SetSockets(const QList<AppInfo>& _apps)
+{
+    QSet<QString> _configured;
+
+    for (const AppInfo& _app : _apps) {
+        if (_app.Listen.isEmpty()) {
+            continue;
+        }
+        _configured.insert(_app.Name);
+
+        AppSockets* _sockets = Apps.value(_app.Name, nullptr);
+        if (_sockets && _sockets->Specs == _app.Listen) {
+            continue; // Unchanged - keep the bound sockets and any queued connections
+        }
+        if (_sockets) {
+            Release(_sockets);
+        }
+
+        _sockets = new AppSockets();
+        _sockets->Specs = _app.Listen;
+        for (const QString& _spec : _app.Listen) {
+            Endpoint _endpoint;
+            _endpoint.Fd = OpenListeningSocket(_spec, &_endpoint.Tcp);
+            if (_endpoint.Fd < 0) {
+                continue;
+            }
+
+            // Only readability matters - the application does the accept
+            _endpoint.Notifier = new QSocketNotifier(_endpoint.Fd, QSocketNotifier::Read, this);
+            _endpoint.Notifier->setEnabled(false);
+            const QString _appName = _app.Name;
+            connect(_endpoint.Notifier, &QSocketNotifier::activated, this, [this, _appName]() {
+                OnConnectionPending(_appName);
+            });
+            _sockets->Endpoints.append(_endpoint);
+        }
+
+        if (_sockets->Endpoints.isEmpty()) {
+            qDebug() << "Warning: No activation socket could be bound for" << _app.Name << "- launching normally";
+            delete _sockets;
+            Apps.remove(_app.Name);
+            continue;
+        }
+        Apps[_app.Name] = _sockets;
+        qDebug() << "Socket activation configured:" << _app.Name << _app.Listen;
+    }
+
+    for (auto _it = Apps.begin(); _it != Apps.end();) {
+        if (_configured.contains(_it.key())) {
+            ++_it;
+            continue;
+        }
+        Release(_it.value());
+        _it = Apps.erase(_it);
+    }
+}
+
+bool A_socketactivator::IsSocketActivated(const QString& _appName) const
+{
+    return Apps.contains(_appName);
+}
+
+QVector<int> A_socketactivator::SocketFds(const QString& _appName) const
+{
+    QVector<int> _fds;
+    const AppSockets* _sockets = Apps.value(_appName, nullptr);
+    if (_sockets) {
+        for (const Endpoint& _endpoint : _sockets->Endpoints) {
+            _fds.append(_endpoint.Fd);
+        }
+    }
+    return _fds;
+}
+
+void A_socketactivator::SetWaiting(const QString& _appName, bool _waiting)
+{
+    AppSockets* _sockets = Apps.value(_appName, nullptr);
+    if (!_sockets || _sockets->Waiting == _waiting) {
+        return;
+    }
+
+    _sockets->Waiting = _waiting;
+    _sockets->Statistics.Dormant = _waiting;
+    for (const Endpoint& _endpoint : _sockets->Endpoints) {
+        _endpoint.Notifier->setEnabled(_waiting);
+    }
+
+    if (_waiting && _sockets->Statistics.LastResidentKb > 0) {
+        qDebug() << "Socket activation:" << _appName << "dormant, saving" << _sockets->Statistics.LastResidentKb << "kB";
+    }
+}
+
+void A_socketactivator::SampleResident(const QString& _appName, qint64 _processId)
+{
+    AppSockets* _sockets = Apps.value(_appName, nullptr);
+    if (!_sockets || _processId <= 0) {
+        return;
+    }
+
+    ProcessStat _stat;
+    if (A_procfsprocesstable::ReadStatm(_processId, &_stat)) {
+        _sockets->Statistics.LastResidentKb = qint64(_stat.ResidentPages) * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+}
+
+QMap<QString, ActivationStatistics> A_socketactivator::GetStatistics() const
+{
+    QMap<QString, ActivationStatistics> _statistics;
+    for (auto _it = Apps.constBegin(); _it != Apps.constEnd(); ++_it) {
+        _statistics.insert(_it.key(), _it.value()->Statistics);
+    }
+    return _statistics;
+}
+
+void A_socketactivator::OnConnectionPending(const QString& _appName)
+{
+    AppSockets* _sockets = Apps.value(_appName, nullptr);
+    if (!_sockets || !_sockets->Waiting) {
+        return;
+    }
+
+    // The connection stays queued; stop watching until the application is dormant again
+    SetWaiting(_appName, false);
+    ++_sockets->Statistics.Activations;
+    _sockets->Activated.start();
+    LatencyTimer->start();
+
+    qDebug() << "Socket activation: connection pending for" << _appName;
+    emit ActivationRequested(_appName);
+}
+
+void A_socketactivator::CheckAcceptQueues()
+{
+    bool _measuring = false;
+
+    for (auto _it = Apps.begin(); _it != Apps.end(); ++_it) {
+        AppSockets* _sockets = _it.value();
+        if (!_sockets->Activated.isValid()) {
+            continue;
+        }
+
+        // Done once every TCP queue has drained; Unix sockets cannot be measured
+        bool _drained = true;
+        bool _anyTcp = false;
+        for (const Endpoint& _endpoint : _sockets->Endpoints) {
+            if (_endpoint.Tcp) {
+                _anyTcp = true;
+                if (AcceptQueueLength(_endpoint.Fd) != 0) {
+                    _drained = false;
+                }
+            }
+        }
+
+        const qint64 _elapsed = _sockets->Activated.elapsed();
+        ActivationStatistics& _statistics = _sockets->Statistics;
+        if (_anyTcp && _drained) {
+            _statistics.LastLatencyMs = _elapsed;
+            _statistics.MaxLatencyMs = qMax(_statistics.MaxLatencyMs, _elapsed);
+            _sockets->Activated.invalidate();
+            qDebug() << "Socket activation:" << _it.key() << "accepted its first connection after" << _elapsed << "ms";
+        } else if (!_anyTcp || _elapsed > LatencyTimeoutMs) {
+            ++_statistics.Unmeasured;
+            _statistics.LastLatencyMs = -1;
+            _sockets->Activated.invalidate();
+        } else {
+            _measuring = true;
+        }
+    }
+
+    if (!_measuring) {
+        LatencyTimer->stop();
+    }
+}
+
+int A_socketactivator::OpenListeningSocket(const QString& _spec, bool* _tcp)
+{
+    *_tcp = !_spec.startsWith('/');
+
+    int _fd = -1;
+    if (*_tcp) {
+        // "port" or "host:port" - loopback unless a host is given
+        QString _host = "127.0.0.1";
+        QString _port = _spec;
+        const int _colon = _spec.lastIndexOf(':');
+        if (_colon >= 0) {
+            _host = _spec.left(_colon);
+            _port = _spec.mid(_colon + 1);
+        }
+
+        bool _ok = false;
+        const int _portNumber = _port.toInt(&_ok);
+        sockaddr_in _address;
+        memset(&_address, 0, sizeof(_address));
+        _address.sin_family = AF_INET;
+        _address.sin_port = htons(quint16(_portNumber));
+        if (!_ok || _portNumber <= 0 || _portNumber > 65535 ||
+            inet_pton(AF_INET, _host.toLatin1().constData(), &_address.sin_addr) != 1) {
+            qDebug() << "Invalid listen address:" << _spec;
+            return -1;
+        }
+
+        _fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (_fd < 0) {
+            qDebug() << "Cannot create socket for" << _spec << strerror(errno);
+            return -1;
+        }
+        const int _reuse = 1;
+        setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &_reuse, sizeof(_reuse));
+        if (::bind(_fd, reinterpret_cast<sockaddr*>(&_address), sizeof(_address)) != 0) {
+            qDebug() << "Cannot bind" << _spec << strerror(errno);
+            ::close(_fd);
+            return -1;
+        }
+    } else {
+        const QByteArray _path = QFile::encodeName(_spec);
+        sockaddr_un _address;
+        memset(&_address, 0, sizeof(_address));
+        _address.sun_family = AF_UNIX;
+        if (size_t(_path.size()) >= sizeof(_address.sun_path)) {
+            qDebug() << "Unix socket path too long:" << _spec;
+            return -1;
+        }
+        memcpy(_address.sun_path, _path.constData(), size_t(_path.size()));
+
+        _fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (_fd < 0) {
+            qDebug() << "Cannot create socket for" << _spec << strerror(errno);
+            return -1;
+        }
+        // A socket file left by a previous run would make bind fail
+        ::unlink(_path.constData());
+        if (::bind(_fd, reinterpret_cast<sockaddr*>(&_address), sizeof(_address)) != 0) {
+            qDebug() << "Cannot bind" << _spec << strerror(errno);
+            ::close(_fd);
+            return -1;
+        }
+    }
+
+    // Blocking on purpose - the application inherits the file status flags
+    if (::listen(_fd, Backlog) != 0) {
+        qDebug() << "Cannot listen on" << _spec << strerror(errno);
+        ::close(_fd);
+        return -1;
+    }
+    return _fd;
+}
+
+int A_socketactivator::AcceptQueueLength(int _fd)
+{
+    // For a listening socket the kernel reports the accept queue length in tcpi_unacked
+    tcp_info _info;
+    socklen_t _length = sizeof(_info);
+    if (getsockopt(_fd, IPPROTO_TCP, TCP_INFO, &_info, &_length) != 0) {
+        return -1;
+    }
+    return int(_info.tcpi_unacked);
+}
+
+void A_socketactivator::Release(AppSockets* _sockets)
+{
+    for (Endpoint& _endpoint : _sockets->Endpoints) {
+        delete _endpoint.Notifier;
+        ::close(_endpoint.Fd);
+    }
+    delete _sockets;
+}
@@ -0,0 +1,165 @@
+#ifndef A_SOCKETACTIVATOR_H
+#define A_SOCKETACTIVATOR_H
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QMap>
+#include <QVector>
+#include <QStringList>
+#include <QDebug>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Activation counters of one socket-activated application
+ */
+struct ActivationStatistics {
+    quint64 Activations = 0;        // Launches caused by an incoming connection
+    quint64 Unmeasured = 0;         // Activations whose first connection was not seen accepted
+    qint64 LastLatencyMs = -1;      // Connection to first accept of the last activation - -1 if unknown
+    qint64 MaxLatencyMs = 0;        // Slowest measured first accept - milliseconds
+    qint64 LastResidentKb = 0;      // Resident memory last seen while running - freed while dormant
+    bool Dormant = false;           // Waiting for a connection with the application stopped
+
+    /**
+     * @brief Formats the counters as a single human-readable line
+     * @return QString Activations, first-request latency and memory saved
+     */
+    QString ToString() const;
+};
+
+/**
+ * @brief Class owning the listening sockets of socket-activated applications
+ *
+ * Sockets declared by <listen> are bound by the monitor and watched with
+ * QSocketNotifier while the application is dormant. The first incoming
+ * connection emits ActivationRequested; the owner then launches the
+ * application with the sockets passed as descriptors 3, 4, ... following the
+ * LISTEN_FDS convention, and the application accepts the waiting connection
+ * itself. Connections are never accepted here, so nothing is lost in between.
+ *
+ * For TCP sockets the time from the wake-up to the first accept is measured
+ * by polling the accept queue length (TCP_INFO) until it drains.
+ */
+class A_socketactivator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int Backlog = 128;             // Listen backlog - connections queued until the app accepts
+    static constexpr int LatencyPollMs = 2;         // Accept queue poll interval while measuring
+    static constexpr int LatencyTimeoutMs = 30000;  // Measurement given up after this long
+
+    explicit A_socketactivator(QObject *parent = nullptr);
+    ~A_socketactivator();
+
+    /**
+     * @brief Synchronizes listening sockets with the configuration
+     * Applications whose <listen> list is unchanged keep their sockets.
+     * @param _apps Current application list - applications without <listen> are always-on
+     */
+    void SetSockets(const QList<AppInfo>& _apps);
+
+    /**
+     * @brief Checks whether an application is socket-activated
+     * @param _appName Application name
+     * @return bool True if at least one of its sockets is bound
+     */
+    bool IsSocketActivated(const QString& _appName) const;
+
+    /**
+     * @brief Gets the listening descriptors to pass to an application
+     * @param _appName Application name
+     * @return QVector<int> Descriptors in <listen> order - empty if none
+     */
+    QVector<int> SocketFds(const QString& _appName) const;
+
+    /**
+     * @brief Starts or stops waiting for a connection on an application's sockets
+     * Idempotent. Waiting is only meaningful while the application is stopped.
+     * @param _appName Application name - ignored if not socket-activated
+     * @param _waiting True to emit ActivationRequested on the next connection
+     */
+    void SetWaiting(const QString& _appName, bool _waiting);
+
+    /**
+     * @brief Records the resident memory of a running socket-activated application
+     * @param _appName Application name - ignored if not socket-activated
+     * @param _processId Running process - read from /proc/<pid>/statm
+     */
+    void SampleResident(const QString& _appName, qint64 _processId);
+
+    /**
+     * @brief Gets activation statistics for all socket-activated applications
+     * @return QMap<QString, ActivationStatistics> Key: app name, value: statistics
+     */
+    QMap<QString, ActivationStatistics> GetStatistics() const;
+
+signals:
+    /**
+     * @brief Emitted when a connection arrives for a dormant application
+     * Waiting is switched off before the signal is emitted.
+     * @param appName Name of the application to launch
+     */
+    void ActivationRequested(const QString& appName);
+
+private slots:
+    /**
+     * @brief Checks whether activated applications have accepted their first connection
+     */
+    void CheckAcceptQueues();
+
+private:
+    /**
+     * @brief One bound listening socket
+     */
+    struct Endpoint {
+        int Fd = -1;                            // Listening socket
+        bool Tcp = false;                       // TCP socket - accept queue can be measured
+        QSocketNotifier* Notifier = nullptr;    // Readable notifier - enabled while waiting
+    };
+
+    /**
+     * @brief Sockets and activation state of one application
+     */
+    struct AppSockets {
+        QStringList Specs;                      // Configured <listen> values - change detection
+        QVector<Endpoint> Endpoints;            // Bound sockets in Specs order
+        bool Waiting = false;                   // Notifiers enabled
+        QElapsedTimer Activated;                // Running while the first accept is being measured
+        ActivationStatistics Statistics;        // Counters
+    };
+
+    QMap<QString, AppSockets*> Apps;            // Socket-activated applications - key: app name
+    QTimer* LatencyTimer;                       // Accept queue poll - active while measuring
+
+    /**
+     * @brief Creates, binds and listens on one socket
+     * @param _spec "port", "host:port" (IPv4) or an absolute Unix socket path
+     * @param _tcp Receives whether the socket is TCP
+     * @return int Listening descriptor - -1 on error
+     */
+    static int OpenListeningSocket(const QString& _spec, bool* _tcp);
+
+    /**
+     * @brief Gets the number of connections waiting in a TCP accept queue
+     * @param _fd Listening TCP socket
+     * @return int Queued connections - -1 if unknown
+     */
+    static int AcceptQueueLength(int _fd);
+
+    /**
+     * @brief Handles a connection arriving on a dormant application's socket
+     * @param _appName Application name
+     */
+    void OnConnectionPending(const QString& _appName);
+
+    /**
+     * @brief Closes all sockets of an application and frees its state
+     * @param _sockets Application sockets - deleted
+     */
+    void Release(AppSockets* _sockets);
+};
+
+#endif // A_SOCKETACTIVATOR_H
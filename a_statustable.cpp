@@ -0,0 +1,238 @@
+#include "a_statustable.h"
+#include "qpm_status.h"
+#include "a_systeminterfaces.h"
+#include <QDebug>
+#include <QFile>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+static_assert(sizeof(qpm_status_header_t) == 64, "Status header layout changed - bump QPM_STATUS_VERSION");
+static_assert(sizeof(qpm_status_record_t) == 128, "Status record layout changed - bump QPM_STATUS_VERSION");
+
+A_statustable::A_statustable(const QString& _segmentName)
+{
+    Header = nullptr;
+    Records = nullptr;
+    Count = 0;
+    TicksPerSecond = double(qMax(1L, sysconf(_SC_CLK_TCK)));
+    PageKb = qMax(1L, sysconf(_SC_PAGESIZE) / 1024);
+
+    char _defaultName[64];
+    qpm_status_default_name(_defaultName, sizeof(_defaultName));
+    const QString _name = _segmentName.isEmpty() ? QString::fromLatin1(_defaultName) : _segmentName;
+    const QByteArray _encoded = QFile::encodeName(_name);
+    const size_t _size = sizeof(qpm_status_header_t) + size_t(Capacity) * sizeof(qpm_status_record_t);
+
+    // A fresh object each time - readers still holding a previous table keep a valid mapping
+    int _fd = shm_open(_encoded.constData(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (_fd < 0 && errno == EEXIST) {
+        // Only the table of a monitor that is gone may be replaced
+        const qint64 _owner = OwnerOf(_encoded);
+        if (_owner > 0 && (::kill(pid_t(_owner), 0) == 0 || errno == EPERM)) {
+            qDebug() << "Warning: Status table" << _name << "is in use by the monitor with PID" << _owner
+                     << "- not published; use --status-table <name> for a second monitor";
+            return;
+        }
+        shm_unlink(_encoded.constData());
+        _fd = shm_open(_encoded.constData(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    }
+    if (_fd < 0) {
+        qDebug() << "Warning: Cannot create status table" << _name << strerror(errno);
+        return;
+    }
+    void* _mapping = MAP_FAILED;
+    if (ftruncate(_fd, off_t(_size)) == 0) {
+        _mapping = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    }
+    ::close(_fd);
+    if (_mapping == MAP_FAILED) {
+        qDebug() << "Warning: Cannot map status table" << _name << strerror(errno);
+        shm_unlink(_encoded.constData());
+        return;
+    }
+
+    Header = static_cast<qpm_status_header*>(_mapping);
+    Records = reinterpret_cast<qpm_status_record*>(Header + 1);
+    Header->version = QPM_STATUS_VERSION;
+    Header->header_size = sizeof(qpm_status_header_t);
+    Header->record_size = sizeof(qpm_status_record_t);
+    Header->capacity = Capacity;
+    Header->count = 0;
+    Header->monitor_pid = getpid();
+    Header->updated_ms = 0;
+    __atomic_store_n(&Header->magic, QPM_STATUS_MAGIC, __ATOMIC_RELEASE);
+    Name = _name;
+}
+
+A_statustable::~A_statustable()
+{
+    if (Header) {
+        munmap(Header, sizeof(qpm_status_header_t) + size_t(Capacity) * sizeof(qpm_status_record_t));
+        shm_unlink(QFile::encodeName(Name).constData());
+    }
+}
+
+qint64 A_statustable::OwnerOf(const QByteArray& _encodedName)
+{
+    const int _fd = shm_open(_encodedName.constData(), O_RDONLY, 0);
+    if (_fd < 0) {
+        return 0;
+    }
+    struct stat _info;
+    void* _mapping = MAP_FAILED;
+    if (fstat(_fd, &_info) == 0 && size_t(_info.st_size) >= sizeof(qpm_status_header_t)) {
+        _mapping = mmap(nullptr, sizeof(qpm_status_header_t), PROT_READ, MAP_SHARED, _fd, 0);
+    }
+    ::close(_fd);
+    if (_mapping == MAP_FAILED) {
+        return 0;
+    }
+
+    // The magic is stored last - without it the creator died before finishing the header
+    const qpm_status_header* _header = static_cast<const qpm_status_header*>(_mapping);
+    const qint64 _owner = __atomic_load_n(&_header->magic, __ATOMIC_ACQUIRE) == QPM_STATUS_MAGIC ? _header->monitor_pid : 0;
+    munmap(_mapping, sizeof(qpm_status_header_t));
+    return _owner;
+}
+
+void A_statustable::Publish(const A_apptable& _apps, qint64 _nowMs)
+{
+    if (!Header) {
+        return;
+    }
+    if (Slots.size() < _apps.Size()) {
+        Slots.resize(_apps.Size());
+    }
+
+    // Clear removed applications first so their records can be reused right away
+    for (int _id = 0; _id < int(Slots.size()); ++_id) {
+        Slot& _slot = Slots[_id];
+        if (_slot.Index < 0 || (_apps.Live.at(_id) && _apps.AppNames.at(_id) == _slot.Name)) {
+            continue;
+        }
+        qpm_status_record _empty;
+        memset(&_empty, 0, sizeof(_empty));
+        Write(_slot.Index, _empty);
+        FreeRecords.append(_slot.Index);
+        _slot = Slot();
+    }
+
+    for (int _id = 0; _id < _apps.Size(); ++_id) {
+        if (!_apps.Live.at(_id)) {
+            continue;
+        }
+
+        Slot& _slot = Slots[_id];
+        if (_slot.Index < 0) {
+            if (!FreeRecords.isEmpty()) {
+                _slot.Index = FreeRecords.takeLast();
+            } else if (Count < quint32(Capacity)) {
+                _slot.Index = int(Count++);
+            } else {
+                continue; // Full - the application is simply not published
+            }
+            _slot.Name = _apps.AppNames.at(_id);
+        }
+
+        const bool _running = _apps.Running.at(_id);
+        const quint32 _state = StateOf(_running, _apps.Parked.at(_id), _apps.Desired.at(_id));
+        const qint64 _processId = _running ? _apps.ProcessIds.at(_id) : 0;
+        if (_slot.ChangedMs == 0 || _state != _slot.State || _processId != _slot.ProcessId) {
+            if (_processId != _slot.ProcessId) {
+                _slot.UsageSampleMs = 0; // New process - its CPU baseline starts over
+            }
+            _slot.State = _state;
+            _slot.ProcessId = _processId;
+            _slot.ChangedMs = _nowMs;
+        }
+
+        if (_processId > 0) {
+            SampleUsage(_slot, _processId, _nowMs);
+        } else {
+            _slot.UsageSampleMs = 0;
+            _slot.CpuHundredths = 0;
+            _slot.ResidentKb = 0;
+        }
+
+        qpm_status_record _record;
+        memset(&_record, 0, sizeof(_record));
+        const QByteArray _name = _slot.Name.toUtf8();
+        memcpy(_record.name, _name.constData(), size_t(qMin<qsizetype>(_name.size(), QPM_STATUS_NAME_SIZE - 1)));
+        _record.pid = _processId;
+        _record.changed_ms = _slot.ChangedMs;
+        _record.started_ms = _running ? _apps.StartTimesMs.at(_id) : 0;
+        _record.resident_kb = _slot.ResidentKb;
+        _record.state = _state;
+        _record.restarts = quint32(qMax(0, _apps.RestartCounts.at(_id)));
+        _record.cpu_hundredths = _slot.CpuHundredths;
+        Write(_slot.Index, _record);
+    }
+
+    __atomic_store_n(&Header->count, Count, __ATOMIC_RELEASE);
+    __atomic_store_n(&Header->updated_ms, _nowMs, __ATOMIC_RELEASE);
+}
+
+quint32 A_statustable::StateOf(const ProcessInfo& _info)
+{
+    return StateOf(_info.IsRunning, _info.Parked, _info.Desired);
+}
+
+quint32 A_statustable::StateOf(bool _running, bool _parked, DesiredState _desired)
+{
+    if (_running) {
+        return QPM_STATE_RUNNING;
+    }
+    if (_parked) {
+        return QPM_STATE_PARKED;
+    }
+    return _desired == DesiredState::Start ? QPM_STATE_BACKOFF : QPM_STATE_STOPPED;
+}
+
+void A_statustable::Write(int _index, const qpm_status_record& _record)
+{
+    qpm_status_record* _target = Records + _index;
+
+    // Only this process writes, so its own record can be compared without the seqlock
+    const size_t _offset = offsetof(qpm_status_record_t, name);
+    if (memcmp(reinterpret_cast<const char*>(_target) + _offset,
+               reinterpret_cast<const char*>(&_record) + _offset, sizeof(_record) - _offset) == 0) {
+        return;
+    }
+
+    const quint64 _sequence = _target->sequence;
+    __atomic_store_n(&_target->sequence, _sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(reinterpret_cast<char*>(_target) + _offset, reinterpret_cast<const char*>(&_record) + _offset,
+           sizeof(_record) - _offset);
+    __atomic_store_n(&_target->sequence, _sequence + 2, __ATOMIC_RELEASE);
+}
+
+void A_statustable::SampleUsage(Slot& _slot, qint64 _processId, qint64 _nowMs)
+{
+    if (_slot.UsageSampleMs > 0 && _nowMs - _slot.UsageSampleMs < UsageIntervalMs) {
+        return;
+    }
+
+    ProcessStat _stat;
+    if (!A_procfsprocesstable::ReadStat(_processId, &_stat)) {
+        return;
+    }
+    const quint64 _cpuTicks = _stat.CpuTicks;
+
+    // The first sample of a process only sets the baseline
+    if (_slot.UsageSampleMs > 0 && _nowMs > _slot.UsageSampleMs && _cpuTicks >= _slot.CpuTicks) {
+        const double _seconds = double(_nowMs - _slot.UsageSampleMs) / 1000.0;
+        const double _busy = double(_cpuTicks - _slot.CpuTicks) / TicksPerSecond;
+        _slot.CpuHundredths = quint32(_busy / _seconds * 10000.0 + 0.5);
+    } else {
+        _slot.CpuHundredths = 0;
+    }
+    _slot.CpuTicks = _cpuTicks;
+    _slot.UsageSampleMs = _nowMs;
+
+    _slot.ResidentKb = A_procfsprocesstable::ReadStatm(_processId, &_stat) ? qint64(_stat.ResidentPages) * PageKb : 0;
+}
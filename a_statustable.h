@@ -0,0 +1,114 @@
+#ifndef A_STATUSTABLE_H
+#define A_STATUSTABLE_H
+
+#include <QString>
+#include <QVector>
+#include "a_apptable.h"
+
+struct qpm_status_header;
+struct qpm_status_record;
+
+/**
+ * @brief Publishes application state to a shared-memory status table
+ *
+ * The table is a POSIX shared-memory segment laid out as in qpm_status.h:
+ * a versioned header followed by one 128-byte record per application.
+ * Every record is written under a seqlock - its sequence number is odd
+ * while the record changes - so any number of readers (qpmstat, scripts
+ * using the header) copy it without ever blocking the monitor. Records are
+ * only rewritten when their contents change.
+ */
+class A_statustable
+{
+public:
+    static constexpr int Capacity = 16384;          // Records in the segment - 2 MB, pages allocated on first use
+    static constexpr qint64 UsageIntervalMs = 1000; // Minimum time between CPU and memory samples of a process
+
+    /**
+     * @param _segmentName Segment name - empty for qpm_status_default_name()
+     */
+    explicit A_statustable(const QString& _segmentName = QString());
+    ~A_statustable();
+
+    A_statustable(const A_statustable&) = delete;
+    A_statustable& operator=(const A_statustable&) = delete;
+
+    /**
+     * @brief Brings the table in line with the current application state
+     * Removed applications are cleared and their records reused.
+     * @param _apps Monitoring state
+     * @param _nowMs Current time - milliseconds since epoch
+     */
+    void Publish(const A_apptable& _apps, qint64 _nowMs);
+
+    /**
+     * @brief Gets the segment name
+     * @return QString Name - empty if the segment could not be created
+     */
+    QString SegmentName() const { return Name; }
+
+    /**
+     * @brief Derives the published state of an application
+     * @param _info Monitoring state
+     * @return quint32 QPM_STATE_* value - never QPM_STATE_EMPTY
+     */
+    static quint32 StateOf(const ProcessInfo& _info);
+
+    /**
+     * @brief Derives the published state from the fields it depends on
+     * @param _running Current running state
+     * @param _parked Stopped for being idle
+     * @param _desired Desired state
+     * @return quint32 QPM_STATE_* value - never QPM_STATE_EMPTY
+     */
+    static quint32 StateOf(bool _running, bool _parked, DesiredState _desired);
+
+private:
+    /**
+     * @brief Publisher-side state of one record
+     */
+    struct Slot {
+        QString Name;               // Application the record belongs to - ids are reused
+        int Index = -1;             // Record index - -1 if none
+        quint32 State = 0;          // Published state - change detection
+        qint64 ProcessId = 0;       // Published PID - change detection
+        qint64 ChangedMs = 0;       // Time State or ProcessId last changed
+        quint64 CpuTicks = 0;       // utime + stime at the last usage sample
+        qint64 UsageSampleMs = 0;   // Time of the last usage sample - 0 if none
+        quint32 CpuHundredths = 0;  // Last CPU figure
+        qint64 ResidentKb = 0;      // Last memory figure
+    };
+
+    QString Name;                       // Segment name - unlinked on destruction
+    qpm_status_header* Header;          // Mapped segment - null if unavailable
+    qpm_status_record* Records;         // First record - follows the header
+    QVector<Slot> Slots;                // Published applications - index: app id
+    QVector<int> FreeRecords;           // Cleared records below the high-water mark - reused first
+    quint32 Count;                      // High-water mark - records [0, Count) have been used
+    double TicksPerSecond;              // Clock ticks per second - from sysconf
+    qint64 PageKb;                      // Page size - kB
+
+    /**
+     * @brief Rewrites one record under its seqlock if the contents differ
+     * @param _index Record index
+     * @param _record New contents - the sequence field is ignored
+     */
+    void Write(int _index, const qpm_status_record& _record);
+
+    /**
+     * @brief Reads the publishing monitor of an existing segment
+     * @param _encodedName Segment name - file system encoding
+     * @return qint64 monitor_pid of the header - 0 if the segment is missing, too small or not initialized
+     */
+    static qint64 OwnerOf(const QByteArray& _encodedName);
+
+    /**
+     * @brief Samples CPU and memory use of a running process at most once per UsageIntervalMs
+     * @param _slot Slot to update
+     * @param _processId Running process
+     * @param _nowMs Current time - milliseconds
+     */
+    void SampleUsage(Slot& _slot, qint64 _processId, qint64 _nowMs);
+};
+
+#endif // A_STATUSTABLE_H
@@ -0,0 +1,556 @@
+#include "a_systeminterfaces.h"
+#include "a_launchpolicy.h"
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <csignal>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int MaxListenFds = 64;    // Sockets passed to one application - LISTEN_FDS is capped here
+
+/**
+ * @brief Parses the content of a procfs stat file
+ * @param _content "<pid> (<comm>) <state> ..." - comm may itself contain ')'
+ * @param _name Set to comm - may be null
+ * @param _stat Filled with state, CPU, nice and start time - fields missing from the content stay 0
+ * @return int Number of fields after comm - 0 if the content is malformed
+ */
+int ParseStat(const QByteArray& _content, QByteArray* _name, ProcessStat* _stat)
+{
+    const int _open = _content.indexOf('(');
+    const int _close = _content.lastIndexOf(')');
+    if (_open < 0 || _close <= _open || _close + 2 >= _content.size()) {
+        return 0;
+    }
+    if (_name) {
+        *_name = _content.mid(_open + 1, _close - _open - 1);
+    }
+
+    // Fields from the third on - utime and stime are fields 14 and 15, nice is 19, starttime is 22
+    const QList<QByteArray> _fields = _content.mid(_close + 2).split(' ');
+    _stat->State = _content.at(_close + 2);
+    _stat->CpuTicks = _fields.size() > 12 ? _fields.at(11).toULongLong() + _fields.at(12).toULongLong() : 0;
+    _stat->Nice = _fields.size() > 16 ? _fields.at(16).toInt() : 0;
+    _stat->StartTicks = _fields.size() > 19 ? _fields.at(19).toULongLong() : 0;
+    return int(_fields.size());
+}
+
+/**
+ * @brief Process table backed by the pidof and pgrep commands
+ */
+class A_systemprocesstable : public A_processtable
+{
+public:
+    qint64 FindProcess(const QString& _executablePath) override
+    {
+        QProcess _findProcess;
+
+        // Use pidof command which is more reliable for finding exact executable matches
+        QFileInfo _fileInfo(_executablePath);
+        QString _execName = _fileInfo.baseName();
+
+        // Try pidof first (most reliable)
+        QString _command = QString("pidof %1").arg(_execName);
+        _findProcess.start("sh", QStringList() << "-c" << _command);
+        _findProcess.waitForFinished(3000);
+
+        if (_findProcess.exitCode() == 0) {
+            QString _output = _findProcess.readAllStandardOutput().trimmed();
+            QStringList _pids = _output.split(' ', Qt::SkipEmptyParts);
+
+            if (!_pids.isEmpty()) {
+                bool _ok;
+                qint64 _pid = _pids.first().toLongLong(&_ok);
+                if (_ok && _pid > 0) {
+                    qDebug() << "Found process by pidof:" << _execName << "PID:" << _pid;
+                    return _pid;
+                }
+            }
+        }
+
+        // Fallback to pgrep with exact executable name
+        _command = QString("pgrep -x %1").arg(_execName);
+        _findProcess.start("sh", QStringList() << "-c" << _command);
+        _findProcess.waitForFinished(3000);
+
+        if (_findProcess.exitCode() == 0) {
+            QString _output = _findProcess.readAllStandardOutput().trimmed();
+            QStringList _pids = _output.split('\n', Qt::SkipEmptyParts);
+
+            if (!_pids.isEmpty()) {
+                bool _ok;
+                qint64 _pid = _pids.first().toLongLong(&_ok);
+                if (_ok && _pid > 0) {
+                    qDebug() << "Found process by pgrep -x:" << _execName << "PID:" << _pid;
+                    return _pid;
+                }
+            }
+        }
+
+        return 0; // Not found
+    }
+};
+
+/**
+ * @brief Signal sender backed by kill(2)
+ *
+ * Supervised applications are double-forked and are not our children, so
+ * SIGCHLD never reports them. Exits are awaited with one poll() over pidfds;
+ * where pidfd_open is unavailable (Linux before 5.3) they are found by
+ * polling kill(pid, 0).
+ */
+class A_systemsignalsender : public A_signalsender
+{
+public:
+    static constexpr int FallbackPollMs = 20;   // Exit polling interval without pidfds
+
+    ~A_systemsignalsender() override
+    {
+        WaitForExit(QVector<qint64>(), 0);
+    }
+
+    bool SendSignal(qint64 _processId, int _signal) override
+    {
+        if (_processId <= 0) {
+            return false;
+        }
+        return ::kill(pid_t(_processId), _signal) == 0;
+    }
+
+    QVector<qint64> WaitForExit(const QVector<qint64>& _processIds, int _timeoutMs) override
+    {
+        // Descriptors of processes no longer asked about are closed
+        const QSet<qint64> _wanted(_processIds.constBegin(), _processIds.constEnd());
+        for (auto _it = PidFds.begin(); _it != PidFds.end();) {
+            if (_wanted.contains(_it.key())) {
+                ++_it;
+                continue;
+            }
+            if (_it.value() >= 0) {
+                ::close(_it.value());
+            }
+            _it = PidFds.erase(_it);
+        }
+
+        QVector<qint64> _exited;
+        QVector<qint64> _polled;
+        std::vector<pollfd> _fds;
+        bool _fallback = false;
+        for (qint64 _processId : _processIds) {
+            auto _it = PidFds.find(_processId);
+            if (_it == PidFds.end()) {
+                _it = PidFds.insert(_processId, OpenPidFd(_processId));
+            }
+            if (_it.value() >= 0) {
+                _fds.push_back(pollfd { _it.value(), POLLIN, 0 });
+                _polled.append(_processId);
+            } else if (!IsAlive(_processId)) {
+                _exited.append(_processId);
+            } else {
+                _fallback = true;
+            }
+        }
+
+        if (_exited.isEmpty()) {
+            // A pidfd becomes readable when its process exits
+            const int _waitMs = _fallback ? qMin(qMax(0, _timeoutMs), FallbackPollMs) : qMax(0, _timeoutMs);
+            if (::poll(_fds.data(), nfds_t(_fds.size()), _waitMs) < 0 && errno != EINTR) {
+                qDebug() << "Exit wait: poll failed, errno" << errno;
+            }
+            for (size_t _i = 0; _i < _fds.size(); ++_i) {
+                if (_fds[_i].revents & (POLLIN | POLLHUP)) {
+                    _exited.append(_polled.at(int(_i)));
+                }
+            }
+            if (_fallback) {
+                for (qint64 _processId : _processIds) {
+                    if (PidFds.value(_processId, -1) < 0 && !IsAlive(_processId)) {
+                        _exited.append(_processId);
+                    }
+                }
+            }
+        }
+
+        for (qint64 _processId : _exited) {
+            const int _fd = PidFds.take(_processId);
+            if (_fd >= 0) {
+                ::close(_fd);
+            }
+        }
+        return _exited;
+    }
+
+private:
+    QHash<qint64, int> PidFds;  // Open pidfd per awaited process - -1 if unavailable
+
+    /**
+     * @brief Opens a pidfd for a process
+     * @param _processId Process ID
+     * @return int Descriptor - -1 if unavailable or the process is gone
+     */
+    static int OpenPidFd(qint64 _processId)
+    {
+#ifdef SYS_pidfd_open
+        return int(::syscall(SYS_pidfd_open, pid_t(_processId), 0));
+#else
+        Q_UNUSED(_processId);
+        return -1;
+#endif
+    }
+
+    /**
+     * @brief Checks whether a process still exists
+     * @param _processId Process ID
+     * @return bool True if kill(pid, 0) finds it
+     */
+    static bool IsAlive(qint64 _processId)
+    {
+        return ::kill(pid_t(_processId), 0) == 0 || errno == EPERM;
+    }
+};
+
+/**
+ * @brief Spawner starting detached processes with a GUI-ready environment
+ *
+ * Uses a double fork so the application is reparented to init exactly like
+ * QProcess::startDetached, but the monitor chooses the child's stdio and
+ * applies the launch policy between fork and exec. A close-on-exec status
+ * pipe reports the application PID and any policy or exec error.
+ */
+class A_systemprocessspawner : public A_processspawner
+{
+public:
+    bool Spawn(const QString& _applicationName, const QString& _path, const LaunchPolicy& _policy,
+               qint64* _processId, int _outputFd, const QVector<int>& _listenFds,
+               const QStringList& _environment) override
+    {
+        if (_processId) {
+            *_processId = 0;
+        }
+
+        // Check if executable exists and is accessible
+        QFileInfo _fileInfo(_path);
+        if (!_fileInfo.exists() || !_fileInfo.isExecutable()) {
+            qDebug() << "Executable does not exist or is not executable:" << _path;
+            return false;
+        }
+
+        QProcessEnvironment _env = QProcessEnvironment::systemEnvironment();
+
+        // Ensure GUI environment variables are set properly
+        if (!_env.contains("DISPLAY")) {
+            _env.insert("DISPLAY", ":0");
+        }
+
+        if (!_env.contains("XAUTHORITY")) {
+            QString _xauth = QDir::homePath() + "/.Xauthority";
+            if (QFileInfo(_xauth).exists()) {
+                _env.insert("XAUTHORITY", _xauth);
+            }
+        }
+
+        // Add XDG variables to ensure proper desktop integration
+        _env.insert("XDG_RUNTIME_DIR", "/run/user/" + QString::number(getuid()));
+        _env.insert("XDG_SESSION_TYPE", "x11");
+
+        // Socket activation variables describe our descriptors, never inherited ones
+        _env.remove("LISTEN_FDS");
+        _env.remove("LISTEN_PID");
+        _env.remove("LISTEN_FDNAMES");
+        if (!_listenFds.isEmpty()) {
+            _env.insert("LISTEN_FDS", QString::number(qMin(int(_listenFds.size()), MaxListenFds)));
+        }
+
+        for (const QString& _variable : _environment) {
+            const int _equals = _variable.indexOf('=');
+            if (_equals > 0) {
+                _env.insert(_variable.left(_equals), _variable.mid(_equals + 1));
+            }
+        }
+
+        // Everything the child needs is built before fork - only async-signal-safe calls after it
+        const QByteArray _program = QFile::encodeName(_path);
+        const QByteArray _workingDir = QFile::encodeName(QDir::homePath());
+        QList<QByteArray> _envStrings;
+        const QStringList _keys = _env.keys();
+        for (const QString& _key : _keys) {
+            _envStrings.append((_key + "=" + _env.value(_key)).toLocal8Bit());
+        }
+        std::vector<char*> _envp;
+        _envp.reserve(size_t(_envStrings.size()) + 1);
+        for (QByteArray& _entry : _envStrings) {
+            _envp.push_back(_entry.data());
+        }
+        // LISTEN_PID must name the application itself - filled in after the second fork
+        QByteArray _listenPid("LISTEN_PID=00000000000");
+        char* const _listenPidDigits = _listenPid.data() + 11;
+        if (!_listenFds.isEmpty()) {
+            _envp.push_back(_listenPid.data());
+        }
+        _envp.push_back(nullptr);
+        char* _argv[] = { const_cast<char*>(_program.constData()), nullptr };
+
+        A_launchpolicy _launchPolicy;
+        if (!_launchPolicy.Prepare(_policy)) {
+            qDebug() << "Launch policy cannot be applied for:" << _applicationName;
+            return false;
+        }
+
+        int _status[2];
+        if (pipe2(_status, O_CLOEXEC) != 0) {
+            qDebug() << "Cannot create status pipe for:" << _applicationName << strerror(errno);
+            return false;
+        }
+
+        const pid_t _child = fork();
+        if (_child < 0) {
+            qDebug() << "fork failed for:" << _applicationName << strerror(errno);
+            ::close(_status[0]);
+            ::close(_status[1]);
+            return false;
+        }
+
+        if (_child == 0) {
+            // Intermediate child - starts a new session and reports the application PID
+            ::close(_status[0]);
+            setsid();
+            const pid_t _grandchild = fork();
+            if (_grandchild != 0) {
+                const qint64 _report = _grandchild > 0 ? qint64(_grandchild) : -qint64(errno);
+                ssize_t _ignored = ::write(_status[1], &_report, sizeof(_report));
+                (void)_ignored;
+                _exit(0);
+            }
+
+            // Application process
+            sigset_t _emptyMask;
+            sigemptyset(&_emptyMask);
+            sigprocmask(SIG_SETMASK, &_emptyMask, nullptr);
+            signal(SIGPIPE, SIG_DFL);
+
+            const int _nullFd = ::open("/dev/null", O_RDWR | O_CLOEXEC); // Only the dup2 copies reach the application
+            dup2(_nullFd, STDIN_FILENO);
+            dup2(_outputFd >= 0 ? _outputFd : _nullFd, STDOUT_FILENO);
+            dup2(_outputFd >= 0 ? _outputFd : _nullFd, STDERR_FILENO);
+            if (_nullFd >= 0 && _nullFd <= STDERR_FILENO) {
+                // Opened onto a closed standard descriptor - dup2 onto itself keeps the flag
+                fcntl(_nullFd, F_SETFD, 0);
+            }
+            if (chdir(_workingDir.constData()) != 0) {
+                // Keep the inherited directory
+            }
+
+            // Listening sockets go to 3, 4, ...; lift everything out of that range first so no dup2 clobbers a source
+            int _statusFd = _status[1];
+            if (!_listenFds.isEmpty()) {
+                const int _count = int(_listenFds.size());
+                _statusFd = fcntl(_status[1], F_DUPFD_CLOEXEC, 3 + _count);
+                int _lifted[MaxListenFds];
+                const int _passed = _count < MaxListenFds ? _count : MaxListenFds;
+                for (int _i = 0; _i < _passed; ++_i) {
+                    _lifted[_i] = fcntl(_listenFds.at(_i), F_DUPFD_CLOEXEC, 3 + _count);
+                }
+                for (int _i = 0; _i < _passed; ++_i) {
+                    dup2(_lifted[_i], 3 + _i);
+                }
+
+                // No leading zeros - some parsers would read them as octal
+                char _digits[16];
+                int _length = 0;
+                for (pid_t _self = getpid(); _self > 0 || _length == 0; _self /= 10) {
+                    _digits[_length++] = char('0' + _self % 10);
+                }
+                for (int _i = 0; _i < _length; ++_i) {
+                    _listenPidDigits[_i] = _digits[_length - 1 - _i];
+                }
+                _listenPidDigits[_length] = '\0';
+            }
+
+            // Failure report - { -errno, failed A_launchpolicy::Step or NoStep for exec }
+            qint64 _failure[2] = { 0, A_launchpolicy::NoStep };
+            _failure[1] = _launchPolicy.Apply();
+            if (_failure[1] == A_launchpolicy::NoStep) {
+                execve(_program.constData(), _argv, _envp.data());
+            }
+            _failure[0] = -qint64(errno);
+            ssize_t _ignored = ::write(_statusFd, _failure, sizeof(_failure));
+            (void)_ignored;
+            _exit(127);
+        }
+
+        // The intermediate child exits immediately; reap it so it never lingers as a zombie
+        ::close(_status[1]);
+        qint64 _pid = 0;
+        qint64 _failure[2] = { 0, A_launchpolicy::NoStep };
+        const bool _gotPid = ReadFully(_status[0], &_pid, sizeof(_pid));
+        const bool _childFailed = ReadFully(_status[0], _failure, sizeof(_failure));
+        ::close(_status[0]);
+        while (waitpid(_child, nullptr, 0) < 0 && errno == EINTR) {
+        }
+
+        if (!_gotPid || _pid <= 0) {
+            qDebug() << "Launch failed for:" << _applicationName << "-" << strerror(int(_gotPid ? -_pid : EIO));
+            return false;
+        }
+        if (_childFailed && _failure[1] != A_launchpolicy::NoStep) {
+            qDebug() << "Launch policy step" << A_launchpolicy::StepName(int(_failure[1])) << "failed for:"
+                     << _applicationName << "-" << strerror(int(-_failure[0]));
+            return false;
+        }
+        if (_childFailed) {
+            qDebug() << "exec failed for:" << _applicationName << "-" << strerror(int(-_failure[0]));
+            return false;
+        }
+
+        qDebug() << "Process started detached successfully:" << _applicationName << "PID:" << _pid
+                 << (_outputFd >= 0 ? "(output captured)" : "");
+        if (_processId) {
+            *_processId = _pid;
+        }
+        return true;
+    }
+
+private:
+    /**
+     * @brief Reads an exact number of bytes from a blocking descriptor
+     * @param _fd Descriptor to read
+     * @param _buffer Destination
+     * @param _length Bytes required
+     * @return bool False on end-of-file or error before _length bytes arrived
+     */
+    static bool ReadFully(int _fd, void* _buffer, size_t _length)
+    {
+        size_t _done = 0;
+        while (_done < _length) {
+            const ssize_t _read = ::read(_fd, static_cast<char*>(_buffer) + _done, _length - _done);
+            if (_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (_read <= 0) {
+                return false;
+            }
+            _done += size_t(_read);
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Wall clock with real blocking sleeps
+ */
+class A_systemclock : public A_clock
+{
+public:
+    qint64 NowMs() override { return QDateTime::currentMSecsSinceEpoch(); }
+    void SleepMs(int _milliseconds) override { QThread::msleep(_milliseconds); }
+};
+
+} // namespace
+
+A_processtable* A_processtable::System()
+{
+    static A_systemprocesstable _instance;
+    return &_instance;
+}
+
+A_signalsender* A_signalsender::System()
+{
+    static A_systemsignalsender _instance;
+    return &_instance;
+}
+
+A_processspawner* A_processspawner::System()
+{
+    static A_systemprocessspawner _instance;
+    return &_instance;
+}
+
+A_clock* A_clock::System()
+{
+    static A_systemclock _instance;
+    return &_instance;
+}
+
+A_procfsprocesstable::A_procfsprocesstable(const QString& _procRoot)
+    : ProcRoot(_procRoot)
+{
+}
+
+qint64 A_procfsprocesstable::FindProcess(const QString& _executablePath)
+{
+    // The kernel truncates process names to 15 characters
+    const QByteArray _execName = QFileInfo(_executablePath).fileName().toLocal8Bit().left(15);
+    qint64 _lowestPid = 0;
+
+    const QStringList _entries = QDir(ProcRoot).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& _entry : _entries) {
+        bool _ok = false;
+        qint64 _pid = _entry.toLongLong(&_ok);
+        if (!_ok || _pid <= 0) {
+            continue;
+        }
+
+        QFile _statFile(ProcRoot + "/" + _entry + "/stat");
+        if (!_statFile.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray _name;
+        ProcessStat _stat;
+        if (ParseStat(_statFile.read(1024), &_name, &_stat) == 0) {
+            continue;
+        }
+
+        // Zombies have exited; they only wait to be reaped
+        if (_stat.State == 'Z' || _stat.State == 'X') {
+            continue;
+        }
+
+        if (_name == _execName &&
+            (_lowestPid == 0 || _pid < _lowestPid)) {
+            _lowestPid = _pid;
+        }
+    }
+
+    return _lowestPid;
+}
+
+bool A_procfsprocesstable::ReadStat(qint64 _processId, ProcessStat* _stat, const QString& _procRoot)
+{
+    QFile _statFile(_procRoot + "/" + QString::number(_processId) + "/stat");
+    if (_processId <= 0 || !_statFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return ParseStat(_statFile.read(1024), nullptr, _stat) > 19;
+}
+
+bool A_procfsprocesstable::ReadStatm(qint64 _processId, ProcessStat* _stat, const QString& _procRoot)
+{
+    // statm: "<size> <resident> <shared> ..." - all in pages
+    QFile _statmFile(_procRoot + "/" + QString::number(_processId) + "/statm");
+    if (_processId <= 0 || !_statmFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QList<QByteArray> _pages = _statmFile.read(256).split(' ');
+    if (_pages.size() < 2) {
+        return false;
+    }
+    _stat->ResidentPages = _pages.at(1).toULongLong();
+    return true;
+}
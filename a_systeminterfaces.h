@@ -0,0 +1,175 @@
+#ifndef A_SYSTEMINTERFACES_H
+#define A_SYSTEMINTERFACES_H
+
+#include <QString>
+#include <QVector>
+#include <QStringList>
+#include <QDebug>
+#include "a_settingsclass.h"
+
+/**
+ * @brief Interface for looking up running processes
+ *
+ * A_process finds processes only through this interface so that a simulator
+ * can substitute a virtual process table.
+ */
+class A_processtable
+{
+public:
+    virtual ~A_processtable() = default;
+
+    /**
+     * @brief Finds a running process by executable
+     * @param _executablePath Full path to executable - matched by file name
+     * @return qint64 Process ID if running, 0 if not found
+     */
+    virtual qint64 FindProcess(const QString& _executablePath) = 0;
+
+    /**
+     * @brief Gets the default implementation backed by pidof/pgrep
+     * @return A_processtable* Process-wide instance - never null
+     */
+    static A_processtable* System();
+};
+
+/**
+ * @brief Interface for delivering signals to processes
+ */
+class A_signalsender
+{
+public:
+    virtual ~A_signalsender() = default;
+
+    /**
+     * @brief Sends a signal to a process
+     * @param _processId Target process ID - must be positive
+     * @param _signal Signal number - e.g. SIGTERM
+     * @return bool True if the signal was delivered
+     */
+    virtual bool SendSignal(qint64 _processId, int _signal) = 0;
+
+    /**
+     * @brief Waits until one of several processes exits
+     * Returns as soon as any of them is gone or the timeout passes. State kept
+     * per process between calls is released for processes a later call leaves
+     * out, so a final call with an empty list releases everything.
+     * @param _processIds Processes to wait for
+     * @param _timeoutMs Longest wait - milliseconds, 0 only checks
+     * @return QVector<qint64> Processes of the list that no longer exist - empty on timeout
+     */
+    virtual QVector<qint64> WaitForExit(const QVector<qint64>& _processIds, int _timeoutMs) = 0;
+
+    /**
+     * @brief Gets the default implementation backed by kill(2) and pidfds
+     * @return A_signalsender* Process-wide instance - never null
+     */
+    static A_signalsender* System();
+};
+
+/**
+ * @brief Interface for starting application processes
+ */
+class A_processspawner
+{
+public:
+    virtual ~A_processspawner() = default;
+
+    /**
+     * @brief Starts an application
+     * @param _appName Application name - for logging
+     * @param _executablePath Full path to executable
+     * @param _policy Scheduling policy applied before the application runs - all or nothing
+     * @param _processId Receives the new process ID - 0 if unknown
+     * @param _outputFd Descriptor that becomes the application's stdout and stderr - -1 for /dev/null
+     * @param _listenFds Listening sockets passed as descriptors 3, 4, ... with LISTEN_FDS/LISTEN_PID set
+     * @param _environment Extra "NAME=value" variables for the application - override inherited ones
+     * @return bool True if the application was started
+     */
+    virtual bool Spawn(const QString& _appName, const QString& _executablePath, const LaunchPolicy& _policy,
+                       qint64* _processId, int _outputFd, const QVector<int>& _listenFds,
+                       const QStringList& _environment) = 0;
+
+    /**
+     * @brief Gets the default implementation (detached fork/exec with GUI environment)
+     * @return A_processspawner* Process-wide instance - never null
+     */
+    static A_processspawner* System();
+};
+
+/**
+ * @brief Interface for time and blocking waits
+ */
+class A_clock
+{
+public:
+    virtual ~A_clock() = default;
+
+    /**
+     * @brief Gets the current time
+     * @return qint64 Milliseconds since epoch (or since simulation start)
+     */
+    virtual qint64 NowMs() = 0;
+
+    /**
+     * @brief Blocks the caller for a duration
+     * @param _milliseconds Duration - virtual clocks advance instead of blocking
+     */
+    virtual void SleepMs(int _milliseconds) = 0;
+
+    /**
+     * @brief Gets the default wall clock implementation
+     * @return A_clock* Process-wide instance - never null
+     */
+    static A_clock* System();
+};
+
+/**
+ * @brief Per-process counters read from procfs
+ */
+struct ProcessStat {
+    char State = '?';               // State letter - 'Z' or 'X' once the process has exited
+    quint64 CpuTicks = 0;           // utime + stime - clock ticks
+    int Nice = 0;                   // Nice value - -20 to 19
+    quint64 StartTicks = 0;         // Start time after boot - clock ticks, stable for the process lifetime
+    quint64 ResidentPages = 0;      // Resident set - pages, filled by ReadStatm() only
+};
+
+/**
+ * @brief Process table reading a procfs tree directly
+ *
+ * Matches the process name in <root>/<pid>/stat like "pgrep -x". The root is
+ * configurable so a simulator can point it at a fake /proc directory.
+ */
+class A_procfsprocesstable : public A_processtable
+{
+public:
+    /**
+     * @param _procRoot Root of the procfs tree - "/proc" on a real system
+     */
+    explicit A_procfsprocesstable(const QString& _procRoot = "/proc");
+
+    qint64 FindProcess(const QString& _executablePath) override;
+
+    /**
+     * @brief Reads state, CPU time, nice and start time from <root>/<pid>/stat
+     * @param _processId Process ID
+     * @param _stat Filled on success - ResidentPages is left untouched
+     * @param _procRoot Root of the procfs tree
+     * @return bool False if the process is gone or the file is malformed
+     */
+    static bool ReadStat(qint64 _processId, ProcessStat* _stat, const QString& _procRoot = "/proc");
+
+    /**
+     * @brief Reads the resident set size from <root>/<pid>/statm
+     * @param _processId Process ID
+     * @param _stat ResidentPages is set on success
+     * @param _procRoot Root of the procfs tree
+     * @return bool False if the process is gone
+     */
+    static bool ReadStatm(qint64 _processId, ProcessStat* _stat, const QString& _procRoot = "/proc");
+
+private:
+    QString ProcRoot;   // procfs root - directory containing <pid>/stat entries
+};
+
+#endif // A_SYSTEMINTERFACES_H
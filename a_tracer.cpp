@@ -0,0 +1,190 @@
+#include "a_tracer.h"
+#include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <vector>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Every thread buffer ever created - the lock is taken once per thread and by the writer
+ */
+struct TraceRegistry {
+    QMutex Lock;
+    std::vector<std::unique_ptr<A_tracebuffer>> Buffers;
+};
+
+TraceRegistry& Registry()
+{
+    static TraceRegistry _registry;
+    return _registry;
+}
+
+/**
+ * @brief Escapes a string for a JSON string literal
+ */
+QByteArray JsonEscaped(const QString& _text)
+{
+    QByteArray _escaped;
+    for (const char _c : _text.toUtf8()) {
+        if (_c == '"' || _c == '\\') {
+            _escaped += '\\';
+            _escaped += _c;
+        } else if (uchar(_c) < 0x20) {
+            _escaped += ' ';
+        } else {
+            _escaped += _c;
+        }
+    }
+    return _escaped;
+}
+
+} // namespace
+
+A_tracebuffer::A_tracebuffer(qint64 _threadId, const QString& _threadName)
+    : Events(new TraceEvent[Capacity])
+{
+    ThreadId = _threadId;
+    ThreadName = _threadName;
+    Written.store(0, std::memory_order_relaxed);
+}
+
+void A_tracer::Start()
+{
+    qint64 _unset = 0;
+    OriginNs.compare_exchange_strong(_unset, NowNs(), std::memory_order_relaxed);
+    Active.store(true, std::memory_order_relaxed);
+}
+
+void A_tracer::Stop()
+{
+    Active.store(false, std::memory_order_relaxed);
+}
+
+void A_tracer::Record(const char* _category, const char* _name, qint64 _startNs, qint64 _endNs)
+{
+    thread_local A_tracebuffer* _buffer = nullptr;
+    if (!_buffer) {
+        _buffer = RegisterThread();
+    }
+    _buffer->Append(TraceEvent { _category, _name, _startNs, _endNs - _startNs });
+}
+
+A_tracebuffer* A_tracer::RegisterThread()
+{
+    QString _threadName = QThread::currentThread() ? QThread::currentThread()->objectName() : QString();
+    if (_threadName.isEmpty()) {
+        char _name[16] = {};
+        if (pthread_getname_np(pthread_self(), _name, sizeof(_name)) == 0) {
+            _threadName = QString::fromLocal8Bit(_name);
+        }
+    }
+
+    TraceRegistry& _registry = Registry();
+    QMutexLocker _lock(&_registry.Lock);
+    _registry.Buffers.emplace_back(new A_tracebuffer(qint64(syscall(SYS_gettid)), _threadName));
+    return _registry.Buffers.back().get();
+}
+
+bool A_tracer::WriteChromeTrace(const QString& _filePath)
+{
+    QFile _file(_filePath);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Error: Cannot open trace file:" << _filePath << _file.errorString();
+        return false;
+    }
+
+    const qint64 _processId = qint64(getpid());
+    const qint64 _originNs = OriginNs.load(std::memory_order_relaxed);
+    // Chrome trace timestamps are microseconds; keep nanosecond precision as decimals
+    auto _us = [](qint64 _ns) { return QByteArray::number(double(_ns) / 1000.0, 'f', 3); };
+
+    TraceRegistry& _registry = Registry();
+    QMutexLocker _lock(&_registry.Lock);
+
+    QByteArray _chunk;
+    _chunk.reserve(1 << 16);
+    _chunk += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool _first = true;
+    auto _separate = [&]() {
+        if (!_first) {
+            _chunk += ",\n";
+        }
+        _first = false;
+    };
+
+    quint64 _events = 0;
+    quint64 _overwritten = 0;
+    std::vector<TraceEvent> _copy;
+    for (const std::unique_ptr<A_tracebuffer>& _buffer : _registry.Buffers) {
+        const QByteArray _ids = ",\"pid\":" + QByteArray::number(_processId)
+                                + ",\"tid\":" + QByteArray::number(_buffer->ThreadId);
+        _separate();
+        _chunk += "{\"name\":\"thread_name\",\"ph\":\"M\"" + _ids + ",\"args\":{\"name\":\""
+                  + JsonEscaped(_buffer->ThreadName.isEmpty() ? QString::number(_buffer->ThreadId) : _buffer->ThreadName)
+                  + "\"}}";
+
+        // Copy the newest entries, then drop any the owner may have overwritten meanwhile
+        const quint64 _end = _buffer->Written.load(std::memory_order_acquire);
+        const quint64 _begin = _end > A_tracebuffer::Capacity ? _end - A_tracebuffer::Capacity : 0;
+        _copy.clear();
+        for (quint64 _i = _begin; _i < _end; ++_i) {
+            _copy.push_back(_buffer->Events[_i & (A_tracebuffer::Capacity - 1)]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 _after = _buffer->Written.load(std::memory_order_relaxed);
+        const quint64 _intact = _after >= A_tracebuffer::Capacity ? _after - A_tracebuffer::Capacity + 1 : 0;
+        const quint64 _first = qMax(_begin, _intact);
+
+        for (quint64 _i = _first; _i < _end; ++_i) {
+            const TraceEvent& _event = _copy[size_t(_i - _begin)];
+            _separate();
+            _chunk += QByteArray("{\"name\":\"") + _event.Name + "\",\"cat\":\"" + _event.Category
+                      + "\",\"ph\":\"X\",\"ts\":" + _us(_event.StartNs - _originNs)
+                      + ",\"dur\":" + _us(_event.DurationNs) + _ids + "}";
+            if (_chunk.size() > (1 << 16) - 512) {
+                _file.write(_chunk);
+                _chunk.clear();
+            }
+        }
+        _events += _end - _first;
+        _overwritten += _first;
+    }
+    _chunk += "\n],\"otherData\":{\"overwritten_events\":\"" + QByteArray::number(_overwritten) + "\"}}\n";
+    _file.write(_chunk);
+
+    if (!_file.flush() || _file.error() != QFile::NoError) {
+        qDebug() << "Error: Failed to write trace file:" << _filePath << _file.errorString();
+        return false;
+    }
+    qDebug() << "Trace written to:" << _filePath << "-" << _events << "events," << _overwritten << "older ones overwritten";
+    return true;
+}
+
+quint64 A_tracer::EventCount()
+{
+    TraceRegistry& _registry = Registry();
+    QMutexLocker _lock(&_registry.Lock);
+    quint64 _count = 0;
+    for (const std::unique_ptr<A_tracebuffer>& _buffer : _registry.Buffers) {
+        _count += qMin<quint64>(_buffer->Written.load(std::memory_order_acquire), A_tracebuffer::Capacity);
+    }
+    return _count;
+}
+
+quint64 A_tracer::OverwrittenCount()
+{
+    TraceRegistry& _registry = Registry();
+    QMutexLocker _lock(&_registry.Lock);
+    quint64 _count = 0;
+    for (const std::unique_ptr<A_tracebuffer>& _buffer : _registry.Buffers) {
+        const quint64 _written = _buffer->Written.load(std::memory_order_acquire);
+        _count += _written > A_tracebuffer::Capacity ? _written - A_tracebuffer::Capacity : 0;
+    }
+    return _count;
+}
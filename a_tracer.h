@@ -0,0 +1,169 @@
+#ifndef A_TRACER_H
+#define A_TRACER_H
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+/**
+ * @brief One completed trace span
+ */
+struct TraceEvent {
+    const char* Category;   // Static string - e.g. "engine"
+    const char* Name;       // Static string - e.g. "CheckProcesses"
+    qint64 StartNs;         // Span start - steady clock nanoseconds
+    qint64 DurationNs;      // Span length - nanoseconds
+};
+
+/**
+ * @brief Fixed-size ring of events written by exactly one thread
+ *
+ * The owning thread overwrites the oldest entry and then publishes it with a
+ * release store of Written; readers load Written with acquire and read the
+ * newest Capacity entries below it, so neither side ever takes a lock. A
+ * long-running monitor thus always holds its most recent activity.
+ */
+class A_tracebuffer
+{
+public:
+    static constexpr quint32 Capacity = 1u << 16;   // Events per thread - 2 MB, a power of two
+    static_assert((Capacity & (Capacity - 1)) == 0, "Ring index is masked");
+
+    /**
+     * @param _threadId Kernel thread ID of the owner
+     * @param _threadName Owner's name - shown as the track name
+     */
+    A_tracebuffer(qint64 _threadId, const QString& _threadName);
+
+    /**
+     * @brief Appends an event - owning thread only
+     * @param _event Completed span
+     */
+    void Append(const TraceEvent& _event)
+    {
+        const quint64 _written = Written.load(std::memory_order_relaxed);
+        Events[_written & (Capacity - 1)] = _event;
+        Written.store(_written + 1, std::memory_order_release);
+    }
+
+    qint64 ThreadId;                        // Kernel thread ID of the owner
+    QString ThreadName;                     // Owner's name - empty if unnamed
+    std::unique_ptr<TraceEvent[]> Events;   // Capacity entries - event n lives at n % Capacity
+    std::atomic<quint64> Written;           // Events ever published - all but the newest Capacity are overwritten
+};
+
+/**
+ * @brief Opt-in timeline tracing of supervision activity
+ *
+ * Instrumented scopes record one complete span each into a buffer owned by
+ * the recording thread. The spans are written as Chrome trace event JSON,
+ * which chrome://tracing and ui.perfetto.dev open directly. While tracing is
+ * off a scope costs one relaxed atomic load and a branch that is always
+ * predicted not taken; no scope object is constructed.
+ */
+class A_tracer
+{
+public:
+    /**
+     * @brief Starts recording - the first call fixes the trace's time origin
+     */
+    static void Start();
+
+    /**
+     * @brief Stops recording - recorded events are kept for WriteChromeTrace()
+     */
+    static void Stop();
+
+    /**
+     * @brief Reports whether scopes are recording
+     * @return bool True between Start() and Stop()
+     */
+    static bool IsActive() { return __builtin_expect(Active.load(std::memory_order_relaxed), false); }
+
+    /**
+     * @brief Reads the clock the spans are timed with
+     * @return qint64 Steady clock - nanoseconds
+     */
+    static qint64 NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Records a completed span into the calling thread's buffer
+     * @param _category Static string - grouping shown in the viewer
+     * @param _name Static string - span name
+     * @param _startNs Span start - NowNs() clock
+     * @param _endNs Span end - NowNs() clock
+     */
+    static void Record(const char* _category, const char* _name, qint64 _startNs, qint64 _endNs);
+
+    /**
+     * @brief Writes every recorded event as a Chrome trace JSON file
+     * Safe while threads are still recording; their newer events are left out.
+     * @param _filePath Output file - overwritten
+     * @return bool True if written
+     */
+    static bool WriteChromeTrace(const QString& _filePath);
+
+    /**
+     * @brief Gets the number of recorded events
+     * @return quint64 Events in all thread buffers
+     */
+    static quint64 EventCount();
+
+    /**
+     * @brief Gets the number of events overwritten by newer ones
+     * @return quint64 Overwritten events in all thread buffers
+     */
+    static quint64 OverwrittenCount();
+
+private:
+    static inline std::atomic<bool> Active { false };   // Recording switch - the only state the disabled path reads
+    static inline std::atomic<qint64> OriginNs { 0 };   // Time of the first Start() - trace timestamps count from here
+
+    /**
+     * @brief Creates and registers the calling thread's buffer
+     * @return A_tracebuffer* Buffer - owned by the tracer, outlives the thread
+     */
+    static A_tracebuffer* RegisterThread();
+};
+
+/**
+ * @brief Scope recording its lifetime as a trace span
+ * Only constructed by QTPM_TRACE_SCOPE while tracing is active, so it always records.
+ */
+class A_tracescope
+{
+public:
+    A_tracescope(const char* _category, const char* _name)
+        : Category(_category), Name(_name), StartNs(A_tracer::NowNs())
+    {
+    }
+
+    ~A_tracescope()
+    {
+        A_tracer::Record(Category, Name, StartNs, A_tracer::NowNs());
+    }
+
+    A_tracescope(const A_tracescope&) = delete;
+    A_tracescope& operator=(const A_tracescope&) = delete;
+
+private:
+    const char* Category;   // Static string - span category
+    const char* Name;       // Static string - span name
+    qint64 StartNs;         // Scope entry time
+};
+
+#define QTPM_TRACE_CONCAT_INNER(_a, _b) _a##_b
+#define QTPM_TRACE_CONCAT(_a, _b) QTPM_TRACE_CONCAT_INNER(_a, _b)
+// The flag is tested once, at entry; while tracing is off nothing is constructed or stored
+#define QTPM_TRACE_SCOPE(_category, _name) \
+    std::optional<A_tracescope> QTPM_TRACE_CONCAT(_traceScope, __LINE__); \
+    if (A_tracer::IsActive()) \
+        QTPM_TRACE_CONCAT(_traceScope, __LINE__).emplace(_category, _name)
+
+#endif // A_TRACER_H
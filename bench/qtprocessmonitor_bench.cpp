@@ -0,0 +1,462 @@
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QProcess>
+#include <QFile>
+#include <QTextStream>
+#include <QList>
+#include <QMap>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+#include "a_settingsclass.h"
+#include "a_apptable.h"
+#include "a_process.h"
+#include "a_applicationmodel.h"
+#include "a_searchindex.h"
+#include "a_heartbeatwatchdog.h"
+#include "a_metrics.h"
+
+/**
+ * @brief Benchmarks for the monitoring hot paths
+ *
+ * Every case builds a synthetic config.xml in a temporary directory. The first
+ * DummyChildCount applications point at uniquely named copies of /bin/sleep
+ * that are really running (status "start"), so lookups and ticks exercise the
+ * found-process path without launching anything. The remaining applications
+ * point at missing executables with status "stop", exercising the not-found
+ * path. Output defaults to JSON so runs can be diffed.
+ */
+
+namespace {
+
+constexpr int DummyChildCount = 8;   // Real child processes shared by all cases
+
+/**
+ * @brief Exposes the protected engine steps of A_process
+ */
+class BenchProcess : public A_process
+{
+public:
+    using A_process::CheckProcesses;
+    using A_process::UpdateProcessMap;
+    using A_process::FindProcessByExecutable;
+};
+
+/**
+ * @brief Owns the temporary directory and the running dummy children
+ */
+class BenchEnvironment
+{
+public:
+    BenchEnvironment()
+    {
+        // SaveConfiguration mirrors into ./config.xml; keep that inside the scratch directory
+        QDir::setCurrent(TempDir.path());
+
+        for (int _i = 0; _i < DummyChildCount; ++_i) {
+            QString _path = TempDir.path() + QString("/qpmbench_dummy_%1").arg(_i);
+            QFile::copy("/bin/sleep", _path);
+            QFile::setPermissions(_path, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+
+            QProcess* _child = new QProcess();
+            _child->start(_path, QStringList() << "3600");
+            _child->waitForStarted(3000);
+            Children.append(_child);
+            DummyPaths.append(_path);
+        }
+    }
+
+    ~BenchEnvironment()
+    {
+        for (QProcess* _child : Children) {
+            _child->kill();
+            _child->waitForFinished(3000);
+            delete _child;
+        }
+    }
+
+    /**
+     * @brief Writes a synthetic configuration with _appCount applications
+     * @param _appCount Number of applications
+     * @return QString Path of the written config.xml
+     */
+    QString WriteConfig(int _appCount)
+    {
+        QString _path = TempDir.path() + QString("/config_%1.xml").arg(_appCount);
+        if (QFile::exists(_path)) {
+            return _path;
+        }
+
+        QFile _file(_path);
+        _file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate);
+        QTextStream _stream(&_file);
+        _stream << "<configuration>\n"
+                << "    <settings><id>BENCH</id><port>1000</port><ip>127.0.0.1</ip></settings>\n"
+                << "    <applications>\n";
+        for (int _i = 0; _i < _appCount; ++_i) {
+            bool _running = _i < DummyPaths.size();
+            QString _executable = _running ? DummyPaths.at(_i)
+                                           : TempDir.path() + QString("/qpmbench_missing_%1").arg(_i);
+            _stream << "        <app><n>App" << _i << "</n>"
+                    << "<executable>" << _executable << "</executable>"
+                    << "<status>" << (_running ? "start" : "stop") << "</status></app>\n";
+        }
+        _stream << "    </applications>\n</configuration>\n";
+        return _path;
+    }
+
+    QString DummyPath(int _index) const { return DummyPaths.at(_index); }
+    QString MissingPath() const { return TempDir.path() + "/qpmbench_missing"; }
+
+private:
+    QTemporaryDir TempDir;          // Scratch directory - configs and dummy executables
+    QList<QProcess*> Children;      // Running dummy children
+    QStringList DummyPaths;         // Dummy executable paths - one per child
+};
+
+BenchEnvironment* Environment = nullptr;
+
+/**
+ * @brief Drops qDebug output so logging does not dominate the measurements
+ */
+void QuietMessageHandler(QtMsgType _type, const QMessageLogContext&, const QString& _message)
+{
+    if (_type != QtDebugMsg && _type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(_message));
+    }
+}
+
+void BM_FindProcessByExecutable_Running(benchmark::State& _state)
+{
+    BenchProcess _process;
+    const QString _path = Environment->DummyPath(0);
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(_process.FindProcessByExecutable(_path));
+    }
+}
+BENCHMARK(BM_FindProcessByExecutable_Running)->Unit(benchmark::kMillisecond);
+
+void BM_FindProcessByExecutable_Missing(benchmark::State& _state)
+{
+    BenchProcess _process;
+    const QString _path = Environment->MissingPath();
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(_process.FindProcessByExecutable(_path));
+    }
+}
+BENCHMARK(BM_FindProcessByExecutable_Missing)->Unit(benchmark::kMillisecond);
+
+void BM_LoadConfiguration(benchmark::State& _state)
+{
+    const QString _path = Environment->WriteConfig(int(_state.range(0)));
+    for (auto _ : _state) {
+        A_settingsclass _settings;
+        benchmark::DoNotOptimize(_settings.LoadConfiguration(_path));
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_LoadConfiguration)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+
+void BM_SaveConfiguration(benchmark::State& _state)
+{
+    A_settingsclass _settings;
+    _settings.LoadConfiguration(Environment->WriteConfig(int(_state.range(0))));
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(_settings.SaveConfiguration());
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_SaveConfiguration)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+
+void BM_UpdateProcessMap(benchmark::State& _state)
+{
+    A_settingsclass _settings;
+    _settings.LoadConfiguration(Environment->WriteConfig(int(_state.range(0))));
+    BenchProcess _process;
+    _process.SetSettingsReference(&_settings);
+    for (auto _ : _state) {
+        // A new configuration version with the same applications - an unchanged version is skipped outright
+        _state.PauseTiming();
+        _settings.UpdateSettings(_settings.GetId(), _settings.GetPort(), _settings.GetIp());
+        _state.ResumeTiming();
+        _process.UpdateProcessMap();
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_UpdateProcessMap)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+
+void BM_CheckProcessesTick(benchmark::State& _state)
+{
+    A_settingsclass _settings;
+    _settings.LoadConfiguration(Environment->WriteConfig(int(_state.range(0))));
+    BenchProcess _process;
+    _process.SetSettingsReference(&_settings);
+    _process.CheckProcesses(); // Warm-up: settle the running dummies into the map
+
+    for (auto _ : _state) {
+        _process.CheckProcesses();
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+// A tick forks pidof (and pgrep for missing apps) per application, so large
+// sizes run a single iteration; use --benchmark_repetitions for more samples
+BENCHMARK(BM_CheckProcessesTick)->RangeMultiplier(10)->Range(10, 10000)
+    ->Iterations(1)->Unit(benchmark::kMillisecond);
+
+void BM_ApplicationModelBuild(benchmark::State& _state)
+{
+    A_settingsclass _settings;
+    _settings.LoadConfiguration(Environment->WriteConfig(int(_state.range(0))));
+    BenchProcess _process;
+    _process.SetSettingsReference(&_settings);
+
+    const qint64 _residentBefore = A_metrics::ResidentKb();
+    A_applicationmodel _model(&_process);
+    for (auto _ : _state) {
+        _model.Reload();
+
+        // One screenful of rows, as a view would request after the reset
+        const int _visibleRows = qMin(_model.rowCount(), 40);
+        for (int _row = 0; _row < _visibleRows; ++_row) {
+            for (int _column = 0; _column < A_applicationmodel::ColumnCount; ++_column) {
+                benchmark::DoNotOptimize(_model.data(_model.index(_row, _column)));
+            }
+        }
+    }
+    _state.counters["rss_delta_kb"] = double(A_metrics::ResidentKb() - _residentBefore);
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_ApplicationModelBuild)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Builds a search index over synthetic application documents
+ * @param _index Index to fill
+ * @param _count Number of documents
+ */
+void FillSearchIndex(A_searchindex& _index, int _count)
+{
+    for (int _i = 0; _i < _count; ++_i) {
+        _index.SetDocument(_i, QString("Service%1\n/opt/vendor%2/bin/service_%1").arg(_i).arg(_i % 97),
+                           quint8(1 << (_i % 3)));
+    }
+}
+
+void BM_SearchIndexBuild(benchmark::State& _state)
+{
+    for (auto _ : _state) {
+        A_searchindex _index;
+        FillSearchIndex(_index, int(_state.range(0)));
+        benchmark::DoNotOptimize(_index.Size());
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_SearchIndexBuild)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+void BM_SearchIndexQuery(benchmark::State& _state)
+{
+    // One keystroke at a time, as typed into the filter box
+    static const char* const _queries[] = { "s", "se", "ser", "vendor4", "vendor42/bin", "service_4999", "zzz" };
+    A_searchindex _index;
+    FillSearchIndex(_index, 50000);
+    const QString _query = QString::fromLatin1(_queries[_state.range(0)]);
+    const quint8 _stateMask = _state.range(1) ? quint8(0x2) : quint8(0x7);
+
+    size_t _matches = 0;
+    for (auto _ : _state) {
+        _matches = size_t(_index.Search(_query, _stateMask).size());
+        benchmark::DoNotOptimize(_matches);
+    }
+    _state.SetLabel(_query.toStdString());
+    _state.counters["matches"] = double(_matches);
+}
+BENCHMARK(BM_SearchIndexQuery)->ArgsProduct({ { 0, 1, 2, 3, 4, 5, 6 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+
+void BM_HeartbeatScan(benchmark::State& _state)
+{
+    // Every slot armed - the scan loads each counter and reports none
+    A_heartbeatwatchdog _watchdog;
+    QList<AppInfo> _apps;
+    for (int _i = 0; _i < _state.range(0); ++_i) {
+        AppInfo _app;
+        _app.Name = QString("Service%1").arg(_i);
+        _app.HeartbeatTimeout = 30;
+        _apps.append(_app);
+    }
+    _watchdog.SetApplications(_apps);
+    for (const AppInfo& _app : _apps) {
+        _watchdog.Arm(_app.Name, 0);
+    }
+
+    qint64 _nowMs = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(_watchdog.Scan(++_nowMs).size());
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_HeartbeatScan)->Arg(100)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Per-application state as A_process kept it before A_apptable
+ */
+struct LegacyProcessInfo {
+    QString ExecutablePath;
+    QString Status;
+    bool IsRunning = false;
+    qint64 ProcessId = 0;
+    qint64 StartTimeMs = 0;
+    int RestartCount = 0;
+    LaunchPolicy Policy;
+    QString PolicyReport;
+    bool PolicyOk = true;
+    IdleInfo Idle;
+    bool Parked = false;
+    qint64 ReclaimedKb = 0;
+    qint64 ParkedProcessId = 0;
+};
+
+/**
+ * @brief Builds synthetic applications - every third one wanted, every other wanted one running
+ * @param _count Number of applications
+ * @return QList<AppInfo> Applications
+ */
+QList<AppInfo> SyntheticApps(int _count)
+{
+    QList<AppInfo> _apps;
+    _apps.reserve(_count);
+    for (int _i = 0; _i < _count; ++_i) {
+        AppInfo _app;
+        _app.Name = QString("Service%1").arg(_i, 6, 10, QChar('0'));
+        _app.Executable = QString("/opt/vendor%1/bin/service_%2").arg(_i % 97).arg(_i);
+        _app.Status = _i % 3 == 0 ? "start" : "stop";
+        _apps.append(_app);
+    }
+    return _apps;
+}
+
+// The two tick cases below make the decisions of CheckProcesses() - restart due,
+// stop due, nothing to do - without the process lookups and launches around
+// them, so they measure only how the per-app state is laid out and walked.
+
+void BM_TickWalk_QMap(benchmark::State& _state)
+{
+    QMap<QString, LegacyProcessInfo> _processMap;
+    QMap<QString, qint64> _lastRestartTime;
+    const QList<AppInfo> _apps = SyntheticApps(int(_state.range(0)));
+    for (int _i = 0; _i < int(_apps.size()); ++_i) {
+        LegacyProcessInfo& _info = _processMap[_apps.at(_i).Name];
+        _info.ExecutablePath = _apps.at(_i).Executable;
+        _info.Status = _apps.at(_i).Status;
+        _info.IsRunning = _i % 6 == 0;
+        _info.ProcessId = _info.IsRunning ? 1000 + _i : 0;
+    }
+
+    qint64 _nowMs = 0;
+    for (auto _ : _state) {
+        _nowMs += 1000;
+        int _restarts = 0;
+        int _stops = 0;
+        for (auto _it = _processMap.begin(); _it != _processMap.end(); ++_it) {
+            LegacyProcessInfo& _info = _it.value();
+            if (_info.Status == "start") {
+                if (!_info.IsRunning && !_info.Parked
+                    && (!_lastRestartTime.contains(_it.key()) || _nowMs - _lastRestartTime.value(_it.key()) > 5000)) {
+                    ++_restarts;
+                }
+            } else if (_info.Status == "stop" && _info.IsRunning && _info.ProcessId > 0) {
+                ++_stops;
+            }
+        }
+        benchmark::DoNotOptimize(_restarts + _stops);
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_TickWalk_QMap)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+void BM_TickWalk_AppTable(benchmark::State& _state)
+{
+    A_apptable _table;
+    _table.Sync(SyntheticApps(int(_state.range(0))));
+    for (int _id = 0; _id < _table.Size(); ++_id) {
+        _table.Running[_id] = _id % 6 == 0;
+        _table.ProcessIds[_id] = _table.Running.at(_id) ? 1000 + _id : 0;
+    }
+
+    qint64 _nowMs = 0;
+    for (auto _ : _state) {
+        _nowMs += 1000;
+        int _restarts = 0;
+        int _stops = 0;
+        for (int _id = 0; _id < _table.Size(); ++_id) {
+            if (!_table.Live.at(_id)) {
+                continue;
+            }
+            const DesiredState _desired = _table.Desired.at(_id);
+            if (_desired == DesiredState::Start) {
+                const qint64 _lastRestartMs = _table.LastRestartMs.at(_id);
+                if (!_table.Running.at(_id) && !_table.Parked.at(_id)
+                    && (_lastRestartMs < 0 || _nowMs - _lastRestartMs > 5000)) {
+                    ++_restarts;
+                }
+            } else if (_desired == DesiredState::Stop && _table.Running.at(_id) && _table.ProcessIds.at(_id) > 0) {
+                ++_stops;
+            }
+        }
+        benchmark::DoNotOptimize(_restarts + _stops);
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_TickWalk_AppTable)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+void BM_AppTableSync(benchmark::State& _state)
+{
+    // Reload of an unchanged configuration - every application keeps its id
+    const QList<AppInfo> _apps = SyntheticApps(int(_state.range(0)));
+    A_apptable _table;
+    _table.Sync(_apps);
+    for (auto _ : _state) {
+        _table.Sync(_apps);
+        benchmark::DoNotOptimize(_table.Count());
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_AppTableSync)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication _app(argc, argv);
+    if (qEnvironmentVariableIsEmpty("QTPM_BENCH_VERBOSE")) {
+        qInstallMessageHandler(QuietMessageHandler);
+    }
+
+    // Default to JSON so results can be diffed between runs
+    std::vector<char*> _args(argv, argv + argc);
+    static char _jsonFormat[] = "--benchmark_format=json";
+    bool _hasFormat = false;
+    for (int _i = 1; _i < argc; ++_i) {
+        if (std::strncmp(argv[_i], "--benchmark_format", 18) == 0) {
+            _hasFormat = true;
+        }
+    }
+    if (!_hasFormat) {
+        _args.push_back(_jsonFormat);
+    }
+    int _argc = int(_args.size());
+
+    benchmark::Initialize(&_argc, _args.data());
+    if (benchmark::ReportUnrecognizedArguments(_argc, _args.data())) {
+        return 1;
+    }
+
+    BenchEnvironment _environment;
+    Environment = &_environment;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    Environment = nullptr;
+    return 0;
+}
@@ -1,7 +1,13 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 #include <QStandardPaths>
+#include "a_metrics.h"
+#include "a_tracer.h"
 #include "mainwindow.h"
 
 /**
@@ -16,6 +22,9 @@
  */
 int main(int argc, char *argv[])
 {
+    QElapsedTimer _startupTimer;
+    _startupTimer.start();
+
     // Create Qt application instance
     QApplication _app(argc, argv);
 
@@ -29,8 +38,22 @@ int main(int argc, char *argv[])
     qDebug() << "Application Name:" << _app.applicationName();
     qDebug() << "Version:" << _app.applicationVersion();
 
-    // Check if config file exists in current directory
-    QString _configPath = QDir::currentPath() + "/config.xml";
+    QCommandLineParser _parser;
+    _parser.addHelpOption();
+    _parser.addVersionOption();
+    QCommandLineOption _configOption("config", "Configuration file.", "path",
+                                     QDir::currentPath() + "/config.xml");
+    QCommandLineOption _traceOption("trace", "Record a timeline and write it as Chrome trace JSON on exit.", "path");
+    _parser.addOption(_configOption);
+    _parser.addOption(_traceOption);
+    _parser.process(_app);
+
+    if (_parser.isSet(_traceOption)) {
+        A_tracer::Start();
+    }
+
+    // Check if the config file exists
+    QString _configPath = QFileInfo(_parser.value(_configOption)).absoluteFilePath();
     QFileInfo _configInfo(_configPath);
 
     if (!_configInfo.exists()) {
@@ -42,15 +65,26 @@ int main(int argc, char *argv[])
     }
 
     // Create and show main window
-    MainWindow _mainWindow;
+    MainWindow _mainWindow(_configPath);
     _mainWindow.show();
 
     qDebug() << "Main window created and displayed";
     qDebug() << "Process monitoring system initialized";
 
+    // Same measurement as qtprocessmonitord, for comparing the two builds
+    QTimer::singleShot(0, &_app, [&]() {
+        qInfo() << "Qt Process Monitor started in" << _startupTimer.elapsed() << "ms, RSS"
+                << A_metrics::ResidentKb() << "kB";
+    });
+
     // Start the Qt event loop
     int _exitCode = _app.exec();
 
+    if (_parser.isSet(_traceOption)) {
+        A_tracer::Stop();
+        A_tracer::WriteChromeTrace(_parser.value(_traceOption));
+    }
+
     qDebug() << "Application exiting with code:" << _exitCode;
     return _exitCode;
 }
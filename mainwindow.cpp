@@ -2,81 +2,321 @@
 #include <QApplication>
 #include <QCoreApplication>
 #include <QThread>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QMenu>
+#include <QScrollBar>
+#include <QFontDatabase>
+#include "a_metrics.h"
+#include "a_tracer.h"
+
+// AppControlDelegate Implementation
+AppControlDelegate::AppControlDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+    // Red start button for stopped apps, green stop button for running ones
+    Styles[0] = ControlStyle { QBrush(QColor("#f44336")), QBrush(QColor("#da190b")), QPen(QColor("#da190b"), 2) };
+    Styles[1] = ControlStyle { QBrush(QColor("#4CAF50")), QBrush(QColor("#45a049")), QPen(QColor("#45a049"), 2) };
+}
 
-// AppControlButton Implementation
-AppControlButton::AppControlButton(const QString& _appName, QWidget* parent)
-    : QPushButton(parent), AppName(_appName), IsRunning(false)
+QRect AppControlDelegate::ButtonRect(const QRect& _cellRect)
 {
-    setText(_appName);
-    setCheckable(false);
-    setMinimumHeight(40);
-    setMinimumWidth(200);
+    return _cellRect.adjusted(4, 3, -4, -3);
+}
 
-    connect(this, &QPushButton::clicked, this, &AppControlButton::OnButtonClicked);
+void AppControlDelegate::paint(QPainter* _painter, const QStyleOptionViewItem& _option, const QModelIndex& _index) const
+{
+    const ControlStyle& _style = Styles[_index.data(A_applicationmodel::RunningRole).toBool() ? 1 : 0];
+    const bool _isHovered = _option.state & QStyle::State_MouseOver;
+
+    const QRect _buttonRect = ButtonRect(_option.rect);
+    _painter->save();
+    _painter->setRenderHint(QPainter::Antialiasing);
+    _painter->setPen(_style.Border);
+    _painter->setBrush(_isHovered ? _style.HoverFill : _style.Fill);
+    _painter->drawRoundedRect(_buttonRect, 6, 6);
+
+    QFont _font = _option.font;
+    _font.setBold(true);
+    _painter->setFont(_font);
+    _painter->setPen(Qt::white);
+    _painter->drawText(_buttonRect, Qt::AlignCenter, _index.data(Qt::DisplayRole).toString());
+    _painter->restore();
+}
 
-    UpdateAppearance();
+QSize AppControlDelegate::sizeHint(const QStyleOptionViewItem& _option, const QModelIndex& _index) const
+{
+    Q_UNUSED(_option);
+    Q_UNUSED(_index);
+    return QSize(90, 32);
 }
 
-void AppControlButton::UpdateStatus(bool _isRunning)
+bool AppControlDelegate::editorEvent(QEvent* _event, QAbstractItemModel* _model,
+                                     const QStyleOptionViewItem& _option, const QModelIndex& _index)
 {
-    if (IsRunning != _isRunning) {
-        IsRunning = _isRunning;
-        UpdateAppearance();
+    Q_UNUSED(_model);
+
+    if (_event->type() != QEvent::MouseButtonRelease) {
+        return false;
+    }
+
+    QMouseEvent* _mouseEvent = static_cast<QMouseEvent*>(_event);
+    if (_mouseEvent->button() != Qt::LeftButton || !ButtonRect(_option.rect).contains(_mouseEvent->position().toPoint())) {
+        return false;
+    }
+
+    const QString _appName = _index.data(A_applicationmodel::AppNameRole).toString();
+    if (_index.data(A_applicationmodel::RunningRole).toBool()) {
+        emit StopRequested(_appName);
+    } else {
+        emit StartRequested(_appName);
     }
+    return true;
 }
 
-void AppControlButton::OnButtonClicked()
+// StatusDelegate Implementation
+StatusDelegate::StatusDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
 {
-    if (IsRunning) {
-        emit StopRequested(AppName);
-    } else {
-        emit StartRequested(AppName);
-    }
-}
-
-void AppControlButton::UpdateAppearance()
-{
-    if (IsRunning) {
-        setStyleSheet(
-            "QPushButton {"
-            "   background-color: #4CAF50;"  // Green
-            "   color: white;"
-            "   border: 2px solid #45a049;"
-            "   border-radius: 8px;"
-            "   font-weight: bold;"
-            "   padding: 8px;"
-            "}"
-            "QPushButton:hover {"
-            "   background-color: #45a049;"
-            "}"
-            "QPushButton:pressed {"
-            "   background-color: #3d8b40;"
-            "}"
-            );
-        setText(AppName + " - STOP");
-    } else {
-        setStyleSheet(
-            "QPushButton {"
-            "   background-color: #f44336;"  // Red
-            "   color: white;"
-            "   border: 2px solid #da190b;"
-            "   border-radius: 8px;"
-            "   font-weight: bold;"
-            "   padding: 8px;"
-            "}"
-            "QPushButton:hover {"
-            "   background-color: #da190b;"
-            "}"
-            "QPushButton:pressed {"
-            "   background-color: #c1170a;"
-            "}"
-            );
-        setText(AppName + " - START");
+}
+
+void StatusDelegate::initStyleOption(QStyleOptionViewItem* _option, const QModelIndex& _index) const
+{
+    QStyledItemDelegate::initStyleOption(_option, _index);
+    if (!_index.data(A_applicationmodel::PolicyOkRole).toBool()) {
+        // Running without the configured CPU, memory, priority or OOM settings
+        _option->palette.setColor(QPalette::Text, Qt::red);
+        _option->palette.setColor(QPalette::HighlightedText, Qt::red);
+    }
+}
+
+// SparklineDelegate Implementation
+SparklineDelegate::SparklineDelegate(A_resourcesampler* _sampler, QObject* parent)
+    : QStyledItemDelegate(parent), Sampler(_sampler), PlottedMetric(A_resourcesampler::CpuPercent),
+      Cache(CacheCostLimit)
+{
+}
+
+void SparklineDelegate::SetMetric(A_resourcesampler::Metric _metric)
+{
+    if (PlottedMetric != _metric) {
+        PlottedMetric = _metric;
+        Cache.clear();
+    }
+}
+
+void SparklineDelegate::paint(QPainter* _painter, const QStyleOptionViewItem& _option, const QModelIndex& _index) const
+{
+    const QString _appName = _index.data(A_applicationmodel::AppNameRole).toString();
+    const quint64 _version = Sampler->Version(_appName);
+    if (_version == 0) {
+        return; // Not sampled yet
+    }
+
+    const QRect _rect = _option.rect.adjusted(4, 4, -4, -4);
+    const qreal _ratio = _painter->device()->devicePixelRatioF();
+    const QSize _pixelSize = _rect.size() * _ratio;
+
+    CachedSparkline* _cached = Cache.object(_appName);
+    if (!_cached || _cached->Version != _version || _cached->Pixmap.size() != _pixelSize) {
+        QTPM_METRIC_SCOPE(SparklineRender);
+        _cached = new CachedSparkline { Render(Sampler->Samples(_appName, PlottedMetric), _rect.size(), _ratio), _version };
+        const int _cost = _pixelSize.width() * _pixelSize.height() * 4;
+        if (!Cache.insert(_appName, _cached, _cost)) {
+            return; // Larger than the whole cache - nothing sensible to draw
+        }
+    }
+
+    _painter->drawPixmap(_rect.topLeft(), _cached->Pixmap);
+}
+
+QPixmap SparklineDelegate::Render(const QVector<float>& _samples, const QSize& _size, qreal _devicePixelRatio) const
+{
+    QPixmap _pixmap(_size * _devicePixelRatio);
+    _pixmap.setDevicePixelRatio(_devicePixelRatio);
+    _pixmap.fill(Qt::transparent);
+    if (_samples.size() < 2 || _size.isEmpty()) {
+        return _pixmap;
+    }
+
+    // Scale to the window's own peak so a climbing series stands out
+    float _peak = 0.0f;
+    for (float _value : _samples) {
+        _peak = qMax(_peak, _value);
+    }
+    if (_peak <= 0.0f) {
+        _peak = 1.0f;
+    }
+
+    // Newest sample at the right edge, one slot per history entry
+    const qreal _step = qreal(_size.width() - 1) / qreal(A_resourcesampler::HistorySize - 1);
+    const qreal _left = qreal(_size.width() - 1) - _step * (_samples.size() - 1);
+    const qreal _height = qreal(_size.height() - 1);
+
+    QPolygonF _line;
+    _line.reserve(_samples.size() + 2);
+    for (int _i = 0; _i < _samples.size(); ++_i) {
+        _line.append(QPointF(_left + _step * _i, _height - _height * qreal(_samples.at(_i) / _peak)));
+    }
+
+    QPolygonF _area = _line;
+    _area.append(QPointF(_line.last().x(), _height));
+    _area.append(QPointF(_line.first().x(), _height));
+
+    QPainter _painter(&_pixmap);
+    _painter.setRenderHint(QPainter::Antialiasing);
+    _painter.setPen(Qt::NoPen);
+    _painter.setBrush(QColor(96, 165, 250, 60));
+    _painter.drawPolygon(_area);
+    _painter.setPen(QPen(QColor("#60A5FA"), 1.5));
+    _painter.setBrush(Qt::NoBrush);
+    _painter.drawPolyline(_line);
+    return _pixmap;
+}
+
+// LogViewerDialog Implementation
+LogViewerDialog::LogViewerDialog(const QString& _appName, const QString& _filePath, QWidget* parent)
+    : QDialog(parent), FilePath(_filePath)
+{
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle("Log - " + _appName);
+    resize(900, 600);
+
+    LogModel = new A_logviewmodel(this);
+    connect(LogModel, &A_logviewmodel::SearchFinished, this, &LogViewerDialog::OnSearchFinished);
+    connect(LogModel, &A_logviewmodel::IndexProgress, this, &LogViewerDialog::OnIndexProgress);
+    connect(LogModel, &QAbstractItemModel::rowsInserted, this, &LogViewerDialog::OnRowsInserted);
+
+    QVBoxLayout* _layout = new QVBoxLayout(this);
+
+    QHBoxLayout* _searchLayout = new QHBoxLayout();
+    SearchLineEdit = new QLineEdit();
+    SearchLineEdit->setPlaceholderText("Search");
+    SearchLineEdit->setClearButtonEnabled(true);
+    connect(SearchLineEdit, &QLineEdit::textChanged, this, &LogViewerDialog::OnSearchTextChanged);
+    connect(SearchLineEdit, &QLineEdit::returnPressed, this, &LogViewerDialog::OnFindNext);
+    QPushButton* _previousButton = new QPushButton("Previous");
+    connect(_previousButton, &QPushButton::clicked, this, &LogViewerDialog::OnFindPrevious);
+    QPushButton* _nextButton = new QPushButton("Next");
+    connect(_nextButton, &QPushButton::clicked, this, &LogViewerDialog::OnFindNext);
+    FollowCheckBox = new QCheckBox("Follow");
+    FollowCheckBox->setChecked(true);
+    connect(FollowCheckBox, &QCheckBox::toggled, this, &LogViewerDialog::OnFollowToggled);
+    _searchLayout->addWidget(SearchLineEdit, 1);
+    _searchLayout->addWidget(_previousButton);
+    _searchLayout->addWidget(_nextButton);
+    _searchLayout->addWidget(FollowCheckBox);
+    _layout->addLayout(_searchLayout);
+
+    // Uniform item sizes: the view never measures rows it does not show
+    LinesView = new QListView();
+    LinesView->setModel(LogModel);
+    LinesView->setUniformItemSizes(true);
+    LinesView->setSelectionMode(QAbstractItemView::SingleSelection);
+    LinesView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    LinesView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    _layout->addWidget(LinesView, 1);
+
+    StatusLabel = new QLabel();
+    _layout->addWidget(StatusLabel);
+}
+
+bool LogViewerDialog::Open()
+{
+    QElapsedTimer _timer;
+    _timer.start();
+    if (!LogModel->Open(FilePath)) {
+        return false;
+    }
+    LogModel->SetFollow(FollowCheckBox->isChecked());
+    qDebug() << "Log viewer opened" << FilePath << "-" << LogModel->MappedBytes() << "bytes, first screen in"
+             << _timer.elapsed() << "ms";
+    return true;
+}
+
+int LogViewerDialog::CurrentRow() const
+{
+    const QModelIndex _current = LinesView->currentIndex();
+    if (_current.isValid()) {
+        return _current.row();
+    }
+    const QModelIndex _top = LinesView->indexAt(QPoint(0, 0));
+    return _top.isValid() ? _top.row() : 0;
+}
+
+void LogViewerDialog::OnSearchTextChanged(const QString& _text)
+{
+    if (_text.isEmpty()) {
+        LogModel->CancelSearch();
+        StatusLabel->clear();
+        return;
+    }
+    StatusLabel->setText("Searching...");
+    LogModel->StartSearch(_text.toUtf8(), CurrentRow(), true);
+}
+
+void LogViewerDialog::OnFindNext()
+{
+    if (!SearchLineEdit->text().isEmpty()) {
+        StatusLabel->setText("Searching...");
+        LogModel->StartSearch(SearchLineEdit->text().toUtf8(), CurrentRow() + 1, true);
+    }
+}
+
+void LogViewerDialog::OnFindPrevious()
+{
+    if (!SearchLineEdit->text().isEmpty()) {
+        StatusLabel->setText("Searching...");
+        LogModel->StartSearch(SearchLineEdit->text().toUtf8(), CurrentRow(), false);
+    }
+}
+
+void LogViewerDialog::OnSearchFinished(int _row)
+{
+    if (_row < 0) {
+        StatusLabel->setText("Not found");
+        return;
+    }
+
+    // Jumping to a match stops following so the match stays in view
+    FollowCheckBox->setChecked(false);
+    const QModelIndex _match = LogModel->index(_row);
+    LinesView->setCurrentIndex(_match);
+    LinesView->scrollTo(_match, QAbstractItemView::PositionAtCenter);
+    StatusLabel->setText(QString("Line %1").arg(_row + 1));
+}
+
+void LogViewerDialog::OnIndexProgress(qint64 _indexedBytes, qint64 _totalBytes)
+{
+    if (_indexedBytes < _totalBytes) {
+        StatusLabel->setText(QString("Indexing... %1 of %2 MB")
+                                 .arg(double(_indexedBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+                                 .arg(double(_totalBytes) / (1024.0 * 1024.0), 0, 'f', 1));
+    } else if (StatusLabel->text().startsWith("Indexing")) {
+        StatusLabel->setText(QString("%1 lines").arg(LogModel->rowCount()));
+    }
+}
+
+void LogViewerDialog::OnRowsInserted()
+{
+    if (FollowCheckBox->isChecked()) {
+        LinesView->scrollToBottom();
+    }
+}
+
+void LogViewerDialog::OnFollowToggled(bool _follow)
+{
+    LogModel->SetFollow(_follow);
+    if (_follow) {
+        LinesView->scrollToBottom();
     }
 }
 
 // MainWindow Implementation
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
+MainWindow::MainWindow(const QString& _configPath, QWidget *parent) : QMainWindow(parent)
 {
     // Initialize core components
     Settings = new A_settingsclass();
@@ -85,34 +325,49 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     // Set up the process manager
     ProcessManager->SetSettingsReference(Settings);
 
+    StatusBarState = -1;
+    FleetGroup = nullptr;
+    FleetView = nullptr;
+    FleetHub = nullptr;
+    FleetModel = nullptr;
+
     // Initialize UI
     InitializeUI();
     ApplyStyles();
 
-    // Set up display update timer
-    DisplayUpdateTimer = new QTimer(this);
-    DisplayUpdateTimer->setInterval(1000); // 1 second updates
-    connect(DisplayUpdateTimer, &QTimer::timeout, this, &MainWindow::UpdateDisplay);
-    DisplayUpdateTimer->start();
+    // Status changes arrive as signals; only the minute-resolution uptimes need a timer
+    UptimeUpdateTimer = new QTimer(this);
+    UptimeUpdateTimer->setInterval(60000); // 1 minute updates
+    connect(UptimeUpdateTimer, &QTimer::timeout, this, &MainWindow::UpdateUptimeColumn);
+    UptimeUpdateTimer->start();
 
     // Connect process manager signals
     connect(ProcessManager, &A_process::ApplicationStatusChanged,
             this, &MainWindow::OnApplicationStatusChanged);
     connect(ProcessManager, &A_process::ApplicationRestarted,
             this, &MainWindow::OnApplicationRestarted);
+    connect(ProcessManager, &A_process::ApplicationScheduled,
+            this, &MainWindow::OnApplicationScheduled);
+    connect(ProcessManager, &A_process::ApplicationParked,
+            this, &MainWindow::OnApplicationParked);
 
-    // Always load directly from the main project config.xml file
-    QString _configPath = "/home/zerozed/projects/QtProcessMonitor/config.xml";
-    
     qDebug() << "Loading configuration from:" << _configPath;
     LoadConfiguration(_configPath);
 
-    // Start process monitoring
+    // Hub mode - the monitor list is read once; changing it needs a restart
+    if (!Settings->GetFleetMonitors().isEmpty()) {
+        SetupFleetSection();
+    }
+
+    // Start process monitoring; local scripts read the state through qpmstat
+    ProcessManager->OpenStatusTable();
     ProcessManager->StartMonitoring();
+    ResourceSampler->Start(5000);
 
     setWindowTitle("Process Monitor - Qt Application Manager");
     resize(600, 800);
 
+    OnRefreshDiagnostics();
     ShowStatusMessage("Application initialized successfully");
 }
 
@@ -133,6 +388,7 @@ void MainWindow::InitializeUI()
 
     SetupSettingsSection();
     SetupApplicationsSection();
+    SetupDiagnosticsSection();
     SetupControlButtons();
 }
 
@@ -170,22 +426,131 @@ void MainWindow::SetupApplicationsSection()
     AppsGroup = new QGroupBox("Application Control");
     QVBoxLayout* _appsGroupLayout = new QVBoxLayout(AppsGroup);
 
-    // Create scroll area for applications
-    ScrollArea = new QScrollArea();
-    ScrollArea->setWidgetResizable(true);
-    ScrollArea->setMinimumHeight(400);
-
-    ScrollWidget = new QWidget();
-    AppsLayout = new QVBoxLayout(ScrollWidget);
-    AppsLayout->setSpacing(10);
-    AppsLayout->setAlignment(Qt::AlignTop);
+    AppModel = new A_applicationmodel(ProcessManager, this);
+    AppFilter = new A_applicationfilter(AppModel, ProcessManager, this);
+    connect(AppFilter, &A_applicationfilter::FilterChanged, this, &MainWindow::OnFilterChanged);
+
+    // Filter bar - substring of name or path, and supervision state
+    QHBoxLayout* _filterLayout = new QHBoxLayout();
+    FilterLineEdit = new QLineEdit();
+    FilterLineEdit->setPlaceholderText("Filter by name or executable path");
+    FilterLineEdit->setClearButtonEnabled(true);
+    connect(FilterLineEdit, &QLineEdit::textChanged, this, &MainWindow::OnFilterTextChanged);
+    StateFilterCombo = new QComboBox();
+    StateFilterCombo->addItems(QStringList() << "All" << "Running" << "Stopped" << "Backoff" << "Parked");
+    connect(StateFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::OnStateFilterChanged);
+    FilterCountLabel = new QLabel();
+    TrendMetricCombo = new QComboBox();
+    TrendMetricCombo->addItems(QStringList() << "CPU" << "Memory");
+    TrendMetricCombo->setToolTip("Metric shown in the Trend column");
+    connect(TrendMetricCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::OnTrendMetricChanged);
+    _filterLayout->addWidget(FilterLineEdit, 1);
+    _filterLayout->addWidget(StateFilterCombo);
+    _filterLayout->addWidget(TrendMetricCombo);
+    _filterLayout->addWidget(FilterCountLabel);
+    _appsGroupLayout->addLayout(_filterLayout);
+
+    ResourceSampler = new A_resourcesampler(ProcessManager, "/proc", this);
+    connect(ResourceSampler, &A_resourcesampler::SamplesUpdated, this, &MainWindow::OnSamplesUpdated);
+    TrendDelegate = new SparklineDelegate(ResourceSampler, this);
+
+    ControlDelegate = new AppControlDelegate(this);
+    connect(ControlDelegate, &AppControlDelegate::StartRequested,
+            this, &MainWindow::OnStartApplication);
+    connect(ControlDelegate, &AppControlDelegate::StopRequested,
+            this, &MainWindow::OnStopApplication);
+
+    PolicyDelegate = new StatusDelegate(this);
+
+    // Fixed row heights and column widths let the view skip measuring every row
+    AppsView = new QTableView();
+    AppsView->setModel(AppFilter);
+    AppsView->setItemDelegateForColumn(A_applicationmodel::ControlColumn, ControlDelegate);
+    AppsView->setItemDelegateForColumn(A_applicationmodel::TrendColumn, TrendDelegate);
+    AppsView->setItemDelegateForColumn(A_applicationmodel::StatusColumn, PolicyDelegate);
+    AppsView->setMinimumHeight(400);
+    AppsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    AppsView->setSelectionMode(QAbstractItemView::SingleSelection);
+    AppsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    AppsView->setShowGrid(false);
+    AppsView->setMouseTracking(true);
+    AppsView->verticalHeader()->hide();
+    AppsView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    AppsView->verticalHeader()->setDefaultSectionSize(36);
+    AppsView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    AppsView->horizontalHeader()->setSectionResizeMode(A_applicationmodel::NameColumn, QHeaderView::Stretch);
+    AppsView->setColumnWidth(A_applicationmodel::StatusColumn, 80);
+    AppsView->setColumnWidth(A_applicationmodel::PidColumn, 70);
+    AppsView->setColumnWidth(A_applicationmodel::UptimeColumn, 90);
+    AppsView->setColumnWidth(A_applicationmodel::RestartsColumn, 70);
+    AppsView->setColumnWidth(A_applicationmodel::ScheduleColumn, 130);
+    AppsView->setColumnWidth(A_applicationmodel::TrendColumn, 130);
+    AppsView->setColumnWidth(A_applicationmodel::ControlColumn, 100);
+    AppsView->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(AppsView, &QTableView::customContextMenuRequested, this, &MainWindow::OnAppsContextMenu);
+    connect(AppsView, &QTableView::doubleClicked, this, [this](const QModelIndex& _index) {
+        if (_index.column() != A_applicationmodel::ControlColumn) {
+            OnShowApplicationLog(_index);
+        }
+    });
+    _appsGroupLayout->addWidget(AppsView);
 
-    ScrollArea->setWidget(ScrollWidget);
-    _appsGroupLayout->addWidget(ScrollArea);
+    NoAppsLabel = new QLabel("No applications configured");
+    NoAppsLabel->setAlignment(Qt::AlignCenter);
+    NoAppsLabel->setStyleSheet("color: gray; font-style: italic; padding: 20px;");
+    NoAppsLabel->hide();
+    _appsGroupLayout->addWidget(NoAppsLabel);
 
     MainLayout->addWidget(AppsGroup);
 }
 
+void MainWindow::SetupFleetSection()
+{
+    FleetHub = new A_fleethub(Settings->GetFleetMonitors(), this);
+    FleetModel = new A_fleetmodel(FleetHub, this);
+
+    FleetGroup = new QGroupBox("Fleet");
+    QVBoxLayout* _fleetLayout = new QVBoxLayout(FleetGroup);
+
+    FleetView = new QTreeView();
+    FleetView->setModel(FleetModel);
+    FleetView->setUniformRowHeights(true);
+    FleetView->setAlternatingRowColors(true);
+    FleetView->setSelectionMode(QAbstractItemView::NoSelection);
+    FleetView->header()->setSectionResizeMode(A_fleetmodel::NameColumn, QHeaderView::Stretch);
+    FleetView->header()->setStretchLastSection(false);
+    _fleetLayout->addWidget(FleetView);
+
+    MainLayout->insertWidget(MainLayout->indexOf(AppsGroup) + 1, FleetGroup);
+
+    FleetHub->Start();
+}
+
+void MainWindow::SetupDiagnosticsSection()
+{
+    DiagnosticsGroup = new QGroupBox("Diagnostics");
+    QVBoxLayout* _diagnosticsLayout = new QVBoxLayout(DiagnosticsGroup);
+
+    DiagnosticsLabel = new QLabel();
+    DiagnosticsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    DiagnosticsLabel->setStyleSheet("font-family: monospace; font-weight: normal;");
+    _diagnosticsLayout->addWidget(DiagnosticsLabel);
+
+    QHBoxLayout* _buttonLayout = new QHBoxLayout();
+    QPushButton* _refreshButton = new QPushButton("Refresh");
+    connect(_refreshButton, &QPushButton::clicked, this, &MainWindow::OnRefreshDiagnostics);
+    QPushButton* _dumpButton = new QPushButton("Dump");
+    connect(_dumpButton, &QPushButton::clicked, this, &MainWindow::OnDumpDiagnostics);
+    _buttonLayout->addWidget(_refreshButton);
+    _buttonLayout->addWidget(_dumpButton);
+    _buttonLayout->addStretch();
+    _diagnosticsLayout->addLayout(_buttonLayout);
+
+    MainLayout->addWidget(DiagnosticsGroup);
+}
+
 void MainWindow::SetupControlButtons()
 {
     QHBoxLayout* _buttonLayout = new QHBoxLayout();
@@ -207,13 +572,19 @@ bool MainWindow::LoadConfiguration(const QString& _filePath)
         ShowStatusMessage("Failed to load configuration file: " + _filePath, true);
         return false;
     }
+    ConfigFilePath = _filePath;
 
     UpdateSettingsDisplay();
-    UpdateApplicationButtons();
+    UpdateApplicationList();
 
     // Update process manager
     ProcessManager->SetSettingsReference(Settings);
 
+    // Keep the supervision journal, captured output and runtime checkpoint next to the configuration file
+    ProcessManager->OpenJournal(QFileInfo(_filePath).absolutePath() + "/journal");
+    ProcessManager->OpenLogCapture(QFileInfo(_filePath).absolutePath() + "/logs");
+    ProcessManager->OpenCheckpoint(QFileInfo(_filePath).absolutePath() + "/checkpoint.qpc");
+
     ShowStatusMessage("Configuration loaded successfully");
     return true;
 }
@@ -225,40 +596,17 @@ void MainWindow::UpdateSettingsDisplay()
     IpLineEdit->setText(Settings->GetIp());
 }
 
-void MainWindow::UpdateApplicationButtons()
+void MainWindow::UpdateApplicationList()
 {
-    // Clear existing buttons
-    for (auto _it = AppButtons.begin(); _it != AppButtons.end(); ++_it) {
-        delete _it.value();
-    }
-    AppButtons.clear();
-
-    // Create new buttons for each application
-    QList<AppInfo> _apps = Settings->GetApplications();
-
-    for (const AppInfo& _app : _apps) {
-        AppControlButton* _button = new AppControlButton(_app.Name);
+    QTPM_TRACE_SCOPE("gui", "UpdateApplicationList");
+    QElapsedTimer _buildTimer;
+    _buildTimer.start();
 
-        // Connect button signals
-        connect(_button, &AppControlButton::StartRequested,
-                this, &MainWindow::OnStartApplication);
-        connect(_button, &AppControlButton::StopRequested,
-                this, &MainWindow::OnStopApplication);
-
-        // Update initial status
-        bool _isRunning = ProcessManager->IsApplicationRunning(_app.Name);
-        _button->UpdateStatus(_isRunning);
-
-        AppButtons[_app.Name] = _button;
-        AppsLayout->addWidget(_button);
-    }
+    AppModel->Reload();
+    NoAppsLabel->setVisible(AppModel->rowCount() == 0);
 
-    if (_apps.isEmpty()) {
-        QLabel* _noAppsLabel = new QLabel("No applications configured");
-        _noAppsLabel->setAlignment(Qt::AlignCenter);
-        _noAppsLabel->setStyleSheet("color: gray; font-style: italic; padding: 20px;");
-        AppsLayout->addWidget(_noAppsLabel);
-    }
+    qDebug() << "Application list built with" << AppModel->rowCount() << "rows in"
+             << _buildTimer.elapsed() << "ms";
 }
 
 void MainWindow::ApplyStyles()
@@ -293,6 +641,13 @@ void MainWindow::ApplyStyles()
         "QLineEdit:focus {"
         "   border-color: #60A5FA;"
         "}"
+        "QComboBox {"
+        "   border: 2px solid #475569;"
+        "   border-radius: 5px;"
+        "   padding: 6px;"
+        "   background-color: #334155;"
+        "   color: #F1F5F9;"
+        "}"
         "QLabel {"
         "   font-size: 12px;"
         "   font-weight: bold;"
@@ -312,13 +667,19 @@ void MainWindow::ApplyStyles()
         "QPushButton:pressed {"
         "   background-color: #1D4ED8;"
         "}"
-        "QScrollArea {"
+        "QTableView {"
         "   border: 1px solid #475569;"
         "   border-radius: 5px;"
         "   background-color: #334155;"
+        "   color: #F1F5F9;"
+        "   selection-background-color: #475569;"
         "}"
-        "QWidget#ScrollWidget {"
-        "   background-color: #334155;"
+        "QHeaderView::section {"
+        "   background-color: #293548;"
+        "   color: #E2E8F0;"
+        "   border: none;"
+        "   padding: 6px;"
+        "   font-weight: bold;"
         "}"
         "QStatusBar {"
         "   background-color: #293548;"
@@ -415,9 +776,7 @@ void MainWindow::OnStopApplication(const QString& _appName)
 
 void MainWindow::OnApplicationStatusChanged(const QString& _appName, bool _isRunning)
 {
-    if (AppButtons.contains(_appName)) {
-        AppButtons[_appName]->UpdateStatus(_isRunning);
-    }
+    AppModel->MarkDirty(_appName);
 
     QString _status = _isRunning ? "running" : "stopped";
     qDebug() << "Application status changed:" << _appName << "-" << _status;
@@ -425,27 +784,154 @@ void MainWindow::OnApplicationStatusChanged(const QString& _appName, bool _isRun
 
 void MainWindow::OnApplicationRestarted(const QString& _appName)
 {
+    AppModel->MarkDirty(_appName);
     ShowStatusMessage("Application automatically restarted: " + _appName);
 }
 
-void MainWindow::UpdateDisplay()
+void MainWindow::OnApplicationScheduled(const QString& _appName, bool _start)
+{
+    AppModel->MarkDirty(_appName);
+    ShowStatusMessage(QString("Scheduled %1: %2").arg(_start ? "start" : "stop", _appName));
+}
+
+void MainWindow::OnApplicationParked(const QString& _appName, qint64 _reclaimedKb)
 {
-    // Update button statuses based on current process states
-    for (auto _it = AppButtons.begin(); _it != AppButtons.end(); ++_it) {
-        QString _appName = _it.key();
-        AppControlButton* _button = _it.value();
-        bool _isRunning = ProcessManager->IsApplicationRunning(_appName);
-        _button->UpdateStatus(_isRunning);
+    AppModel->MarkDirty(_appName);
+    ShowStatusMessage(QString("Parked idle application %1 - %2 MB reclaimed").arg(_appName).arg(_reclaimedKb / 1024));
+}
+
+void MainWindow::OnFilterTextChanged(const QString& _text)
+{
+    AppFilter->SetFilterText(_text.trimmed());
+    qDebug() << "Filter" << _text << "applied in" << AppFilter->LastFilterNs() / 1000 << "us";
+}
+
+void MainWindow::OnStateFilterChanged(int _index)
+{
+    static const quint8 _masks[] = { A_applicationmodel::AnyState, A_applicationmodel::RunningState,
+                                     A_applicationmodel::StoppedState, A_applicationmodel::BackoffState,
+                                     A_applicationmodel::ParkedState };
+    AppFilter->SetStateMask(_masks[qBound(0, _index, 4)]);
+}
+
+void MainWindow::OnFilterChanged(int _visibleCount, int _totalCount)
+{
+    FilterCountLabel->setText(QString("%1 of %2").arg(_visibleCount).arg(_totalCount));
+}
+
+void MainWindow::OnTrendMetricChanged(int _index)
+{
+    TrendDelegate->SetMetric(_index == 1 ? A_resourcesampler::ResidentMb : A_resourcesampler::CpuPercent);
+    AppsView->viewport()->update();
+}
+
+void MainWindow::OnSamplesUpdated(const QStringList& _appNames)
+{
+    for (const QString& _appName : _appNames) {
+        AppModel->MarkDirty(_appName);
+    }
+}
+
+void MainWindow::OnShowApplicationLog(const QModelIndex& _index)
+{
+    const QString _appName = _index.data(A_applicationmodel::AppNameRole).toString();
+    const QString _logPath = ProcessManager->GetLogFilePath(_appName);
+    if (_logPath.isEmpty() || !QFileInfo::exists(_logPath)) {
+        ShowStatusMessage("No captured output for: " + _appName, true);
+        return;
+    }
+
+    LogViewerDialog* _viewer = new LogViewerDialog(_appName, _logPath, this);
+    if (!_viewer->Open()) {
+        delete _viewer;
+        ShowStatusMessage("Cannot open log: " + _logPath, true);
+        return;
+    }
+    _viewer->show();
+}
+
+void MainWindow::OnAppsContextMenu(const QPoint& _position)
+{
+    const QModelIndex _index = AppsView->indexAt(_position);
+    if (!_index.isValid()) {
+        return;
+    }
+
+    QMenu _menu(this);
+    QAction* _viewLog = _menu.addAction("View Log");
+    if (_menu.exec(AppsView->viewport()->mapToGlobal(_position)) == _viewLog) {
+        OnShowApplicationLog(_index);
+    }
+}
+
+void MainWindow::UpdateUptimeColumn()
+{
+    QTPM_TRACE_SCOPE("gui", "UpdateUptimeColumn");
+    // The view repaints only the visible rows
+    AppModel->UptimeColumnChanged();
+    if (FleetModel) {
+        FleetModel->UptimeColumnChanged();
+    }
+}
+
+QString MainWindow::BuildDiagnosticsText() const
+{
+    QString _text = A_metrics::Dump();
+
+    QMap<QString, ProbeStatistics> _probes = ProcessManager->GetProbeStatistics();
+    if (!_probes.isEmpty()) {
+        _text += "\n\nHealth probes:";
+        for (auto _it = _probes.constBegin(); _it != _probes.constEnd(); ++_it) {
+            _text += "\n" + _it.key() + ": " + _it.value().ToString();
+        }
+    }
+
+    QMap<QString, ActivationStatistics> _activations = ProcessManager->GetActivationStatistics();
+    if (!_activations.isEmpty()) {
+        _text += "\n\nSocket activation:";
+        for (auto _it = _activations.constBegin(); _it != _activations.constEnd(); ++_it) {
+            _text += "\n" + _it.key() + ": " + _it.value().ToString();
+        }
+    }
+    return _text;
+}
+
+void MainWindow::OnRefreshDiagnostics()
+{
+    DiagnosticsLabel->setText(BuildDiagnosticsText());
+}
+
+void MainWindow::OnDumpDiagnostics()
+{
+    QString _text = BuildDiagnosticsText();
+    DiagnosticsLabel->setText(_text);
+    qDebug().noquote() << "Diagnostics dump:\n" + _text;
+
+    QString _dumpPath = QFileInfo(ConfigFilePath).absolutePath() + "/diagnostics-"
+                        + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".txt";
+    QFile _dumpFile(_dumpPath);
+    if (_dumpFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        _dumpFile.write(_text.toUtf8());
+        _dumpFile.write("\n");
+        ShowStatusMessage("Diagnostics written to: " + _dumpPath);
+    } else {
+        ShowStatusMessage("Failed to write diagnostics to: " + _dumpPath, true);
     }
 }
 
 void MainWindow::ShowStatusMessage(const QString& _message, bool _isError)
 {
+    // Restyling re-parses the stylesheet; only do it when the kind of message changes
+    const int _state = _isError ? 1 : 0;
+    if (StatusBarState != _state) {
+        StatusBarState = _state;
+        statusBar()->setStyleSheet(_isError ? "color: red; font-weight: bold;"
+                                            : "color: green; font-weight: bold;");
+    }
+
     if (_isError) {
-        statusBar()->setStyleSheet("color: red; font-weight: bold;");
         qDebug() << "Error:" << _message;
     } else {
-        statusBar()->setStyleSheet("color: green; font-weight: bold;");
         qDebug() << "Info:" << _message;
     }
 
@@ -10,41 +10,58 @@
 #include <QPushButton>
 #include <QGroupBox>
 #include <QFrame>
-#include <QScrollArea>
 #include <QWidget>
 #include <QMap>
 #include <QMessageBox>
 #include <QTimer>
 #include <QDebug>
 #include <QStatusBar>
+#include <QTableView>
+#include <QStyledItemDelegate>
+#include <QComboBox>
+#include <QCache>
+#include <QPixmap>
+#include <QDialog>
+#include <QListView>
+#include <QCheckBox>
+#include <QTreeView>
 
 #include "a_settingsclass.h"
 #include "a_process.h"
+#include "a_applicationmodel.h"
+#include "a_applicationfilter.h"
+#include "a_resourcesampler.h"
+#include "a_logviewmodel.h"
+#include "a_fleethub.h"
+#include "a_fleetmodel.h"
 
 /**
- * @brief Custom button class for application control
+ * @brief Item delegate painting the start/stop control of an application row
  *
- * Extends QPushButton to provide start/stop functionality with
- * visual indicators and status tracking for managed applications.
+ * Replaces a per-application push button: the control is only painted for
+ * visible rows and clicks are turned into start/stop requests, so the cost of
+ * the application list no longer grows with the number of applications.
  */
-class AppControlButton : public QPushButton
+class AppControlDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
 
 public:
-    explicit AppControlButton(const QString& _appName, QWidget* parent = nullptr);
+    explicit AppControlDelegate(QObject* parent = nullptr);
 
     /**
-     * @brief Updates button state based on application status
-     * @param _isRunning Current running state - true for running, false for stopped
+     * @brief Paints the control as a rounded green STOP or red START button
+     * @param _painter Painter of the view's viewport
+     * @param _option Cell geometry and state - hover darkens the button
+     * @param _index Cell index - RunningRole selects the state
      */
-    void UpdateStatus(bool _isRunning);
+    void paint(QPainter* _painter, const QStyleOptionViewItem& _option, const QModelIndex& _index) const override;
 
     /**
-     * @brief Gets the application name associated with this button
-     * @return QString Application name - identifier for the managed app
+     * @brief Gets the preferred cell size
+     * @return QSize Minimum size of the control
      */
-    QString GetAppName() const { return AppName; }
+    QSize sizeHint(const QStyleOptionViewItem& _option, const QModelIndex& _index) const override;
 
 signals:
     /**
@@ -59,29 +76,200 @@ signals:
      */
     void StopRequested(const QString& appName);
 
-private slots:
+protected:
     /**
-     * @brief Handles button click events
+     * @brief Handles clicks on the control
      * Toggles between start and stop commands based on current state
+     * @return bool True if the event was consumed
+     */
+    bool editorEvent(QEvent* _event, QAbstractItemModel* _model,
+                     const QStyleOptionViewItem& _option, const QModelIndex& _index) override;
+
+private:
+    /**
+     * @brief Precomputed paint state of the control
+     */
+    struct ControlStyle {
+        QBrush Fill;            // Button fill - normal
+        QBrush HoverFill;       // Button fill - under the mouse
+        QPen Border;            // Button outline
+    };
+
+    ControlStyle Styles[2];     // Style table - index 0: stopped (red START), 1: running (green STOP)
+
+    /**
+     * @brief Gets the button area inside a cell
+     * @param _cellRect Cell rectangle
+     * @return QRect Button rectangle - inset by a small margin
+     */
+    static QRect ButtonRect(const QRect& _cellRect);
+};
+
+/**
+ * @brief Item delegate of the status column
+ *
+ * Shows the status in red while the application runs without its configured
+ * CPU, memory, priority or OOM settings, as reported by PolicyOkRole.
+ */
+class StatusDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit StatusDelegate(QObject* parent = nullptr);
+
+protected:
+    /**
+     * @brief Fills the style option of a status cell
+     * @param _option Style option - text colour set to red for a failed policy
+     * @param _index Cell index - PolicyOkRole selects the colour
+     */
+    void initStyleOption(QStyleOptionViewItem* _option, const QModelIndex& _index) const override;
+};
+
+/**
+ * @brief Item delegate drawing a per-row sparkline of recent resource use
+ *
+ * Each row's sparkline is rendered once into a cached QPixmap and blitted on
+ * later paints. A pixmap is only re-rendered when the sampler's version for
+ * that application has moved on, the metric was switched or the cell was
+ * resized, and only when the row is actually painted, i.e. visible.
+ */
+class SparklineDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param _sampler Resource sampler - source of the histories, must outlive this instance
+     */
+    explicit SparklineDelegate(A_resourcesampler* _sampler, QObject* parent = nullptr);
+
+    /**
+     * @brief Selects the plotted metric
+     * Drops all cached pixmaps when the metric changes.
+     * @param _metric Metric to plot
+     */
+    void SetMetric(A_resourcesampler::Metric _metric);
+
+    /**
+     * @brief Paints the cached sparkline, rendering it first if stale
+     * @param _painter Painter of the view's viewport
+     * @param _option Cell geometry
+     * @param _index Cell index - AppNameRole selects the history
+     */
+    void paint(QPainter* _painter, const QStyleOptionViewItem& _option, const QModelIndex& _index) const override;
+
+private:
+    /**
+     * @brief A rendered sparkline and what it was rendered from
+     */
+    struct CachedSparkline {
+        QPixmap Pixmap;             // Rendered sparkline - device pixels
+        quint64 Version;            // Sampler version the pixmap shows
+    };
+
+    static constexpr int CacheCostLimit = 16 * 1024 * 1024;    // Pixmap cache limit - bytes
+
+    A_resourcesampler* Sampler;                                 // History source
+    A_resourcesampler::Metric PlottedMetric;                    // Plotted metric
+    mutable QCache<QString, CachedSparkline> Cache;             // Rendered pixmaps - key: app name, cost: bytes
+
+    /**
+     * @brief Renders one sparkline
+     * @param _samples History, oldest first
+     * @param _size Pixmap size - device independent pixels
+     * @param _devicePixelRatio Target device pixel ratio
+     * @return QPixmap Rendered sparkline with transparent background
+     */
+    QPixmap Render(const QVector<float>& _samples, const QSize& _size, qreal _devicePixelRatio) const;
+};
+
+/**
+ * @brief Window showing the captured output log of one application
+ *
+ * Backed by A_logviewmodel, so the log is memory-mapped and only visible
+ * lines are materialized. Follows the file while "Follow" is checked and
+ * searches incrementally as the search text is typed.
+ */
+class LogViewerDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param _appName Application name - shown in the title
+     * @param _filePath Log file to show
+     */
+    LogViewerDialog(const QString& _appName, const QString& _filePath, QWidget* parent = nullptr);
+
+    /**
+     * @brief Maps the log and shows its first screen
+     * @return bool False if the file cannot be opened
+     */
+    bool Open();
+
+private slots:
+    /**
+     * @brief Searches from the current line as the search text changes
+     * @param _text Search text - case sensitive
      */
-    void OnButtonClicked();
+    void OnSearchTextChanged(const QString& _text);
+
+    /**
+     * @brief Searches for the next match after the current line
+     */
+    void OnFindNext();
+
+    /**
+     * @brief Searches for the previous match before the current line
+     */
+    void OnFindPrevious();
+
+    /**
+     * @brief Selects the line of a search result
+     * @param _row Matching row - -1 if nothing was found
+     */
+    void OnSearchFinished(int _row);
+
+    /**
+     * @brief Shows indexing progress
+     * @param _indexedBytes Bytes indexed
+     * @param _totalBytes File size
+     */
+    void OnIndexProgress(qint64 _indexedBytes, qint64 _totalBytes);
+
+    /**
+     * @brief Keeps the newest line in view while following
+     */
+    void OnRowsInserted();
+
+    /**
+     * @brief Switches follow mode
+     * @param _follow True to follow the file as it grows
+     */
+    void OnFollowToggled(bool _follow);
 
 private:
-    QString AppName;        // Application name - identifier for managed application
-    bool IsRunning;         // Current status - true if app is running, false if stopped
+    QString FilePath;               // Log file
+    A_logviewmodel* LogModel;       // Mapped log - one row per line
+    QListView* LinesView;           // Line list - uniform item sizes, only visible rows are laid out
+    QLineEdit* SearchLineEdit;      // Search text
+    QCheckBox* FollowCheckBox;      // Follow mode - scroll to new lines as they arrive
+    QLabel* StatusLabel;            // Indexing progress and search result
 
     /**
-     * @brief Updates button appearance based on current state
-     * Sets colors, text, and visual indicators
+     * @brief Gets the row searches start from
+     * @return int Current row, or the first visible row if nothing is selected
      */
-    void UpdateAppearance();
+    int CurrentRow() const;
 };
 
 /**
  * @brief Main application window class
  *
  * Provides GUI interface for configuration management and process monitoring.
- * Displays server settings, dynamic application control buttons, and handles
+ * Displays server settings, a virtualized application list, and handles
  * user interactions for the process monitoring system.
  */
 class MainWindow : public QMainWindow
@@ -89,7 +277,10 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    /**
+     * @param _configPath Configuration file to load and monitor
+     */
+    explicit MainWindow(const QString& _configPath, QWidget *parent = nullptr);
     ~MainWindow();
 
 private slots:
@@ -125,10 +316,79 @@ private slots:
     void OnApplicationRestarted(const QString& _appName);
 
     /**
-     * @brief Periodic update of GUI elements
-     * Refreshes status displays and button states
+     * @brief Handles run window transitions
+     * @param _appName Name of the scheduled application
+     * @param _start True if its window opened
+     */
+    void OnApplicationScheduled(const QString& _appName, bool _start);
+
+    /**
+     * @brief Handles idle applications being parked
+     * @param _appName Name of the parked application
+     * @param _reclaimedKb Resident memory it held - kB
+     */
+    void OnApplicationParked(const QString& _appName, qint64 _reclaimedKb);
+
+    /**
+     * @brief Applies the filter text to the application list
+     * @param _text Substring of name or executable path
+     */
+    void OnFilterTextChanged(const QString& _text);
+
+    /**
+     * @brief Applies the selected state filter to the application list
+     * @param _index Combo box index - 0 all, 1 running, 2 stopped, 3 backoff
      */
-    void UpdateDisplay();
+    void OnStateFilterChanged(int _index);
+
+    /**
+     * @brief Updates the filter result count
+     * @param _visibleCount Applications passing the filter
+     * @param _totalCount Configured applications
+     */
+    void OnFilterChanged(int _visibleCount, int _totalCount);
+
+    /**
+     * @brief Switches the sparkline metric
+     * @param _index Combo box index - 0 CPU, 1 memory
+     */
+    void OnTrendMetricChanged(int _index);
+
+    /**
+     * @brief Marks rows with new resource samples for repaint
+     * @param _appNames Applications whose history changed
+     */
+    void OnSamplesUpdated(const QStringList& _appNames);
+
+    /**
+     * @brief Opens the captured output log of the application in a row
+     * @param _index Any cell of the row - from the filtered view
+     */
+    void OnShowApplicationLog(const QModelIndex& _index);
+
+    /**
+     * @brief Shows the row context menu of the application list
+     * @param _position Click position - viewport coordinates
+     */
+    void OnAppsContextMenu(const QPoint& _position);
+
+    /**
+     * @brief Periodic update of the uptime column
+     * Runs once per minute, the resolution uptimes are shown at
+     */
+    void UpdateUptimeColumn();
+
+    /**
+     * @brief Refreshes the diagnostics panel
+     * Shows p50/p99/max of the hot-path latency histograms and probe statistics
+     */
+    void OnRefreshDiagnostics();
+
+    /**
+     * @brief Writes the current diagnostics to the log and a dump file
+     * The dump file is written next to the loaded configuration file
+     */
+    void OnDumpDiagnostics();
 
 private:
     // Core components
@@ -147,20 +407,38 @@ private:
     QLineEdit* IpLineEdit;          // IP input field - IP address entry (IPv4 format)
 
     // Applications section
-    QGroupBox* AppsGroup;           // Applications group box - container for app control buttons
-    QScrollArea* ScrollArea;        // Scroll area - scrollable container for many apps
-    QWidget* ScrollWidget;          // Scroll widget - content widget inside scroll area
-    QVBoxLayout* AppsLayout;        // Apps layout - vertical arrangement of app buttons
+    QGroupBox* AppsGroup;           // Applications group box - container for the application list
+    QTableView* AppsView;           // Application list - one row per app, only visible rows are painted
+    A_applicationmodel* AppModel;   // Application model - rows backed by the process manager
+    A_applicationfilter* AppFilter; // Application filter - substring and state filter over the model
+    AppControlDelegate* ControlDelegate; // Control delegate - paints and handles start/stop buttons
+    StatusDelegate* PolicyDelegate;     // Status delegate - marks applications with a failed launch policy
+    QLineEdit* FilterLineEdit;      // Filter input - substring of name or executable path
+    QComboBox* StateFilterCombo;    // State filter - all, running, stopped, backoff or parked
+    QLabel* FilterCountLabel;       // Filter result - visible and total application count
+    QComboBox* TrendMetricCombo;    // Sparkline metric - CPU or memory
+    A_resourcesampler* ResourceSampler; // Resource sampler - CPU and memory histories
+    SparklineDelegate* TrendDelegate;   // Trend delegate - cached per-row sparklines
+    QLabel* NoAppsLabel;            // Placeholder - shown when no applications are configured
+
+    // Fleet section - only in hub mode
+    QGroupBox* FleetGroup;          // Fleet group box - null unless <fleet> lists monitors
+    QTreeView* FleetView;           // Fleet tree - monitors with their applications below
+    A_fleethub* FleetHub;           // Fleet hub - connections to the listed monitors
+    A_fleetmodel* FleetModel;       // Fleet model - rows backed by the hub
+
+    // Diagnostics section
+    QGroupBox* DiagnosticsGroup;    // Diagnostics group box - container for latency statistics
+    QLabel* DiagnosticsLabel;       // Diagnostics text - monospaced latency table
 
     // Control buttons
     QPushButton* SaveButton;        // Save button - persists changes to XML file
 
-
-    // Button tracking
-    QMap<QString, AppControlButton*> AppButtons; // Map of app buttons - key: app name, value: button widget
-
     // Status updates
-    QTimer* DisplayUpdateTimer;     // Display timer - periodic GUI refresh timer
+    QTimer* UptimeUpdateTimer;      // Uptime timer - one refresh per minute, status changes are event driven
+    int StatusBarState;             // Status bar style in effect - -1 none, 0 info, 1 error
+
+    QString ConfigFilePath;         // Loaded configuration path - also locates dump files
 
     /**
      * @brief Initializes the user interface components
@@ -176,10 +454,28 @@ private:
 
     /**
      * @brief Sets up the applications section of the interface
-     * Creates scrollable area for application control buttons
+     * Creates the filter bar and the application table view with its model and control delegate
      */
     void SetupApplicationsSection();
 
+    /**
+     * @brief Sets up the fleet section of the interface
+     * Connects to the monitors of the <fleet> element and shows them grouped by server ID
+     */
+    void SetupFleetSection();
+
+    /**
+     * @brief Sets up the diagnostics section of the interface
+     * Creates the latency statistics display with refresh and dump buttons
+     */
+    void SetupDiagnosticsSection();
+
+    /**
+     * @brief Builds the diagnostics text
+     * @return QString Latency table followed by per-app probe statistics
+     */
+    QString BuildDiagnosticsText() const;
+
     /**
      * @brief Sets up control buttons section
      * Creates save and refresh buttons with proper styling
@@ -200,10 +496,10 @@ private:
     void UpdateSettingsDisplay();
 
     /**
-     * @brief Recreates application control buttons
-     * Generates buttons dynamically based on current configuration
+     * @brief Rebuilds the application list
+     * Reloads the model rows from the current configuration
      */
-    void UpdateApplicationButtons();
+    void UpdateApplicationList();
 
     /**
      * @brief Applies consistent styling to the interface
@@ -0,0 +1,99 @@
+/**
+ * @brief Heartbeat client for applications supervised by QtProcessMonitor
+ *
+ * Header-only C (C99 or C++); no library to link. The monitor starts an
+ * application with a heartbeat watchdog (<heartbeatTimeout> in config.xml)
+ * with two environment variables naming its slot in a shared-memory file:
+ *
+ *   QPM_HEARTBEAT_FILE  Path of the slot file - normally under /dev/shm
+ *   QPM_HEARTBEAT_SLOT  Index of this application's 64-byte slot
+ *
+ * Usage:
+ *
+ *   qpm_heartbeat_t* heartbeat = qpm_heartbeat_open();   // once, at startup
+ *   ...
+ *   qpm_heartbeat_beat(heartbeat);                       // from the main loop
+ *
+ * qpm_heartbeat_beat() is a single relaxed atomic increment - no system
+ * call - so it can be called on every loop iteration. Beat from the loop
+ * whose progress matters: the watchdog only starts once the first beat has
+ * been seen, and restarts the application when the counter then stops
+ * moving for the configured time. Without the environment variables, e.g.
+ * when run by hand, qpm_heartbeat_open() returns NULL and beating is a no-op.
+ */
+
+#ifndef QPM_HEARTBEAT_H
+#define QPM_HEARTBEAT_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define QPM_HEARTBEAT_SLOT_SIZE 64  /* One cache line per slot - applications never share a line */
+
+#ifdef O_CLOEXEC
+#define QPM_HEARTBEAT_OPEN_FLAGS (O_RDWR | O_CLOEXEC)
+#else
+#define QPM_HEARTBEAT_OPEN_FLAGS O_RDWR      /* Strict C99 hides O_CLOEXEC; the descriptor is closed at once anyway */
+#endif
+
+typedef struct qpm_heartbeat {
+    volatile uint64_t counter;      /* Bumped by the application, read by the monitor */
+    uint64_t reserved[7];
+} qpm_heartbeat_t;
+
+/**
+ * @brief Maps this application's heartbeat slot
+ * @return qpm_heartbeat_t* Slot - NULL if not supervised or the slot cannot be mapped
+ */
+static inline qpm_heartbeat_t* qpm_heartbeat_open(void)
+{
+    const char* path = getenv("QPM_HEARTBEAT_FILE");
+    const char* slot_text = getenv("QPM_HEARTBEAT_SLOT");
+    char* end = NULL;
+    long slot;
+    long page_size;
+    off_t offset;
+    off_t page_offset;
+    int fd;
+    void* page;
+
+    if (!path || !slot_text) {
+        return NULL;
+    }
+    slot = strtol(slot_text, &end, 10);
+    if (end == slot_text || *end != '\0' || slot < 0) {
+        return NULL;
+    }
+
+    /* Only the page holding our slot is mapped */
+    page_size = sysconf(_SC_PAGESIZE);
+    offset = (off_t)slot * QPM_HEARTBEAT_SLOT_SIZE;
+    page_offset = offset - offset % page_size;
+
+    fd = open(path, QPM_HEARTBEAT_OPEN_FLAGS);
+    if (fd < 0) {
+        return NULL;
+    }
+    page = mmap(NULL, (size_t)page_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, page_offset);
+    close(fd);
+    if (page == MAP_FAILED) {
+        return NULL;
+    }
+    return (qpm_heartbeat_t*)((char*)page + (offset - page_offset));
+}
+
+/**
+ * @brief Records one heartbeat
+ * @param heartbeat Slot from qpm_heartbeat_open() - NULL is ignored
+ */
+static inline void qpm_heartbeat_beat(qpm_heartbeat_t* heartbeat)
+{
+    if (heartbeat) {
+        __atomic_fetch_add(&heartbeat->counter, 1, __ATOMIC_RELAXED);
+    }
+}
+
+#endif /* QPM_HEARTBEAT_H */
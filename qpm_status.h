@@ -0,0 +1,193 @@
+/**
+ * @brief Layout and reader of the QtProcessMonitor status table
+ *
+ * Header-only C (C99 or C++). The monitor publishes one record per
+ * application to the POSIX shared-memory segment named by
+ * qpm_status_default_name() ("/qtprocessmonitor-status-<uid>"). Readers map
+ * it read-only and never block the monitor: every record carries a sequence
+ * number that is odd while the record is being written, and
+ * qpm_status_read() retries until it copies a record whose sequence was even
+ * and unchanged around the copy (a seqlock).
+ *
+ * Versioning: any layout change bumps QPM_STATUS_VERSION. qpm_status_open()
+ * refuses a segment whose magic, version or structure sizes differ from the
+ * ones it was compiled with, so an older reader fails with
+ * QPM_STATUS_BAD_VERSION instead of misreading newer records.
+ */
+
+#ifndef QPM_STATUS_H
+#define QPM_STATUS_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define QPM_STATUS_MAGIC 0x54535051u     /* "QPST" */
+#define QPM_STATUS_VERSION 1u
+#define QPM_STATUS_NAME_SIZE 64          /* Application name bytes including the terminating NUL */
+#define QPM_STATUS_READ_ATTEMPTS 1000    /* Seqlock retries before a record is reported busy */
+
+/* Application states - same meaning as the Status column of the GUI */
+enum {
+    QPM_STATE_EMPTY = 0,        /* Unused record */
+    QPM_STATE_STOPPED = 1,      /* Not running and not wanted */
+    QPM_STATE_RUNNING = 2,      /* Running */
+    QPM_STATE_BACKOFF = 3,      /* Wanted but not running - waiting for the next restart attempt */
+    QPM_STATE_PARKED = 4        /* Stopped for being idle - started again on demand */
+};
+
+/* qpm_status_open() results */
+enum {
+    QPM_STATUS_OK = 0,
+    QPM_STATUS_NOT_FOUND = -1,      /* No segment - the monitor is not running */
+    QPM_STATUS_BAD_MAGIC = -2,      /* Not a status table */
+    QPM_STATUS_BAD_VERSION = -3,    /* Layout written by a different monitor version */
+    QPM_STATUS_TRUNCATED = -4,      /* Segment smaller than its header claims */
+    QPM_STATUS_BUSY = -5            /* Record kept changing during every read attempt */
+};
+
+/* Segment header - 64 bytes, followed by capacity records */
+typedef struct qpm_status_header {
+    uint32_t magic;             /* QPM_STATUS_MAGIC */
+    uint32_t version;           /* QPM_STATUS_VERSION of the writer */
+    uint32_t header_size;       /* sizeof(qpm_status_header_t) of the writer */
+    uint32_t record_size;       /* sizeof(qpm_status_record_t) of the writer */
+    uint32_t capacity;          /* Records allocated after the header */
+    volatile uint32_t count;    /* Records in use - [0, count) */
+    int64_t monitor_pid;        /* Publishing monitor */
+    volatile int64_t updated_ms; /* Last publish - milliseconds since epoch */
+    uint8_t reserved[24];
+} qpm_status_header_t;
+
+/* One application - 128 bytes */
+typedef struct qpm_status_record {
+    volatile uint64_t sequence; /* Odd while the monitor writes the record */
+    char name[QPM_STATUS_NAME_SIZE]; /* Application name - truncated, always NUL-terminated */
+    int64_t pid;                /* Running process - 0 if none */
+    int64_t changed_ms;         /* Last state or PID change - milliseconds since epoch */
+    int64_t started_ms;         /* Start of the running process - 0 if not running */
+    int64_t resident_kb;        /* Resident memory - 0 if not running */
+    uint32_t state;             /* QPM_STATE_* */
+    uint32_t restarts;          /* Automatic restarts since the monitor started */
+    uint32_t cpu_hundredths;    /* CPU use over the last interval - hundredths of a percent of one core */
+    uint32_t reserved[3];
+} qpm_status_record_t;
+
+/**
+ * @brief Builds the default segment name of the current user
+ * @param buffer Receives the name
+ * @param size Buffer size - 64 bytes are enough
+ */
+static inline void qpm_status_default_name(char* buffer, size_t size)
+{
+    snprintf(buffer, size, "/qtprocessmonitor-status-%u", (unsigned)getuid());
+}
+
+/**
+ * @brief Maps a status segment read-only and validates its layout
+ * @param name Segment name - e.g. from qpm_status_default_name()
+ * @param header Receives the mapped header - records follow it
+ * @return int QPM_STATUS_OK or a negative QPM_STATUS_* error
+ */
+static inline int qpm_status_open(const char* name, const qpm_status_header_t** header)
+{
+    struct stat info;
+    const qpm_status_header_t* mapped;
+    void* mapping;
+    int fd;
+    int result = QPM_STATUS_OK;
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return QPM_STATUS_NOT_FOUND;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(qpm_status_header_t)) {
+        close(fd);
+        return QPM_STATUS_TRUNCATED;
+    }
+    mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return QPM_STATUS_NOT_FOUND;
+    }
+
+    /* The monitor stores the magic last, so a half-initialized segment reads as foreign */
+    mapped = (const qpm_status_header_t*)mapping;
+    if (__atomic_load_n(&mapped->magic, __ATOMIC_ACQUIRE) != QPM_STATUS_MAGIC) {
+        result = QPM_STATUS_BAD_MAGIC;
+    } else if (mapped->version != QPM_STATUS_VERSION || mapped->header_size != sizeof(qpm_status_header_t) ||
+               mapped->record_size != sizeof(qpm_status_record_t)) {
+        result = QPM_STATUS_BAD_VERSION;
+    } else if ((size_t)info.st_size < sizeof(qpm_status_header_t) + (size_t)mapped->capacity * sizeof(qpm_status_record_t)) {
+        result = QPM_STATUS_TRUNCATED;
+    }
+    if (result != QPM_STATUS_OK) {
+        munmap(mapping, (size_t)info.st_size);
+        return result;
+    }
+
+    *header = mapped;
+    return QPM_STATUS_OK;
+}
+
+/**
+ * @brief Gets the number of records in use
+ * @param header Mapped header
+ * @return uint32_t Records - never more than the capacity
+ */
+static inline uint32_t qpm_status_count(const qpm_status_header_t* header)
+{
+    const uint32_t count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+    return count < header->capacity ? count : header->capacity;
+}
+
+/**
+ * @brief Copies one record consistently
+ * @param header Mapped header
+ * @param index Record index - below qpm_status_count()
+ * @param record Receives the copy
+ * @return int QPM_STATUS_OK or QPM_STATUS_BUSY
+ */
+static inline int qpm_status_read(const qpm_status_header_t* header, uint32_t index, qpm_status_record_t* record)
+{
+    const qpm_status_record_t* source = (const qpm_status_record_t*)(header + 1) + index;
+    int attempt;
+
+    for (attempt = 0; attempt < QPM_STATUS_READ_ATTEMPTS; ++attempt) {
+        const uint64_t before = __atomic_load_n(&source->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            continue;
+        }
+        memcpy(record, (const void*)source, sizeof(*record));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&source->sequence, __ATOMIC_RELAXED) == before) {
+            record->name[QPM_STATUS_NAME_SIZE - 1] = '\0';
+            return QPM_STATUS_OK;
+        }
+    }
+    return QPM_STATUS_BUSY;
+}
+
+/**
+ * @brief Describes a qpm_status_open() or qpm_status_read() result
+ * @param result QPM_STATUS_* value
+ * @return const char* Static message
+ */
+static inline const char* qpm_status_error(int result)
+{
+    switch (result) {
+    case QPM_STATUS_OK:          return "ok";
+    case QPM_STATUS_NOT_FOUND:   return "no status table - is the monitor running?";
+    case QPM_STATUS_BAD_MAGIC:   return "not a status table";
+    case QPM_STATUS_BAD_VERSION: return "status table written by an incompatible monitor version";
+    case QPM_STATUS_TRUNCATED:   return "status table is truncated";
+    case QPM_STATUS_BUSY:        return "record is being rewritten continuously";
+    default:                     return "unknown error";
+    }
+}
+
+#endif /* QPM_STATUS_H */
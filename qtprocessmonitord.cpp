@@ -0,0 +1,163 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QSocketNotifier>
+#include <QFileInfo>
+#include <QDir>
+#include <QTimer>
+#include <QDebug>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "a_settingsclass.h"
+#include "a_process.h"
+#include "a_metrics.h"
+#include "a_tracer.h"
+#include "a_fleetserver.h"
+
+/**
+ * @brief Headless entry point for the Qt Process Monitor
+ *
+ * Runs the same monitoring engine as the GUI on a QCoreApplication, so it
+ * needs no display and does not load Qt6::Widgets. SIGTERM and SIGINT stop
+ * monitoring and exit cleanly. Startup time and resident memory are logged
+ * once the event loop runs, for comparison with the GUI build. With --fleet
+ * the state is also served to fleet hubs on the <ip>:<port> of the
+ * configuration, identified by its <id>. With --trace a timeline of ticks,
+ * launches, kills and saves is written on exit for ui.perfetto.dev.
+ */
+
+namespace {
+
+int SignalSockets[2] = { -1, -1 };  // Self-pipe - the handler writes, the event loop reads
+
+void HandleTerminationSignal(int _signal)
+{
+    const char _byte = char(_signal);
+    ssize_t _ignored = ::write(SignalSockets[0], &_byte, 1);
+    (void)_ignored;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QElapsedTimer _startupTimer;
+    _startupTimer.start();
+
+    QCoreApplication _app(argc, argv);
+    _app.setApplicationName("qtprocessmonitord");
+    _app.setApplicationVersion("1.0");
+
+    QCommandLineParser _parser;
+    _parser.setApplicationDescription("Headless process monitor");
+    _parser.addHelpOption();
+    _parser.addVersionOption();
+    QCommandLineOption _configOption("config", "Configuration file.", "path",
+                                     QDir::currentPath() + "/config.xml");
+    QCommandLineOption _journalOption("journal", "Journal directory - default: journal/ next to the configuration.", "dir");
+    QCommandLineOption _logsOption("logs", "Captured output directory - default: logs/ next to the configuration.", "dir");
+    QCommandLineOption _checkpointOption("checkpoint", "Runtime state file adopted after a restart - default: checkpoint.qpc next to the configuration.", "path");
+    QCommandLineOption _statusOption("status-table", "Shared-memory status table name - default: /qtprocessmonitor-status-<uid>.", "name");
+    QCommandLineOption _fleetOption("fleet", "Serve application state to fleet hubs on <ip>:<port> of the configuration.");
+    QCommandLineOption _traceOption("trace", "Record a timeline and write it as Chrome trace JSON on exit.", "path");
+    QCommandLineOption _stopAppsOption("stop-apps", "Stop all supervised applications on exit.");
+    QCommandLineOption _stopDeadlineOption("stop-deadline", "Time allowed for --stop-apps before everything left is killed - default: 30.", "seconds", "30");
+    _parser.addOptions({ _configOption, _journalOption, _logsOption, _checkpointOption, _statusOption, _fleetOption, _traceOption,
+                         _stopAppsOption, _stopDeadlineOption });
+    _parser.process(_app);
+
+    if (_parser.isSet(_traceOption)) {
+        A_tracer::Start();
+    }
+
+    const QString _configPath = QFileInfo(_parser.value(_configOption)).absoluteFilePath();
+    A_settingsclass _settings;
+    if (!_settings.LoadConfiguration(_configPath)) {
+        qCritical() << "Failed to load configuration file:" << _configPath;
+        return 1;
+    }
+
+    // Route SIGTERM and SIGINT into the event loop - not inherited by applications, and the handler never blocks
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, SignalSockets) != 0) {
+        qCritical() << "Cannot create signal socket pair";
+        return 1;
+    }
+    ::fcntl(SignalSockets[0], F_SETFL, ::fcntl(SignalSockets[0], F_GETFL) | O_NONBLOCK);
+    QSocketNotifier _signalNotifier(SignalSockets[1], QSocketNotifier::Read);
+    QObject::connect(&_signalNotifier, &QSocketNotifier::activated, &_app, [&]() {
+        char _signal = 0;
+        ssize_t _ignored = ::read(SignalSockets[1], &_signal, 1);
+        (void)_ignored;
+        qInfo() << "Received signal" << int(_signal) << "- shutting down";
+        _app.quit();
+    });
+    struct sigaction _action = {};
+    _action.sa_handler = HandleTerminationSignal;
+    sigemptyset(&_action.sa_mask);
+    _action.sa_flags = SA_RESTART;
+    sigaction(SIGTERM, &_action, nullptr);
+    sigaction(SIGINT, &_action, nullptr);
+
+    A_process _process;
+    _process.SetSettingsReference(&_settings);
+
+    const QString _journalDir = _parser.isSet(_journalOption) ? _parser.value(_journalOption)
+                                                              : QFileInfo(_configPath).absolutePath() + "/journal";
+    if (!_process.OpenJournal(_journalDir)) {
+        qWarning() << "Journal unavailable at:" << _journalDir;
+    }
+    const QString _logsDir = _parser.isSet(_logsOption) ? _parser.value(_logsOption)
+                                                        : QFileInfo(_configPath).absolutePath() + "/logs";
+    if (!_process.OpenLogCapture(_logsDir)) {
+        qWarning() << "Output capture unavailable at:" << _logsDir << "- application output is discarded";
+    }
+    if (!_process.OpenStatusTable(_parser.value(_statusOption))) {
+        qWarning() << "Status table unavailable - qpmstat will not see this monitor";
+    }
+    const QString _checkpointPath = _parser.isSet(_checkpointOption) ? _parser.value(_checkpointOption)
+                                                                     : QFileInfo(_configPath).absolutePath() + "/checkpoint.qpc";
+    if (!_process.OpenCheckpoint(_checkpointPath)) {
+        qWarning() << "Checkpoint unavailable at:" << _checkpointPath << "- a restart rediscovers applications by name";
+    }
+
+    _process.StartMonitoring();
+
+    A_fleetserver _fleetServer(_settings.GetId());
+    if (_parser.isSet(_fleetOption)) {
+        QHostAddress _address(_settings.GetIp());
+        if (_address.isNull()) {
+            _address = QHostAddress::Any;
+        }
+        if (_fleetServer.Listen(_address, _settings.GetPort().toUShort())) {
+            _fleetServer.AttachProcess(&_process);
+        } else {
+            qWarning() << "Fleet server unavailable - hubs will not see this monitor";
+        }
+    }
+
+    QTimer::singleShot(0, &_app, [&]() {
+        qInfo() << "qtprocessmonitord started in" << _startupTimer.elapsed() << "ms, RSS"
+                << A_metrics::ResidentKb() << "kB, monitoring" << _settings.GetApplications().size()
+                << "applications from" << _configPath;
+    });
+
+    const int _exitCode = _app.exec();
+
+    if (_parser.isSet(_stopAppsOption)) {
+        const int _deadlineSeconds = qMax(0, _parser.value(_stopDeadlineOption).toInt());
+        const ShutdownReport _report = _process.ShutdownApplications(_deadlineSeconds * 1000);
+        qInfo() << "Stopped" << _report.ToString();
+    }
+    _process.StopMonitoring();
+    if (_parser.isSet(_traceOption)) {
+        A_tracer::Stop();
+        A_tracer::WriteChromeTrace(_parser.value(_traceOption));
+    }
+    ::close(SignalSockets[0]);
+    ::close(SignalSockets[1]);
+    qInfo() << "qtprocessmonitord exiting with code:" << _exitCode;
+    return _exitCode;
+}
@@ -0,0 +1,194 @@
+#include "a_simulatedsystem.h"
+#include <QDir>
+#include <QFile>
+#include <csignal>
+
+A_simulatedsystem::A_simulatedsystem(quint64 _seed)
+    : Random(_seed)
+{
+    CurrentTimeMs = 0;
+    NextProcessId = 1000;
+    NextSequence = 0;
+}
+
+A_simulatedsystem::~A_simulatedsystem()
+{
+}
+
+void A_simulatedsystem::SetBehavior(const QString& _executablePath, const SimulatedBehavior& _behavior)
+{
+    Behaviors[_executablePath] = _behavior;
+}
+
+void A_simulatedsystem::SetProcRoot(const QString& _procRoot)
+{
+    ProcRoot = _procRoot;
+    if (!ProcRoot.isEmpty()) {
+        QDir().mkpath(ProcRoot);
+    }
+}
+
+void A_simulatedsystem::AdvanceTo(qint64 _timeMs)
+{
+    while (!ExitQueue.empty() && ExitQueue.top().TimeMs <= _timeMs) {
+        ExitEvent _event = ExitQueue.top();
+        ExitQueue.pop();
+        CurrentTimeMs = qMax(CurrentTimeMs, _event.TimeMs);
+        TerminateProcess(_event.ProcessId);
+    }
+    CurrentTimeMs = qMax(CurrentTimeMs, _timeMs);
+}
+
+qint64 A_simulatedsystem::FindProcess(const QString& _executablePath)
+{
+    auto _it = ProcessesByName.constFind(ProcessName(_executablePath));
+    if (_it == ProcessesByName.constEnd()) {
+        return 0;
+    }
+
+    // Lowest visible PID, like a sorted pidof
+    for (auto _pid = _it->constBegin(); _pid != _it->constEnd(); ++_pid) {
+        if (Processes.value(_pid.key()).VisibleAtMs <= CurrentTimeMs) {
+            return _pid.key();
+        }
+    }
+    return 0;
+}
+
+bool A_simulatedsystem::SendSignal(qint64 _processId, int _signal)
+{
+    auto _it = Processes.find(_processId);
+    if (_it == Processes.end()) {
+        return false; // ESRCH
+    }
+
+    ++Stats.SignalsDelivered;
+
+    if (_signal == SIGKILL) {
+        _it->Signalled = true;
+        TerminateProcess(_processId);
+        return true;
+    }
+
+    const SimulatedBehavior _behavior = Behaviors.value(_it->ExecutablePath);
+    if (!_behavior.IgnoreTerm) {
+        _it->Signalled = true;
+        ScheduleExit(_processId, CurrentTimeMs + _behavior.TermExitDelayMs);
+    }
+    return true;
+}
+
+QVector<qint64> A_simulatedsystem::WaitForExit(const QVector<qint64>& _processIds, int _timeoutMs)
+{
+    auto _collectExited = [&]() {
+        QVector<qint64> _exited;
+        for (qint64 _processId : _processIds) {
+            if (!Processes.contains(_processId)) {
+                _exited.append(_processId);
+            }
+        }
+        return _exited;
+    };
+
+    // Jump from exit to exit until one of ours is gone or the timeout is reached
+    const qint64 _untilMs = CurrentTimeMs + qMax(0, _timeoutMs);
+    QVector<qint64> _exited = _collectExited();
+    while (_exited.isEmpty() && !ExitQueue.empty() && ExitQueue.top().TimeMs <= _untilMs) {
+        AdvanceTo(ExitQueue.top().TimeMs);
+        _exited = _collectExited();
+    }
+    if (_exited.isEmpty()) {
+        AdvanceTo(_untilMs);
+    }
+    return _exited;
+}
+
+bool A_simulatedsystem::Spawn(const QString& _appName, const QString& _executablePath,
+                              const LaunchPolicy& _policy, qint64* _processId, int _outputFd,
+                              const QVector<int>& _listenFds, const QStringList& _environment)
+{
+    Q_UNUSED(_appName);
+    Q_UNUSED(_policy);
+    Q_UNUSED(_outputFd);
+    Q_UNUSED(_listenFds);
+    Q_UNUSED(_environment);
+
+    if (_processId) {
+        *_processId = 0;
+    }
+
+    const SimulatedBehavior _behavior = Behaviors.value(_executablePath);
+    if (_behavior.Type == SimulatedBehavior::FailToStart) {
+        ++Stats.SpawnFailures;
+        return false;
+    }
+
+    const qint64 _pid = NextProcessId++;
+    VirtualProcess _process;
+    _process.Name = ProcessName(_executablePath);
+    _process.ExecutablePath = _executablePath;
+    _process.VisibleAtMs = CurrentTimeMs + _behavior.StartupDelayMs;
+    Processes.insert(_pid, _process);
+    ProcessesByName[_process.Name].insert(_pid, true);
+    ++Stats.Spawns;
+
+    if (_behavior.Type == SimulatedBehavior::RandomCrash) {
+        std::exponential_distribution<double> _lifetime(1.0 / double(qMax<qint64>(1, _behavior.MeanLifetimeMs)));
+        ScheduleExit(_pid, CurrentTimeMs + qint64(_lifetime(Random)));
+    } else if (_behavior.Type == SimulatedBehavior::CrashLoop) {
+        ScheduleExit(_pid, CurrentTimeMs + _behavior.CrashAfterMs);
+    }
+
+    if (!ProcRoot.isEmpty()) {
+        const QString _dir = ProcRoot + "/" + QString::number(_pid);
+        QDir().mkpath(_dir);
+        QFile _stat(_dir + "/stat");
+        if (_stat.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            _stat.write(QString("%1 (%2) S 1 %1 %1 0 -1\n").arg(_pid).arg(_process.Name).toLocal8Bit());
+        }
+    }
+
+    if (_processId) {
+        *_processId = _pid;
+    }
+    return true;
+}
+
+void A_simulatedsystem::ScheduleExit(qint64 _processId, qint64 _timeMs)
+{
+    ExitQueue.push(ExitEvent { _timeMs, NextSequence++, _processId });
+}
+
+void A_simulatedsystem::TerminateProcess(qint64 _processId)
+{
+    auto _it = Processes.find(_processId);
+    if (_it == Processes.end()) {
+        return;
+    }
+
+    if (_it->Signalled) {
+        ++Stats.SignalledExits;
+    } else {
+        ++Stats.Crashes;
+    }
+
+    auto _byName = ProcessesByName.find(_it->Name);
+    if (_byName != ProcessesByName.end()) {
+        _byName->remove(_processId);
+        if (_byName->isEmpty()) {
+            ProcessesByName.erase(_byName);
+        }
+    }
+    Processes.erase(_it);
+
+    if (!ProcRoot.isEmpty()) {
+        QDir(ProcRoot + "/" + QString::number(_processId)).removeRecursively();
+    }
+}
+
+QString A_simulatedsystem::ProcessName(const QString& _executablePath)
+{
+    QString _name = _executablePath.mid(_executablePath.lastIndexOf('/') + 1);
+    const int _dot = _name.indexOf('.');
+    return _dot >= 0 ? _name.left(_dot) : _name;
+}
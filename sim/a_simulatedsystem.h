@@ -0,0 +1,167 @@
+#ifndef A_SIMULATEDSYSTEM_H
+#define A_SIMULATEDSYSTEM_H
+
+#include <QString>
+#include <QHash>
+#include <QMap>
+#include <functional>
+#include <random>
+#include <queue>
+#include <vector>
+#include "a_systeminterfaces.h"
+
+/**
+ * @brief Scripted behaviour of a simulated executable
+ */
+struct SimulatedBehavior {
+    enum Mode {
+        Stable,         // Runs until signalled
+        RandomCrash,    // Exits after an exponentially distributed lifetime
+        CrashLoop,      // Exits CrashAfterMs after every start
+        FailToStart     // Spawn always fails
+    };
+
+    Mode Type = Stable;             // Crash pattern
+    qint64 MeanLifetimeMs = 600000; // RandomCrash - mean lifetime in virtual ms
+    qint64 CrashAfterMs = 1000;     // CrashLoop - lifetime in virtual ms
+    qint64 StartupDelayMs = 0;      // Delay before the process shows up in the process table
+    qint64 TermExitDelayMs = 100;   // Delay between a catchable signal and the exit
+    bool IgnoreTerm = false;        // Ignore catchable signals - only SIGKILL ends the process
+};
+
+/**
+ * @brief Counters collected by the simulated system
+ */
+struct SimulationStatistics {
+    quint64 Spawns = 0;             // Successful spawns
+    quint64 SpawnFailures = 0;      // Spawns rejected by FailToStart
+    quint64 Crashes = 0;            // Exits not caused by a signal
+    quint64 SignalledExits = 0;     // Exits caused by a signal
+    quint64 SignalsDelivered = 0;   // Signals sent to live processes
+};
+
+/**
+ * @brief Virtual process table, signal delivery, spawner and clock in one
+ *
+ * Processes exist only as table entries and time only advances when the
+ * monitor sleeps or the driver calls AdvanceTo(), so thousands of processes
+ * and hours of supervision run in a fraction of real time with fully
+ * reproducible results for a given seed. Optionally every process is also
+ * mirrored into a fake procfs tree for use with A_procfsprocesstable.
+ */
+class A_simulatedsystem : public A_processtable, public A_signalsender,
+                          public A_processspawner, public A_clock
+{
+public:
+    /**
+     * @param _seed Random seed - same seed gives the same run
+     */
+    explicit A_simulatedsystem(quint64 _seed = 1);
+    ~A_simulatedsystem() override;
+
+    /**
+     * @brief Sets the behaviour of processes started from an executable
+     * @param _executablePath Executable path as written in the configuration
+     * @param _behavior Crash pattern and timings
+     */
+    void SetBehavior(const QString& _executablePath, const SimulatedBehavior& _behavior);
+
+    /**
+     * @brief Mirrors processes into a fake procfs tree
+     * Directories are created at spawn and removed at exit; StartupDelayMs is
+     * not modelled in the tree.
+     * @param _procRoot Directory receiving <pid>/stat entries - created if missing
+     */
+    void SetProcRoot(const QString& _procRoot);
+
+    /**
+     * @brief Advances virtual time, running all process exits that fall due
+     * @param _timeMs Target virtual time - ignored if in the past
+     */
+    void AdvanceTo(qint64 _timeMs);
+
+    /**
+     * @brief Gets the number of live simulated processes
+     * @return int Live process count
+     */
+    int LiveProcessCount() const { return Processes.size(); }
+
+    /**
+     * @brief Gets the collected counters
+     * @return const SimulationStatistics& Counters since construction
+     */
+    const SimulationStatistics& Statistics() const { return Stats; }
+
+    // A_processtable
+    qint64 FindProcess(const QString& _executablePath) override;
+
+    // A_signalsender
+    bool SendSignal(qint64 _processId, int _signal) override;
+    QVector<qint64> WaitForExit(const QVector<qint64>& _processIds, int _timeoutMs) override;
+
+    // A_processspawner
+    bool Spawn(const QString& _appName, const QString& _executablePath, const LaunchPolicy& _policy,
+               qint64* _processId, int _outputFd, const QVector<int>& _listenFds,
+               const QStringList& _environment) override;
+
+    // A_clock
+    qint64 NowMs() override { return CurrentTimeMs; }
+    void SleepMs(int _milliseconds) override { AdvanceTo(CurrentTimeMs + _milliseconds); }
+
+private:
+    /**
+     * @brief One simulated process
+     */
+    struct VirtualProcess {
+        QString Name;               // Process name - executable base name, as pidof sees it
+        QString ExecutablePath;     // Spawned executable - selects the behaviour
+        qint64 VisibleAtMs = 0;     // First virtual time the process is listed
+        bool Signalled = false;     // Exit was requested by a signal
+    };
+
+    /**
+     * @brief A scheduled process exit
+     */
+    struct ExitEvent {
+        qint64 TimeMs;      // Exit time - virtual ms
+        quint64 Sequence;   // Tie breaker - keeps ordering deterministic
+        qint64 ProcessId;   // Exiting process
+
+        bool operator>(const ExitEvent& _other) const {
+            return TimeMs != _other.TimeMs ? TimeMs > _other.TimeMs : Sequence > _other.Sequence;
+        }
+    };
+
+    qint64 CurrentTimeMs;                                   // Virtual time - ms since simulation start
+    qint64 NextProcessId;                                   // Next PID to hand out
+    quint64 NextSequence;                                   // Next exit event sequence number
+    std::mt19937_64 Random;                                 // Seeded generator - lifetimes
+    QString ProcRoot;                                       // Fake procfs root - empty when disabled
+    QHash<QString, SimulatedBehavior> Behaviors;            // Behaviour per executable path
+    QHash<qint64, VirtualProcess> Processes;                // Live processes - key: PID
+    QHash<QString, QMap<qint64, bool>> ProcessesByName;     // Live PIDs per name - ordered, value unused
+    std::priority_queue<ExitEvent, std::vector<ExitEvent>, std::greater<ExitEvent>> ExitQueue; // Pending exits
+    SimulationStatistics Stats;                             // Counters
+
+    /**
+     * @brief Schedules a process exit
+     * @param _processId Process to end
+     * @param _timeMs Exit time - virtual ms
+     */
+    void ScheduleExit(qint64 _processId, qint64 _timeMs);
+
+    /**
+     * @brief Removes a process from the table
+     * @param _processId Process to remove - ignored if already gone
+     */
+    void TerminateProcess(qint64 _processId);
+
+    /**
+     * @brief Derives the pidof-visible process name from a path
+     * @param _executablePath Executable path
+     * @return QString Base name without extension
+     */
+    static QString ProcessName(const QString& _executablePath);
+};
+
+#endif // A_SIMULATEDSYSTEM_H
@@ -0,0 +1,214 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QHash>
+#include <QVector>
+#include <cstdio>
+#include <random>
+#include <memory>
+
+#include "a_settingsclass.h"
+#include "a_process.h"
+#include "a_simulatedsystem.h"
+
+/**
+ * @brief Deterministic supervision simulator
+ *
+ * Runs the real A_process engine against A_simulatedsystem: a virtual
+ * process table with scripted crash patterns and a virtual clock. The driver
+ * calls CheckProcesses once per monitoring interval of virtual time, so
+ * restart policies can be exercised at scales and durations that cannot be
+ * spawned for real, and the wall time spent per tick measures the engine's
+ * own scheduling overhead.
+ */
+
+namespace {
+
+/**
+ * @brief Exposes the protected monitoring tick of A_process
+ */
+class SimulatedProcess : public A_process
+{
+public:
+    using A_process::CheckProcesses;
+};
+
+void QuietMessageHandler(QtMsgType _type, const QMessageLogContext&, const QString& _message)
+{
+    if (_type != QtDebugMsg && _type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(_message));
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication _app(argc, argv);
+    _app.setApplicationName("qtprocessmonitor_sim");
+
+    QCommandLineParser _parser;
+    _parser.setApplicationDescription("Deterministic virtual-time simulation of the process monitor");
+    _parser.addHelpOption();
+    QCommandLineOption _appsOption("apps", "Number of simulated applications.", "count", "1000");
+    QCommandLineOption _durationOption("duration", "Virtual duration in seconds.", "seconds", "3600");
+    QCommandLineOption _seedOption("seed", "Random seed.", "seed", "1");
+    QCommandLineOption _intervalOption("interval", "Monitoring interval in virtual ms.", "ms", "2000");
+    QCommandLineOption _lifetimeOption("mean-lifetime", "Mean lifetime of randomly crashing apps in seconds.", "seconds", "600");
+    QCommandLineOption _crashingOption("crashing", "Fraction of apps that crash randomly.", "fraction", "0.5");
+    QCommandLineOption _loopOption("crash-loop", "Fraction of apps that crash 1 s after every start.", "fraction", "0.01");
+    QCommandLineOption _failOption("fail-to-start", "Fraction of apps whose launch always fails.", "fraction", "0");
+    QCommandLineOption _stubbornOption("ignore-term", "Fraction of apps that ignore catchable signals.", "fraction", "0");
+    QCommandLineOption _startupOption("startup-delay", "Virtual ms before a new process becomes visible.", "ms", "500");
+    QCommandLineOption _procRootOption("proc-root", "Mirror processes into a fake procfs tree and look them up there.", "dir");
+    QCommandLineOption _verboseOption("verbose", "Show engine debug output.");
+    _parser.addOptions({ _appsOption, _durationOption, _seedOption, _intervalOption, _lifetimeOption,
+                         _crashingOption, _loopOption, _failOption, _stubbornOption, _startupOption,
+                         _procRootOption, _verboseOption });
+    _parser.process(_app);
+
+    if (!_parser.isSet(_verboseOption)) {
+        qInstallMessageHandler(QuietMessageHandler);
+    }
+
+    const int _appCount = qMax(1, _parser.value(_appsOption).toInt());
+    const qint64 _durationMs = _parser.value(_durationOption).toLongLong() * 1000;
+    const quint64 _seed = _parser.value(_seedOption).toULongLong();
+    const qint64 _intervalMs = qMax<qint64>(1, _parser.value(_intervalOption).toLongLong());
+
+    // Assign a crash pattern to every application from the seed
+    A_simulatedsystem _system(_seed);
+    std::mt19937_64 _assignRandom(_seed ^ 0x9E3779B97F4A7C15ull);
+    std::uniform_real_distribution<double> _uniform(0.0, 1.0);
+
+    QTemporaryDir _tempDir;
+    const QString _configPath = _tempDir.path() + "/config.xml";
+    QFile _configFile(_configPath);
+    if (!_configFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        fprintf(stderr, "Cannot write simulation config: %s\n", qPrintable(_configPath));
+        return 1;
+    }
+
+    QTextStream _stream(&_configFile);
+    _stream << "<configuration>\n    <settings><id>SIM</id><port>1000</port><ip>127.0.0.1</ip></settings>\n"
+            << "    <applications>\n";
+    for (int _i = 0; _i < _appCount; ++_i) {
+        const QString _path = QString("/sim/bin/simapp_%1").arg(_i);
+        _stream << "        <app><n>SimApp" << _i << "</n><executable>" << _path
+                << "</executable><status>start</status></app>\n";
+
+        SimulatedBehavior _behavior;
+        _behavior.StartupDelayMs = _parser.value(_startupOption).toLongLong();
+        _behavior.MeanLifetimeMs = _parser.value(_lifetimeOption).toLongLong() * 1000;
+        _behavior.IgnoreTerm = _uniform(_assignRandom) < _parser.value(_stubbornOption).toDouble();
+
+        const double _roll = _uniform(_assignRandom);
+        const double _fail = _parser.value(_failOption).toDouble();
+        const double _loop = _parser.value(_loopOption).toDouble();
+        const double _crashing = _parser.value(_crashingOption).toDouble();
+        if (_roll < _fail) {
+            _behavior.Type = SimulatedBehavior::FailToStart;
+        } else if (_roll < _fail + _loop) {
+            _behavior.Type = SimulatedBehavior::CrashLoop;
+        } else if (_roll < _fail + _loop + _crashing) {
+            _behavior.Type = SimulatedBehavior::RandomCrash;
+        }
+        _system.SetBehavior(_path, _behavior);
+    }
+    _stream << "    </applications>\n</configuration>\n";
+    _stream.flush();
+    _configFile.close();
+
+    A_settingsclass _settings;
+    if (!_settings.LoadConfiguration(_configPath)) {
+        fprintf(stderr, "Cannot load simulation config\n");
+        return 1;
+    }
+
+    std::unique_ptr<A_procfsprocesstable> _procfsTable;
+    if (_parser.isSet(_procRootOption)) {
+        _system.SetProcRoot(_parser.value(_procRootOption));
+        _procfsTable.reset(new A_procfsprocesstable(_parser.value(_procRootOption)));
+    }
+
+    SimulatedProcess _process;
+    _process.SetSystemInterfaces(_procfsTable ? static_cast<A_processtable*>(_procfsTable.get()) : &_system,
+                                 &_system, &_system, &_system);
+    _process.SetSettingsReference(&_settings);
+
+    // Restart storms: the most restarts any single app saw within one virtual minute
+    QHash<QString, QVector<qint64>> _restartTimes;
+    quint64 _restarts = 0;
+    QObject::connect(&_process, &A_process::ApplicationRestarted, [&](const QString& _appName) {
+        ++_restarts;
+        _restartTimes[_appName].append(_system.NowMs());
+    });
+
+    // Drive the monitor in virtual time; a tick that overruns delays the next one
+    quint64 _ticks = 0;
+    qint64 _tickWallTotalNs = 0;
+    qint64 _tickWallMaxNs = 0;
+    qint64 _nextTickMs = 0;
+    QElapsedTimer _wallClock;
+    _wallClock.start();
+
+    while (_system.NowMs() < _durationMs) {
+        _system.AdvanceTo(_nextTickMs);
+        const qint64 _tickStartMs = _system.NowMs();
+
+        QElapsedTimer _tickTimer;
+        _tickTimer.start();
+        _process.CheckProcesses();
+        const qint64 _tickNs = _tickTimer.nsecsElapsed();
+
+        _tickWallTotalNs += _tickNs;
+        _tickWallMaxNs = qMax(_tickWallMaxNs, _tickNs);
+        ++_ticks;
+        _nextTickMs = qMax(_tickStartMs + _intervalMs, _system.NowMs());
+    }
+
+    const double _wallSeconds = double(_wallClock.nsecsElapsed()) / 1e9;
+    const double _virtualSeconds = double(_system.NowMs()) / 1000.0;
+
+    int _worstMinute = 0;
+    QString _worstApp;
+    for (auto _it = _restartTimes.constBegin(); _it != _restartTimes.constEnd(); ++_it) {
+        const QVector<qint64>& _times = _it.value();
+        int _begin = 0;
+        for (int _end = 0; _end < _times.size(); ++_end) {
+            while (_times.at(_end) - _times.at(_begin) >= 60000) {
+                ++_begin;
+            }
+            if (_end - _begin + 1 > _worstMinute) {
+                _worstMinute = _end - _begin + 1;
+                _worstApp = _it.key();
+            }
+        }
+    }
+
+    const SimulationStatistics& _stats = _system.Statistics();
+    printf("applications         %d\n", _appCount);
+    printf("seed                 %llu\n", static_cast<unsigned long long>(_seed));
+    printf("virtual time         %.1f s\n", _virtualSeconds);
+    printf("wall time            %.3f s (%.0fx real time)\n", _wallSeconds,
+           _wallSeconds > 0 ? _virtualSeconds / _wallSeconds : 0.0);
+    printf("ticks                %llu\n", static_cast<unsigned long long>(_ticks));
+    printf("tick overhead        mean %.1f us, max %.1f us, %.3f us/app\n",
+           _ticks ? double(_tickWallTotalNs) / double(_ticks) / 1000.0 : 0.0,
+           double(_tickWallMaxNs) / 1000.0,
+           _ticks ? double(_tickWallTotalNs) / double(_ticks) / 1000.0 / _appCount : 0.0);
+    printf("spawns               %llu (failed %llu)\n",
+           static_cast<unsigned long long>(_stats.Spawns), static_cast<unsigned long long>(_stats.SpawnFailures));
+    printf("crashes              %llu\n", static_cast<unsigned long long>(_stats.Crashes));
+    printf("signalled exits      %llu (signals %llu)\n",
+           static_cast<unsigned long long>(_stats.SignalledExits), static_cast<unsigned long long>(_stats.SignalsDelivered));
+    printf("restarts             %llu\n", static_cast<unsigned long long>(_restarts));
+    printf("worst restart storm  %d restarts/min (%s)\n", _worstMinute,
+           _worstApp.isEmpty() ? "-" : qPrintable(_worstApp));
+    printf("live processes       %d\n", _system.LiveProcessCount());
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <unistd.h>
+#include "a_checkpoint.h"
+#include "a_process.h"
+#include "a_settingsclass.h"
+
+namespace {
+
+/**
+ * @brief Process table that reports one fixed PID for every executable
+ */
+class A_fixedprocesstable : public A_processtable
+{
+public:
+    qint64 ProcessId = 0;   // Reported PID - 0 reports nothing running
+
+    qint64 FindProcess(const QString& _executablePath) override
+    {
+        Q_UNUSED(_executablePath);
+        return ProcessId;
+    }
+};
+
+/**
+ * @brief Exposes the protected monitoring tick of A_process
+ */
+class TestProcess : public A_process
+{
+public:
+    using A_process::CheckProcesses;
+};
+
+} // namespace
+
+/**
+ * @brief Behavior tests of checkpoint adoption across monitor restarts
+ *
+ * A real child process stands in for the supervised application, because
+ * adoption compares the kernel start time in /proc/<pid>/stat.
+ */
+class tst_checkpointadoption : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir Directory;        // Configuration and checkpoint
+    QString ConfigPath;             // config.xml with one application
+    QString CheckpointPath;         // Checkpoint file
+    A_settingsclass Settings;       // Loaded configuration
+    QProcess Child;                 // Stand-in for the supervised application
+
+    /**
+     * @brief Runs one monitor that sees the child running and checkpoints it
+     */
+    void CheckpointChild()
+    {
+        A_fixedprocesstable _table;
+        _table.ProcessId = Child.processId();
+
+        TestProcess _monitor;
+        _monitor.SetSystemInterfaces(&_table, nullptr, nullptr, nullptr);
+        _monitor.SetSettingsReference(&Settings);
+        QVERIFY(_monitor.OpenCheckpoint(CheckpointPath));
+        _monitor.CheckProcesses();
+
+        const ProcessInfo _info = _monitor.GetProcessInfo("Sleeper");
+        QVERIFY(_info.IsRunning);
+        QCOMPARE(_info.ProcessId, Child.processId());
+    }
+
+private slots:
+    void init()
+    {
+        QVERIFY(Directory.isValid());
+        ConfigPath = Directory.path() + "/config.xml";
+        CheckpointPath = Directory.path() + "/state/checkpoint.qpc";
+        QFile::remove(CheckpointPath);
+
+        QFile _config(ConfigPath);
+        QVERIFY(_config.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text));
+        QTextStream _stream(&_config);
+        _stream << "<configuration>\n    <settings><id>TEST</id><port>1000</port><ip>127.0.0.1</ip></settings>\n"
+                << "    <applications>\n        <app><n>Sleeper</n><executable>/bin/sleep</executable>"
+                << "<status>start</status></app>\n    </applications>\n</configuration>\n";
+        _stream.flush();
+        _config.close();
+        QVERIFY(Settings.LoadConfiguration(ConfigPath));
+
+        Child.start("/bin/sleep", { "60" });
+        QVERIFY(Child.waitForStarted());
+    }
+
+    void cleanup()
+    {
+        Child.kill();
+        Child.waitForFinished();
+
+        // Adoption keeps the heartbeat slot file of the checkpoint - it outlives the monitors
+        QFile::remove(QString("/dev/shm/qtprocessmonitor-heartbeat-%1-%2")
+                          .arg(getuid())
+                          .arg(A_checkpoint::Hash(QFileInfo(CheckpointPath).absoluteFilePath()), 8, 16, QChar('0')));
+    }
+
+    void adoptsRunningProcess()
+    {
+        CheckpointChild();
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+        QVERIFY(QFileInfo::exists(CheckpointPath));
+
+        // The restarted monitor cannot find the process by name - only the checkpoint knows it
+        A_fixedprocesstable _table;
+        TestProcess _monitor;
+        _monitor.SetSystemInterfaces(&_table, nullptr, nullptr, nullptr);
+        _monitor.SetSettingsReference(&Settings);
+        QSignalSpy _statusSpy(&_monitor, &A_process::ApplicationStatusChanged);
+        QVERIFY(_monitor.OpenCheckpoint(CheckpointPath));
+
+        const ProcessInfo _info = _monitor.GetProcessInfo("Sleeper");
+        QVERIFY(_info.IsRunning);
+        QCOMPARE(_info.ProcessId, Child.processId());
+        QCOMPARE(int(_statusSpy.count()), 1);
+        QCOMPARE(_statusSpy.first().at(0).toString(), QString("Sleeper"));
+        QCOMPARE(_statusSpy.first().at(1).toBool(), true);
+    }
+
+    void ignoresExitedProcess()
+    {
+        CheckpointChild();
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+        Child.kill();
+        QVERIFY(Child.waitForFinished());
+
+        A_fixedprocesstable _table;
+        TestProcess _monitor;
+        _monitor.SetSystemInterfaces(&_table, nullptr, nullptr, nullptr);
+        _monitor.SetSettingsReference(&Settings);
+        QVERIFY(_monitor.OpenCheckpoint(CheckpointPath));
+        QVERIFY(!_monitor.GetProcessInfo("Sleeper").IsRunning);
+    }
+
+    void ignoresChangedExecutable()
+    {
+        CheckpointChild();
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+
+        // Same application name, another binary - the recorded process is not the one configured now
+        QFile _config(ConfigPath);
+        QVERIFY(_config.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text));
+        QTextStream _stream(&_config);
+        _stream << "<configuration>\n    <settings><id>TEST</id><port>1000</port><ip>127.0.0.1</ip></settings>\n"
+                << "    <applications>\n        <app><n>Sleeper</n><executable>/bin/true</executable>"
+                << "<status>start</status></app>\n    </applications>\n</configuration>\n";
+        _stream.flush();
+        _config.close();
+        A_settingsclass _settings;
+        QVERIFY(_settings.LoadConfiguration(ConfigPath));
+
+        A_fixedprocesstable _table;
+        TestProcess _monitor;
+        _monitor.SetSystemInterfaces(&_table, nullptr, nullptr, nullptr);
+        _monitor.SetSettingsReference(&_settings);
+        QVERIFY(_monitor.OpenCheckpoint(CheckpointPath));
+        QVERIFY(!_monitor.GetProcessInfo("Sleeper").IsRunning);
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_checkpointadoption)
+#include "tst_checkpointadoption.moc"
@@ -0,0 +1,119 @@
+#include <QtTest>
+#include <QDateTime>
+#include "a_scheduler.h"
+
+/**
+ * @brief Behavior tests of A_cronexpression - next and previous fire times
+ *
+ * Times are local; ctest runs this with TZ=UTC so no daylight saving
+ * transition falls into a tested range.
+ */
+class tst_cronexpression : public QObject
+{
+    Q_OBJECT
+
+private:
+    /**
+     * @brief Converts a local date and time to milliseconds since epoch
+     */
+    static qint64 Ms(int _year, int _month, int _day, int _hour = 0, int _minute = 0, int _second = 0)
+    {
+        return QDateTime(QDate(_year, _month, _day), QTime(_hour, _minute, _second)).toMSecsSinceEpoch();
+    }
+
+private slots:
+    void next_data()
+    {
+        QTest::addColumn<QString>("expression");
+        QTest::addColumn<qint64>("after");
+        QTest::addColumn<qint64>("expected");
+
+        QTest::newRow("daily later today") << QString("30 2 * * *") << Ms(2026, 1, 10, 1, 0) << Ms(2026, 1, 10, 2, 30);
+        QTest::newRow("after is exclusive") << QString("30 2 * * *") << Ms(2026, 1, 10, 2, 30) << Ms(2026, 1, 11, 2, 30);
+        QTest::newRow("step minutes") << QString("*/15 * * * *") << Ms(2026, 1, 10, 10, 7, 30) << Ms(2026, 1, 10, 10, 15);
+        QTest::newRow("weekdays skip weekend") << QString("0 9 * * 1-5") << Ms(2026, 1, 9, 10, 0) << Ms(2026, 1, 12, 9, 0);
+        QTest::newRow("day 7 is sunday") << QString("0 0 * * 7") << Ms(2026, 1, 9) << Ms(2026, 1, 11);
+        QTest::newRow("weekly shorthand") << QString("@weekly") << Ms(2026, 1, 9) << Ms(2026, 1, 11);
+        QTest::newRow("either day field") << QString("0 12 13 * 5") << Ms(2026, 2, 1) << Ms(2026, 2, 6, 12, 0);
+        QTest::newRow("month list") << QString("0 0 1 3,9 *") << Ms(2026, 3, 2) << Ms(2026, 9, 1);
+        QTest::newRow("leap day") << QString("0 0 29 2 *") << Ms(2026, 3, 1) << Ms(2028, 2, 29);
+        QTest::newRow("year end") << QString("59 23 31 12 *") << Ms(2026, 12, 31, 23, 59) << Ms(2027, 12, 31, 23, 59);
+    }
+
+    void next()
+    {
+        QFETCH(QString, expression);
+        QFETCH(qint64, after);
+        QFETCH(qint64, expected);
+
+        A_cronexpression _cron;
+        QVERIFY(_cron.Parse(expression));
+        QCOMPARE(_cron.NextMs(after), expected);
+    }
+
+    void previous_data()
+    {
+        QTest::addColumn<QString>("expression");
+        QTest::addColumn<qint64>("atOrBefore");
+        QTest::addColumn<qint64>("expected");
+
+        QTest::newRow("at is inclusive") << QString("30 2 * * *") << Ms(2026, 1, 10, 2, 30) << Ms(2026, 1, 10, 2, 30);
+        QTest::newRow("one second early") << QString("30 2 * * *") << Ms(2026, 1, 10, 2, 29, 59) << Ms(2026, 1, 9, 2, 30);
+        QTest::newRow("weekdays skip weekend") << QString("0 9 * * 1-5") << Ms(2026, 1, 11, 12, 0) << Ms(2026, 1, 9, 9, 0);
+        QTest::newRow("hourly shorthand") << QString("@hourly") << Ms(2026, 1, 10, 10, 59, 59) << Ms(2026, 1, 10, 10, 0);
+        QTest::newRow("leap day") << QString("0 0 29 2 *") << Ms(2026, 3, 1) << Ms(2024, 2, 29);
+        QTest::newRow("year start") << QString("0 0 1 1 *") << Ms(2026, 1, 1) - 1 << Ms(2025, 1, 1);
+    }
+
+    void previous()
+    {
+        QFETCH(QString, expression);
+        QFETCH(qint64, atOrBefore);
+        QFETCH(qint64, expected);
+
+        A_cronexpression _cron;
+        QVERIFY(_cron.Parse(expression));
+        QCOMPARE(_cron.PreviousMs(atOrBefore), expected);
+    }
+
+    void nextAndPreviousAgree()
+    {
+        A_cronexpression _cron;
+        QVERIFY(_cron.Parse("15,45 8-17 * * 1-5"));
+
+        qint64 _fire = Ms(2026, 1, 5);
+        for (int _i = 0; _i < 200; ++_i) {
+            const qint64 _next = _cron.NextMs(_fire);
+            QVERIFY(_next > _fire);
+            QCOMPARE(_cron.PreviousMs(_next), _next);
+            QCOMPARE(_cron.PreviousMs(_next - 1), _i == 0 ? qint64(Ms(2026, 1, 2, 17, 45)) : _fire);
+            _fire = _next;
+        }
+    }
+
+    void invalidExpressionsNeverFire_data()
+    {
+        QTest::addColumn<QString>("expression");
+
+        QTest::newRow("minute out of range") << QString("60 * * * *");
+        QTest::newRow("too few fields") << QString("* * * *");
+        QTest::newRow("reversed range") << QString("0 0 * * 5-1");
+        QTest::newRow("zero step") << QString("*/0 * * * *");
+        QTest::newRow("unknown shorthand") << QString("@fortnightly");
+        QTest::newRow("impossible date") << QString("0 0 31 2 *");
+    }
+
+    void invalidExpressionsNeverFire()
+    {
+        QFETCH(QString, expression);
+
+        A_cronexpression _cron;
+        _cron.Parse(expression);
+        const qint64 _nowMs = Ms(2026, 1, 10);
+        QCOMPARE(_cron.NextMs(_nowMs), qint64(0));
+        QCOMPARE(_cron.PreviousMs(_nowMs), qint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_cronexpression)
+#include "tst_cronexpression.moc"
@@ -0,0 +1,156 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtEndian>
+#include "a_fleetprotocol.h"
+#include "a_fleetserver.h"
+#include "a_fleethub.h"
+#include "qpm_status.h"
+
+/**
+ * @brief Behavior tests of the fleet protocol - framing, delta sequencing and resync
+ */
+class tst_fleet : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int WaitMs = 5000;     // Covers the hub's first reconnect delay with margin
+
+    /**
+     * @brief Builds the state of one application
+     */
+    static FleetAppState App(const QString& _name, quint8 _state, qint64 _processId = 0)
+    {
+        FleetAppState _app;
+        _app.Name = _name;
+        _app.State = _state;
+        _app.ProcessId = _processId;
+        return _app;
+    }
+
+    /**
+     * @brief Finds an application in a hub view
+     * @return const FleetAppState* State - null if the hub does not know it
+     */
+    static const FleetAppState* Find(const FleetHost& _host, const QString& _name)
+    {
+        const int _row = _host.Index.value(_name, -1);
+        return _row < 0 ? nullptr : &_host.Apps.at(_row);
+    }
+
+private slots:
+    void decodeWaitsForCompleteFrames()
+    {
+        const QByteArray _frame = A_fleetprotocol::EncodeDelta(7, { App("Web", QPM_STATE_RUNNING, 42) }, { "Old" });
+
+        // Every prefix is incomplete and leaves the read position alone
+        for (int _length = 0; _length < _frame.size(); ++_length) {
+            int _offset = 0;
+            A_fleetprotocol::Message _message;
+            QCOMPARE(A_fleetprotocol::Decode(_frame.left(_length), &_offset, &_message), 0);
+            QCOMPARE(_offset, 0);
+        }
+
+        // Two frames in one buffer decode one after the other
+        const QByteArray _buffer = _frame + A_fleetprotocol::EncodePing();
+        int _offset = 0;
+        A_fleetprotocol::Message _message;
+        QCOMPARE(A_fleetprotocol::Decode(_buffer, &_offset, &_message), 1);
+        QCOMPARE(_offset, int(_frame.size()));
+        QCOMPARE(_message.Type, A_fleetprotocol::DeltaMessage);
+        QCOMPARE(_message.Sequence, quint64(7));
+        QCOMPARE(int(_message.Apps.size()), 1);
+        QVERIFY(_message.Apps.first() == App("Web", QPM_STATE_RUNNING, 42));
+        QCOMPARE(_message.Removed, QStringList { "Old" });
+        QCOMPARE(A_fleetprotocol::Decode(_buffer, &_offset, &_message), 1);
+        QCOMPARE(_message.Type, A_fleetprotocol::PingMessage);
+        QCOMPARE(_offset, int(_buffer.size()));
+    }
+
+    void decodeRejectsOversizedFrames()
+    {
+        QByteArray _frame(4, '\0');
+        qToBigEndian<quint32>(quint32(A_fleetprotocol::MaxFrameBytes) + 1, _frame.data());
+        int _offset = 0;
+        A_fleetprotocol::Message _message;
+        QCOMPARE(A_fleetprotocol::Decode(_frame, &_offset, &_message), -1);
+    }
+
+    void hubFollowsServerDeltas()
+    {
+        A_fleetserver _server("MONITOR_A");
+        QVERIFY(_server.Listen(QHostAddress::LocalHost, 0));
+        _server.Publish({ App("Web", QPM_STATE_RUNNING, 100), App("Db", QPM_STATE_STOPPED) });
+
+        A_fleethub _hub({ QString("127.0.0.1:%1").arg(_server.Port()) });
+        _hub.Start();
+        QTRY_VERIFY_WITH_TIMEOUT(_hub.Host(0).Connected, WaitMs);
+        QCOMPARE(_hub.Host(0).ServerId, QString("MONITOR_A"));
+        QCOMPARE(_hub.Host(0).Sequence, _server.Sequence());
+        QCOMPARE(int(_hub.Host(0).Apps.size()), 2);
+        QCOMPARE(_hub.Host(0).Snapshots, quint64(1));
+
+        // A change travels as one Delta with the next sequence number
+        _server.Publish({ App("Web", QPM_STATE_RUNNING, 101), App("Db", QPM_STATE_STOPPED) });
+        QTRY_COMPARE_WITH_TIMEOUT(_hub.Host(0).Sequence, _server.Sequence(), WaitMs);
+        QCOMPARE(_hub.Host(0).Deltas, quint64(1));
+        QCOMPARE(Find(_hub.Host(0), "Web")->ProcessId, qint64(101));
+
+        // Publishing the same state sends nothing
+        const quint64 _sequence = _server.Sequence();
+        _server.Publish({ App("Web", QPM_STATE_RUNNING, 101), App("Db", QPM_STATE_STOPPED) });
+        QCOMPARE(_server.Sequence(), _sequence);
+
+        // Removal and addition in one Delta
+        _server.Publish({ App("Web", QPM_STATE_RUNNING, 101), App("Cache", QPM_STATE_RUNNING, 200) });
+        QTRY_COMPARE_WITH_TIMEOUT(_hub.Host(0).Sequence, _server.Sequence(), WaitMs);
+        QCOMPARE(_hub.Host(0).Deltas, quint64(2));
+        QCOMPARE(int(_hub.Host(0).Apps.size()), 2);
+        QVERIFY(!Find(_hub.Host(0), "Db"));
+        QCOMPARE(Find(_hub.Host(0), "Cache")->ProcessId, qint64(200));
+        QCOMPARE(_hub.ResyncCount(), quint64(0));
+    }
+
+    void hubResyncsAfterSequenceGap()
+    {
+        // A scripted monitor: the first connection skips a sequence number, the second is consistent
+        QTcpServer _listener;
+        QVERIFY(_listener.listen(QHostAddress::LocalHost, 0));
+        int _connections = 0;
+        connect(&_listener, &QTcpServer::newConnection, this, [&]() {
+            QTcpSocket* _socket = _listener.nextPendingConnection();
+            connect(_socket, &QTcpSocket::disconnected, _socket, &QObject::deleteLater);
+            ++_connections;
+            _socket->write(A_fleetprotocol::EncodeHello("SCRIPTED"));
+            if (_connections == 1) {
+                _socket->write(A_fleetprotocol::EncodeSnapshot(1, { App("Web", QPM_STATE_RUNNING, 10) }));
+                _socket->write(A_fleetprotocol::EncodeDelta(3, { App("Web", QPM_STATE_STOPPED) }, {}));
+            } else {
+                _socket->write(A_fleetprotocol::EncodeSnapshot(10, { App("Web", QPM_STATE_RUNNING, 11),
+                                                                     App("Db", QPM_STATE_RUNNING, 12) }));
+            }
+        });
+
+        A_fleethub _hub({ QString("127.0.0.1:%1").arg(_listener.serverPort()) });
+        _hub.Start();
+
+        // The gap drops the connection and keeps the last consistent state
+        QTRY_COMPARE_WITH_TIMEOUT(_hub.ResyncCount(), quint64(1), WaitMs);
+        QCOMPARE(_hub.Host(0).Sequence, quint64(1));
+        QCOMPARE(Find(_hub.Host(0), "Web")->State, quint8(QPM_STATE_RUNNING));
+        QCOMPARE(_hub.Host(0).Deltas, quint64(0));
+
+        // The reconnect starts over from a Snapshot
+        QTRY_COMPARE_WITH_TIMEOUT(_hub.Host(0).Snapshots, quint64(2), WaitMs);
+        QVERIFY(_hub.Host(0).Connected);
+        QCOMPARE(_connections, 2);
+        QCOMPARE(_hub.Host(0).Sequence, quint64(10));
+        QCOMPARE(int(_hub.Host(0).Apps.size()), 2);
+        QCOMPARE(Find(_hub.Host(0), "Web")->ProcessId, qint64(11));
+        QCOMPARE(_hub.ResyncCount(), quint64(1));
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_fleet)
+#include "tst_fleet.moc"
@@ -0,0 +1,127 @@
+#include <QtTest>
+#include <QDir>
+#include <QTemporaryDir>
+#include "a_journal.h"
+
+/**
+ * @brief Behavior tests of A_journal - queries, rotation and retention
+ */
+class tst_journal : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr qint64 SegmentBytes = qint64(sizeof(JournalSegmentHeader))
+                                           + A_journal::SparseInterval * qint64(sizeof(JournalRecord));
+
+    /**
+     * @brief Counts the segment files of a journal directory
+     * @param _directory Journal directory
+     * @return int Segment files
+     */
+    static int SegmentFiles(const QString& _directory)
+    {
+        return int(QDir(_directory).entryList(QStringList() << "journal-*.qpj", QDir::Files).size());
+    }
+
+private slots:
+    void queryFiltersByApplicationAndTime()
+    {
+        QTemporaryDir _dir;
+        A_journal _journal;
+        QVERIFY(_journal.Open(_dir.path()));
+
+        for (int _i = 0; _i < 200; ++_i) {
+            _journal.Append(1000 + _i * 10, JournalEventType::Running, _i % 2 ? "Odd" : "Even", _i);
+        }
+
+        const QList<JournalRecord> _odd = _journal.Query("Odd", 1100, 1200);
+        QCOMPARE(int(_odd.size()), 5);
+        for (int _i = 0; _i < _odd.size(); ++_i) {
+            QCOMPARE(QByteArray(_odd.at(_i).AppName), QByteArray("Odd"));
+            QCOMPARE(_odd.at(_i).TimestampMs, qint64(1110 + _i * 20));
+        }
+
+        QCOMPARE(int(_journal.Query(QString(), 1000, 1990).size()), 200);
+        QCOMPARE(int(_journal.Query("Missing", 0, 10000).size()), 0);
+        QCOMPARE(int(_journal.Query("Even", 5000, 6000).size()), 0);
+    }
+
+    void queryReturnsTimeOrderAcrossClockSteps()
+    {
+        QTemporaryDir _dir;
+        A_journal _journal;
+        QVERIFY(_journal.Open(_dir.path()));
+
+        // The wall clock stepped back between the second and the third event
+        const QVector<qint64> _times = { 5000, 6000, 2000, 3000, 7000 };
+        for (int _i = 0; _i < _times.size(); ++_i) {
+            _journal.Append(_times.at(_i), JournalEventType::Crashed, "App", _i);
+        }
+
+        const QList<JournalRecord> _all = _journal.Query("App", 0, 10000);
+        QCOMPARE(int(_all.size()), 5);
+        for (int _i = 1; _i < _all.size(); ++_i) {
+            QVERIFY(_all.at(_i - 1).TimestampMs <= _all.at(_i).TimestampMs);
+        }
+
+        const QList<JournalRecord> _early = _journal.Query("App", 1500, 3500);
+        QCOMPARE(int(_early.size()), 2);
+        QCOMPARE(_early.at(0).ProcessId, qint64(2));
+        QCOMPARE(_early.at(1).ProcessId, qint64(3));
+    }
+
+    void rotationKeepsNewestSegments()
+    {
+        QTemporaryDir _dir;
+        A_journal _journal;
+        QVERIFY(_journal.Open(_dir.path(), SegmentBytes, 3));
+
+        // Five full segments and ten records in a sixth - the oldest three are deleted
+        const int _count = 5 * int(A_journal::SparseInterval) + 10;
+        for (int _i = 0; _i < _count; ++_i) {
+            _journal.Append(_i, JournalEventType::Restarted, "App", _i);
+        }
+
+        QCOMPARE(SegmentFiles(_dir.path()), 3);
+        const QList<JournalRecord> _kept = _journal.Query("App", 0, _count);
+        QCOMPARE(int(_kept.size()), 2 * int(A_journal::SparseInterval) + 10);
+        QCOMPARE(_kept.first().TimestampMs, qint64(3 * A_journal::SparseInterval));
+        QCOMPARE(_kept.last().TimestampMs, qint64(_count - 1));
+    }
+
+    void reopenResumesAndAppliesRetention()
+    {
+        QTemporaryDir _dir;
+        const int _count = 3 * int(A_journal::SparseInterval) + 5;
+        {
+            A_journal _journal;
+            QVERIFY(_journal.Open(_dir.path(), SegmentBytes, 8));
+            for (int _i = 0; _i < _count; ++_i) {
+                _journal.Append(_i, JournalEventType::Running, "App", _i);
+            }
+        }
+        QCOMPARE(SegmentFiles(_dir.path()), 4);
+
+        // Same limit - everything is found again and appends go to the partial segment
+        {
+            A_journal _journal;
+            QVERIFY(_journal.Open(_dir.path(), SegmentBytes, 8));
+            QCOMPARE(int(_journal.Query("App", 0, _count).size()), _count);
+            _journal.Append(_count, JournalEventType::Stopped, "App");
+            QCOMPARE(SegmentFiles(_dir.path()), 4);
+            QCOMPARE(int(_journal.Query("App", _count, _count).size()), 1);
+        }
+
+        // Lower limit - the oldest segments go when the journal opens
+        A_journal _journal;
+        QVERIFY(_journal.Open(_dir.path(), SegmentBytes, 2));
+        QCOMPARE(SegmentFiles(_dir.path()), 2);
+        const QList<JournalRecord> _kept = _journal.Query("App", 0, _count);
+        QCOMPARE(int(_kept.size()), int(A_journal::SparseInterval) + 6);
+        QCOMPARE(_kept.first().TimestampMs, qint64(2 * A_journal::SparseInterval));
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_journal)
+#include "tst_journal.moc"
@@ -0,0 +1,74 @@
+/**
+ * @brief Tiny crash-prone child process for the stress harness
+ *
+ * Copies of this binary are supervised under unique names. Each instance
+ * appends a start record to the event log, lives for an exponentially
+ * distributed time and then exits with a failure code as if it crashed,
+ * appending an exit record first. Records use CLOCK_MONOTONIC so the harness
+ * can subtract times written by different processes.
+ *
+ * Environment:
+ *   QPM_STRESS_EVENT_LOG      Event log path - records are "S|E <name> <pid> <ns>"
+ *   QPM_STRESS_MEAN_LIFETIME  Mean lifetime in milliseconds - default 5000
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+long long MonotonicNs()
+{
+    timespec _now;
+    clock_gettime(CLOCK_MONOTONIC, &_now);
+    return static_cast<long long>(_now.tv_sec) * 1000000000LL + _now.tv_nsec;
+}
+
+void AppendRecord(const char* _logPath, char _kind, const char* _name)
+{
+    if (!_logPath) {
+        return;
+    }
+
+    // One write per record with O_APPEND keeps records from different processes intact
+    char _line[256];
+    int _length = snprintf(_line, sizeof(_line), "%c %s %d %lld\n", _kind, _name, int(getpid()), MonotonicNs());
+    int _fd = open(_logPath, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd >= 0) {
+        ssize_t _ignored = write(_fd, _line, size_t(_length));
+        (void)_ignored;
+        close(_fd);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    const char* _name = strrchr(argv[0], '/') ? strrchr(argv[0], '/') + 1 : argv[0];
+    const char* _logPath = getenv("QPM_STRESS_EVENT_LOG");
+    const char* _meanEnv = getenv("QPM_STRESS_MEAN_LIFETIME");
+    const double _meanMs = (_meanEnv && atof(_meanEnv) > 0) ? atof(_meanEnv) : 5000.0;
+
+    AppendRecord(_logPath, 'S', _name);
+
+    // Exponential lifetime, seeded per process
+    srand48(long(MonotonicNs() ^ (long long)getpid() << 20));
+    const double _lifetimeMs = -_meanMs * std::log(1.0 - drand48());
+
+    timespec _sleep;
+    _sleep.tv_sec = time_t(_lifetimeMs / 1000.0);
+    _sleep.tv_nsec = long(std::fmod(_lifetimeMs, 1000.0) * 1000000.0);
+    while (nanosleep(&_sleep, &_sleep) != 0 && errno == EINTR) {
+    }
+
+    AppendRecord(_logPath, 'E', _name);
+    return 1;
+}
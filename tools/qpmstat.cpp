@@ -0,0 +1,177 @@
+/**
+ * @brief Prints application state from the monitor's shared-memory status table
+ *
+ * Reads the table published by qtprocessmonitord or the GUI (see
+ * qpm_status.h) without contacting the monitor: one mmap and a seqlock copy
+ * per record, so a query costs microseconds and never stalls monitoring.
+ *
+ * Usage:
+ *   qpmstat [-n name]              Lists every application
+ *   qpmstat [-n name] [-q|-p] APP  Shows one application
+ *
+ *   -n name  Segment name - default: /qtprocessmonitor-status-<uid>
+ *   -q       Print nothing - only the exit status
+ *   -p       Print only the PID, like pidof
+ *
+ * Exit status: 0 if APP is running (or the list was printed), 1 if APP is
+ * not running or unknown, 2 if the table cannot be read.
+ */
+
+#include "qpm_status.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+namespace {
+
+const char* StateName(uint32_t _state)
+{
+    switch (_state) {
+    case QPM_STATE_STOPPED: return "stopped";
+    case QPM_STATE_RUNNING: return "running";
+    case QPM_STATE_BACKOFF: return "backoff";
+    case QPM_STATE_PARKED:  return "parked";
+    default:                return "-";
+    }
+}
+
+long long NowMs()
+{
+    timespec _now;
+    clock_gettime(CLOCK_REALTIME, &_now);
+    return static_cast<long long>(_now.tv_sec) * 1000LL + _now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Formats a duration as "3d04h", "5h12m", "7m05s" or "42s"
+ */
+void FormatDuration(long long _ms, char* _buffer, size_t _size)
+{
+    const long long _seconds = _ms > 0 ? _ms / 1000 : 0;
+    if (_seconds >= 86400) {
+        snprintf(_buffer, _size, "%lldd%02lldh", _seconds / 86400, _seconds % 86400 / 3600);
+    } else if (_seconds >= 3600) {
+        snprintf(_buffer, _size, "%lldh%02lldm", _seconds / 3600, _seconds % 3600 / 60);
+    } else if (_seconds >= 60) {
+        snprintf(_buffer, _size, "%lldm%02llds", _seconds / 60, _seconds % 60);
+    } else {
+        snprintf(_buffer, _size, "%llds", _seconds);
+    }
+}
+
+void PrintHeader()
+{
+    printf("%-32s %-8s %8s %8s %9s %7s %9s %9s\n",
+           "NAME", "STATE", "PID", "RESTARTS", "UPTIME", "CPU%", "RSS(MB)", "CHANGED");
+}
+
+void PrintRecord(const qpm_status_record_t& _record, long long _nowMs)
+{
+    char _pid[24] = "-";
+    char _uptime[24] = "-";
+    char _changed[24];
+    if (_record.pid > 0) {
+        snprintf(_pid, sizeof(_pid), "%lld", static_cast<long long>(_record.pid));
+    }
+    if (_record.started_ms > 0) {
+        FormatDuration(_nowMs - _record.started_ms, _uptime, sizeof(_uptime));
+    }
+    FormatDuration(_nowMs - _record.changed_ms, _changed, sizeof(_changed));
+
+    printf("%-32s %-8s %8s %8u %9s %7.2f %9.1f %9s\n",
+           _record.name, StateName(_record.state), _pid, _record.restarts, _uptime,
+           _record.cpu_hundredths / 100.0, _record.resident_kb / 1024.0, _changed);
+}
+
+void Usage(const char* _program)
+{
+    fprintf(stderr, "Usage: %s [-n name] [-q|-p] [APP]\n", _program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    char _segment[128];
+    qpm_status_default_name(_segment, sizeof(_segment));
+    bool _quiet = false;
+    bool _pidOnly = false;
+
+    int _option;
+    while ((_option = getopt(argc, argv, "n:qph")) != -1) {
+        switch (_option) {
+        case 'n':
+            snprintf(_segment, sizeof(_segment), "%s", optarg);
+            break;
+        case 'q':
+            _quiet = true;
+            break;
+        case 'p':
+            _pidOnly = true;
+            break;
+        default:
+            Usage(argv[0]);
+            return _option == 'h' ? 0 : 2;
+        }
+    }
+    const char* _appName = optind < argc ? argv[optind] : nullptr;
+
+    const qpm_status_header_t* _header = nullptr;
+    const int _result = qpm_status_open(_segment, &_header);
+    if (_result != QPM_STATUS_OK) {
+        fprintf(stderr, "qpmstat: %s: %s\n", _segment, qpm_status_error(_result));
+        return 2;
+    }
+
+    // A monitor that crashed leaves its table behind
+    if (kill(pid_t(_header->monitor_pid), 0) != 0 && errno == ESRCH) {
+        fprintf(stderr, "qpmstat: %s: monitor %lld is gone - table is stale\n",
+                _segment, static_cast<long long>(_header->monitor_pid));
+        return 2;
+    }
+
+    const long long _nowMs = NowMs();
+    const uint32_t _count = qpm_status_count(_header);
+
+    if (!_appName) {
+        PrintHeader();
+        for (uint32_t _i = 0; _i < _count; ++_i) {
+            qpm_status_record_t _record;
+            if (qpm_status_read(_header, _i, &_record) == QPM_STATUS_OK && _record.state != QPM_STATE_EMPTY) {
+                PrintRecord(_record, _nowMs);
+            }
+        }
+        return 0;
+    }
+
+    for (uint32_t _i = 0; _i < _count; ++_i) {
+        qpm_status_record_t _record;
+        const int _read = qpm_status_read(_header, _i, &_record);
+        if (_read != QPM_STATUS_OK) {
+            continue;
+        }
+        if (_record.state == QPM_STATE_EMPTY || strcmp(_record.name, _appName) != 0) {
+            continue;
+        }
+
+        if (_pidOnly) {
+            if (_record.pid > 0) {
+                printf("%lld\n", static_cast<long long>(_record.pid));
+            }
+        } else if (!_quiet) {
+            PrintHeader();
+            PrintRecord(_record, _nowMs);
+        }
+        return _record.state == QPM_STATE_RUNNING ? 0 : 1;
+    }
+
+    if (!_quiet && !_pidOnly) {
+        fprintf(stderr, "qpmstat: %s: unknown application\n", _appName);
+    }
+    return 1;
+}
@@ -0,0 +1,244 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <sys/resource.h>
+
+#include "a_fleetserver.h"
+#include "a_fleethub.h"
+#include "a_metrics.h"
+#include "qpm_status.h"
+
+/**
+ * @brief Fleet hub load and convergence harness
+ *
+ * Starts N fleet servers with M synthetic applications each on loopback
+ * ports and one hub connected to all of them, in one process. For the run
+ * time it changes random applications (state, PID, restarts, occasionally a
+ * rename, which the protocol carries as a removal plus an addition) and
+ * periodically disconnects the hubs of a random server so the hub has to
+ * resynchronize. Afterwards it stops the churn, waits for the hub to
+ * converge and compares the hub's view of every server with the server's
+ * published state. The report lists time to first sync, message counts,
+ * resyncs, time to converge and the memory the hub added.
+ */
+
+namespace {
+
+void QuietMessageHandler(QtMsgType _type, const QMessageLogContext&, const QString& _message)
+{
+    if (_type != QtDebugMsg && _type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(_message));
+    }
+}
+
+/**
+ * @brief Raises the descriptor limit - every server costs a listening and two connected sockets
+ */
+void RaiseDescriptorLimit()
+{
+    rlimit _limit;
+    if (getrlimit(RLIMIT_NOFILE, &_limit) == 0 && _limit.rlim_cur < _limit.rlim_max) {
+        _limit.rlim_cur = _limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &_limit);
+    }
+}
+
+/**
+ * @brief Counts servers whose state the hub does not mirror exactly
+ */
+int CountMismatches(const A_fleethub& _hub, const std::vector<std::unique_ptr<A_fleetserver>>& _servers)
+{
+    int _mismatches = 0;
+    for (int _host = 0; _host < int(_servers.size()); ++_host) {
+        const FleetHost& _view = _hub.Host(_host);
+        const QVector<FleetAppState> _published = _servers[size_t(_host)]->PublishedState();
+        bool _equal = _view.Connected && _view.Sequence == _servers[size_t(_host)]->Sequence()
+                      && _view.Apps.size() == _published.size();
+        for (int _i = 0; _equal && _i < int(_published.size()); ++_i) {
+            const int _row = _view.Index.value(_published.at(_i).Name, -1);
+            _equal = _row >= 0 && _view.Apps.at(_row) == _published.at(_i);
+        }
+        _mismatches += _equal ? 0 : 1;
+    }
+    return _mismatches;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication _app(argc, argv);
+    _app.setApplicationName("qtprocessmonitor_fleetload");
+
+    QCommandLineParser _parser;
+    _parser.setApplicationDescription("Run many fleet servers and one hub on loopback and check convergence");
+    _parser.addHelpOption();
+    QCommandLineOption _instancesOption("instances", "Number of fleet servers.", "count", "500");
+    QCommandLineOption _appsOption("apps", "Applications per server.", "count", "200");
+    QCommandLineOption _durationOption("duration", "Churn time in seconds.", "seconds", "30");
+    QCommandLineOption _churnOption("churn", "Application changes per second across the fleet.", "count", "2000");
+    QCommandLineOption _dropOption("drop-interval", "Milliseconds between forced disconnects - 0 for none.", "ms", "2000");
+    QCommandLineOption _verboseOption("verbose", "Show server and hub debug output.");
+    _parser.addOptions({ _instancesOption, _appsOption, _durationOption, _churnOption, _dropOption, _verboseOption });
+    _parser.process(_app);
+
+    if (!_parser.isSet(_verboseOption)) {
+        qInstallMessageHandler(QuietMessageHandler);
+    }
+    RaiseDescriptorLimit();
+
+    const int _instanceCount = qMax(1, _parser.value(_instancesOption).toInt());
+    const int _appCount = qBound(1, _parser.value(_appsOption).toInt(), A_fleetprotocol::MaxAppsPerHost);
+    const int _durationSeconds = qMax(1, _parser.value(_durationOption).toInt());
+    const int _churnPerSecond = qMax(0, _parser.value(_churnOption).toInt());
+    const int _dropIntervalMs = qMax(0, _parser.value(_dropOption).toInt());
+    QRandomGenerator _random(12345);
+
+    // Servers with their synthetic application state
+    std::vector<std::unique_ptr<A_fleetserver>> _servers;
+    QVector<QVector<FleetAppState>> _states(_instanceCount);
+    QStringList _endpoints;
+    for (int _host = 0; _host < _instanceCount; ++_host) {
+        _servers.emplace_back(new A_fleetserver(QString("HOST_%1").arg(_host, 4, 10, QChar('0'))));
+        if (!_servers.back()->Listen(QHostAddress::LocalHost, 0)) {
+            fprintf(stderr, "Cannot listen for server %d - raise the open file limit\n", _host);
+            return 1;
+        }
+        _endpoints << QString("127.0.0.1:%1").arg(_servers.back()->Port());
+
+        QVector<FleetAppState>& _apps = _states[_host];
+        _apps.resize(_appCount);
+        for (int _i = 0; _i < _appCount; ++_i) {
+            _apps[_i].Name = QString("app_%1").arg(_i);
+            _apps[_i].State = QPM_STATE_RUNNING;
+            _apps[_i].ProcessId = 1000 + _i;
+            _apps[_i].StartedMs = 1;
+        }
+        _servers.back()->Publish(_apps);
+    }
+
+    const qint64 _baselineKb = A_metrics::ResidentKb();
+    QElapsedTimer _clock;
+    _clock.start();
+
+    A_fleethub _hub(_endpoints);
+    _hub.Start();
+
+    // Initial synchronization
+    qint64 _syncMs = -1;
+    QTimer _poll;
+    QObject::connect(&_poll, &QTimer::timeout, &_app, [&]() {
+        if (_hub.ConnectedCount() == _instanceCount) {
+            _syncMs = _clock.elapsed();
+            _app.quit();
+        } else if (_clock.elapsed() > 60000) {
+            _app.quit();
+        }
+    });
+    _poll.start(10);
+    _app.exec();
+    _poll.stop();
+    _poll.disconnect();
+    if (_syncMs < 0) {
+        fprintf(stderr, "Only %d of %d servers synchronized within 60 s\n", _hub.ConnectedCount(), _instanceCount);
+        return 1;
+    }
+    const qint64 _syncedKb = A_metrics::ResidentKb();
+
+    // Churn - one batch every 50 ms, published per touched server
+    quint64 _changes = 0;
+    quint64 _renames = 0;
+    quint64 _drops = 0;
+    QTimer _churnTimer;
+    QObject::connect(&_churnTimer, &QTimer::timeout, &_app, [&]() {
+        QSet<int> _touched;
+        for (int _n = 0; _n < _churnPerSecond / 20; ++_n) {
+            const int _host = int(_random.bounded(_instanceCount));
+            FleetAppState& _state = _states[_host][int(_random.bounded(_appCount))];
+            if (_random.bounded(100) == 0) {
+                _state.Name = QString("app_r%1").arg(++_renames);
+            } else if (_state.State == QPM_STATE_RUNNING) {
+                _state.State = QPM_STATE_BACKOFF;
+                _state.ProcessId = 0;
+                _state.StartedMs = 0;
+            } else {
+                _state.State = QPM_STATE_RUNNING;
+                _state.ProcessId = 1000 + qint64(_random.bounded(4000000));
+                _state.StartedMs = QDateTime::currentMSecsSinceEpoch();
+                ++_state.Restarts;
+            }
+            _touched.insert(_host);
+            ++_changes;
+        }
+        for (int _host : _touched) {
+            _servers[size_t(_host)]->Publish(_states[_host]);
+        }
+    });
+    QTimer _dropTimer;
+    QObject::connect(&_dropTimer, &QTimer::timeout, &_app, [&]() {
+        _servers[size_t(_random.bounded(_instanceCount))]->DisconnectClients();
+        ++_drops;
+    });
+
+    _churnTimer.start(50);
+    if (_dropIntervalMs > 0) {
+        _dropTimer.start(_dropIntervalMs);
+    }
+    QTimer::singleShot(_durationSeconds * 1000, &_app, &QCoreApplication::quit);
+    _app.exec();
+    _churnTimer.stop();
+    _dropTimer.stop();
+
+    // Convergence - every server reconnected and mirrored exactly
+    const qint64 _quietStartMs = _clock.elapsed();
+    int _mismatches = CountMismatches(_hub, _servers);
+    QObject::connect(&_poll, &QTimer::timeout, &_app, [&]() {
+        _mismatches = CountMismatches(_hub, _servers);
+        if (_mismatches == 0 || _clock.elapsed() - _quietStartMs > 60000) {
+            _app.quit();
+        }
+    });
+    if (_mismatches > 0) {
+        _poll.start(100);
+        _app.exec();
+        _poll.stop();
+    }
+    const qint64 _convergeMs = _clock.elapsed() - _quietStartMs;
+
+    quint64 _published = 0;
+    for (const auto& _server : _servers) {
+        _published += _server->DeltaCount();
+    }
+    quint64 _snapshots = 0;
+    quint64 _applied = 0;
+    for (int _host = 0; _host < _hub.HostCount(); ++_host) {
+        _snapshots += _hub.Host(_host).Snapshots;
+        _applied += _hub.Host(_host).Deltas;
+    }
+
+    printf("servers              %d x %d applications\n", _instanceCount, _appCount);
+    printf("initial sync         %lld ms\n", static_cast<long long>(_syncMs));
+    printf("churn                %llu changes (%llu renames) in %d s\n",
+           static_cast<unsigned long long>(_changes), static_cast<unsigned long long>(_renames), _durationSeconds);
+    printf("deltas               %llu published, %llu applied\n",
+           static_cast<unsigned long long>(_published), static_cast<unsigned long long>(_applied));
+    printf("resyncs              %llu snapshots, %llu forced disconnects, %llu gap resyncs\n",
+           static_cast<unsigned long long>(_snapshots), static_cast<unsigned long long>(_drops),
+           static_cast<unsigned long long>(_hub.ResyncCount()));
+    printf("converged            %s after %lld ms (%d mismatched servers)\n", _mismatches == 0 ? "yes" : "NO",
+           static_cast<long long>(_convergeMs), _mismatches);
+    printf("hub memory           %lld kB after sync, %lld kB at end (RSS growth over the servers alone)\n",
+           static_cast<long long>(_syncedKb - _baselineKb),
+           static_cast<long long>(A_metrics::ResidentKb() - _baselineKb));
+
+    return _mismatches == 0 ? 0 : 1;
+}
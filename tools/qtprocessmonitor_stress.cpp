@@ -0,0 +1,226 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <sys/resource.h>
+
+#include "a_settingsclass.h"
+#include "a_process.h"
+
+/**
+ * @brief Crash-to-restart latency stress harness
+ *
+ * Generates a configuration of N uniquely named copies of qpm_crashdummy,
+ * runs the real monitoring engine headlessly against it for a fixed time and
+ * then reads the dummies' event log. For every crash the latency is the time
+ * from the exit record to the start record of the replacement process. The
+ * report lists the latency distribution, launch throughput and the CPU time
+ * used by the monitor itself and by its helper processes (pidof, pgrep).
+ */
+
+namespace {
+
+/**
+ * @brief One start or exit record from the event log
+ */
+struct StressEvent {
+    char Kind;          // 'S' start, 'E' exit
+    qint64 ProcessId;   // Process that wrote the record
+    qint64 TimeNs;      // CLOCK_MONOTONIC time - nanoseconds
+};
+
+void QuietMessageHandler(QtMsgType _type, const QMessageLogContext&, const QString& _message)
+{
+    if (_type != QtDebugMsg && _type != QtInfoMsg) {
+        fprintf(stderr, "%s\n", qPrintable(_message));
+    }
+}
+
+double CpuSeconds(int _who)
+{
+    rusage _usage;
+    getrusage(_who, &_usage);
+    return double(_usage.ru_utime.tv_sec + _usage.ru_stime.tv_sec)
+           + double(_usage.ru_utime.tv_usec + _usage.ru_stime.tv_usec) / 1e6;
+}
+
+double Percentile(const QVector<double>& _sorted, double _fraction)
+{
+    if (_sorted.isEmpty()) {
+        return 0.0;
+    }
+    const int _index = qBound(0, int(std::ceil(_fraction * _sorted.size())) - 1, int(_sorted.size()) - 1);
+    return _sorted.at(_index);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication _app(argc, argv);
+    _app.setApplicationName("qtprocessmonitor_stress");
+
+    QCommandLineParser _parser;
+    _parser.setApplicationDescription("Measure crash-to-restart latency with real child processes");
+    _parser.addHelpOption();
+    QCommandLineOption _appsOption("apps", "Number of supervised dummy applications.", "count", "20");
+    QCommandLineOption _durationOption("duration", "Run time in seconds.", "seconds", "60");
+    QCommandLineOption _lifetimeOption("mean-lifetime", "Mean dummy lifetime in milliseconds.", "ms", "5000");
+    QCommandLineOption _dummyOption("dummy", "Path of the qpm_crashdummy binary.", "path",
+                                    QCoreApplication::applicationDirPath() + "/qpm_crashdummy");
+    QCommandLineOption _verboseOption("verbose", "Show engine debug output.");
+    _parser.addOptions({ _appsOption, _durationOption, _lifetimeOption, _dummyOption, _verboseOption });
+    _parser.process(_app);
+
+    if (!_parser.isSet(_verboseOption)) {
+        qInstallMessageHandler(QuietMessageHandler);
+    }
+
+    const int _appCount = qMax(1, _parser.value(_appsOption).toInt());
+    const int _durationSeconds = qMax(1, _parser.value(_durationOption).toInt());
+    const QString _dummyPath = _parser.value(_dummyOption);
+    if (!QFileInfo(_dummyPath).isExecutable()) {
+        fprintf(stderr, "Dummy binary not found or not executable: %s\n", qPrintable(_dummyPath));
+        return 1;
+    }
+
+    // Unique names so pidof can tell the applications apart
+    QTemporaryDir _tempDir;
+    const QString _eventLogPath = _tempDir.path() + "/events.log";
+    const QString _configPath = _tempDir.path() + "/config.xml";
+    QStringList _names;
+    for (int _i = 0; _i < _appCount; ++_i) {
+        const QString _name = QString("qpmstress_%1").arg(_i);
+        const QString _path = _tempDir.path() + "/" + _name;
+        if (!QFile::copy(_dummyPath, _path)) {
+            fprintf(stderr, "Cannot copy dummy to %s\n", qPrintable(_path));
+            return 1;
+        }
+        QFile::setPermissions(_path, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+        _names << _name;
+    }
+
+    QFile _configFile(_configPath);
+    if (!_configFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        fprintf(stderr, "Cannot write stress config: %s\n", qPrintable(_configPath));
+        return 1;
+    }
+    QTextStream _stream(&_configFile);
+    _stream << "<configuration>\n    <settings><id>STRESS</id><port>1000</port><ip>127.0.0.1</ip></settings>\n"
+            << "    <applications>\n";
+    for (const QString& _name : _names) {
+        _stream << "        <app><n>" << _name << "</n><executable>" << _tempDir.path() << "/" << _name
+                << "</executable><status>start</status></app>\n";
+    }
+    _stream << "    </applications>\n</configuration>\n";
+    _stream.flush();
+    _configFile.close();
+
+    // Dummies inherit these through the detached launch
+    qputenv("QPM_STRESS_EVENT_LOG", _eventLogPath.toLocal8Bit());
+    qputenv("QPM_STRESS_MEAN_LIFETIME", _parser.value(_lifetimeOption).toLocal8Bit());
+
+    A_settingsclass _settings;
+    if (!_settings.LoadConfiguration(_configPath)) {
+        fprintf(stderr, "Cannot load stress config\n");
+        return 1;
+    }
+
+    const double _selfCpuStart = CpuSeconds(RUSAGE_SELF);
+    const double _childCpuStart = CpuSeconds(RUSAGE_CHILDREN);
+    QElapsedTimer _wallClock;
+    _wallClock.start();
+
+    {
+        A_process _process;
+        _process.SetSettingsReference(&_settings);
+        _process.StartMonitoring();
+        QTimer::singleShot(_durationSeconds * 1000, &_app, &QCoreApplication::quit);
+        _app.exec();
+        _process.StopMonitoring();
+    }
+
+    const double _wallSeconds = double(_wallClock.nsecsElapsed()) / 1e9;
+    const double _selfCpu = CpuSeconds(RUSAGE_SELF) - _selfCpuStart;
+    const double _childCpu = CpuSeconds(RUSAGE_CHILDREN) - _childCpuStart;
+
+    // Read the event log and pair every exit with the next start of the same app
+    QHash<QString, QVector<StressEvent>> _events;
+    QFile _eventLog(_eventLogPath);
+    if (_eventLog.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!_eventLog.atEnd()) {
+            const QList<QByteArray> _fields = _eventLog.readLine().trimmed().split(' ');
+            if (_fields.size() != 4 || _fields.at(0).size() != 1) {
+                continue;
+            }
+            _events[QString::fromLocal8Bit(_fields.at(1))].append(
+                StressEvent { _fields.at(0).at(0), _fields.at(2).toLongLong(), _fields.at(3).toLongLong() });
+        }
+    }
+
+    QVector<double> _latenciesMs;
+    int _starts = 0;
+    int _exits = 0;
+    int _unrecovered = 0;
+    QSet<qint64> _alive;
+    for (auto _it = _events.begin(); _it != _events.end(); ++_it) {
+        QVector<StressEvent>& _appEvents = _it.value();
+        std::sort(_appEvents.begin(), _appEvents.end(),
+                  [](const StressEvent& _a, const StressEvent& _b) { return _a.TimeNs < _b.TimeNs; });
+
+        for (int _i = 0; _i < _appEvents.size(); ++_i) {
+            const StressEvent& _event = _appEvents.at(_i);
+            if (_event.Kind == 'S') {
+                ++_starts;
+                _alive.insert(_event.ProcessId);
+                continue;
+            }
+
+            ++_exits;
+            _alive.remove(_event.ProcessId);
+            auto _next = std::find_if(_appEvents.constBegin() + _i + 1, _appEvents.constEnd(),
+                                      [](const StressEvent& _candidate) { return _candidate.Kind == 'S'; });
+            if (_next == _appEvents.constEnd()) {
+                ++_unrecovered;
+            } else {
+                _latenciesMs.append(double(_next->TimeNs - _event.TimeNs) / 1e6);
+            }
+        }
+    }
+
+    // Dummies are detached; end the survivors explicitly
+    for (qint64 _pid : _alive) {
+        ::kill(pid_t(_pid), SIGKILL);
+    }
+
+    std::sort(_latenciesMs.begin(), _latenciesMs.end());
+    double _sum = 0.0;
+    for (double _latency : _latenciesMs) {
+        _sum += _latency;
+    }
+
+    printf("applications         %d\n", _appCount);
+    printf("wall time            %.1f s\n", _wallSeconds);
+    printf("starts               %d (%.2f launches/s)\n", _starts, _starts / _wallSeconds);
+    printf("crashes              %d (recovered %d, pending at end %d)\n",
+           _exits, int(_latenciesMs.size()), _unrecovered);
+    printf("restart latency ms   p50 %.1f  p90 %.1f  p99 %.1f  max %.1f  mean %.1f\n",
+           Percentile(_latenciesMs, 0.50), Percentile(_latenciesMs, 0.90), Percentile(_latenciesMs, 0.99),
+           _latenciesMs.isEmpty() ? 0.0 : _latenciesMs.last(),
+           _latenciesMs.isEmpty() ? 0.0 : _sum / _latenciesMs.size());
+    printf("monitor cpu          %.2f s (%.1f%% of one core)\n", _selfCpu, 100.0 * _selfCpu / _wallSeconds);
+    printf("helper process cpu   %.2f s (pidof/pgrep and launch helpers)\n", _childCpu);
+
+    return 0;
+}